@@ -1,3 +1,8 @@
+import { Buffer } from 'buffer';
+
+import { decodeGraphCommands } from '../src/audio/bridge/GraphCommandBuffer';
+import type { GraphCommand } from '../src/audio/bridge/GraphCommandBuffer';
+
 const noop = async () => {};
 
 export const View = 'View';
@@ -109,12 +114,19 @@ type AudioEngineNode = {
   options: Record<string, number | string | boolean>;
 };
 
-type AutomationPoint = { frame: number; value: number };
+type AutomationPoint = {
+  frame: number;
+  value: number;
+  durationFrames?: number;
+  curve?: 'linear' | 'exponential';
+};
 
 type AudioEngineMockState = {
   initialized: boolean;
   sampleRate: number;
   framesPerBuffer: number;
+  maxChannels: number;
+  maxFramesPerBuffer: number;
   nodes: Map<string, AudioEngineNode>;
   connections: Set<string>;
   diagnostics: {
@@ -131,6 +143,8 @@ type AudioEngineMockState = {
       frames: number;
       channelData: Float32Array[];
       byteLength: number;
+      filePath?: string;
+      dataOffsetBytes?: number;
     }
   >;
   transport: {
@@ -139,12 +153,26 @@ type AudioEngineMockState = {
     isPlaying: boolean;
     lastUpdatedMs: number;
   };
+  offlineRender: {
+    state: 'idle' | 'rendering' | 'finished' | 'cancelled' | 'failed';
+    filePath: string;
+    renderedFrames: number;
+    totalFrames: number;
+    error?: string;
+  };
+  graphUpdate: {
+    depth: number;
+    commits: number;
+  };
+  profilingEnabled: boolean;
 };
 
 const audioEngineState: AudioEngineMockState = {
   initialized: false,
   sampleRate: 0,
   framesPerBuffer: 0,
+  maxChannels: 0,
+  maxFramesPerBuffer: 0,
   nodes: new Map(),
   connections: new Set(),
   diagnostics: { xruns: 0, lastRenderDurationMicros: 0, clipBufferBytes: 0 },
@@ -156,6 +184,23 @@ const audioEngineState: AudioEngineMockState = {
     isPlaying: false,
     lastUpdatedMs: Date.now(),
   },
+  offlineRender: {
+    state: 'idle',
+    filePath: '',
+    renderedFrames: 0,
+    totalFrames: 0,
+  },
+  graphUpdate: { depth: 0, commits: 0 },
+  profilingEnabled: false,
+};
+
+const resetOfflineRender = () => {
+  audioEngineState.offlineRender = {
+    state: 'idle',
+    filePath: '',
+    renderedFrames: 0,
+    totalFrames: 0,
+  };
 };
 
 const recomputeClipBufferBytes = () => {
@@ -185,11 +230,82 @@ const computeTransportFrame = (now: number): number => {
   return audioEngineState.transport.startFrame + framesAdvanced;
 };
 
+const recordAutomationPoint = (nodeId: string, parameter: string, point: AutomationPoint) => {
+  const { frame, value } = point;
+  const trimmedId = nodeId.trim();
+  const trimmedParam = parameter.trim().toLowerCase();
+  if (!audioEngineState.nodes.has(trimmedId)) {
+    throw new Error(`Node '${trimmedId}' is not registered`);
+  }
+  if (!trimmedParam) {
+    throw new Error('Parameter name is required');
+  }
+  if (!Number.isFinite(frame) || frame < 0 || !Number.isInteger(frame)) {
+    throw new Error('Frame must be a non-negative integer');
+  }
+  if (!Number.isFinite(value)) {
+    throw new Error('Value must be finite');
+  }
+  let parameterMap = audioEngineState.automations.get(trimmedId);
+  if (!parameterMap) {
+    parameterMap = new Map<string, AutomationPoint[]>();
+    audioEngineState.automations.set(trimmedId, parameterMap);
+  }
+  const points: AutomationPoint[] = parameterMap.get(trimmedParam) ?? [];
+  const nextPoints: AutomationPoint[] = points.filter((existing) => existing.frame !== frame);
+  nextPoints.push(point);
+  nextPoints.sort((lhs, rhs) => lhs.frame - rhs.frame);
+  parameterMap.set(trimmedParam, nextPoints);
+};
+
+const applyGraphCommand = async (command: GraphCommand): Promise<void> => {
+  switch (command.op) {
+    case 'addNode':
+      return audioEngineModule.addNode(command.nodeId, command.nodeType, command.options);
+    case 'removeNode':
+      return audioEngineModule.removeNode(command.nodeId);
+    case 'connect':
+      return audioEngineModule.connectNodes(command.source, command.destination);
+    case 'disconnect':
+      return audioEngineModule.disconnectNodes(command.source, command.destination);
+    case 'setParameter':
+      return audioEngineModule.scheduleParameterAutomation(
+        command.nodeId,
+        command.parameter,
+        0,
+        command.value,
+      );
+    case 'scheduleAutomation':
+      return audioEngineModule.scheduleParameterAutomation(
+        command.nodeId,
+        command.parameter,
+        command.frame,
+        command.value,
+      );
+    case 'scheduleRamp':
+      return audioEngineModule.scheduleParameterRamp(
+        command.nodeId,
+        command.parameter,
+        command.frame,
+        command.value,
+        command.durationFrames,
+        command.curve,
+      );
+  }
+};
+
 const audioEngineModule = {
-  initialize: async (sampleRate: number, framesPerBuffer: number) => {
+  initialize: async (
+    sampleRate: number,
+    framesPerBuffer: number,
+    maxChannels: number,
+    maxFramesPerBuffer: number,
+  ) => {
     audioEngineState.initialized = true;
     audioEngineState.sampleRate = sampleRate;
     audioEngineState.framesPerBuffer = framesPerBuffer;
+    audioEngineState.maxChannels = maxChannels;
+    audioEngineState.maxFramesPerBuffer = maxFramesPerBuffer;
     audioEngineState.diagnostics.xruns = 0;
     audioEngineState.diagnostics.lastRenderDurationMicros = 0;
     audioEngineState.diagnostics.clipBufferBytes = 0;
@@ -197,6 +313,9 @@ const audioEngineModule = {
     audioEngineState.transport.startFrame = 0;
     audioEngineState.transport.isPlaying = false;
     audioEngineState.transport.lastUpdatedMs = Date.now();
+    audioEngineState.graphUpdate = { depth: 0, commits: 0 };
+    audioEngineState.profilingEnabled = false;
+    resetOfflineRender();
   },
   shutdown: async () => {
     audioEngineState.initialized = false;
@@ -211,6 +330,9 @@ const audioEngineModule = {
     audioEngineState.transport.startFrame = 0;
     audioEngineState.transport.isPlaying = false;
     audioEngineState.transport.lastUpdatedMs = Date.now();
+    audioEngineState.graphUpdate = { depth: 0, commits: 0 };
+    audioEngineState.profilingEnabled = false;
+    resetOfflineRender();
   },
   addNode: async (
     nodeId: string,
@@ -236,6 +358,7 @@ const audioEngineModule = {
     channels: number,
     frames: number,
     channelData: Array<ArrayBuffer | ArrayBufferView>,
+    storageFormat: 'float32' | 'int16' | 'float16' = 'float32',
   ) => {
     const key = bufferKey.trim();
     if (!key) {
@@ -271,7 +394,11 @@ const audioEngineModule = {
       }
       return new Float32Array(view.slice(0, frames));
     });
-    const byteLength = frames * channels * Float32Array.BYTES_PER_ELEMENT;
+    if (!['float32', 'int16', 'float16'].includes(storageFormat)) {
+      throw new Error('storageFormat must be float32, int16 or float16');
+    }
+    const bytesPerSample = storageFormat === 'float32' ? Float32Array.BYTES_PER_ELEMENT : 2;
+    const byteLength = frames * channels * bytesPerSample;
     audioEngineState.clipBuffers.set(key, {
       sampleRate,
       channels,
@@ -281,6 +408,73 @@ const audioEngineModule = {
     });
     recomputeClipBufferBytes();
   },
+  registerClipBufferFile: async (
+    bufferKey: string,
+    filePath: string,
+    sampleRate: number,
+    channels: number,
+    frames: number,
+    dataOffsetBytes: number,
+  ) => {
+    const key = bufferKey.trim();
+    if (!key || !filePath) {
+      throw new Error('bufferKey and filePath are required');
+    }
+    if (!Number.isFinite(sampleRate) || sampleRate <= 0) {
+      throw new Error('sampleRate must be a positive number');
+    }
+    if (!Number.isInteger(channels) || channels <= 0) {
+      throw new Error('channels must be a positive integer');
+    }
+    if (!Number.isInteger(frames) || frames <= 0) {
+      throw new Error('frames must be a positive integer');
+    }
+    if (!Number.isInteger(dataOffsetBytes) || dataOffsetBytes < 0) {
+      throw new Error('dataOffsetBytes must be a non-negative integer');
+    }
+    audioEngineState.clipBuffers.set(key, {
+      sampleRate,
+      channels,
+      frames,
+      channelData: [],
+      byteLength: frames * channels * Float32Array.BYTES_PER_ELEMENT,
+      filePath,
+      dataOffsetBytes,
+    });
+    recomputeClipBufferBytes();
+  },
+  registerClipStream: async (
+    bufferKey: string,
+    filePath: string,
+    sampleRate: number,
+    channels: number,
+    dataOffsetBytes: number,
+  ) => {
+    const key = bufferKey.trim();
+    if (!key || !filePath) {
+      throw new Error('bufferKey and filePath are required');
+    }
+    if (!Number.isFinite(sampleRate) || sampleRate <= 0) {
+      throw new Error('sampleRate must be a positive number');
+    }
+    if (!Number.isInteger(channels) || channels <= 0) {
+      throw new Error('channels must be a positive integer');
+    }
+    if (!Number.isInteger(dataOffsetBytes) || dataOffsetBytes < 0) {
+      throw new Error('dataOffsetBytes must be a non-negative integer');
+    }
+    // Streamed clips are mapped rather than resident, so they add nothing to clipBufferBytes.
+    audioEngineState.clipBuffers.set(key, {
+      sampleRate,
+      channels,
+      frames: 0,
+      channelData: [],
+      byteLength: 0,
+      filePath,
+      dataOffsetBytes,
+    });
+    recomputeClipBufferBytes();
+  },
   unregisterClipBuffer: async (bufferKey: string) => {
     const key = bufferKey.trim();
     if (!key) {
@@ -326,6 +520,35 @@ const audioEngineModule = {
   disconnectNodes: async (source: string, destination: string) => {
     audioEngineState.connections.delete(connectionKey(source.trim(), destination.trim()));
   },
+  applyGraphCommands: async (encoded: string) => {
+    // Decoding everything first mirrors the native side: a malformed buffer applies nothing.
+    const commands = decodeGraphCommands(new Uint8Array(Buffer.from(encoded, 'base64')));
+    await audioEngineModule.beginGraphUpdate();
+    try {
+      for (const [index, command] of commands.entries()) {
+        try {
+          await applyGraphCommand(command);
+        } catch (error) {
+          const message = error instanceof Error ? error.message : String(error);
+          throw new Error(`graph command ${index}: ${message}`);
+        }
+      }
+    } finally {
+      await audioEngineModule.commitGraphUpdate();
+    }
+  },
+  beginGraphUpdate: async () => {
+    audioEngineState.graphUpdate.depth += 1;
+  },
+  commitGraphUpdate: async () => {
+    if (audioEngineState.graphUpdate.depth === 0) {
+      return;
+    }
+    audioEngineState.graphUpdate.depth -= 1;
+    if (audioEngineState.graphUpdate.depth === 0) {
+      audioEngineState.graphUpdate.commits += 1;
+    }
+  },
   startTransport: async () => {
     const now = Date.now();
     audioEngineState.transport.frame = computeTransportFrame(now);
@@ -362,36 +585,111 @@ const audioEngineModule = {
     frame: number,
     value: number,
   ) => {
-    const trimmedId = nodeId.trim();
-    const trimmedParam = parameter.trim().toLowerCase();
-    if (!audioEngineState.nodes.has(trimmedId)) {
-      throw new Error(`Node '${trimmedId}' is not registered`);
+    recordAutomationPoint(nodeId, parameter, { frame, value });
+  },
+  scheduleParameterRamp: async (
+    nodeId: string,
+    parameter: string,
+    frame: number,
+    value: number,
+    durationFrames: number,
+    curve: 'linear' | 'exponential',
+  ) => {
+    if (
+      !Number.isFinite(durationFrames) ||
+      durationFrames < 0 ||
+      !Number.isInteger(durationFrames)
+    ) {
+      throw new Error('Duration must be a non-negative integer');
+    }
+    if (curve !== 'linear' && curve !== 'exponential') {
+      throw new Error(`Unsupported ramp curve '${String(curve)}'`);
+    }
+    recordAutomationPoint(nodeId, parameter, { frame, value, durationFrames, curve });
+  },
+  startOfflineRender: async (
+    filePath: string,
+    frameCount: number,
+    channels: number,
+    workerCount: number,
+    sampleFormat: string,
+  ) => {
+    if (!audioEngineState.initialized) {
+      throw new Error('Audio engine is not initialized');
+    }
+    if (!filePath) {
+      throw new Error('filePath is required');
+    }
+    if (!Number.isInteger(frameCount) || frameCount <= 0) {
+      throw new Error('frameCount must be a positive integer');
     }
-    if (!trimmedParam) {
-      throw new Error('Parameter name is required');
+    if (!Number.isInteger(channels) || channels <= 0 || channels > 4) {
+      throw new Error('channels must be an integer between 1 and 4');
     }
-    if (!Number.isFinite(frame) || frame < 0 || !Number.isInteger(frame)) {
-      throw new Error('Frame must be a non-negative integer');
+    if (!Number.isInteger(workerCount) || workerCount < 0) {
+      throw new Error('workerCount must be a non-negative integer');
     }
-    if (!Number.isFinite(value)) {
-      throw new Error('Value must be finite');
+    if (sampleFormat !== 'float32' && sampleFormat !== 'int16') {
+      throw new Error('sampleFormat must be float32 or int16');
     }
-    let parameterMap = audioEngineState.automations.get(trimmedId);
-    if (!parameterMap) {
-      parameterMap = new Map<string, AutomationPoint[]>();
-      audioEngineState.automations.set(trimmedId, parameterMap);
+    if (audioEngineState.offlineRender.state === 'rendering') {
+      throw new Error('An offline render is already running');
+    }
+    audioEngineState.offlineRender = {
+      state: 'rendering',
+      filePath,
+      renderedFrames: 0,
+      totalFrames: frameCount,
+    };
+  },
+  cancelOfflineRender: async () => {
+    if (audioEngineState.offlineRender.state === 'rendering') {
+      audioEngineState.offlineRender.state = 'cancelled';
     }
-    const points: AutomationPoint[] = parameterMap.get(trimmedParam) ?? [];
-    const nextPoints: AutomationPoint[] = points.filter((point) => point.frame !== frame);
-    nextPoints.push({ frame, value });
-    nextPoints.sort((lhs, rhs) => lhs.frame - rhs.frame);
-    parameterMap.set(trimmedParam, nextPoints);
+  },
+  getOfflineRenderStatus: async () => {
+    const render = audioEngineState.offlineRender;
+    // Each poll advances the bounce by one second of audio.
+    if (render.state === 'rendering') {
+      render.renderedFrames = Math.min(
+        render.totalFrames,
+        render.renderedFrames + Math.max(1, audioEngineState.sampleRate),
+      );
+      if (render.renderedFrames === render.totalFrames) {
+        render.state = 'finished';
+      }
+    }
+    return {
+      state: render.state,
+      renderedFrames: render.renderedFrames,
+      writtenFrames: render.renderedFrames,
+      totalFrames: render.totalFrames,
+      ...(render.error ? { error: render.error } : {}),
+    };
   },
   getRenderDiagnostics: async () => ({
     xruns: audioEngineState.diagnostics.xruns,
     lastRenderDurationMicros: audioEngineState.diagnostics.lastRenderDurationMicros,
     clipBufferBytes: audioEngineState.diagnostics.clipBufferBytes,
   }),
+  setProfilingEnabled: async (enabled: boolean) => {
+    audioEngineState.profilingEnabled = enabled;
+  },
+  // The mock never renders, so an enabled profile is always empty.
+  getRenderProfile: async () => {
+    const empty = () => ({ count: 0, mean: 0, p50: 0, p95: 0, p99: 0, max: 0 });
+    return {
+      enabled: audioEngineState.profilingEnabled,
+      blocks: 0,
+      overloads: 0,
+      renderErrors: 0,
+      droppedRecords: 0,
+      renderMicros: empty(),
+      dspLoad: empty(),
+      callbackJitterMicros: empty(),
+      nodes: [],
+    };
+  },
   __state: audioEngineState,
 };
 
@@ -0,0 +1,129 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string_view>
+
+#include "audio_engine/DSPKernels.h"
+#include "audio_engine/RealtimeSafety.h"
+
+namespace daft::audio::bench {
+namespace {
+
+double Percentile(const std::vector<double>& sorted, double fraction) {
+  const auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+std::string Number(double value) {
+  char text[32];
+  std::snprintf(text, sizeof(text), "%.6g", value);
+  return text;
+}
+
+[[noreturn]] void Usage(const char* error) {
+  std::cerr << error << "\n"
+            << "usage: daft_audio_engine_bench [--filter <substring>] [--min-time-ms <ms>] [--output <file>]\n";
+  std::exit(2);
+}
+
+}  // namespace
+
+void Runner::record(const std::string& name, std::size_t frames, std::uint64_t iterations,
+                    std::vector<double> samples) {
+  std::sort(samples.begin(), samples.end());
+  Result result;
+  result.name = name;
+  result.frames = frames;
+  result.iterations = iterations;
+  result.medianNanos = Percentile(samples, 0.5);
+  result.meanNanos = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+  result.minNanos = samples.front();
+  result.p95Nanos = Percentile(samples, 0.95);
+  // Progress goes to stderr so stdout stays valid JSON.
+  std::cerr << name << ": " << Number(result.medianNanos) << " ns" << std::endl;
+  results_.push_back(std::move(result));
+}
+
+std::string Runner::json() const {
+  std::ostringstream out;
+  out << "{\n"
+      << "  \"engine\": \"daft_audio_engine\",\n"
+      << "  \"instructionSet\": \"" << dsp::instructionSet() << "\",\n"
+#if defined(NDEBUG)
+      << "  \"assertions\": false,\n"
+#else
+      << "  \"assertions\": true,\n"
+#endif
+      << "  \"realtimeChecks\": " << (RealtimeAllocationChecksInstalled() ? "true" : "false") << ",\n"
+      << "  \"sampleRate\": " << Number(kSampleRate) << ",\n"
+      << "  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results_.size(); ++i) {
+    const auto& result = results_[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name << "\", \"frames\": " << result.frames
+        << ", \"iterations\": " << result.iterations << ", \"nsPerIteration\": {\"median\": "
+        << Number(result.medianNanos) << ", \"mean\": " << Number(result.meanNanos)
+        << ", \"min\": " << Number(result.minNanos) << ", \"p95\": " << Number(result.p95Nanos) << "}";
+    if (result.frames > 0) {
+      // DSP load: time to render the block over the time the block lasts when played.
+      const double blockNanos = static_cast<double>(result.frames) * 1e9 / kSampleRate;
+      out << ", \"nsPerFrame\": " << Number(result.medianNanos / static_cast<double>(result.frames))
+          << ", \"dspLoad\": " << Number(result.medianNanos / blockNanos);
+    }
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+  return out.str();
+}
+
+}  // namespace daft::audio::bench
+
+int main(int argc, char** argv) {
+  using namespace daft::audio::bench;
+  Options options;
+  std::string outputPath;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (i + 1 >= argc) {
+      Usage("missing value or unknown argument");
+    }
+    const char* value = argv[++i];
+    if (arg == "--filter") {
+      options.filter = value;
+    } else if (arg == "--min-time-ms") {
+      options.minTime = std::chrono::milliseconds(std::strtol(value, nullptr, 10));
+    } else if (arg == "--output") {
+      outputPath = value;
+    } else {
+      Usage("unknown argument");
+    }
+  }
+
+  Runner runner(options);
+  try {
+    RunNodeBenchmarks(runner);
+    RunGraphBenchmarks(runner);
+  } catch (const std::exception& ex) {
+    std::cerr << "Benchmark failure: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  const auto json = runner.json();
+  if (outputPath.empty()) {
+    std::cout << json;
+  } else {
+    std::ofstream file(outputPath);
+    file << json;
+    if (!file) {
+      std::cerr << "Could not write " << outputPath << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
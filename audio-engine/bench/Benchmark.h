@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace daft::audio::bench {
+
+constexpr double kSampleRate = 48000.0;
+
+struct Options {
+  /** Substring a benchmark name must contain to run; empty runs everything. */
+  std::string filter;
+  /** Time spent sampling each benchmark after warm-up. */
+  std::chrono::milliseconds minTime{200};
+};
+
+struct Result {
+  std::string name;
+  /** Audio frames one iteration renders; 0 for benchmarks that do not produce audio. */
+  std::size_t frames = 0;
+  std::uint64_t iterations = 0;
+  double medianNanos = 0.0;
+  double meanNanos = 0.0;
+  double minNanos = 0.0;
+  double p95Nanos = 0.0;
+};
+
+// Keeps the compiler from dropping or hoisting work whose only effect is on memory.
+inline void ClobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+  __asm__ __volatile__("" : : : "memory");
+#endif
+}
+
+/**
+ * Times benchmark bodies and collects their results.
+ *
+ * Each body runs once to warm up, then in batches sized to take at least 20 µs so clock reads stay
+ * out of the measurement. Batches repeat until `Options::minTime` has passed, and every batch yields
+ * one per-iteration sample, which is what the median, mean, minimum and p95 are taken over.
+ */
+class Runner {
+ public:
+  explicit Runner(Options options) : options_(std::move(options)) {}
+
+  template <typename Body>
+  void run(const std::string& name, std::size_t frames, Body&& body) {
+    if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) {
+      return;
+    }
+    using Clock = std::chrono::steady_clock;
+    const auto timeBatch = [&body](std::uint64_t iterations) {
+      const auto start = Clock::now();
+      for (std::uint64_t i = 0; i < iterations; ++i) {
+        body();
+        ClobberMemory();
+      }
+      return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    };
+
+    timeBatch(1);
+    std::uint64_t batch = 1;
+    while (batch < kMaxBatch && timeBatch(batch) < kMinBatchNanos) {
+      batch *= 2;
+    }
+    std::vector<double> samples;
+    std::uint64_t iterations = 0;
+    const auto deadline = Clock::now() + options_.minTime;
+    while ((Clock::now() < deadline || samples.size() < kMinSamples) && samples.size() < kMaxSamples) {
+      samples.push_back(timeBatch(batch) / static_cast<double>(batch));
+      iterations += batch;
+    }
+    record(name, frames, iterations, std::move(samples));
+  }
+
+  [[nodiscard]] const std::vector<Result>& results() const { return results_; }
+
+  /** Results as JSON: run metadata plus one object per benchmark, with ns/frame and DSP load for audio. */
+  [[nodiscard]] std::string json() const;
+
+ private:
+  static constexpr double kMinBatchNanos = 20000.0;
+  static constexpr std::uint64_t kMaxBatch = std::uint64_t{1} << 20U;
+  static constexpr std::size_t kMinSamples = 5;
+  static constexpr std::size_t kMaxSamples = 100000;
+
+  void record(const std::string& name, std::size_t frames, std::uint64_t iterations, std::vector<double> samples);
+
+  Options options_;
+  std::vector<Result> results_;
+};
+
+void RunNodeBenchmarks(Runner& runner);
+void RunGraphBenchmarks(Runner& runner);
+
+}  // namespace daft::audio::bench
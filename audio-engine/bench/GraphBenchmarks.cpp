@@ -0,0 +1,198 @@
+#include "Benchmark.h"
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "audio_engine/Clock.h"
+#include "audio_engine/DSPNode.h"
+#include "audio_engine/PluginNode.h"
+#include "audio_engine/SceneGraph.h"
+#include "audio_engine/Scheduler.h"
+#include "audio_engine/VoicePoolNode.h"
+
+namespace daft::audio::bench {
+namespace {
+
+constexpr std::size_t kChannels = 2;
+constexpr std::size_t kTracks = 16;
+constexpr std::size_t kClipFrames = 48000 * 20;
+
+const std::string kOutput(SceneGraph::kOutputBusId);
+
+PluginRenderResult GainCallback(PluginRenderRequest& request, void*) {
+  for (std::size_t ch = 0; ch < request.audioBuffer.channelCount(); ++ch) {
+    for (auto& sample : request.audioBuffer.channel(ch)) {
+      sample *= 0.5F;
+    }
+  }
+  return PluginRenderResult{true, false};
+}
+
+ClipPlayerNode::ClipBufferData SharedClip() {
+  auto storage = std::make_shared<std::vector<float>>(kClipFrames);
+  for (std::size_t frame = 0; frame < kClipFrames; ++frame) {
+    (*storage)[frame] = 0.5F * std::sin(0.01F * static_cast<float>(frame));
+  }
+  ClipPlayerNode::ClipBufferData data;
+  data.key = "bench";
+  data.sampleRate = kSampleRate;
+  data.frameCount = kClipFrames;
+  data.owner = storage;
+  data.channels.assign(kChannels, storage->data());
+  return data;
+}
+
+// `nodes` nodes as oscillator -> gain pairs feeding the output bus.
+void BuildPairs(SceneGraph& graph, std::size_t nodes) {
+  graph.beginUpdate();
+  for (std::size_t pair = 0; pair < nodes / 2; ++pair) {
+    const auto source = "osc" + std::to_string(pair);
+    const auto gain = "gain" + std::to_string(pair);
+    graph.addNode(source, std::make_unique<SineOscillatorNode>());
+    graph.addNode(gain, std::make_unique<GainNode>());
+    graph.connect(source, gain);
+    graph.connect(gain, kOutput);
+  }
+  graph.commit();
+}
+
+void BenchmarkTopology(Runner& runner) {
+  for (const std::size_t nodes : {10, 100, 1000}) {
+    SceneGraph graph(kSampleRate, 256);
+    BuildPairs(graph, nodes);
+    // resetTimeline recompiles the whole plan; a connect/disconnect pair takes the incremental path.
+    runner.run("graph/rebuildTopology/" + std::to_string(nodes), 0, [&]() { graph.resetTimeline(); });
+    runner.run("graph/connectDisconnect/" + std::to_string(nodes), 0, [&]() {
+      graph.connect("osc0", kOutput);
+      graph.disconnect("osc0", kOutput);
+    });
+  }
+}
+
+void BenchmarkScheduler(Runner& runner) {
+  constexpr std::size_t kEvents = 128;
+  constexpr std::uint32_t kBlock = 256;
+  RenderClock clock(kSampleRate, kBlock);
+  RealTimeScheduler<kEvents> scheduler(clock);
+  double sink = 0.0;
+  // Fill the queue with one block's worth of events in reverse frame order, then dispatch them all.
+  runner.run("scheduler/dispatch-128", kBlock, [&]() {
+    const auto now = clock.frameTime();
+    for (std::size_t i = 0; i < kEvents; ++i) {
+      ScheduledEvent event;
+      event.frame = now + (kEvents - i) * (kBlock / kEvents);
+      event.value = static_cast<double>(i);
+      scheduler.schedule(event);
+    }
+    scheduler.drainInbox();
+    clock.advance();
+    scheduler.dispatchDueEvents([&sink](const ScheduledEvent& event) { sink += event.value; });
+  });
+}
+
+// Tracks of clip player -> plugin insert -> fader summed on a mixer bus, like a small session.
+void BuildSession(SceneGraph& graph) {
+  const auto clip = SharedClip();
+  PluginBusCapabilities capabilities{};
+  capabilities.acceptsAudio = true;
+  capabilities.emitsAudio = true;
+  graph.beginUpdate();
+  graph.addNode("bus", std::make_unique<MixerNode>(kTracks));
+  graph.connect("bus", kOutput);
+  for (std::size_t track = 0; track < kTracks; ++track) {
+    const auto suffix = std::to_string(track);
+    auto player = std::make_unique<ClipPlayerNode>();
+    player->setClipBuffer(clip);
+    player->setParameter(ClipPlayerNode::kEndFrame, static_cast<double>(kClipFrames));
+    graph.addNode("clip" + suffix, std::move(player));
+    graph.addNode("insert" + suffix, std::make_unique<PluginNode>("plugin" + suffix, capabilities));
+    graph.addNode("fader" + suffix, std::make_unique<GainNode>());
+    graph.connect("clip" + suffix, "insert" + suffix);
+    graph.connect("insert" + suffix, "fader" + suffix);
+    graph.connect("fader" + suffix, "bus");
+  }
+  graph.commit();
+}
+
+void BenchmarkRender(Runner& runner) {
+  PluginHostBridge::SetRenderCallback(&GainCallback);
+  for (const std::size_t workers : {0, 2}) {
+    for (const std::size_t frames : {64, 128, 256, 1024}) {
+      SceneGraph graph(kSampleRate, static_cast<std::uint32_t>(frames));
+      BuildSession(graph);
+      graph.setRenderWorkerCount(workers);
+      std::array<std::vector<float>, kChannels> output;
+      std::array<float*, kChannels> channels{};
+      for (std::size_t ch = 0; ch < kChannels; ++ch) {
+        output[ch].resize(frames);
+        channels[ch] = output[ch].data();
+      }
+      const auto lastBlock = kClipFrames / frames;
+      std::size_t blocks = 0;
+      const auto name = std::string(workers == 0 ? "graph/render/" : "graph/render-workers2/") + std::to_string(frames);
+      runner.run(name, frames, [&]() {
+        // Rewind before the clips run out, or the rest of the run would measure silence.
+        if (++blocks >= lastBlock) {
+          graph.resetTimeline();
+          blocks = 0;
+        }
+        graph.render(AudioBufferView(channels.data(), kChannels, frames));
+      });
+    }
+  }
+  PluginHostBridge::ClearRenderCallback();
+}
+
+// A 32-note chord as one voice pool against one oscillator -> gain pair per note, the way callers
+// played notes before the pool.
+void BenchmarkPolyphony(Runner& runner) {
+  constexpr std::size_t kNotes = 32;
+  constexpr std::size_t kFrames = 256;
+  std::array<std::vector<float>, kChannels> output;
+  std::array<float*, kChannels> channels{};
+  for (std::size_t ch = 0; ch < kChannels; ++ch) {
+    output[ch].resize(kFrames);
+    channels[ch] = output[ch].data();
+  }
+
+  SceneGraph pooled(kSampleRate, kFrames);
+  auto pool = std::make_unique<VoicePoolNode>(kNotes);
+  pool->setParameter(VoicePoolNode::kWaveform, 1.0);
+  pooled.addNode("synth", std::move(pool));
+  pooled.connect("synth", kOutput);
+  for (std::size_t note = 0; note < kNotes; ++note) {
+    pooled.scheduleAutomation("synth", VoicePoolNode::kNoteOn, 0, static_cast<double>((48 + note) * 128 + 100));
+  }
+  runner.run("graph/polyphony/voicePool-32", kFrames,
+             [&]() { pooled.render(AudioBufferView(channels.data(), kChannels, kFrames)); });
+
+  SceneGraph separate(kSampleRate, kFrames);
+  separate.beginUpdate();
+  for (std::size_t note = 0; note < kNotes; ++note) {
+    const auto suffix = std::to_string(note);
+    auto oscillator = std::make_unique<SineOscillatorNode>();
+    oscillator->setParameter(SineOscillatorNode::kWaveform, 1.0);
+    oscillator->setParameter(SineOscillatorNode::kFrequency, 440.0 * std::exp2((48.0 + note - 69.0) / 12.0));
+    separate.addNode("osc" + suffix, std::move(oscillator));
+    separate.addNode("gain" + suffix, std::make_unique<GainNode>());
+    separate.connect("osc" + suffix, "gain" + suffix);
+    separate.connect("gain" + suffix, kOutput);
+  }
+  separate.commit();
+  runner.run("graph/polyphony/oscillators-32", kFrames,
+             [&]() { separate.render(AudioBufferView(channels.data(), kChannels, kFrames)); });
+}
+
+}  // namespace
+
+void RunGraphBenchmarks(Runner& runner) {
+  BenchmarkTopology(runner);
+  BenchmarkScheduler(runner);
+  BenchmarkRender(runner);
+  BenchmarkPolyphony(runner);
+}
+
+}  // namespace daft::audio::bench
@@ -0,0 +1,194 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "audio_engine/AudioBuffer.h"
+#include "audio_engine/DSPNode.h"
+#include "audio_engine/PluginNode.h"
+#include "audio_engine/VoicePoolNode.h"
+
+namespace daft::audio::bench {
+namespace {
+
+constexpr std::size_t kChannels = 2;
+constexpr std::size_t kFrames = 256;
+
+// A stereo block of `kFrames` frames filled with a quiet sine, so effects never run into denormals.
+class Block {
+ public:
+  Block() {
+    for (std::size_t ch = 0; ch < kChannels; ++ch) {
+      samples_[ch].resize(kFrames);
+      for (std::size_t frame = 0; frame < kFrames; ++frame) {
+        samples_[ch][frame] = 0.25F * std::sin(0.05F * static_cast<float>(frame + ch));
+      }
+      pointers_[ch] = samples_[ch].data();
+    }
+  }
+
+  AudioBufferView view() { return AudioBufferView(pointers_.data(), kChannels, kFrames); }
+
+  void copyFrom(const Block& other) {
+    for (std::size_t ch = 0; ch < kChannels; ++ch) {
+      std::copy(other.samples_[ch].begin(), other.samples_[ch].end(), samples_[ch].begin());
+    }
+  }
+
+ private:
+  std::array<std::vector<float>, kChannels> samples_;
+  std::array<float*, kChannels> pointers_{};
+};
+
+ClipPlayerNode::ClipBufferData MakeClip(SampleFormat format, double sampleRate, std::size_t frames) {
+  const std::size_t bytes = format == SampleFormat::kFloat32 ? sizeof(float) : sizeof(std::int16_t);
+  auto storage = std::make_shared<std::vector<std::vector<unsigned char>>>(
+      kChannels, std::vector<unsigned char>(frames * bytes));
+  for (auto& channel : *storage) {
+    for (std::size_t frame = 0; frame < frames; ++frame) {
+      const float value = 0.5F * std::sin(0.01F * static_cast<float>(frame));
+      if (format == SampleFormat::kFloat32) {
+        std::copy_n(reinterpret_cast<const unsigned char*>(&value), sizeof(float), &channel[frame * bytes]);
+      } else {
+        const auto encoded = static_cast<std::int16_t>(value * 32767.0F);
+        std::copy_n(reinterpret_cast<const unsigned char*>(&encoded), sizeof(encoded), &channel[frame * bytes]);
+      }
+    }
+  }
+  ClipPlayerNode::ClipBufferData data;
+  data.key = "bench";
+  data.sampleRate = sampleRate;
+  data.frameCount = frames;
+  data.format = format;
+  data.owner = storage;
+  for (const auto& channel : *storage) {
+    data.channels.push_back(channel.data());
+  }
+  return data;
+}
+
+PluginRenderResult GainCallback(PluginRenderRequest& request, void*) {
+  for (std::size_t ch = 0; ch < request.audioBuffer.channelCount(); ++ch) {
+    for (auto& sample : request.audioBuffer.channel(ch)) {
+      sample *= 0.5F;
+    }
+  }
+  return PluginRenderResult{true, false};
+}
+
+// Effects rewrite their block in place, so each iteration starts from a fresh copy of the input.
+void RunEffect(Runner& runner, const std::string& name, DSPNode& node) {
+  node.prepare(kSampleRate);
+  const Block input;
+  Block block;
+  runner.run(name, kFrames, [&]() {
+    block.copyFrom(input);
+    node.process(block.view());
+  });
+}
+
+void RunClipPlayer(Runner& runner, const std::string& name, ClipPlayerNode::ClipBufferData clip) {
+  ClipPlayerNode node;
+  node.prepare(kSampleRate);
+  // Long enough that a benchmark rarely reaches the end; it rewinds when it does.
+  const double timelineFrames = static_cast<double>(clip.frameCount) * kSampleRate / clip.sampleRate;
+  node.setParameter(ClipPlayerNode::kEndFrame, timelineFrames);
+  const auto lastBlock = static_cast<std::size_t>(timelineFrames) / kFrames;
+  node.setClipBuffer(std::move(clip));
+  Block block;
+  std::size_t blocks = 0;
+  runner.run(name, kFrames, [&]() {
+    if (++blocks >= lastBlock) {
+      node.reset();
+      blocks = 0;
+    }
+    node.process(block.view());
+  });
+}
+
+void BenchmarkNodes(Runner& runner) {
+  GainNode gain;
+  gain.setParameter(GainNode::kGain, 0.5);
+  RunEffect(runner, "node/gain/process", gain);
+
+  constexpr std::array<const char*, 4> kWaveforms = {"sine", "saw", "square", "triangle"};
+  for (std::size_t waveform = 0; waveform < kWaveforms.size(); ++waveform) {
+    SineOscillatorNode oscillator;
+    oscillator.prepare(kSampleRate);
+    oscillator.setParameter(SineOscillatorNode::kWaveform, static_cast<double>(waveform));
+    Block oscillatorBlock;
+    runner.run(std::string("node/") + kWaveforms[waveform] + "/process", kFrames,
+               [&]() { oscillator.process(oscillatorBlock.view()); });
+  }
+
+  constexpr std::size_t kMixerInputs = 8;
+  MixerNode mixer(kMixerInputs);
+  mixer.prepare(kSampleRate);
+  std::vector<Block> inputs(kMixerInputs);
+  std::vector<AudioBufferView> inputViews;
+  for (auto& input : inputs) {
+    inputViews.push_back(input.view());
+  }
+  Block mixed;
+  runner.run("node/mixer/processInputs-8", kFrames, [&]() { mixer.processInputs(inputViews, mixed.view()); });
+
+  constexpr std::size_t kClipFrames = 48000 * 20;
+  RunClipPlayer(runner, "node/clipPlayer/process-float32", MakeClip(SampleFormat::kFloat32, kSampleRate, kClipFrames));
+  RunClipPlayer(runner, "node/clipPlayer/process-int16", MakeClip(SampleFormat::kInt16, kSampleRate, kClipFrames));
+  RunClipPlayer(runner, "node/clipPlayer/process-resampled", MakeClip(SampleFormat::kFloat32, 44100.0, kClipFrames));
+
+  // Held notes never release, so every iteration renders the full pool.
+  constexpr std::size_t kVoices = 32;
+  VoicePoolNode synth(kVoices);
+  synth.prepare(kSampleRate);
+  synth.setParameter(VoicePoolNode::kWaveform, 1.0);
+  for (std::size_t note = 0; note < kVoices; ++note) {
+    synth.setParameter(VoicePoolNode::kNoteOn, static_cast<double>((48 + note) * 128 + 100));
+  }
+  Block synthBlock;
+  runner.run("node/voicePool/process-saw32", kFrames, [&]() { synth.process(synthBlock.view()); });
+
+  constexpr std::size_t kPads = 16;
+  VoicePoolNode sampler(kPads);
+  sampler.prepare(kSampleRate);
+  sampler.setClipBuffer(MakeClip(SampleFormat::kInt16, kSampleRate, kClipFrames));
+  Block samplerBlock;
+  std::size_t samplerBlocks = 0;
+  runner.run("node/voicePool/process-clip16", kFrames, [&]() {
+    // Retrigger before the clips run out, as a pad player would.
+    if (samplerBlocks++ % 1000 == 0) {
+      for (std::size_t pad = 0; pad < kPads; ++pad) {
+        sampler.setParameter(VoicePoolNode::kNoteOn, static_cast<double>((54 + pad) * 128 + 100));
+      }
+    }
+    sampler.process(samplerBlock.view());
+  });
+
+  PluginHostBridge::SetRenderCallback(&GainCallback);
+  PluginBusCapabilities capabilities{};
+  capabilities.acceptsAudio = true;
+  capabilities.emitsAudio = true;
+  PluginNode plugin("bench-plugin", capabilities);
+  RunEffect(runner, "node/plugin/process", plugin);
+  PluginHostBridge::ClearRenderCallback();
+}
+
+void BenchmarkBuffers(Runner& runner) {
+  Block source;
+  Block dest;
+  runner.run("buffer/addBufferInPlace", kFrames, [&]() { dest.view().addBufferInPlace(source.view()); });
+  runner.run("buffer/fill", kFrames, [&]() { dest.view().fill(0.0F); });
+}
+
+}  // namespace
+
+void RunNodeBenchmarks(Runner& runner) {
+  BenchmarkNodes(runner);
+  BenchmarkBuffers(runner);
+}
+
+}  // namespace daft::audio::bench
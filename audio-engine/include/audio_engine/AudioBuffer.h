@@ -1,11 +1,12 @@
 #pragma once
 
-#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstddef>
 #include <span>
 
+#include "audio_engine/DSPKernels.h"
+
 namespace daft::audio {
 
 template <std::size_t MaxChannels, std::size_t MaxFrames>
@@ -31,14 +32,13 @@ class StackAudioBuffer {
 
   void clear() {
     for (auto& channelData : data_) {
-      for (std::size_t i = 0; i < frameCount_; ++i) {
-        channelData[i] = 0.0F;
-      }
+      dsp::fill(channelData.data(), 0.0F, frameCount_);
     }
   }
 
  private:
-  std::array<std::array<float, MaxFrames>, MaxChannels> data_{};
+  // Cache-line aligned so every channel of a full-size buffer starts on its own line for the kernels.
+  alignas(dsp::kBufferAlignment) std::array<std::array<float, MaxFrames>, MaxChannels> data_{};
   std::size_t frameCount_;
 };
 
@@ -61,9 +61,19 @@ class AudioBufferView {
     return {channels_[index], frameCount_};
   }
 
+  /** The channel pointer array, for kernels that take a whole planar block. */
+  [[nodiscard]] float* const* channels() const { return channels_; }
+
+  /**
+   * Set by the graph on input views whose producer skipped rendering; the samples of a silent view are
+   * stale and must not be read.
+   */
+  [[nodiscard]] bool isSilent() const { return silent_; }
+  void setSilent(bool silent) { silent_ = silent; }
+
   void fill(float value) {
     for (std::size_t ch = 0; ch < channelCount_; ++ch) {
-      std::fill_n(channels_[ch], frameCount_, value);
+      dsp::fill(channels_[ch], value, frameCount_);
     }
   }
 
@@ -71,11 +81,7 @@ class AudioBufferView {
     assert(other.channelCount() == channelCount_);
     assert(other.frameCount() == frameCount_);
     for (std::size_t ch = 0; ch < channelCount_; ++ch) {
-      auto* dest = channels_[ch];
-      const auto* src = other.channels_[ch];
-      for (std::size_t i = 0; i < frameCount_; ++i) {
-        dest[i] += src[i];
-      }
+      dsp::add(channels_[ch], other.channels_[ch], frameCount_);
     }
   }
 
@@ -83,6 +89,7 @@ class AudioBufferView {
   float** channels_;
   std::size_t channelCount_;
   std::size_t frameCount_;
+  bool silent_ = false;
 };
 
 }  // namespace daft::audio
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "audio_engine/ClipStream.h"
+#include "audio_engine/SampleFormat.h"
+
+namespace daft::audio {
+
+/** Decoded or adopted sample data registered under a key and shared by every ClipPlayerNode playing it. */
+struct ClipBuffer {
+  double sampleRate = 0.0;
+  std::size_t frameCount = 0;
+  std::vector<std::vector<float>> channelSamples;
+  // Set instead of channelSamples for memory adopted without copying (a direct ByteBuffer, NSData or
+  // a mapped descriptor) or re-encoded into a compact format: one pointer of `frameCount` samples
+  // encoded as `format` per channel, kept alive by `storage`.
+  std::vector<const void*> adoptedChannels;
+  std::shared_ptr<const void> storage;
+  SampleFormat format = SampleFormat::kFloat32;
+  // Set instead of channelSamples for clips streamed from a decoded cache file.
+  std::shared_ptr<const ClipFileSource> stream;
+
+  [[nodiscard]] std::size_t channelCount() const {
+    if (stream) {
+      return stream->channelCount();
+    }
+    return adoptedChannels.empty() ? channelSamples.size() : adoptedChannels.size();
+  }
+  /** Samples of channel `index` encoded as `format`, or `nullptr` if it holds fewer than `frameCount`. */
+  [[nodiscard]] const void* channelData(std::size_t index) const {
+    if (!adoptedChannels.empty()) {
+      return index < adoptedChannels.size() ? adoptedChannels[index] : nullptr;
+    }
+    if (index >= channelSamples.size() || channelSamples[index].size() < frameCount) {
+      return nullptr;
+    }
+    return channelSamples[index].data();
+  }
+};
+
+/**
+ * Reference-counted map from clip key to ClipBuffer, read without locks. Every edit copies the current
+ * snapshot, applies itself to the copy and publishes it with one atomic exchange, so `find` and the byte
+ * total never wait on a writer, and writers only wait on each other. A replaced snapshot is freed by the
+ * writer once no reader is still inside it.
+ *
+ * Buffers dropped from the registry are not freed by whichever thread happens to release the last
+ * reference, which may be the audio thread through `ClipPlayerNode::ClipBufferData::owner`. The registry
+ * keeps a reference to each of them on a reclaimer thread, which frees a buffer once that reference is
+ * the only one left.
+ */
+class ClipRegistry {
+ public:
+  explicit ClipRegistry(std::chrono::milliseconds reclaimInterval = std::chrono::milliseconds(100));
+  ~ClipRegistry();
+
+  ClipRegistry(const ClipRegistry&) = delete;
+  ClipRegistry& operator=(const ClipRegistry&) = delete;
+
+  /**
+   * Publish `buffer` under `key`, replacing the buffer already there and taking one more reference on
+   * the key. `byteSize` is what the buffer counts towards `bytes`.
+   */
+  void store(const std::string& key, std::shared_ptr<const ClipBuffer> buffer, std::size_t byteSize);
+  /**
+   * Drop one reference on `key`; the last one removes it and hands its buffer to the reclaimer.
+   * @returns `false` if the key is not registered.
+   */
+  bool release(const std::string& key);
+  /** Remove every key regardless of its references. */
+  void clear();
+
+  /** Lock-free lookup from any control thread. @returns The buffer, or `nullptr`. */
+  [[nodiscard]] std::shared_ptr<const ClipBuffer> find(const std::string& key) const;
+  /** Sum of the byte sizes of every registered buffer, maintained as keys come and go. */
+  [[nodiscard]] std::size_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+  /** Buffers dropped from the registry that something else still references. */
+  [[nodiscard]] std::size_t pendingReclaims() const;
+
+ private:
+  struct Entry {
+    std::shared_ptr<const ClipBuffer> buffer;
+    std::size_t referenceCount = 0;
+    std::size_t byteSize = 0;
+  };
+  using Snapshot = std::unordered_map<std::string, Entry>;
+
+  // Writer side, under writeMutex_: swap in `next` and free the previous snapshot after readers leave.
+  void publish(std::unique_ptr<Snapshot> next);
+  void retire(std::shared_ptr<const ClipBuffer> buffer);
+  void runReclaimer();
+
+  std::mutex writeMutex_;
+  std::atomic<const Snapshot*> snapshot_;
+  mutable std::atomic<std::size_t> readers_{0};
+  std::atomic<std::size_t> bytes_{0};
+
+  std::chrono::milliseconds reclaimInterval_;
+  mutable std::mutex reclaimMutex_;
+  std::condition_variable reclaimWake_;
+  std::vector<std::shared_ptr<const ClipBuffer>> retired_;
+  bool stopping_ = false;
+  // Started with the first retired buffer, so registries that never drop one never start a thread.
+  std::thread reclaimer_;
+};
+
+}  // namespace daft::audio
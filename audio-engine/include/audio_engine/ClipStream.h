@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace daft::audio {
+
+/**
+ * Map `length` bytes of `fd` starting at any byte `offset` read-only. The returned pointer addresses
+ * the first requested byte and owns the mapping, which stays valid after `fd` is closed and is unmapped
+ * with the last reference. Lets clip buffers adopt file-backed or shared memory without copying it.
+ * @returns The mapping, or `nullptr` with `error` set.
+ */
+std::shared_ptr<const void> MapFileRegion(int fd, std::size_t offset, std::size_t length, std::string& error);
+
+/**
+ * Read-only, memory-mapped view of a decoded PCM cache file (interleaved 32-bit float, native byte
+ * order, optionally behind a header of `dataOffsetBytes`). Pages are faulted in by the streaming thread
+ * and stay evictable, so a mapped clip costs address space rather than resident memory.
+ */
+class ClipFileSource {
+ public:
+  /**
+   * Map `path` for streaming.
+   * @returns The source, or `nullptr` with `error` set if the file cannot be mapped or holds no frames.
+   */
+  static std::shared_ptr<ClipFileSource> open(const std::string& path, std::size_t channelCount, double sampleRate,
+                                              std::size_t dataOffsetBytes, std::string& error);
+
+  ~ClipFileSource();
+
+  ClipFileSource(const ClipFileSource&) = delete;
+  ClipFileSource& operator=(const ClipFileSource&) = delete;
+
+  [[nodiscard]] std::size_t channelCount() const { return channelCount_; }
+  [[nodiscard]] std::size_t frameCount() const { return frameCount_; }
+  [[nodiscard]] double sampleRate() const { return sampleRate_; }
+
+  /** De-interleave `count` frames starting at `frame` into one destination pointer per channel. */
+  void read(std::uint64_t frame, std::size_t count, float* const* channels) const;
+
+ private:
+  ClipFileSource(void* mapping, std::size_t mappedBytes, const float* samples, std::size_t channelCount,
+                 std::size_t frameCount, double sampleRate);
+
+  void* mapping_;
+  std::size_t mappedBytes_;
+  const float* samples_;
+  std::size_t channelCount_;
+  std::size_t frameCount_;
+  double sampleRate_;
+};
+
+/**
+ * Per-player read-ahead ring over a ClipFileSource. The audio thread is the only consumer and the
+ * streaming thread the only producer; both sides exchange a packed `generation << 40 | frame` cursor, so
+ * neither ever blocks. A read that is not contiguous with the previous one (a relocate) or that finds
+ * its frames missing renders silence, counts an underrun and asks the producer to refill from where
+ * playback continues.
+ */
+class ClipStream {
+ public:
+  ClipStream(std::shared_ptr<const ClipFileSource> source, std::size_t capacityFrames,
+             std::shared_ptr<std::atomic<std::uint64_t>> underrunCounter = nullptr);
+
+  ClipStream(const ClipStream&) = delete;
+  ClipStream& operator=(const ClipStream&) = delete;
+
+  /**
+   * Audio thread: copy frames `[frame, frame + count)` into one destination pointer per channel.
+   * @returns `false` if the frames were not resident; the destination is then silent.
+   */
+  bool read(std::uint64_t frame, std::size_t count, float* const* channels) noexcept;
+
+  /** Audio thread: start refilling from `frame` ahead of the next read, e.g. after a relocate. */
+  void seek(std::uint64_t frame) noexcept;
+
+  /**
+   * Direct mode for offline renders: reads copy straight from the mapped source and never underrun,
+   * while the producer keeps refilling the ring from where they stop so realtime reads resume cleanly.
+   * Set on a control thread while the consumer is not reading.
+   */
+  void setDirect(bool direct) noexcept { direct_ = direct; }
+
+  /**
+   * Streaming thread: top the ring up by at most `maxFrames`.
+   * @returns The number of frames written.
+   */
+  std::size_t fill(std::size_t maxFrames);
+
+  [[nodiscard]] std::size_t channelCount() const { return source_->channelCount(); }
+  [[nodiscard]] std::size_t frameCount() const { return source_->frameCount(); }
+  [[nodiscard]] double sampleRate() const { return source_->sampleRate(); }
+  [[nodiscard]] std::size_t capacityFrames() const { return capacity_; }
+  [[nodiscard]] std::uint64_t underruns() const { return underruns_.load(std::memory_order_relaxed); }
+
+ private:
+  void requestFrom(std::uint64_t frame) noexcept;
+
+  std::shared_ptr<const ClipFileSource> source_;
+  std::size_t capacity_;
+  std::vector<float> samples_;  // planar: channel c owns [c * capacity_, (c + 1) * capacity_)
+  std::vector<float*> fillChannels_;
+  std::shared_ptr<std::atomic<std::uint64_t>> underrunCounter_;
+  std::atomic<std::uint64_t> underruns_{0};
+
+  // Consumer side: next frame expected by the player, published together with its generation.
+  std::uint64_t readFrame_ = 0;
+  std::uint64_t generation_ = 0;
+  bool direct_ = false;
+  alignas(64) std::atomic<std::uint64_t> request_{0};
+  // Producer side: end of the resident range for the generation it was filled for.
+  std::uint64_t writeFrame_ = 0;
+  std::uint64_t fillGeneration_ = 0;
+  alignas(64) std::atomic<std::uint64_t> published_{0};
+};
+
+/**
+ * Background I/O thread that keeps every live ClipStream topped up. Streams are held weakly, so a
+ * stream dies with the ClipPlayerNode that owns it. Control threads create streams; the thread wakes
+ * on a short interval and never touches the audio thread.
+ */
+class ClipStreamer {
+ public:
+  explicit ClipStreamer(std::chrono::milliseconds interval = std::chrono::milliseconds(2));
+  ~ClipStreamer();
+
+  ClipStreamer(const ClipStreamer&) = delete;
+  ClipStreamer& operator=(const ClipStreamer&) = delete;
+
+  /** Create a stream over `source` with `capacityFrames` of read-ahead and start filling it. */
+  std::shared_ptr<ClipStream> createStream(std::shared_ptr<const ClipFileSource> source, std::size_t capacityFrames);
+
+  /** Total underruns across every stream this streamer created, including destroyed ones. */
+  [[nodiscard]] std::uint64_t underruns() const { return underruns_->load(std::memory_order_relaxed); }
+
+ private:
+  void run();
+
+  std::chrono::milliseconds interval_;
+  std::shared_ptr<std::atomic<std::uint64_t>> underruns_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::vector<std::weak_ptr<ClipStream>> streams_;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+}  // namespace daft::audio
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "audio_engine/SampleFormat.h"
+
+namespace daft::audio::dsp {
+
+/**
+ * Vectorized block kernels shared by AudioBufferView, the built-in nodes and the SceneGraph summing
+ * paths. Each kernel compiles to NEON on ARM, AVX when the translation unit is built with it and SSE
+ * on other x86 targets, with a scalar fallback elsewhere. Pointers may be unaligned and `count` may be
+ * any length; blocks aligned to `kBufferAlignment` simply avoid split loads.
+ */
+inline constexpr std::size_t kBufferAlignment = 64;
+
+/** dest[i] = value */
+void fill(float* dest, float value, std::size_t count);
+
+/** dest[i] = source[i]; the ranges must not overlap. */
+void copy(float* dest, const float* source, std::size_t count);
+
+/** dest[i] = source[i] * gain */
+void copyScaled(float* dest, const float* source, float gain, std::size_t count);
+
+/** dest[i] = source[i] * gains[i] */
+void copyMultiplied(float* dest, const float* source, const float* gains, std::size_t count);
+
+/** dest[i] = source[i] * (start + step * i), for linear fades. */
+void copyRamped(float* dest, const float* source, float start, float step, std::size_t count);
+
+/** dest[i] *= start + step * i */
+void multiplyRamped(float* dest, float start, float step, std::size_t count);
+
+/** dest[i] += source[i] */
+void add(float* dest, const float* source, std::size_t count);
+
+/** dest[i] += source[i] * gain */
+void addScaled(float* dest, const float* source, float gain, std::size_t count);
+
+/** dest[i] *= gain */
+void scale(float* dest, float gain, std::size_t count);
+
+/** dest[i] *= gains[i], for ramped gain envelopes. */
+void multiply(float* dest, const float* gains, std::size_t count);
+
+/** dest[i] += source[i] * gains[i], for summing under a ramped gain envelope. */
+void addMultiplied(float* dest, const float* source, const float* gains, std::size_t count);
+
+/**
+ * dest[i] += sum over s of sources[s][i] * gains[s]. Accumulates every source in one pass over `dest`,
+ * so a bus with many inputs reads and writes its output once instead of once per input.
+ */
+void mixScaled(float* dest, const float* const* sources, const float* gains, std::size_t sourceCount,
+               std::size_t count);
+
+/** dest[i] = source[i] / 32768 */
+void decodeInt16(float* dest, const std::int16_t* source, std::size_t count);
+
+/**
+ * Sum over i of source[i] * (lower[i] + (upper[i] - lower[i]) * fraction): a FIR tap evaluated between
+ * two adjacent rows of a polyphase coefficient table.
+ */
+float dotInterpolated(const float* source, const float* lower, const float* upper, float fraction, std::size_t count);
+
+/** dest[i] = half-precision source[i] widened to float, including subnormals, infinities and NaN. */
+void decodeFloat16(float* dest, const std::uint16_t* source, std::size_t count);
+
+/** Oscillator shapes rendered by `oscillator`. Each starts at the rising zero crossing of a sine. */
+enum class Waveform : std::uint8_t { kSine, kSaw, kSquare, kTriangle };
+
+/**
+ * Render `count` samples of `waveform` starting at `phase` cycles and advancing `increment` cycles per
+ * sample, clamped to [0, 0.5]. Sine is a polynomial with no libm call. Saw and square steps are smoothed
+ * with polyBLEP residuals and triangle corners with polyBLAMP, so harmonics above Nyquist are
+ * attenuated instead of folding back. Evaluates a register of consecutive samples at a time.
+ * @returns The phase after the last sample, wrapped into [0, 1).
+ */
+double oscillator(Waveform waveform, float* dest, double phase, double increment, std::size_t count);
+
+/**
+ * Oscillator bank over voices held as structure-of-arrays: dest[i] += sum over v of
+ * (gains[v] + gainSteps[v] * i) * waveform(phases[v] + increments[v] * i). One register evaluates as many
+ * voices as it has lanes, so a bank costs about voiceCount / lanes single oscillators. Increments are
+ * clamped like `oscillator`'s. Each phases[v] must lie in [0, 1) and is advanced past the block and
+ * wrapped back into it.
+ */
+void mixOscillators(Waveform waveform, float* dest, double* phases, const double* increments, const float* gains,
+                    const float* gainSteps, std::size_t voiceCount, std::size_t count);
+
+/** Decode `count` samples starting at sample `offset` of a channel stored as `format`. */
+void decode(SampleFormat format, const void* source, std::size_t offset, float* dest, std::size_t count);
+
+/** Quantize to 16-bit PCM, rounding to nearest and clamping to the representable range. */
+void encodeInt16(std::int16_t* dest, const float* source, std::size_t count);
+
+/** Narrow to half precision, rounding to nearest even and saturating out-of-range values to infinity. */
+void encodeFloat16(std::uint16_t* dest, const float* source, std::size_t count);
+
+/**
+ * Clear and sum loops for whole planar blocks of one shape, as used by the SceneGraph buffer paths.
+ * Mono and stereo blocks of 64, 128 and 256 frames get loops specialised at compile time, which run
+ * whole registers with no tail and no per-call length checks; every other shape loops over `fill` and
+ * `add`. The specialised loops ignore their `channels` and `frames` arguments.
+ */
+struct BlockKernels {
+  /** dest[ch][i] = 0 */
+  void (*clear)(float* const* dest, std::size_t channels, std::size_t frames);
+  /** dest[ch][i] += source[ch][i] */
+  void (*add)(float* const* dest, const float* const* source, std::size_t channels, std::size_t frames);
+  /** Whether these are the compile-time specialised loops. */
+  bool specialised;
+};
+
+const BlockKernels& blockKernels(std::size_t channels, std::size_t frames);
+
+/** Name of the instruction set the kernels were compiled for ("avx", "sse2", "neon" or "scalar"). */
+const char* instructionSet();
+
+}  // namespace daft::audio::dsp
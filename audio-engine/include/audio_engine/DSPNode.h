@@ -2,19 +2,51 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
 #include <optional>
 #include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "audio_engine/AudioBuffer.h"
 #include "audio_engine/Clock.h"
+#include "audio_engine/DSPKernels.h"
+#include "audio_engine/Resampler.h"
+#include "audio_engine/SampleFormat.h"
+#include "audio_engine/SmoothedValue.h"
 
 namespace daft::audio {
 
+class ClipStream;
+
+using ParamId = std::uint32_t;
+inline constexpr ParamId kInvalidParamId = std::numeric_limits<ParamId>::max();
+
+enum class ParameterSmoothing : std::uint8_t {
+  kNone,    // applied as a step; frame, count and mode parameters
+  kLinear,  // level-like parameters that tolerate per-sample interpolation
+};
+
+/**
+ * Compile-time description of one node parameter. Nodes publish a static table of these so names are
+ * resolved to `ParamId`s once on the control thread and the audio thread only ever sees integers.
+ * `controlOnly` parameters allocate or call out when set, so the graph applies them on the control
+ * thread and refuses to schedule them as automation.
+ */
+struct ParameterDescriptor {
+  ParamId id;
+  std::string_view name;  // lower-case; lookups through DSPNode::findParameter ignore case
+  double minValue;
+  double maxValue;
+  double defaultValue;
+  ParameterSmoothing smoothing;
+  bool controlOnly = false;
+};
+
 class DSPNode {
  public:
   DSPNode() = default;
@@ -28,7 +60,97 @@ class DSPNode {
   virtual void prepare(double sampleRate) { sampleRate_ = sampleRate; }
   virtual void reset() {}
   virtual void process(AudioBufferView buffer) = 0;
-  virtual void setParameter(const std::string& name, double value) = 0;
+
+  /** `tailFrames` value for nodes that may ring indefinitely once their inputs fall silent. */
+  static constexpr std::uint64_t kInfiniteTail = std::numeric_limits<std::uint64_t>::max();
+
+  /**
+   * Silence skipping. When every input of a node is silent and `isIdle` reports that the node adds no
+   * signal of its own over the next `frameCount` frames, the graph keeps rendering it for `tailFrames`
+   * more frames (reverb and delay tails) and then calls `skipSilence` instead of `process`: the buffer is
+   * neither cleared nor summed and consumers treat it as silent. The defaults never skip, so custom nodes
+   * opt in explicitly. All three run on the audio thread and must not allocate.
+   */
+  [[nodiscard]] virtual bool isIdle(std::size_t frameCount) const {
+    (void)frameCount;
+    return false;
+  }
+  [[nodiscard]] virtual std::uint64_t tailFrames() const { return 0; }
+  /** Keep time (ramps, playheads) across `frameCount` frames that are not rendered. */
+  virtual void skipSilence(std::size_t frameCount) { (void)frameCount; }
+
+  /**
+   * Latency compensation. A node whose output lags its input (lookahead, block-based or anticipative
+   * processing) reports the lag in frames, and the graph delays the parallel paths meeting it so every
+   * join stays in phase. `maxLatencyFrames` bounds what `latencyFrames` may report over the node's
+   * lifetime and sizes the compensation delay lines when a plan is compiled; the defaults report none.
+   * `latencyFrames` runs on the audio thread once per block.
+   */
+  [[nodiscard]] virtual std::uint32_t latencyFrames() const { return 0; }
+  [[nodiscard]] virtual std::uint32_t maxLatencyFrames() const { return 0; }
+
+  /**
+   * Offline renders (bounces) have no deadline. Nodes that would otherwise drop work arriving late,
+   * such as streamed clips and anticipative plugins, wait for it instead, so a bounce never contains an
+   * underrun. Called on control threads while no thread renders the node.
+   */
+  virtual void setOfflineRendering(bool offline) { (void)offline; }
+
+  /**
+   * Most channels and longest block the owning graph renders through the node. Nodes that preallocate
+   * per-block state size it from these. Called on control threads when the node joins a graph, before
+   * `prepare` and while no thread renders the node.
+   */
+  virtual void setRenderLimits(std::size_t maxChannels, std::size_t maxFrames) {
+    (void)maxChannels;
+    (void)maxFrames;
+  }
+
+  /**
+   * Nodes that return `true` receive their inbound edges as separate buffers through `processInputs`
+   * instead of having the graph sum them into the node buffer before `process`.
+   */
+  [[nodiscard]] virtual bool mixesInputs() const { return false; }
+
+  /**
+   * Render `output` from the node's inbound buffers, given in connection order. Only called by the graph
+   * when `mixesInputs()` is true; `output` never aliases an input, and inputs flagged `isSilent()` must be
+   * skipped. The default sums the audible inputs and calls `process`.
+   */
+  virtual void processInputs(std::span<const AudioBufferView> inputs, AudioBufferView output);
+
+  /** Descriptor table for this node; `ParamId`s index into it. */
+  [[nodiscard]] virtual std::span<const ParameterDescriptor> parameters() const { return {}; }
+
+  /** Realtime parameter path. Must not allocate; unknown ids are ignored. */
+  virtual void setParameter(ParamId id, double value) {
+    (void)id;
+    (void)value;
+  }
+
+  /**
+   * Realtime ramp path: move `id` to `target` over `frames` samples, interpolating inside `process`.
+   * Nodes without a smoothed implementation for `id` apply the target as a step.
+   */
+  virtual void rampParameter(ParamId id, double target, std::uint32_t frames, RampShape shape) {
+    (void)frames;
+    (void)shape;
+    setParameter(id, target);
+  }
+
+  /**
+   * Control-thread convenience that resolves `name` through `findParameter` and forwards to the
+   * `ParamId` overload. Not intended for the audio thread.
+   */
+  virtual void setParameter(const std::string& name, double value);
+
+  /**
+   * Resolve a parameter name (case-insensitive) against `parameters()`.
+   * @returns The parameter id, or `kInvalidParamId` if the node has no such parameter.
+   */
+  [[nodiscard]] ParamId findParameter(std::string_view name) const;
+  /** Whether `id` is declared `controlOnly` in `parameters()`. */
+  [[nodiscard]] bool isControlOnly(ParamId id) const;
 
   [[nodiscard]] double sampleRate() const { return sampleRate_; }
 
@@ -38,34 +160,91 @@ class DSPNode {
 
 class GainNode final : public DSPNode {
  public:
+  enum Parameter : ParamId { kGain };
+  static constexpr std::array<ParameterDescriptor, 1> kParameters{{
+      {kGain, "gain", 0.0, 16.0, 1.0, ParameterSmoothing::kLinear},
+  }};
+
+  using DSPNode::setParameter;
   void process(AudioBufferView buffer) override;
-  void setParameter(const std::string& name, double value) override;
+  [[nodiscard]] std::span<const ParameterDescriptor> parameters() const override { return kParameters; }
+  void setParameter(ParamId id, double value) override;
+  void rampParameter(ParamId id, double target, std::uint32_t frames, RampShape shape) override;
+  [[nodiscard]] bool isIdle(std::size_t) const override { return true; }
+  void skipSilence(std::size_t frameCount) override { gain_.skip(frameCount); }
 
  private:
-  double gain_ = 1.0;
+  SmoothedValue gain_{1.0};
 };
 
+/**
+ * Free-running oscillator. `waveform` selects sine (0), saw (1), square (2) or triangle (3); each block is
+ * rendered band-limited once by `dsp::oscillator` and copied to the remaining channels.
+ */
 class SineOscillatorNode final : public DSPNode {
  public:
+  enum Parameter : ParamId { kFrequency, kWaveform };
+  static constexpr std::array<ParameterDescriptor, 2> kParameters{{
+      {kFrequency, "frequency", 0.0, 24000.0, 440.0, ParameterSmoothing::kLinear},
+      {kWaveform, "waveform", 0.0, 3.0, 0.0, ParameterSmoothing::kNone},
+  }};
+
+  using DSPNode::setParameter;
   void prepare(double sampleRate) override;
   void process(AudioBufferView buffer) override;
-  void setParameter(const std::string& name, double value) override;
+  [[nodiscard]] std::span<const ParameterDescriptor> parameters() const override { return kParameters; }
+  void setParameter(ParamId id, double value) override;
 
  private:
-  double phase_ = 0.0;
+  double phase_ = 0.0;  // cycles
   double frequency_ = 440.0;
+  dsp::Waveform waveform_ = dsp::Waveform::kSine;
 };
 
+/**
+ * Summing bus over the node's graph inputs. Each inbound edge, in connection order, feeds a channel strip
+ * with its own gain and pan; strips are accumulated channel-major in a single multi-input kernel pass
+ * and the master `gain` is applied to the mix. Pan is a balance control on stereo outputs and is ignored
+ * for other channel counts. Inputs beyond the configured strip count mix at unity.
+ */
 class MixerNode final : public DSPNode {
  public:
+  enum Parameter : ParamId { kGain, kFirstInputParameter };
+  static constexpr std::size_t kMaxInputs = 64;
+
+  /** Ids of the per-strip parameters, published as `input<N>.gain` and `input<N>.pan`. */
+  static constexpr ParamId inputGain(std::size_t input) {
+    return kFirstInputParameter + static_cast<ParamId>(2 * input);
+  }
+  static constexpr ParamId inputPan(std::size_t input) { return inputGain(input) + 1; }
+
   explicit MixerNode(std::size_t inputCount);
+  using DSPNode::setParameter;
+  /** Applies the master gain to an already summed buffer. */
   void process(AudioBufferView buffer) override;
-  void setParameter(const std::string& name, double value) override;
-  void updateInput(std::size_t index, std::span<const float> input);
+  [[nodiscard]] bool mixesInputs() const override { return true; }
+  void processInputs(std::span<const AudioBufferView> inputs, AudioBufferView output) override;
+  [[nodiscard]] std::span<const ParameterDescriptor> parameters() const override { return parameters_; }
+  void setParameter(ParamId id, double value) override;
+  void rampParameter(ParamId id, double target, std::uint32_t frames, RampShape shape) override;
+  [[nodiscard]] std::size_t inputCount() const { return strips_.size(); }
+  [[nodiscard]] bool isIdle(std::size_t) const override { return true; }
+  void skipSilence(std::size_t frameCount) override;
 
  private:
-  std::vector<std::span<const float>> inputs_;
-  double gain_ = 1.0;
+  struct Strip {
+    SmoothedValue gain{1.0};
+    double pan = 0.0;
+  };
+
+  [[nodiscard]] Strip* stripForParameter(ParamId id);
+  void mixRampingStrip(Strip& strip, const AudioBufferView& input, AudioBufferView& output);
+
+  std::vector<Strip> strips_;
+  // Per-instance table because the strip count is chosen at construction; names back the descriptors.
+  std::vector<std::string> parameterNames_;
+  std::vector<ParameterDescriptor> parameters_;
+  SmoothedValue gain_{1.0};
 };
 
 class ClipPlayerNode final : public DSPNode {
@@ -74,7 +253,9 @@ class ClipPlayerNode final : public DSPNode {
     std::string key;
     double sampleRate = 0.0;
     std::size_t frameCount = 0;
-    std::vector<const float*> channels;
+    // One pointer per channel to `frameCount` samples encoded as `format`.
+    std::vector<const void*> channels;
+    SampleFormat format = SampleFormat::kFloat32;
     std::shared_ptr<void> owner;
 
     [[nodiscard]] std::size_t channelCount() const { return channels.size(); }
@@ -83,29 +264,111 @@ class ClipPlayerNode final : public DSPNode {
       sampleRate = 0.0;
       frameCount = 0;
       channels.clear();
+      format = SampleFormat::kFloat32;
       owner.reset();
     }
     [[nodiscard]] bool empty() const { return frameCount == 0 || channels.empty(); }
   };
 
+  enum Parameter : ParamId {
+    kStartFrame,
+    kEndFrame,
+    kFadeInFrames,
+    kFadeOutFrames,
+    kGain,
+    kBufferSampleRate,
+    kBufferChannels,
+    kBufferFrames,
+    kPlaybackRate,
+    kResampleQuality,
+  };
+  static constexpr double kMaxFrameValue = static_cast<double>(std::numeric_limits<std::uint64_t>::max());
+  static constexpr std::array<ParameterDescriptor, 10> kParameters{{
+      {kStartFrame, "startframe", 0.0, kMaxFrameValue, 0.0, ParameterSmoothing::kNone},
+      {kEndFrame, "endframe", 0.0, kMaxFrameValue, 0.0, ParameterSmoothing::kNone},
+      {kFadeInFrames, "fadeinframes", 0.0, kMaxFrameValue, 0.0, ParameterSmoothing::kNone},
+      {kFadeOutFrames, "fadeoutframes", 0.0, kMaxFrameValue, 0.0, ParameterSmoothing::kNone},
+      {kGain, "gain", 0.0, 16.0, 1.0, ParameterSmoothing::kLinear},
+      {kBufferSampleRate, "buffersamplerate", 0.0, 384000.0, 0.0, ParameterSmoothing::kNone},
+      {kBufferChannels, "bufferchannels", 0.0, 64.0, 0.0, ParameterSmoothing::kNone},
+      {kBufferFrames, "bufferframes", 0.0, kMaxFrameValue, 0.0, ParameterSmoothing::kNone},
+      // Varispeed: pitch follows speed, like tape. Start, end and fades stay in timeline frames.
+      {kPlaybackRate, "playbackrate", 0.25, 4.0, 1.0, ParameterSmoothing::kNone},
+      // 0 = linear interpolation, 1 = windowed sinc.
+      {kResampleQuality, "resamplequality", 0.0, 1.0, 1.0, ParameterSmoothing::kNone},
+  }};
+
+  using DSPNode::setParameter;
   void prepare(double sampleRate) override;
   void reset() override;
   void process(AudioBufferView buffer) override;
-  void setParameter(const std::string& name, double value) override;
+  [[nodiscard]] std::span<const ParameterDescriptor> parameters() const override { return kParameters; }
+  void setParameter(ParamId id, double value) override;
+  void rampParameter(ParamId id, double target, std::uint32_t frames, RampShape shape) override;
+  /** Idle whenever the next `frameCount` frames fall outside the clip's playback window. */
+  [[nodiscard]] bool isIdle(std::size_t frameCount) const override;
+  void skipSilence(std::size_t frameCount) override;
 
   void setClipBuffer(ClipBufferData data);
   [[nodiscard]] const ClipBufferData& clipBuffer() const noexcept { return clipBuffer_; }
+  /**
+   * Play from a disk-backed read-ahead stream instead of a resident buffer. Replaces any clip buffer;
+   * frames the stream has not read ahead in time render as silence and count as underruns.
+   */
+  void setClipStream(std::shared_ptr<ClipStream> stream);
+  [[nodiscard]] const std::shared_ptr<ClipStream>& clipStream() const noexcept { return stream_; }
+  /** Offline, streamed clips read straight from their file rather than from the read-ahead ring. */
+  void setOfflineRendering(bool offline) override;
 
  private:
+  // Frames pulled from a stream, decoded from a compact format or resampled at a time; longer blocks
+  // are rendered in segments.
+  static constexpr std::size_t kDecodeChunkFrames = 1024;
+  // Source frames the resampler can see at once, including its filter context.
+  static constexpr std::size_t kResampleWindowFrames = 2048;
+  // Source frames per output frame are clamped to this, so every chunk makes progress.
+  static constexpr double kMaxResampleStep = 16.0;
+
   static std::uint64_t sanitizeFrameValue(double value);
   static std::uint64_t sanitizeCountValue(double value);
+  [[nodiscard]] std::size_t sourceChannelCount() const noexcept;
+  [[nodiscard]] std::uint64_t sourceFrameCount() const noexcept;
+  [[nodiscard]] double sourceSampleRate() const noexcept;
+  /** Source frames consumed per output frame for the clip's rate and `playbackrate`. */
+  [[nodiscard]] double resampleStep() const noexcept;
+  /** Whether the block starting at `blockStart` must go through the resampler. */
+  [[nodiscard]] bool resamples(std::uint64_t blockStart, double step) const noexcept;
+  /** End of the playback window in timeline frames, as seen from the block starting at `blockStart`. */
+  [[nodiscard]] std::uint64_t playbackEnd(std::uint64_t blockStart, double step, bool resampled) const noexcept;
+  void allocateScratch(std::size_t channelCount);
+  /** Copy, decode or stream source frames [first, first + count) to `offset` in the resampling window. */
+  void fetchSource(std::int64_t first, std::size_t count, std::size_t offset);
+  /** Resample `count` output frames from `sourcePosition_` into the decoded scratch. */
+  void resampleChunk(std::size_t count, double step);
 
   ClipBufferData clipBuffer_{};
+  std::shared_ptr<ClipStream> stream_;
+  bool offline_ = false;
+  // Float32 clips are read in place through these; streamed, compact and resampled clips go through
+  // the scratch.
+  std::vector<const float*> residentChannels_;
+  std::vector<float> decodedSamples_;
+  std::vector<float*> decodedChannels_;
+  // Sliding window of source frames [windowStart_, windowStart_ + windowFrames_) for the resampler.
+  std::vector<float> windowSamples_;
+  std::vector<float*> windowChannels_;
+  std::vector<float*> fetchChannels_;
+  std::int64_t windowStart_ = 0;
+  std::size_t windowFrames_ = 0;
+  // Clip frame played at timeline frame `processedFrames_`; fractional while resampling.
+  double sourcePosition_ = 0.0;
+  double playbackRate_ = 1.0;
+  ResampleQuality resampleQuality_ = ResampleQuality::kSinc;
   std::uint64_t startFrame_ = 0;
   std::uint64_t endFrame_ = 0;
   std::uint64_t fadeInFrames_ = 0;
   std::uint64_t fadeOutFrames_ = 0;
-  double gain_ = 1.0;
+  SmoothedValue gain_{1.0};
   double declaredBufferSampleRate_ = 0.0;
   std::uint64_t declaredBufferFrames_ = 0;
   std::uint64_t declaredBufferChannels_ = 0;
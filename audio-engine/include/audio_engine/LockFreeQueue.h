@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace daft::audio {
+
+/**
+ * Bounded single-producer/single-consumer ring buffer.
+ *
+ * One thread may call `push` while another calls `pop`; neither side blocks or allocates, which makes
+ * the queue suitable for handing data to and from the audio render thread.
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+ public:
+  SpscQueue() = default;
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  bool push(const T& value) { return emplace(value); }
+  bool push(T&& value) { return emplace(std::move(value)); }
+
+  [[nodiscard]] std::optional<T> pop() {
+    const auto readIndex = readIndex_.load(std::memory_order_relaxed);
+    const auto writeIndex = writeIndex_.load(std::memory_order_acquire);
+    if (readIndex == writeIndex) {
+      return std::nullopt;
+    }
+    std::optional<T> value(std::move(slots_[readIndex]));
+    readIndex_.store(increment(readIndex), std::memory_order_release);
+    return value;
+  }
+
+  /** Producer-side check; a `false` result guarantees the next `push` succeeds. */
+  [[nodiscard]] bool full() const {
+    const auto writeIndex = writeIndex_.load(std::memory_order_relaxed);
+    return increment(writeIndex) == readIndex_.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] bool empty() const {
+    return readIndex_.load(std::memory_order_acquire) == writeIndex_.load(std::memory_order_acquire);
+  }
+
+  static constexpr std::size_t capacity() { return Capacity; }
+
+ private:
+  template <typename U>
+  bool emplace(U&& value) {
+    const auto writeIndex = writeIndex_.load(std::memory_order_relaxed);
+    const auto nextWrite = increment(writeIndex);
+    if (nextWrite == readIndex_.load(std::memory_order_acquire)) {
+      return false;  // full
+    }
+    slots_[writeIndex] = std::forward<U>(value);
+    writeIndex_.store(nextWrite, std::memory_order_release);
+    return true;
+  }
+
+  static constexpr std::size_t kSlotCount = Capacity + 1;
+  static constexpr std::size_t increment(std::size_t index) { return (index + 1) % kSlotCount; }
+
+  std::array<T, kSlotCount> slots_{};
+  std::atomic<std::size_t> writeIndex_{0};
+  std::atomic<std::size_t> readIndex_{0};
+};
+
+}  // namespace daft::audio
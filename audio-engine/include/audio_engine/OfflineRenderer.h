@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio_engine/SampleFormat.h"
+
+namespace daft::audio {
+
+class SceneGraph;
+
+/**
+ * Streaming RIFF/WAVE writer for interleaved float samples, stored as 32-bit float or 16-bit PCM. The
+ * size fields are patched by `close`, so the data is appended with plain sequential writes.
+ */
+class WavFileWriter {
+ public:
+  WavFileWriter() = default;
+  ~WavFileWriter();
+
+  WavFileWriter(const WavFileWriter&) = delete;
+  WavFileWriter& operator=(const WavFileWriter&) = delete;
+
+  /**
+   * Create or truncate `path` and write a header for `channelCount` channels at `sampleRate`.
+   * @returns `false` with `error` set if the file cannot be created or `format` is not float32 or int16.
+   */
+  bool open(const std::string& path, std::size_t channelCount, double sampleRate, SampleFormat format,
+            std::string& error);
+
+  /** Append `frames` interleaved frames. @returns `false` with `error` set on an I/O error or a full RIFF. */
+  bool write(const float* interleaved, std::size_t frames, std::string& error);
+
+  /** Patch the header sizes and close the file. @returns `false` with `error` set on an I/O error. */
+  bool close(std::string& error);
+
+  [[nodiscard]] bool isOpen() const { return fd_ >= 0; }
+  [[nodiscard]] std::uint64_t framesWritten() const { return framesWritten_; }
+
+ private:
+  int fd_ = -1;
+  std::size_t channelCount_ = 0;
+  SampleFormat format_ = SampleFormat::kFloat32;
+  std::uint64_t framesWritten_ = 0;
+  std::vector<std::int16_t> encoded_;
+};
+
+/**
+ * Faster-than-realtime bounce of a SceneGraph to a WAV file. A render thread drives the graph from frame
+ * zero in blocks of up to the graph's `maxSupportedFramesPerBuffer()` frames, through the parallel
+ * scheduler when workers are enabled, with every node in offline mode so streamed clips and anticipative
+ * plugins wait for their audio instead of dropping it; the same graph and automation therefore render
+ * the same file every time. Interleaved chunks go to a writer thread, so disk stalls never hold up the
+ * graph. Nobody else may render the graph between `start` and `wait`.
+ */
+class OfflineRenderer {
+ public:
+  enum class State : std::uint8_t { kIdle, kRendering, kFinished, kCancelled, kFailed };
+
+  struct Options {
+    std::uint64_t frameCount = 0;
+    std::size_t channelCount = 2;
+    /** Graph block size; zero (or anything larger) uses the largest block the graph supports. */
+    std::size_t blockFrames = 0;
+    SampleFormat format = SampleFormat::kFloat32;
+    /** Render workers for the bounce, restored by `wait`; zero keeps the graph's current setting. */
+    std::size_t workerCount = 0;
+  };
+
+  struct Progress {
+    State state = State::kIdle;
+    std::uint64_t renderedFrames = 0;
+    std::uint64_t writtenFrames = 0;
+    std::uint64_t totalFrames = 0;
+  };
+
+  OfflineRenderer() = default;
+  /** Cancels and waits for a bounce still running. */
+  ~OfflineRenderer();
+
+  OfflineRenderer(const OfflineRenderer&) = delete;
+  OfflineRenderer& operator=(const OfflineRenderer&) = delete;
+
+  /**
+   * Rewind `graph`, switch it to offline rendering and start bouncing `options.frameCount` frames to
+   * `path`. Control threads only.
+   * @returns `false` with `error` set if a bounce is already running, the options are out of range or
+   * the file cannot be created.
+   */
+  bool start(SceneGraph& graph, const std::string& path, const Options& options, std::string& error);
+
+  /** Ask a running bounce to stop; the partial file is deleted. Safe from any thread. */
+  void cancel() noexcept;
+
+  /**
+   * Block until the bounce ends, then hand the graph back to realtime rendering: offline mode and the
+   * worker count are restored and the timeline is rewound again. Control threads only; returns at once
+   * when no bounce was started.
+   * @returns The final state (`kFinished`, `kCancelled` or `kFailed`), or `kIdle`.
+   */
+  State wait();
+
+  /** Safe from any thread while the bounce runs. */
+  [[nodiscard]] Progress progress() const;
+  /** Reason for `kFailed`; empty otherwise. */
+  [[nodiscard]] std::string error() const;
+
+ private:
+  static constexpr std::size_t kChunkCount = 4;
+  static constexpr std::size_t kChunkFrames = 16384;
+
+  struct Chunk {
+    std::vector<float> samples;
+    std::size_t frames = 0;
+  };
+
+  void runRender();
+  void runWriter();
+  void fail(std::string message);
+
+  SceneGraph* graph_ = nullptr;
+  Options options_{};
+  std::string path_;
+  bool previousOffline_ = false;
+  std::size_t previousWorkers_ = 0;
+  WavFileWriter writer_;
+
+  // Chunk ring between the render thread (producer) and the writer thread (consumer), guarded by mutex_.
+  mutable std::mutex mutex_;
+  std::condition_variable chunkReady_;
+  std::condition_variable chunkFree_;
+  std::vector<Chunk> chunks_;
+  std::uint64_t producedChunks_ = 0;
+  std::uint64_t consumedChunks_ = 0;
+  bool renderDone_ = false;
+  std::string error_;
+
+  std::atomic<State> state_{State::kIdle};
+  std::atomic<bool> cancelled_{false};
+  std::atomic<std::uint64_t> renderedFrames_{0};
+  std::atomic<std::uint64_t> writtenFrames_{0};
+  std::atomic<std::uint64_t> totalFrames_{0};
+  std::thread renderThread_;
+  std::thread writerThread_;
+};
+
+}  // namespace daft::audio
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <span>
 #include <string_view>
 
 #include "audio_engine/AudioBuffer.h"
@@ -17,26 +20,134 @@ struct PluginBusCapabilities {
   bool emitsSidechain = false;
 };
 
+/**
+ * Opaque host-side identity of a plugin instance (an index or a pointer), resolved once from a host
+ * instance id so render calls need no string lookup. Zero never names an instance.
+ */
+using PluginInstanceHandle = std::uint64_t;
+inline constexpr PluginInstanceHandle kInvalidPluginInstanceHandle = 0;
+
+enum class PluginEventType : std::uint8_t { kMidi, kParameter };
+
+/** Plain-data MIDI message or plugin parameter change, stamped with its frame inside the block. */
+struct PluginEvent {
+  std::uint32_t sampleOffset = 0;
+  PluginEventType type = PluginEventType::kMidi;
+  std::uint8_t midiSize = 0;
+  std::array<std::uint8_t, 3> midi{};
+  // Host-defined parameter identifier and value; unused by MIDI events.
+  std::uint32_t parameterId = 0;
+  float value = 0.0F;
+
+  static constexpr PluginEvent Midi(std::uint32_t sampleOffset, std::uint8_t status, std::uint8_t data1 = 0,
+                                    std::uint8_t data2 = 0, std::uint8_t size = 3) {
+    return {sampleOffset, PluginEventType::kMidi, size, {status, data1, data2}, 0, 0.0F};
+  }
+  static constexpr PluginEvent Parameter(std::uint32_t sampleOffset, std::uint32_t parameterId, float value) {
+    return {sampleOffset, PluginEventType::kParameter, 0, {}, parameterId, value};
+  }
+};
+
+/**
+ * Fixed-capacity event list owned by a `PluginNode` and handed to the host with every render request.
+ * Storage is inline, so filling and clearing it on the audio thread never allocates; events that do
+ * not fit are dropped and counted.
+ */
+class PluginEventList {
+ public:
+  static constexpr std::size_t kCapacity = 256;
+
+  bool push(const PluginEvent& event) noexcept {
+    if (size_ == kCapacity) {
+      ++dropped_;
+      return false;
+    }
+    events_[size_++] = event;
+    return true;
+  }
+
+  void clear() noexcept {
+    size_ = 0;
+    dropped_ = 0;
+  }
+
+  [[nodiscard]] std::span<const PluginEvent> events() const noexcept { return {events_.data(), size_}; }
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+  /** Events rejected since the last `clear` because the list was full. */
+  [[nodiscard]] std::size_t dropped() const noexcept { return dropped_; }
+
+ private:
+  std::array<PluginEvent, kCapacity> events_{};
+  std::size_t size_ = 0;
+  std::size_t dropped_ = 0;
+};
+
 struct PluginRenderRequest {
   std::string_view hostInstanceId;
   AudioBufferView audioBuffer;
   double sampleRate = 0.0;
   PluginBusCapabilities capabilities{};
   bool bypassed = false;
+  /** Events due in this block, ordered by `sampleOffset`. Never null for requests built by `PluginNode`. */
+  const PluginEventList* inputEvents = nullptr;
+  /** Empty list the host may fill with the plugin's MIDI output for this block. */
+  PluginEventList* outputEvents = nullptr;
+  /** Sidechain inputs in connection order; views flagged `isSilent()` carry stale samples. */
+  std::span<const AudioBufferView> sidechainBuffers{};
+  /** Handle resolved for `hostInstanceId`; invalid when the host has not resolved it (use the id instead). */
+  PluginInstanceHandle instanceHandle = kInvalidPluginInstanceHandle;
 };
 
 struct PluginRenderResult {
   bool success = false;
   bool pluginBypassed = false;
+  /** Frames the plugin keeps ringing after its input falls silent, when the host knows it. */
+  std::optional<std::uint64_t> tailFrames{};
+  /** Frames the plugin currently delays its output by (lookahead, FFT blocks), when the host knows it. */
+  std::optional<std::uint32_t> latencyFrames{};
 };
 
 class PluginHostBridge {
  public:
   using RenderCallback = PluginRenderResult (*)(PluginRenderRequest& request, void* userData);
+  /**
+   * Render `count` independent plugin instances in one call and write one result per request. Hosts
+   * that cross a language or process boundary per call register this to amortize the dispatch.
+   */
+  using BatchRenderCallback = void (*)(PluginRenderRequest* const* requests, PluginRenderResult* results,
+                                       std::size_t count, void* userData);
+
+  /** Map a host instance id to a handle; called on control threads only, so it may lock or allocate. */
+  using ResolveCallback = PluginInstanceHandle (*)(std::string_view hostInstanceId, void* userData);
 
   static void SetRenderCallback(RenderCallback callback, void* userData = nullptr) noexcept;
   static void ClearRenderCallback() noexcept;
   static std::optional<PluginRenderResult> Render(PluginRenderRequest& request) noexcept;
+
+  static void SetBatchRenderCallback(BatchRenderCallback callback, void* userData = nullptr) noexcept;
+  static void ClearBatchRenderCallback() noexcept;
+  [[nodiscard]] static bool HasBatchRenderCallback() noexcept;
+  /**
+   * Render every request through the batch callback, or one by one through the render callback when no
+   * batch callback is registered. A throwing batch callback fails the whole batch.
+   * @returns `false`, leaving `results` untouched, when neither callback is registered.
+   */
+  static bool RenderBatch(std::span<PluginRenderRequest* const> requests,
+                          std::span<PluginRenderResult> results) noexcept;
+
+  static void SetResolveCallback(ResolveCallback callback, void* userData = nullptr) noexcept;
+  static void ClearResolveCallback() noexcept;
+  /** @returns The host's handle for `hostInstanceId`, or `kInvalidPluginInstanceHandle`. Control threads only. */
+  static PluginInstanceHandle Resolve(std::string_view hostInstanceId) noexcept;
+  /**
+   * Retire every handle resolved so far, e.g. after the host reloaded its instances. Render requests
+   * carry `kInvalidPluginInstanceHandle` until each node is bound again (`PluginNode::prepare` or
+   * `setHostInstanceId`). Registering or clearing the resolve callback invalidates as well.
+   */
+  static void InvalidateHandles() noexcept;
+  /** Incremented by every invalidation; a handle stays valid while this matches its resolution. */
+  [[nodiscard]] static std::uint64_t HandleGeneration() noexcept;
 };
 
 }  // namespace daft::audio
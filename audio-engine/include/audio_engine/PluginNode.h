@@ -1,24 +1,124 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 
 #include "audio_engine/DSPNode.h"
+#include "audio_engine/LockFreeQueue.h"
 #include "audio_engine/PluginHost.h"
 
 namespace daft::audio {
 
 class PluginNode final : public DSPNode {
  public:
+  enum Parameter : ParamId { kBypass, kBypassed, kHostInstanceId, kTailFrames, kLatencyFrames };
+  static constexpr std::array<ParameterDescriptor, 5> kParameters{{
+      {kBypass, "bypass", 0.0, 1.0, 0.0, ParameterSmoothing::kNone},
+      {kBypassed, "bypassed", 0.0, 1.0, 0.0, ParameterSmoothing::kNone},
+      // Numeric host instance id. Rebinding resolves through the host, so it is never automated.
+      {kHostInstanceId, "hostinstanceid", 0.0, 9007199254740992.0, 0.0, ParameterSmoothing::kNone, true},
+      // Declared tail; negative means unknown (never skipped). Hosts may refine it per render result.
+      {kTailFrames, "tailframes", -1.0, 9007199254740992.0, -1.0, ParameterSmoothing::kNone},
+      // Declared processing latency, clamped to kMaxReportedLatencyFrames; refined per render result.
+      {kLatencyFrames, "latencyframes", 0.0, 8192.0, 0.0, ParameterSmoothing::kNone},
+  }};
+
+  /** Largest plugin latency the node reports; the graph sizes compensation delays from it. */
+  static constexpr std::uint32_t kMaxReportedLatencyFrames = 8192;
+
   explicit PluginNode(std::string hostInstanceId, PluginBusCapabilities capabilities);
+  ~PluginNode() override;
 
+  using DSPNode::setParameter;
   void prepare(double sampleRate) override;
   void reset() override;
   void process(AudioBufferView buffer) override;
-  void setParameter(const std::string& name, double value) override;
+  /** Sidechain-capable plugins take their first input as the main bus and every further input as a sidechain. */
+  [[nodiscard]] bool mixesInputs() const override { return capabilities_.acceptsSidechain; }
+  void processInputs(std::span<const AudioBufferView> inputs, AudioBufferView output) override;
+  [[nodiscard]] std::span<const ParameterDescriptor> parameters() const override { return kParameters; }
+  void setParameter(ParamId id, double value) override;
+  /**
+   * Audio effects (not instruments) are idle while their input is silent, once their tail has rung out
+   * and no queued event falls due.
+   */
+  [[nodiscard]] bool isIdle(std::size_t frameCount) const override;
+  [[nodiscard]] std::uint64_t tailFrames() const override;
+  void skipSilence(std::size_t frameCount) override;
+  /** Offline, an anticipative plugin waits for its worker instead of playing late frames as silence. */
+  void setOfflineRendering(bool offline) override { offline_ = offline; }
+  /** Sizes the anticipation rings to the graph's limits, restarting the worker if they change. */
+  void setRenderLimits(std::size_t maxChannels, std::size_t maxFrames) override;
+
+  /**
+   * Queue a MIDI message or plugin parameter change for render frame `frame`, counted on the node's
+   * own timeline (frames rendered or skipped since the last reset). The event reaches the host in the
+   * request of the block containing that frame, with `sampleOffset` set accordingly; late events play
+   * at the start of the next block. Single producer, typically the control thread.
+   * @returns `false` if the queue is full.
+   */
+  bool queueEvent(std::uint64_t frame, const PluginEvent& event) { return inbox_.push({frame, event}); }
+
+  /** Events the host emitted during the last rendered block. Render thread only. */
+  [[nodiscard]] const PluginEventList& outputEvents() const noexcept { return outputEvents_; }
+
+  /**
+   * Batched rendering, render thread only. After `deferRender`, the next `process` prepares its host
+   * request without calling the host; `takeDeferredRequest` then hands it out (or returns null when the
+   * block needed no host call) and clears the deferral, and `finishRender` applies the host's result.
+   */
+  void deferRender() noexcept { deferRender_ = true; }
+  [[nodiscard]] PluginRenderRequest* takeDeferredRequest() noexcept;
+  void finishRender(const std::optional<PluginRenderResult>& result) noexcept;
 
-  void setHostInstanceId(std::string hostInstanceId);
+  /** Longest host instance id a node can bind; ids are stored inline for the render thread. */
+  static constexpr std::size_t kMaxHostInstanceIdLength = 128;
+
+  /**
+   * Bind the node to `hostInstanceId` and resolve its handle through `PluginHostBridge::Resolve`.
+   * Control threads only; the render thread adopts the new binding at its next block, and requests
+   * never pair an id with another binding's handle. `prepare` resolves the current id again.
+   * @returns `false`, keeping the current binding, if the id exceeds `kMaxHostInstanceIdLength`.
+   */
+  bool setHostInstanceId(std::string hostInstanceId);
   [[nodiscard]] const std::string& hostInstanceId() const noexcept { return hostInstanceId_; }
+  /** Handle resolved by the last binding, as seen from the control thread. */
+  [[nodiscard]] PluginInstanceHandle instanceHandle() const noexcept { return instanceHandle_; }
+
+  /**
+   * Anticipation rings hold this many channels and frames per block until the node joins a graph,
+   * which sizes them to its own limits through `setRenderLimits`. Outside a graph, larger blocks play
+   * as silence and count as underruns. The frame count is also the default anticipation latency.
+   */
+  static constexpr std::size_t kDefaultAnticipativeFrames = 1024;
+  static constexpr std::size_t kDefaultAnticipativeChannels = 4;
+
+  /**
+   * Opt-in anticipative mode for heavy plugins. The host is no longer called inside the audio callback:
+   * `process` hands its input and events to a dedicated worker thread through lock-free rings and plays
+   * back what the worker rendered `latencyFrames` earlier, so the plugin gets that much time per block
+   * for a fixed, reported latency. `latencyFrames` must cover the largest block the graph renders;
+   * twice the hardware buffer leaves the worker a full buffer of slack. Frames the worker has not
+   * finished in time play as silence and count as `anticipationUnderruns`. Sidechain inputs, batching
+   * and host MIDI output are not available in this mode. Control thread only, before the node renders.
+   */
+  void enableAnticipation(std::uint32_t latencyFrames);
+  [[nodiscard]] bool anticipative() const noexcept { return anticipation_ != nullptr; }
+  /**
+   * Frames by which the node delays its input: the anticipation latency plus the plugin's own, as
+   * declared through `latencyframes` or reported in render results. A bypassed plugin passes its input
+   * through dry and reports the anticipation latency only.
+   */
+  [[nodiscard]] std::uint32_t latencyFrames() const noexcept override;
+  [[nodiscard]] std::uint32_t maxLatencyFrames() const noexcept override;
+  [[nodiscard]] std::uint64_t anticipationUnderruns() const noexcept;
 
   void setBypassed(bool bypassed) noexcept;
   [[nodiscard]] bool bypassed() const noexcept { return bypassed_.load(std::memory_order_relaxed); }
@@ -26,18 +126,73 @@ class PluginNode final : public DSPNode {
   [[nodiscard]] const PluginBusCapabilities& capabilities() const noexcept { return capabilities_; }
 
  private:
-  void logHostUnavailable() const noexcept;
-  void logRenderFailure() const noexcept;
+  struct TimedEvent {
+    std::uint64_t frame = 0;
+    PluginEvent event{};
+  };
+  static constexpr std::size_t kMaxQueuedEvents = PluginEventList::kCapacity;
+
+  // Host instance id and the handle resolved for it, stored inline so adopting one copies nothing.
+  struct Binding {
+    std::array<char, kMaxHostInstanceIdLength> id{};
+    std::size_t length = 0;
+    PluginInstanceHandle handle = kInvalidPluginInstanceHandle;
+    std::uint64_t generation = 0;
+  };
+  static constexpr std::uint8_t kFreshBinding = 4;
+  struct Anticipation;
+
+  void bind();
+  const Binding& adoptBinding() noexcept;
+  void render(AudioBufferView buffer, std::span<const AudioBufferView> sidechains);
+  void startAnticipation(std::uint32_t latencyFrames);
+  void stopAnticipation() noexcept;
+  void renderAnticipated(AudioBufferView buffer) noexcept;
+  void runAnticipationWorker();
+  void drainInbox() noexcept;
+  void collectEvents(std::uint64_t blockStart, std::size_t frameCount) noexcept;
+  // Shared by the render thread and the anticipation worker, so the id comes from the caller's request.
+  void applyRenderResult(const std::optional<PluginRenderResult>& result, std::string_view instanceId) noexcept;
+  void logHostUnavailable(std::string_view instanceId) const noexcept;
+  void logRenderFailure(std::string_view instanceId) const noexcept;
   void resetFailureFlags() noexcept;
 
   static bool truthy(double value) noexcept;
-  static std::string toLower(std::string value);
 
+  // Control-thread view of the binding.
   std::string hostInstanceId_;
+  PluginInstanceHandle instanceHandle_ = kInvalidPluginInstanceHandle;
+  // Latest-wins triple buffer: the control thread fills bindings_[writeBinding_] and swaps it into
+  // sharedBinding_ tagged kFreshBinding; the render thread swaps a fresh slot out into readBinding_.
+  std::array<Binding, 3> bindings_{};
+  std::atomic<std::uint8_t> sharedBinding_{1};
+  std::uint8_t writeBinding_ = 2;
+  std::uint8_t readBinding_ = 0;
+  // Render thread: bindings adopted so far, so the anticipation worker can follow rebinding.
+  std::uint32_t adoptedBindings_ = 0;
   PluginBusCapabilities capabilities_;
   std::atomic<bool> bypassed_{false};
+  // Also updated by the anticipation worker from host results.
+  std::atomic<std::uint64_t> tailFrames_{kInfiniteTail};
+  std::atomic<std::uint32_t> pluginLatency_{0};
+  // Render-thread timeline that queued event frames are measured against.
+  std::uint64_t processedFrames_ = 0;
+  SpscQueue<TimedEvent, kMaxQueuedEvents> inbox_{};
+  // Drained events not yet due, ordered by frame and, within a frame, by arrival.
+  std::array<TimedEvent, kMaxQueuedEvents> pending_{};
+  std::size_t pendingCount_ = 0;
+  PluginEventList inputEvents_;
+  PluginEventList outputEvents_;
+  PluginRenderRequest request_{{}, AudioBufferView(nullptr, 0, 0)};
+  bool deferRender_ = false;
+  bool offline_ = false;
+  bool requestPending_ = false;
   mutable std::atomic<bool> hostUnavailableLogged_{false};
   mutable std::atomic<bool> renderFailureLogged_{false};
+  // Limits from the owning graph; the anticipation rings are sized to them.
+  std::size_t maxChannels_ = kDefaultAnticipativeChannels;
+  std::size_t maxFrames_ = kDefaultAnticipativeFrames;
+  std::unique_ptr<Anticipation> anticipation_;
 };
 
 }  // namespace daft::audio
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+
+namespace daft::audio {
+
+/**
+ * Realtime-safety checks for debug and test builds.
+ *
+ * `ScopedRealtimeThread` marks the calling thread as rendering under a deadline. SceneGraph puts one
+ * around every realtime `render` call, and RenderWorkerPool workers carry the mark of the block they
+ * help with. While a thread is marked, any heap allocation, mutex lock or log call it makes is reported
+ * as a violation: by default a message and a stack trace go to stderr and `RealtimeViolationCount` goes
+ * up, and the test runner fails if it is not zero at exit.
+ *
+ * The checks are compiled in when `DAFT_AUDIO_ENGINE_REALTIME_CHECKS` is defined (the CMake option of
+ * the same name, on by default in test builds). Allocations are trapped by replacing the global
+ * `operator new`, plus `malloc` and `pthread_mutex_lock` on glibc. Logging goes through
+ * `CheckRealtimeSafe` at each call site. Sanitizer builds keep the explicit checks but skip the
+ * interposers, which would clash with the sanitizer's own. Without the define every function here is
+ * an inline no-op.
+ */
+#if defined(DAFT_AUDIO_ENGINE_REALTIME_CHECKS)
+
+class ScopedRealtimeThread {
+ public:
+  explicit ScopedRealtimeThread(bool active = true) noexcept;
+  ~ScopedRealtimeThread();
+
+  ScopedRealtimeThread(const ScopedRealtimeThread&) = delete;
+  ScopedRealtimeThread& operator=(const ScopedRealtimeThread&) = delete;
+
+ private:
+  bool active_;
+};
+
+/** Suspends the checks on this thread, for code that knowingly leaves the realtime contract (tests). */
+class ScopedRealtimeExemption {
+ public:
+  ScopedRealtimeExemption() noexcept;
+  ~ScopedRealtimeExemption();
+
+  ScopedRealtimeExemption(const ScopedRealtimeExemption&) = delete;
+  ScopedRealtimeExemption& operator=(const ScopedRealtimeExemption&) = delete;
+};
+
+/** Called for each violation on the offending thread, with the checks suspended. */
+using RealtimeViolationHandler = void (*)(const char* operation) noexcept;
+
+[[nodiscard]] bool IsRealtimeThread() noexcept;
+/** Reports `operation` as a violation if the calling thread is marked and not exempt. */
+void CheckRealtimeSafe(const char* operation) noexcept;
+/** Violations reported by the default handler, which also prints them with a stack trace. */
+[[nodiscard]] std::uint64_t RealtimeViolationCount() noexcept;
+/** Replaces the violation handler (nullptr restores the default) and returns the previous one. */
+RealtimeViolationHandler SetRealtimeViolationHandler(RealtimeViolationHandler handler) noexcept;
+/** Whether heap allocations are trapped; false in sanitizer builds. Locks are trapped on glibc only. */
+[[nodiscard]] bool RealtimeAllocationChecksInstalled() noexcept;
+[[nodiscard]] bool RealtimeLockChecksInstalled() noexcept;
+
+#else
+
+class ScopedRealtimeThread {
+ public:
+  explicit ScopedRealtimeThread(bool = true) noexcept {}
+  ScopedRealtimeThread(const ScopedRealtimeThread&) = delete;
+  ScopedRealtimeThread& operator=(const ScopedRealtimeThread&) = delete;
+};
+
+class ScopedRealtimeExemption {
+ public:
+  ScopedRealtimeExemption() noexcept {}
+  ScopedRealtimeExemption(const ScopedRealtimeExemption&) = delete;
+  ScopedRealtimeExemption& operator=(const ScopedRealtimeExemption&) = delete;
+};
+
+using RealtimeViolationHandler = void (*)(const char* operation) noexcept;
+
+[[nodiscard]] inline bool IsRealtimeThread() noexcept { return false; }
+inline void CheckRealtimeSafe(const char*) noexcept {}
+[[nodiscard]] inline std::uint64_t RealtimeViolationCount() noexcept { return 0; }
+inline RealtimeViolationHandler SetRealtimeViolationHandler(RealtimeViolationHandler) noexcept { return nullptr; }
+[[nodiscard]] inline bool RealtimeAllocationChecksInstalled() noexcept { return false; }
+[[nodiscard]] inline bool RealtimeLockChecksInstalled() noexcept { return false; }
+
+#endif
+
+}  // namespace daft::audio
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "audio_engine/LockFreeQueue.h"
+
+namespace daft::audio {
+
+/**
+ * Log-bucketed histogram of non-negative integer samples (nanoseconds, parts per million, ...).
+ *
+ * Values below 8 get exact buckets; above that every power of two is split into 8 buckets, so a
+ * percentile is reported within 12.5% of the true sample. Values from 2^41 up share the last bucket.
+ * Recording is a handful of integer operations and never allocates.
+ */
+class LogHistogram {
+ public:
+  void record(std::uint64_t value);
+  void clear() { *this = LogHistogram{}; }
+
+  [[nodiscard]] std::uint64_t count() const { return count_; }
+  [[nodiscard]] std::uint64_t max() const { return max_; }
+  [[nodiscard]] double mean() const { return count_ == 0 ? 0.0 : static_cast<double>(sum_) / count_; }
+  /** Upper bound of the bucket holding the `fraction` quantile (0..1), capped at the largest sample. */
+  [[nodiscard]] std::uint64_t percentile(double fraction) const;
+
+ private:
+  static constexpr std::size_t kSubBuckets = 8;
+  static constexpr std::size_t kMaxExponent = 40;
+  static constexpr std::size_t kBucketCount = (kMaxExponent - 1) * kSubBuckets;
+
+  static std::size_t bucketOf(std::uint64_t value);
+  static std::uint64_t bucketUpperBound(std::size_t bucket);
+
+  std::array<std::uint64_t, kBucketCount> buckets_{};
+  std::uint64_t count_ = 0;
+  std::uint64_t sum_ = 0;
+  std::uint64_t max_ = 0;
+};
+
+/**
+ * Opt-in render profiler fed by the audio thread.
+ *
+ * The audio thread appends fixed-size records (one per block and one per plan step) to a lock-free
+ * SPSC ring and never blocks, allocates or formats; when the ring is full the record is counted as
+ * dropped instead. A collector thread drains the ring every `interval` into histograms: block render
+ * time, DSP load (render time over the block's duration), callback jitter (how far the interval
+ * between two callbacks strays from the previous block's duration) and per-node render time. Blocks
+ * whose render time exceeds their duration count as overload xruns; render failures reported through
+ * `recordRenderError` count separately.
+ *
+ * A SceneGraph only creates a profiler while profiling is enabled, and its plans check for it once per
+ * block and once per step, so a graph without a profiler reads no clock at all.
+ */
+class RenderProfiler {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using NodeHandle = std::uint32_t;
+
+  struct Summary {
+    std::uint64_t count = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+  };
+
+  struct NodeProfile {
+    std::string id;
+    /** Time spent rendering the node per block, in microseconds. */
+    Summary renderMicros;
+  };
+
+  struct Report {
+    bool enabled = false;
+    std::uint64_t blocks = 0;
+    Summary renderMicros;
+    /** Render time as a fraction of the block's duration; above 1 the deadline was missed. */
+    Summary dspLoad;
+    Summary callbackJitterMicros;
+    std::uint64_t overloads = 0;
+    std::uint64_t renderErrors = 0;
+    std::uint64_t droppedRecords = 0;
+    std::vector<NodeProfile> nodes;
+  };
+
+  /** Identifies a live node for `report`; stats recorded under another generation are not reported. */
+  struct NodeLabel {
+    std::string_view id;
+    NodeHandle handle = 0;
+    std::uint32_t generation = 0;
+  };
+
+  explicit RenderProfiler(double sampleRate, std::chrono::milliseconds interval = std::chrono::milliseconds(20));
+  ~RenderProfiler();
+
+  RenderProfiler(const RenderProfiler&) = delete;
+  RenderProfiler& operator=(const RenderProfiler&) = delete;
+
+  // Audio thread only.
+  void recordBlock(Clock::time_point start, Clock::time_point end, std::uint32_t frames);
+  void recordNode(NodeHandle handle, std::uint32_t generation, std::uint64_t nanos);
+  void recordRenderError();
+
+  /** Drain pending records and summarise everything recorded so far; `nodes` come back slowest first. */
+  [[nodiscard]] Report report(std::span<const NodeLabel> nodes);
+
+  static constexpr std::size_t kRingCapacity = 8192;
+
+ private:
+  enum class RecordKind : std::uint8_t { kBlock, kNode, kRenderError };
+
+  struct Record {
+    RecordKind kind = RecordKind::kBlock;
+    bool hasJitter = false;
+    std::uint32_t handle = 0;
+    std::uint32_t generation = 0;
+    std::uint32_t frames = 0;
+    std::uint64_t nanos = 0;
+    // Blocks only: how far this callback strayed from the previous block's duration.
+    std::uint64_t jitterNanos = 0;
+  };
+
+  struct NodeStats {
+    std::uint32_t generation = 0;
+    LogHistogram nanos;
+  };
+
+  void push(const Record& record);
+  void drain();
+  void run();
+
+  double sampleRate_;
+  std::chrono::milliseconds interval_;
+  SpscQueue<Record, kRingCapacity> ring_;
+  std::atomic<std::uint64_t> dropped_{0};
+  // Audio-thread state.
+  Clock::time_point lastBlockStart_{};
+  std::uint32_t lastBlockFrames_ = 0;
+  // Collector state, guarded by mutex_ (report() drains too).
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+  LogHistogram blockNanos_;
+  LogHistogram loadPpm_;
+  LogHistogram jitterNanos_;
+  std::uint64_t overloads_ = 0;
+  std::uint64_t renderErrors_ = 0;
+  std::vector<NodeStats> nodes_;
+  std::thread thread_;
+};
+
+}  // namespace daft::audio
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace daft::audio {
+
+/**
+ * Fixed pool of realtime render workers used by the parallel SceneGraph render mode.
+ *
+ * A job is a sequence of dependency levels: tasks inside a level may run concurrently, and a level
+ * only opens once every task of the previous level has finished. The calling (audio) thread joins the
+ * pool for the duration of `run`, so a pool of N workers renders with N + 1 participants. Each level is
+ * split into one contiguous chunk per participant; participants drain their own chunk first and then
+ * steal from the others by claiming indices off the shared cursors, so scheduling never takes a lock
+ * or allocates. Workers are pinned to cores and request realtime priority where the platform allows;
+ * between blocks they sleep on an atomic wait instead of spinning.
+ */
+class RenderWorkerPool {
+ public:
+  struct Job {
+    /** `levelCount + 1` strictly ascending offsets; level `l` owns tasks `[levelOffsets[l], levelOffsets[l + 1])`. */
+    const std::uint32_t* levelOffsets = nullptr;
+    std::size_t levelCount = 0;
+    void (*runTask)(void* context, std::uint32_t task) = nullptr;
+    /** Invoked exactly once per level, by whichever participant completes its last task. */
+    void (*finishLevel)(void* context, std::size_t level) = nullptr;
+    void* context = nullptr;
+  };
+
+  explicit RenderWorkerPool(std::size_t workerCount);
+  ~RenderWorkerPool();
+
+  RenderWorkerPool(const RenderWorkerPool&) = delete;
+  RenderWorkerPool& operator=(const RenderWorkerPool&) = delete;
+
+  /**
+   * Execute a job on the pool and the calling thread; returns once every level has finished. Must only
+   * be called from one thread at a time (the audio thread).
+   * @returns `false` if any task or level callback threw; the remaining tasks still run.
+   */
+  bool run(const Job& job);
+
+  [[nodiscard]] std::size_t workerCount() const { return workers_.size(); }
+
+ private:
+  struct alignas(64) Cursor {
+    // Packed `end << 32 | next` so a claim can never pair one level's index with another level's end.
+    std::atomic<std::uint64_t> range{0};
+  };
+
+  void workerLoop(std::size_t participant);
+  bool runOne(std::size_t participant);
+  void openLevel(std::size_t level);
+  void completeTask();
+
+  Job job_{};
+  // Whether run() was called from a marked realtime thread; a late worker may read it during the next run().
+  std::atomic<bool> jobIsRealtime_{false};
+  std::vector<Cursor> cursors_;
+  std::vector<std::thread> workers_;
+  alignas(64) std::atomic<std::uint32_t> remaining_{0};
+  std::atomic<std::size_t> currentLevel_{0};
+  std::atomic<bool> blockDone_{true};
+  std::atomic<bool> failed_{false};
+  alignas(64) std::atomic<std::uint32_t> epoch_{0};
+  std::atomic<bool> stopping_{false};
+};
+
+}  // namespace daft::audio
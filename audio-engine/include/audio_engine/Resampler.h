@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace daft::audio {
+
+/** Interpolator used when a clip plays at a rate other than 1:1. */
+enum class ResampleQuality : std::uint8_t {
+  kLinear,  // two-point interpolation; cheap, audibly dull and aliasing on large ratio changes
+  kSinc,    // 32-tap Kaiser-windowed sinc with a per-ratio anti-aliasing cutoff
+};
+
+/** Source frames an interpolator reads before the frame at floor(position). */
+constexpr std::size_t ResampleLookBehind(ResampleQuality quality) {
+  return quality == ResampleQuality::kSinc ? 15 : 0;
+}
+
+/** Source frames an interpolator reads after the frame at floor(position). */
+constexpr std::size_t ResampleLookAhead(ResampleQuality quality) { return quality == ResampleQuality::kSinc ? 16 : 1; }
+
+/**
+ * Render `count` samples of `source` read at `position`, `position + step`, ... (in source frames).
+ * `source` must be readable from `ResampleLookBehind` frames before floor(position) to
+ * `ResampleLookAhead` frames after the last sample read. The sinc cutoff follows `step`, so playing
+ * faster than 1:1 filters out what would otherwise alias. Realtime-safe once `PrepareResampler` ran.
+ * @returns The position of the next sample.
+ */
+double Resample(const float* source, double position, double step, float* dest, std::size_t count,
+                ResampleQuality quality);
+
+/** Build the shared polyphase tables up front, so the audio thread never does. Safe to call repeatedly. */
+void PrepareResampler();
+
+}  // namespace daft::audio
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace daft::audio {
+
+/**
+ * Storage encoding of resident clip samples. Players decode to 32-bit float while rendering, so the
+ * compact formats trade a little decode work for half the clip memory.
+ */
+enum class SampleFormat : std::uint8_t {
+  kFloat32,  // native-endian IEEE float, read in place
+  kInt16,    // signed 16-bit PCM, full scale at +/-32768
+  kFloat16,  // IEEE half precision; ~11 bits of precision with float-like headroom
+};
+
+constexpr std::size_t BytesPerSample(SampleFormat format) {
+  return format == SampleFormat::kFloat32 ? sizeof(float) : sizeof(std::uint16_t);
+}
+
+/** Parse the bridge-facing names "float32", "int16" and "float16". */
+constexpr std::optional<SampleFormat> ParseSampleFormat(std::string_view name) {
+  if (name == "float32" || name.empty()) {
+    return SampleFormat::kFloat32;
+  }
+  if (name == "int16") {
+    return SampleFormat::kInt16;
+  }
+  if (name == "float16") {
+    return SampleFormat::kFloat16;
+  }
+  return std::nullopt;
+}
+
+}  // namespace daft::audio
@@ -1,9 +1,10 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
-#include <functional>
+#include <limits>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -12,6 +13,10 @@
 
 #include "audio_engine/AudioBuffer.h"
 #include "audio_engine/DSPNode.h"
+#include "audio_engine/LockFreeQueue.h"
+#include "audio_engine/PluginNode.h"
+#include "audio_engine/RenderProfiler.h"
+#include "audio_engine/RenderWorkerPool.h"
 #include "audio_engine/Scheduler.h"
 #include "audio_engine/Clock.h"
 
@@ -19,6 +24,12 @@
    * Construct a scene graph configured for audio processing.
    * @param sampleRate The audio sample rate in Hz used for processing.
    * @param framesPerBuffer The expected number of frames per render buffer.
+   * @param maxChannels Most output channels the graph renders; node buffers hold exactly this many, and
+   *   output channels beyond it are left silent.
+   * @param maxFramesPerBuffer Longest sub-block the graph renders at once, raised to `framesPerBuffer`
+   *   if smaller. Node buffers hold this many frames; longer blocks are rendered in several pieces.
+   * @throws std::invalid_argument if `maxChannels` is zero or above `kChannelLimit`, or the block size
+   *   exceeds `kFrameLimit`.
    */
   
   /**
@@ -38,6 +49,7 @@
    * @param source Identifier of the source node.
    * @param destination Identifier of the destination node.
    * @returns `true` if the connection was established, `false` if the connection could not be created (e.g., nodes missing or connection invalid).
+   * A connection that closes a cycle becomes a feedback edge: its destination reads the previous block.
    */
   
   /**
@@ -46,16 +58,128 @@
    * @param destination Identifier of the destination node.
    */
   
+  /**
+   * Open a batch of graph edits. Until the matching `commit`, node and connection edits only update the
+   * control-thread graph and the audio thread keeps rendering the last published plan, so loading a
+   * whole session compiles a single plan. Batches nest; only the outermost `commit` compiles. Automation
+   * scheduled inside a batch for a node the audio thread has not seen yet is held back and queued right
+   * after that compile, so interleaving node edits with parameter events still compiles once.
+   * Control threads only.
+   */
+  
+  /**
+   * Close the innermost batch opened by `beginUpdate`. Closing the outermost batch compiles and
+   * publishes one plan if any edit was made inside it, then queues the automation held back during the
+   * batch; unmatched calls are ignored.
+   * @throws std::runtime_error if the held-back automation does not fit the scheduler queue; the plan is
+   *   published and the events that did not fit are dropped.
+   */
+  
   /**
    * Render audio by processing the graph topology and write the mixed output into the provided buffer.
+   * Called from the audio thread only; it never blocks on control-thread edits and instead picks up the
+   * most recently published render plan at the start of the block. The block is split into sub-blocks
+   * at scheduled automation frames so each event is applied on its exact sample, and wherever it would
+   * exceed `maxSupportedFramesPerBuffer`.
    * @param outputBuffer View into the destination buffer that will receive the rendered audio.
    */
   
   /**
-   * Schedule a one-time automation callback to be invoked for a node at a specific render frame.
+   * Enable or disable the parallel render mode. With a non-zero count the graph is compiled into
+   * dependency levels that a fixed pool of realtime workers renders alongside the audio thread; zero
+   * restores the serial in-place render path. Called from control threads only.
+   * @param workerCount Number of worker threads to start in addition to the audio thread.
+   */
+  
+  /**
+   * Return the number of render workers used by the parallel render mode.
+   * @returns Zero when the graph renders serially on the audio thread.
+   */
+  
+  /**
+   * Turn render profiling on or off (see `RenderProfiler`). Enabling starts from empty histograms and
+   * republishes the plan so the audio thread times every block and node; disabling drops the profiler
+   * and its history, after which rendering reads no clock. Control threads only.
+   */
+  
+  /**
+   * Summarise the profile recorded since profiling was last enabled: block render time, DSP load,
+   * callback jitter, overloads and render errors, plus render time for every node still in the graph,
+   * slowest first. Control threads only.
+   * @returns A report with `enabled == false` while profiling is off.
+   */
+  
+  /**
+   * Count a block that failed to render (the caller caught an exception from `render`) in the profile.
+   * Audio thread only; does nothing while profiling is off.
+   */
+  
+  /**
+   * Switch every node, including nodes added later, between realtime and offline rendering (see
+   * `DSPNode::setOfflineRendering`). Control threads only, while no thread is rendering the graph.
+   */
+  
+  /**
+   * Rewind the render clock to frame zero, reset every node and publish a fresh plan, so rendering
+   * starts over from the top of the session with no tails, compensation history or silence state
+   * carried over. Scheduled automation stays queued. Control threads only, while no thread is
+   * rendering the graph.
+   */
+  
+  /**
+   * Free render plans that the audio thread has finished with. Called from control threads only; every
+   * graph mutation also reclaims as a side effect.
+   */
+  
+  /**
+   * Schedule a parameter change for a node at a specific render frame. The queued event is plain data,
+   * so dispatching it never allocates. Events for a node that is removed (or whose handle is recycled)
+   * before they fall due are dropped.
+   * @param nodeId Identifier of the node to automate.
+   * @param parameter Parameter id, typically resolved once through `findParameter`.
+   * @param frame Absolute render frame at which the change should be applied.
+   * @param value Value to apply.
+   * @throws std::runtime_error if the node does not exist or the scheduler queue is full.
+   * @throws std::invalid_argument if the parameter is control-only; set it through `setParameter`.
+   */
+  
+  /**
+   * Set a node parameter as soon as possible. A node added since the last published plan is still owned
+   * by the control thread, so the value is applied to it directly without using the scheduler; a
+   * session snapshot can therefore set any number of parameters on the nodes it creates. Nodes the
+   * audio thread may be rendering get an event due at the start of the next block instead. Control-only
+   * parameters (`ParameterDescriptor::controlOnly`) are always applied directly.
+   * @param nodeId Identifier of the node.
+   * @param parameter Parameter id, typically resolved once through `findParameter`.
+   * @param value Value to apply.
+   * @throws std::runtime_error if the node does not exist or the scheduler queue is full.
+   */
+  
+  /**
+   * Schedule a ramp for a node parameter: starting at `frame`, the node interpolates per sample from
+   * its current value to `target` over `durationFrames`. One ramp replaces a dense stream of step
+   * events for fades and crossfades. Parameters without a smoothed implementation step to `target`.
    * @param nodeId Identifier of the node to automate.
-   * @param cb Callback invoked with the target node to perform parameter updates.
-   * @param frame Absolute render frame at which the callback should execute.
+   * @param parameter Parameter id, typically resolved once through `findParameter`.
+   * @param frame Absolute render frame at which the ramp starts.
+   * @param target Value reached at the end of the ramp.
+   * @param durationFrames Ramp length in frames; zero applies `target` as a step.
+   * @param shape Linear or exponential interpolation.
+   * @throws std::runtime_error if the node does not exist or the scheduler queue is full.
+   * @throws std::invalid_argument if the parameter is control-only; set it through `setParameter`.
+   */
+  
+  /**
+   * Resolve a parameter name against a node's descriptor table. Control threads only.
+   * @param nodeId Identifier of the node.
+   * @param name Case-insensitive parameter name.
+   * @returns The parameter id, or `kInvalidParamId` if the node or parameter does not exist.
+   */
+  
+  /**
+   * Resolve a node identifier to the integer handle used inside compiled render plans.
+   * @param id Identifier of the node.
+   * @returns The node handle, or `kInvalidNodeHandle` if no such node exists.
    */
   
   /**
@@ -63,78 +187,300 @@
    * @returns The sample rate in Hz.
    */
   
+  /**
+   * Return the number of pooled scratch buffers used by the most recently compiled render plan.
+   * @returns Pool size after buffer liveness analysis (scales with graph width, not node count).
+   */
+  
   /**
    * Identifier used for the graph's output bus.
    */
   
   /**
-   * Return the maximum number of supported audio channels.
-   * @returns The compile-time upper limit on supported channels.
+   * Return the maximum number of audio channels the graph renders.
+   * @returns The channel limit the graph was constructed with.
    */
   
   /**
-   * Return the maximum supported frames per buffer.
-   * @returns The compile-time upper limit on frames per buffer.
+   * Return the longest block the graph renders in one piece.
+   * @returns The frame limit the graph was constructed with.
    */
   namespace daft::audio {
 
 class SceneGraph {
  public:
-  explicit SceneGraph(double sampleRate, std::uint32_t framesPerBuffer);
+  using NodeHandle = std::uint32_t;
+  static constexpr NodeHandle kInvalidNodeHandle = std::numeric_limits<NodeHandle>::max();
+
+  static constexpr std::size_t kDefaultMaxChannels = 2;
+  static constexpr std::size_t kDefaultMaxFrames = 1024;
+  // Ceilings for the construction limits: enough for third-order ambisonics and long offline blocks.
+  static constexpr std::size_t kChannelLimit = 64;
+  static constexpr std::size_t kFrameLimit = 16384;
+
+  explicit SceneGraph(double sampleRate, std::uint32_t framesPerBuffer, std::size_t maxChannels = kDefaultMaxChannels,
+                      std::size_t maxFramesPerBuffer = kDefaultMaxFrames);
+  ~SceneGraph();
+
+  SceneGraph(const SceneGraph&) = delete;
+  SceneGraph& operator=(const SceneGraph&) = delete;
 
   bool addNode(const std::string& id, std::unique_ptr<DSPNode> node);
   void removeNode(const std::string& id);
   bool connect(const std::string& source, const std::string& destination);
   void disconnect(const std::string& source, const std::string& destination);
+  void beginUpdate();
+  void commit();
 
   void render(AudioBufferView outputBuffer);
-  void scheduleAutomation(const std::string& nodeId, std::function<void(DSPNode&)> cb,
-                          std::uint64_t frame);
+  void reclaimRetiredPlans();
+  void setRenderWorkerCount(std::size_t workerCount);
+  [[nodiscard]] std::size_t renderWorkerCount() const { return workerPool_ ? workerPool_->workerCount() : 0; }
+  void setProfilingEnabled(bool enabled);
+  [[nodiscard]] bool profilingEnabled() const { return profiler_ != nullptr; }
+  [[nodiscard]] RenderProfiler::Report renderProfile();
+  void recordRenderError();
+  void setOfflineRendering(bool offline);
+  [[nodiscard]] bool offlineRendering() const { return offline_; }
+  void resetTimeline();
+  void setParameter(const std::string& nodeId, ParamId parameter, double value);
+  void scheduleAutomation(const std::string& nodeId, ParamId parameter, std::uint64_t frame, double value);
+  void scheduleRamp(const std::string& nodeId, ParamId parameter, std::uint64_t frame, double target,
+                    std::uint32_t durationFrames, RampShape shape);
 
+  [[nodiscard]] ParamId findParameter(const std::string& nodeId, std::string_view name) const;
+  [[nodiscard]] NodeHandle findNode(const std::string& id) const;
   [[nodiscard]] double sampleRate() const { return sampleRate_; }
+  [[nodiscard]] std::size_t scratchBufferCount() const {
+    return scratchBufferCount_.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] std::size_t scratchBufferBytes() const {
+    return scratchBufferCount() * maxChannels_ * maxFrames_ * sizeof(float);
+  }
+  /**
+   * Latency of the output bus after compensation: the longest node latency sum along any path into it,
+   * refreshed by the audio thread at the start of every block. Transports subtract it to align playback.
+   */
+  [[nodiscard]] std::uint64_t outputLatencyFrames() const { return outputLatency_.load(std::memory_order_relaxed); }
+  /** Render plans compiled since construction; batching keeps this at one per committed batch. */
+  [[nodiscard]] std::uint64_t compiledPlanCount() const { return compiledPlans_; }
 
   static constexpr std::string_view kOutputBusId = "__output__";
 
-  static constexpr std::size_t maxSupportedChannels() { return kMaxChannels; }
-  static constexpr std::size_t maxSupportedFramesPerBuffer() { return kMaxFrames; }
+  [[nodiscard]] std::size_t maxSupportedChannels() const { return maxChannels_; }
+  [[nodiscard]] std::size_t maxSupportedFramesPerBuffer() const { return maxFrames_; }
+  /** Longest delay a single edge compensates; larger latency differences stay partly misaligned. */
+  static constexpr std::uint32_t maxCompensationFrames() { return kMaxCompensationFrames; }
 
  private:
-  static constexpr std::size_t kMaxChannels = 4;
-  static constexpr std::size_t kMaxFrames = 1024;
+  static constexpr std::size_t kMaxRetiredPlans = 64;
+  static constexpr std::uint32_t kMaxCompensationFrames = 8192;
+  // Marks an input without a producing step (feedback edge) or an edge without a delay line.
+  static constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
 
-  struct Connection {
-    std::string source;
-    std::string destination;
-  };
+  // Destination handle used by connections that feed kOutputBusId.
+  static constexpr NodeHandle kOutputBusHandle = kInvalidNodeHandle - 1;
 
+
+  // Planar samples for the graph's channel and frame limits, allocated when the plan is compiled so the
+  // audio thread only repoints channels. Each channel starts on its own `dsp::kBufferAlignment` line.
   struct NodeBuffer {
-    StackAudioBuffer<kMaxChannels, kMaxFrames> storage{};
-    std::array<float*, kMaxChannels> channelPointers{};
-
-    void configure(std::size_t channelCount, std::size_t frameCount) {
-      storage.setFrameCount(frameCount);
-      for (std::size_t ch = 0; ch < kMaxChannels; ++ch) {
-        channelPointers[ch] = ch < channelCount ? storage.channel(ch) : nullptr;
-      }
-    }
+    std::vector<float> storage;
+    std::vector<float*> channelPointers;
+    std::size_t stride = 0;
 
-    [[nodiscard]] AudioBufferView view(std::size_t channelCount) {
-      return AudioBufferView(channelPointers.data(), channelCount, storage.frameCount());
+    void allocate(std::size_t maxChannels, std::size_t maxFrames);
+    void configure(std::size_t channelCount);
+
+    // Sub-block renders use a prefix of the configured frames.
+    [[nodiscard]] AudioBufferView view(std::size_t channelCount, std::size_t frameCount) {
+      return AudioBufferView(channelPointers.data(), channelCount, frameCount);
     }
   };
 
+  /**
+   * Compensation delay on one edge into a join: a node, or the output bus, fed by several paths. The
+   * ring is sized when the plan is compiled for the largest delay the edge can ever need, so retuning
+   * it on the audio thread never allocates. Once its source has been silent for longer than the delay
+   * the line stops advancing: its history is all zeros, which stays valid for when the source resumes.
+   */
+  struct DelayLine {
+    std::vector<float> ring;
+    std::size_t capacity = 0;
+    std::uint32_t maxDelay = 0;
+    std::uint32_t delay = 0;
+    std::uint64_t writeFrame = 0;
+    std::uint64_t silentFrames = 0;
+    NodeBuffer output;
+
+    [[nodiscard]] bool active() const { return delay > 0; }
+    [[nodiscard]] bool flushed(bool sourceSilent) const { return sourceSilent && silentFrames >= delay; }
+    void retune(std::uint32_t frames);
+    // `dest` may alias `source`; a silent source reads as zeros.
+    void process(const AudioBufferView& source, bool sourceSilent, AudioBufferView& dest);
+  };
+
+  /**
+   * One node invocation in a compiled plan; inputs index into RenderPlan::inputBuffers. When `inPlace`
+   * is set the first input already lives in `buffer` (its last reader is this step), so the step skips
+   * clearing and summing it. Steps for nodes that mix their own inputs (`mixesInputs`) never render in
+   * place; their inputs are handed over as views in connection order. `outputDelay` names the delay
+   * line aligning the step with the other output-bus feeders, or `kNone`.
+   */
+  struct PlanStep {
+    DSPNode* node = nullptr;
+    NodeHandle handle = kInvalidNodeHandle;
+    std::uint32_t buffer = 0;
+    std::uint32_t firstInput = 0;
+    std::uint32_t inputCount = 0;
+    std::uint32_t outputDelay = kNone;
+    bool inPlace = false;
+    bool mixesInputs = false;
+    bool feedsOutput = false;
+  };
+
+  /**
+   * Immutable, index-based snapshot of the graph consumed by the audio thread. Rendering walks `steps`
+   * in order and resolves every buffer through integer indices, so the audio thread never hashes or
+   * touches node identifiers. `buffers` is a pool sized by liveness analysis: steps whose outputs are
+   * never alive at the same time share a slot, so the pool scales with graph width rather than node
+   * count. Plans share ownership of their nodes so a node removed on the control thread stays alive
+   * until every plan referencing it is reclaimed.
+   *
+   * Parallel plans additionally group `steps` into dependency levels. Steps inside a level never share
+   * a buffer or render in place, and output-bus feeders are summed once their level has finished (see
+   * `levelOutputOffsets`/`outputBuffers`), so a level's steps can run on any worker in any order.
+   * Levels holding several plugin nodes list them in `batchPlugins` (see `levelBatchOffsets`); while a
+   * batch render callback is registered their steps only prepare host requests, and the level's
+   * finisher renders them all in one `PluginHostBridge::RenderBatch` call.
+   *
+   * Latency compensation: nodes report latency through `DSPNode::latencyFrames`, and every edge into
+   * a join whose paths can differ in latency gets a delay line (`inputDelays`, `PlanStep::outputDelay`)
+   * holding the earlier paths back by the difference. `inputSteps` maps each input to the step that
+   * produced it, so the audio thread re-derives the delays in place whenever a reported latency moves.
+   */
+  // Handle-indexed view of the nodes in a plan; the generation rejects events aimed at recycled handles.
+  struct PlanNode {
+    DSPNode* node = nullptr;
+    std::uint32_t generation = 0;
+  };
+
+  struct RenderPlan {
+    std::vector<std::shared_ptr<DSPNode>> owners;
+    std::vector<PlanNode> handleNodes;
+    std::vector<NodeBuffer> buffers;
+    std::vector<PlanStep> steps;
+    std::vector<std::uint32_t> inputBuffers;
+    // Parallel to inputBuffers; refreshed per sub-block for steps that mix their own inputs.
+    std::vector<AudioBufferView> inputViews;
+    // Parallel to inputBuffers: the producing step (kNone for feedback edges) and the edge's delay line.
+    std::vector<std::uint32_t> inputSteps;
+    std::vector<std::uint32_t> inputDelays;
+    std::vector<std::uint32_t> outputSteps;
+    std::vector<DelayLine> delayLines;
+    // Steps whose node may report latency; per step, the latency last applied and the path latency.
+    std::vector<std::uint32_t> latencySteps;
+    std::vector<std::uint32_t> nodeLatencies;
+    std::vector<std::uint64_t> pathLatencies;
+    std::uint64_t outputLatency = 0;
+    bool compensated = false;
+    // Render-thread state: per-slot silence flags (a silent slot's samples are stale) and, per step,
+    // how many frames its inputs have been silent, which counts down the node's tail.
+    std::vector<std::uint8_t> silentBuffers;
+    std::vector<std::uint64_t> quietFrames;
+    std::shared_ptr<RenderWorkerPool> workers;
+    // Set while profiling; stepNanos accumulates each step's render time over the current block.
+    std::shared_ptr<RenderProfiler> profiler;
+    std::vector<std::uint64_t> stepNanos;
+    std::vector<std::uint32_t> levelOffsets;
+    std::vector<std::uint32_t> levelOutputOffsets;
+    std::vector<std::uint32_t> outputBuffers;
+    std::vector<PluginNode*> batchPlugins;
+    std::vector<std::uint32_t> levelBatchOffsets;
+    // Scratch for one level's batch, sized for the largest level.
+    std::vector<PluginNode*> batchNodes;
+    std::vector<PluginRenderRequest*> batchRequests;
+    std::vector<PluginRenderResult> batchResults;
+    std::size_t configuredChannels = 0;
+    // Clear and sum loops for the sub-block being rendered, picked by its shape.
+    const dsp::BlockKernels* kernels = nullptr;
+  };
+
   double sampleRate_;
-  std::unordered_map<std::string, std::unique_ptr<DSPNode>> nodes_;
-  std::vector<Connection> connections_;
+  std::size_t maxChannels_;
+  std::size_t maxFrames_;
+  // Control-thread graph state. Handles index nodes_; freed slots are recycled through freeHandles_.
+  std::vector<std::shared_ptr<DSPNode>> nodes_;
+  std::vector<NodeHandle> freeHandles_;
+  std::vector<std::uint32_t> generations_;
+  std::unordered_map<std::string, NodeHandle> handles_;
+  // Edges per handle in connection order, which is also the order a destination receives its inputs.
+  // Connections to the output bus are kept apart as a flag per source.
+  std::vector<std::vector<NodeHandle>> inputs_;
+  std::vector<std::vector<NodeHandle>> outputs_;
+  std::vector<bool> feedsBus_;
+  // Per handle: whether a plan holding the node has been published, after which only the audio thread
+  // may touch its parameters.
+  std::vector<bool> published_;
+  std::size_t busConnections_ = 0;
+  // Render order, maintained incrementally: every edge runs forward in it except feedback edges, which
+  // close a cycle. position_ is indexed by handle; visited_ marks nodes reached by the current search.
+  std::vector<NodeHandle> order_;
+  std::vector<std::uint32_t> position_;
+  std::vector<std::uint32_t> visited_;
+  std::uint32_t visitEpoch_ = 0;
+  // Removing edges can break the cycle behind a feedback edge; its order is retried at the next compile.
+  bool feedbackStale_ = false;
+  std::size_t updateDepth_ = 0;
+  bool planStale_ = false;
+  std::uint64_t compiledPlans_ = 0;
+  // Events scheduled inside a batch for nodes no published plan holds yet, queued after the next publish.
+  std::vector<ScheduledEvent> deferredEvents_;
+  bool offline_ = false;
   RenderClock clock_;
   RealTimeScheduler<128> scheduler_;
-  std::unordered_map<std::string, NodeBuffer> nodeBuffers_;
-  std::vector<std::string> renderOrder_;
-  std::unordered_map<std::string, std::vector<std::string>> inboundEdges_;
-  std::vector<std::string> outputSources_;
+  // Per-channel pointers into the caller's buffer for the sub-block being rendered.
+  std::vector<float*> sliceChannels_;
+
+  // Control thread -> audio thread handoff. The control thread exchanges a freshly compiled plan into
+  // pendingPlan_; the audio thread swaps it into activePlan_ and hands the previous plan back through
+  // retiredPlans_ so that it is destroyed off the realtime path.
+  std::atomic<RenderPlan*> pendingPlan_{nullptr};
+  RenderPlan* activePlan_ = nullptr;
+  SpscQueue<RenderPlan*, kMaxRetiredPlans> retiredPlans_{};
+  std::atomic<std::size_t> scratchBufferCount_{0};
+  std::atomic<std::uint64_t> outputLatency_{0};
+  // Shared with every parallel plan so the pool outlives plans still queued for reclamation.
+  std::shared_ptr<RenderWorkerPool> workerPool_;
+  // Shared with every plan compiled while profiling, for the same reason.
+  std::shared_ptr<RenderProfiler> profiler_;
+
+  struct Topology;
+  struct ParallelBlock;
 
+  void topologyChanged();
   void rebuildTopology();
-  void ensureNodeBuffers(std::size_t channelCount, std::size_t frameCount);
+  bool orderEdge(NodeHandle source, NodeHandle destination);
+  void reorderFeedbackEdges();
+  void compileSerialPlan(const Topology& topology, RenderPlan& plan);
+  void compileParallelPlan(const Topology& topology, RenderPlan& plan);
+  static void prepareCompensation(RenderPlan& plan, std::size_t maxChannels, std::size_t maxFrames);
+  static std::uint64_t updateCompensation(RenderPlan& plan);
+  static DelayLine* activeDelay(RenderPlan& plan, std::uint32_t line);
+  static void sumDelayed(const RenderPlan& plan, DelayLine& line, const AudioBufferView& source, bool sourceSilent,
+                         AudioBufferView& output);
+  static void applyEvent(const RenderPlan* plan, const ScheduledEvent& event);
+  static void renderPlan(RenderPlan& plan, AudioBufferView& outputBuffer);
+  static void renderStep(RenderPlan& plan, const PlanStep& step, AudioBufferView& outputBuffer);
+  static void processStep(RenderPlan& plan, const PlanStep& step, AudioBufferView& outputBuffer);
+  static void recordProfile(RenderPlan& plan, RenderProfiler::Clock::time_point start, std::size_t frameCount);
+  static void renderParallelTask(void* context, std::uint32_t task);
+  static void finishParallelLevel(void* context, std::size_t level);
+  static void renderPluginBatch(RenderPlan& plan, std::size_t level);
+  void publishPlan(std::unique_ptr<RenderPlan> plan);
+  void flushDeferredEvents();
+  RenderPlan* acquirePlan();
+  static void ensureNodeBuffers(RenderPlan& plan, std::size_t channelCount);
 }; 
 
 }  // namespace daft::audio
\ No newline at end of file
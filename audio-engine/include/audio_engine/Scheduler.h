@@ -1,63 +1,101 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <functional>
-#include <vector>
+#include <limits>
 
 #include "audio_engine/Clock.h"
+#include "audio_engine/DSPNode.h"
+#include "audio_engine/LockFreeQueue.h"
 
 namespace daft::audio {
 
+/**
+ * Plain-data automation record; copying or dispatching an event never allocates. A non-zero
+ * `rampFrames` turns the event into a ramp that starts at `frame` and reaches `value` that many
+ * frames later.
+ */
 struct ScheduledEvent {
   std::uint64_t frame = 0;
-  std::function<void()> callback{};
+  std::uint32_t node = 0;
+  std::uint32_t generation = 0;
+  ParamId parameter = kInvalidParamId;
+  double value = 0.0;
+  std::uint32_t rampFrames = 0;
+  RampShape rampShape = RampShape::kLinear;
 };
 
 template <std::size_t MaxEvents>
 class RealTimeScheduler {
  public:
-  explicit RealTimeScheduler(RenderClock& clock) : clock_(clock) { events_.reserve(MaxEvents); }
+  explicit RealTimeScheduler(RenderClock& clock) : clock_(clock) {}
 
-  bool schedule(const ScheduledEvent& event) {
-    if (events_.size() >= MaxEvents) {
-      return false;
-    }
-    events_.push_back(event);
-    return true;
-  }
+  /**
+   * Queue an event from the control thread. Events travel through a lock-free inbox and are merged
+   * into the pending heap by the render thread, so scheduling never contends with dispatch.
+   */
+  bool schedule(const ScheduledEvent& event) { return inbox_.push(event); }
 
-  void dispatchDueEvents() {
-    if (events_.empty()) {
-      return;
+  /** Render thread: move queued events into the pending heap while capacity remains. */
+  void drainInbox() {
+    while (heapSize_ < MaxEvents) {
+      auto event = inbox_.pop();
+      if (!event) {
+        break;
+      }
+      heap_[heapSize_++] = {*event, nextSequence_++};
+      std::push_heap(heap_.begin(), heap_.begin() + heapSize_, Later{});
     }
+  }
 
+  /**
+   * Render thread: hand every pending event due at or before the current clock frame to `handler`, in
+   * frame order and in scheduling order for events sharing a frame. Costs O(k log n) for k due events.
+   */
+  template <typename Handler>
+  void dispatchDueEvents(Handler&& handler) {
     const auto now = clock_.frameTime();
-    std::sort(events_.begin(), events_.end(),
-              [](const ScheduledEvent& a, const ScheduledEvent& b) { return a.frame < b.frame; });
-
-    const auto split = std::partition_point(events_.begin(), events_.end(),
-                                            [now](const ScheduledEvent& event) {
-                                              return event.frame <= now;
-                                            });
-
-    for (auto it = events_.begin(); it != split; ++it) {
-      if (!it->callback) {
-        continue;
-      }
+    while (heapSize_ > 0 && heap_.front().event.frame <= now) {
+      std::pop_heap(heap_.begin(), heap_.begin() + heapSize_, Later{});
+      --heapSize_;
       try {
-        it->callback();
+        handler(heap_[heapSize_].event);
       } catch (...) {
         // Swallow exceptions to keep the audio thread responsive.
       }
     }
+  }
 
-    events_.erase(events_.begin(), split);
+  /**
+   * Frame of the earliest pending event, or the maximum frame value when nothing is queued. The render
+   * thread uses it to split blocks at event boundaries.
+   */
+  [[nodiscard]] std::uint64_t nextEventFrame() const {
+    return heapSize_ == 0 ? std::numeric_limits<std::uint64_t>::max() : heap_.front().event.frame;
   }
 
+  [[nodiscard]] std::size_t pendingCount() const { return heapSize_; }
+
  private:
+  struct Entry {
+    ScheduledEvent event;
+    std::uint64_t sequence = 0;
+  };
+
+  // Min-heap on (frame, sequence) expressed as the "later than" ordering std::push_heap expects.
+  struct Later {
+    bool operator()(const Entry& a, const Entry& b) const {
+      return a.event.frame != b.event.frame ? a.event.frame > b.event.frame : a.sequence > b.sequence;
+    }
+  };
+
   RenderClock& clock_;
-  std::vector<ScheduledEvent> events_{};
+  std::array<Entry, MaxEvents> heap_{};
+  std::size_t heapSize_ = 0;
+  std::uint64_t nextSequence_ = 0;
+  SpscQueue<ScheduledEvent, MaxEvents> inbox_{};
 };
 
 }  // namespace daft::audio
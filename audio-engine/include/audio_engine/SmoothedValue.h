@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace daft::audio {
+
+enum class RampShape : std::uint8_t {
+  kLinear,       // constant slope, like AudioParam.linearRampToValueAtTime
+  kExponential,  // one-pole approach, like AudioParam.setTargetAtTime; crosses zero safely
+};
+
+/**
+ * Per-sample parameter interpolator used by nodes that accept ramp events. A ramp lands exactly on its
+ * target after the requested number of frames; `next` is cheap enough to call once per frame inside
+ * `process`, and nodes can test `isRamping` to keep a constant-value fast path.
+ */
+class SmoothedValue {
+ public:
+  explicit SmoothedValue(double initial = 0.0) : current_(initial), target_(initial) {}
+
+  /** Jump to `value`, cancelling any ramp in flight. */
+  void setValue(double value) {
+    current_ = value;
+    target_ = value;
+    remaining_ = 0;
+  }
+
+  /** Start a ramp from the current value to `target` over `frames` samples (0 jumps immediately). */
+  void rampTo(double target, std::uint32_t frames, RampShape shape) {
+    if (frames == 0) {
+      setValue(target);
+      return;
+    }
+    target_ = target;
+    remaining_ = frames;
+    shape_ = shape;
+    if (shape == RampShape::kLinear) {
+      step_ = (target - current_) / static_cast<double>(frames);
+    } else {
+      // Time constant chosen so the residual error is ~0.1% when the ramp snaps to its target.
+      step_ = 1.0 - std::exp(-kExponentialTimeConstants / static_cast<double>(frames));
+    }
+  }
+
+  /** Advance one sample and return the value to apply to it. */
+  double next() {
+    if (remaining_ == 0) {
+      return current_;
+    }
+    if (--remaining_ == 0) {
+      current_ = target_;
+    } else if (shape_ == RampShape::kLinear) {
+      current_ += step_;
+    } else {
+      current_ += (target_ - current_) * step_;
+    }
+    return current_;
+  }
+
+  /** Write the next `count` per-sample values into `gains`, e.g. as an envelope for `dsp::multiply`. */
+  void fill(float* gains, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      gains[i] = static_cast<float>(next());
+    }
+  }
+
+  /** Advance `frames` samples without producing values, e.g. when a node renders silence. */
+  void skip(std::size_t frames) {
+    if (remaining_ == 0 || frames == 0) {
+      return;
+    }
+    if (frames >= remaining_) {
+      setValue(target_);
+      return;
+    }
+    remaining_ -= static_cast<std::uint32_t>(frames);
+    if (shape_ == RampShape::kLinear) {
+      current_ += step_ * static_cast<double>(frames);
+    } else {
+      current_ = target_ + (current_ - target_) * std::pow(1.0 - step_, static_cast<double>(frames));
+    }
+  }
+
+  [[nodiscard]] bool isRamping() const { return remaining_ != 0; }
+  [[nodiscard]] double current() const { return current_; }
+  [[nodiscard]] double target() const { return target_; }
+
+ private:
+  static constexpr double kExponentialTimeConstants = 6.9;
+
+  double current_;
+  double target_;
+  double step_ = 0.0;
+  std::uint32_t remaining_ = 0;
+  RampShape shape_ = RampShape::kLinear;
+};
+
+}  // namespace daft::audio
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "audio_engine/DSPKernels.h"
+#include "audio_engine/DSPNode.h"
+
+namespace daft::audio {
+
+/**
+ * Polyphonic voice container. A pool of voices fixed at construction is started and released on the
+ * audio thread by `noteon` and `noteoff` parameter events, which the graph applies sample-accurately, so
+ * playing notes never adds nodes to or removes them from the graph. With a clip buffer every voice plays
+ * the clip transposed from `rootnote` (drum pads, sampler keyboards); without one each voice is a
+ * band-limited oscillator of the node's `waveform`. A note arriving while every voice sounds steals the
+ * oldest released voice, or failing that the oldest voice, which restarts from its current level.
+ *
+ * Voice state is kept as structure-of-arrays. Every 64 frames the sounding voices are packed into a
+ * batch, and oscillator batches render through `dsp::mixOscillators` one register of voices at a time.
+ */
+class VoicePoolNode final : public DSPNode {
+ public:
+  enum Parameter : ParamId { kNoteOn, kNoteOff, kAllNotesOff, kWaveform, kAttack, kRelease, kGain, kRootNote };
+  static constexpr std::array<ParameterDescriptor, 8> kParameters{{
+      // note * 128 + velocity for a MIDI note and velocity (1-127); velocity 0 releases the note instead.
+      {kNoteOn, "noteon", 0.0, 16383.0, 0.0, ParameterSmoothing::kNone},
+      {kNoteOff, "noteoff", 0.0, 127.0, 0.0, ParameterSmoothing::kNone},
+      // Any value releases every sounding voice.
+      {kAllNotesOff, "allnotesoff", 0.0, 1.0, 0.0, ParameterSmoothing::kNone},
+      // Oscillator voices only: 0 = sine, 1 = saw, 2 = square, 3 = triangle.
+      {kWaveform, "waveform", 0.0, 3.0, 0.0, ParameterSmoothing::kNone},
+      // Linear envelope ramps in seconds. An attack of 0 starts at full level.
+      {kAttack, "attack", 0.0, 10.0, 0.002, ParameterSmoothing::kNone},
+      {kRelease, "release", 0.0, 10.0, 0.05, ParameterSmoothing::kNone},
+      {kGain, "gain", 0.0, 16.0, 1.0, ParameterSmoothing::kLinear},
+      // Clip voices only: the note that plays the clip at its recorded pitch.
+      {kRootNote, "rootnote", 0.0, 127.0, 60.0, ParameterSmoothing::kNone},
+  }};
+  static constexpr std::size_t kMaxVoices = 64;
+
+  /** `voiceCount` is clamped to [1, kMaxVoices]. */
+  explicit VoicePoolNode(std::size_t voiceCount);
+
+  using DSPNode::setParameter;
+  void prepare(double sampleRate) override;
+  /** Silences every voice at once. */
+  void reset() override;
+  void process(AudioBufferView buffer) override;
+  [[nodiscard]] std::span<const ParameterDescriptor> parameters() const override { return kParameters; }
+  void setParameter(ParamId id, double value) override;
+  /** Idle while no voice sounds; a note-on event arrives before the slice it starts in is checked. */
+  [[nodiscard]] bool isIdle(std::size_t) const override { return activeVoices_ == 0; }
+
+  /**
+   * Play resident clip `data` from every voice instead of the oscillator. Call from control threads before
+   * the node is added to a graph; an empty clip switches back to oscillator voices.
+   */
+  void setClipBuffer(ClipPlayerNode::ClipBufferData data);
+
+  [[nodiscard]] std::size_t voiceCount() const noexcept { return voiceCount_; }
+  [[nodiscard]] std::size_t activeVoiceCount() const noexcept { return activeVoices_; }
+  /** Notes that had to take over a sounding voice since construction. */
+  [[nodiscard]] std::uint64_t stolenVoiceCount() const noexcept { return stolenVoices_; }
+
+ private:
+  static constexpr std::size_t kChunkFrames = 64;
+  // Source frames per output frame for clip voices are clamped to this, three octaves above the clip's
+  // own pitch at matching sample rates, which bounds the source span one chunk reads.
+  static constexpr double kMaxSampleStep = 8.0;
+  static constexpr std::size_t kSourceFrames = static_cast<std::size_t>(kChunkFrames * kMaxSampleStep) + 2;
+  static constexpr std::int16_t kFreeVoice = -1;
+
+  void noteOn(int note, float velocity);
+  void noteOff(int note);
+  void releaseAll();
+  /** A free voice, else the oldest released one, else the oldest one. */
+  std::size_t allocateVoice();
+  void freeVoice(std::size_t voice);
+  /** Source frames (clip voices) or cycles (oscillator voices) per output frame for `note`. */
+  [[nodiscard]] double noteIncrement(int note) const;
+  /** Pack the sounding voices and their gain ramps over the next `frames` frames into the batch. */
+  void packBatch(std::size_t frames);
+  /** Render the batch into `frames` frames of `buffer` from `offset`, which start out silent. */
+  void renderOscillatorBatch(AudioBufferView& buffer, std::size_t offset, std::size_t frames);
+  void renderClipBatch(AudioBufferView& buffer, std::size_t offset, std::size_t frames);
+
+  std::size_t voiceCount_;
+
+  // Voice state, structure-of-arrays over the pool.
+  std::array<std::int16_t, kMaxVoices> notes_{};  // kFreeVoice when silent
+  std::array<std::uint64_t, kMaxVoices> ages_{};
+  std::array<float, kMaxVoices> velocities_{};
+  std::array<float, kMaxVoices> levels_{};
+  std::array<float, kMaxVoices> levelSteps_{};  // per frame; negative once released
+  std::array<bool, kMaxVoices> released_{};
+  std::array<double, kMaxVoices> positions_{};   // oscillator phase in cycles, or clip source frame
+  std::array<double, kMaxVoices> increments_{};
+
+  // The batch being rendered: sounding voices packed densely.
+  std::array<std::uint8_t, kMaxVoices> batchVoices_{};
+  std::array<double, kMaxVoices> batchPositions_{};
+  std::array<double, kMaxVoices> batchIncrements_{};
+  std::array<float, kMaxVoices> batchGains_{};
+  std::array<float, kMaxVoices> batchGainSteps_{};
+  std::size_t batchSize_ = 0;
+
+  std::size_t activeVoices_ = 0;
+  std::uint64_t nextAge_ = 0;
+  std::uint64_t stolenVoices_ = 0;
+  dsp::Waveform waveform_ = dsp::Waveform::kSine;
+  double attackSeconds_ = 0.002;
+  double releaseSeconds_ = 0.05;
+  float gain_ = 1.0F;
+  double rootNote_ = 60.0;
+
+  ClipPlayerNode::ClipBufferData clip_{};
+  // kSourceFrames decoded source frames per clip channel, and one chunk of a clip voice.
+  std::vector<float> sourceScratch_;
+  std::array<float, kChunkFrames> voiceScratch_{};
+};
+
+}  // namespace daft::audio
@@ -3,21 +3,30 @@
 #include <android/log.h>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <exception>
+#include <thread>
 
+#include "audio_engine/DSPKernels.h"
 #include "audio_engine/DSPNode.h"
 
 namespace daft::audio::bridge {
 
 namespace {
 constexpr const char* kTag = "DaftAudioEngine";
+// Read-ahead held per streamed clip player, in seconds of source audio.
+constexpr double kStreamReadAheadSeconds = 2.0;
 }
 
 std::unique_ptr<SceneGraph> AudioEngineBridge::graph_;
 std::mutex AudioEngineBridge::mutex_;
+std::atomic<SceneGraph*> AudioEngineBridge::renderGraph_{nullptr};
+std::atomic<bool> AudioEngineBridge::renderInFlight_{false};
 std::atomic<std::uint64_t> AudioEngineBridge::xruns_{0};
 std::atomic<double> AudioEngineBridge::lastRenderDurationMicros_{0.0};
-std::unordered_map<std::string, AudioEngineBridge::ClipBufferEntry> AudioEngineBridge::clipBuffers_;
+ClipRegistry AudioEngineBridge::clipRegistry_;
+std::unique_ptr<ClipStreamer> AudioEngineBridge::streamer_;
+std::unique_ptr<OfflineRenderer> AudioEngineBridge::offlineRenderer_;
 
 /**
  * @brief Initializes the audio engine and creates a new scene graph.
@@ -26,13 +35,31 @@ std::unordered_map<std::string, AudioEngineBridge::ClipBufferEntry> AudioEngineB
  *
  * @param sampleRate Sample rate in Hertz for the audio engine.
  * @param framesPerBuffer Number of frames per audio buffer.
+ * @param maxChannels Output channels the graph renders.
+ * @param maxFramesPerBuffer Longest block the graph renders at once; 0 keeps the graph's default.
+ * @throws std::invalid_argument if the limits are outside what SceneGraph accepts.
  */
-void AudioEngineBridge::initialize(JNIEnv*, double sampleRate, std::uint32_t framesPerBuffer) {
+void AudioEngineBridge::initialize(JNIEnv*, double sampleRate, std::uint32_t framesPerBuffer,
+                                   std::size_t maxChannels, std::size_t maxFramesPerBuffer) {
+  // Build the new graph first so invalid limits leave the running one untouched.
+  auto graph = std::make_unique<SceneGraph>(
+      sampleRate, framesPerBuffer, maxChannels,
+      maxFramesPerBuffer == 0 ? SceneGraph::kDefaultMaxFrames : maxFramesPerBuffer);
   std::lock_guard<std::mutex> lock(mutex_);
-  graph_ = std::make_unique<SceneGraph>(sampleRate, framesPerBuffer);
+  detachRenderGraph();
+  if (offlineRenderer_) {
+    offlineRenderer_->cancel();
+    offlineRenderer_.reset();
+  }
+  graph_ = std::move(graph);
+  renderGraph_.store(graph_.get());
+  if (!streamer_) {
+    streamer_ = std::make_unique<ClipStreamer>();
+  }
   xruns_.store(0);
   lastRenderDurationMicros_.store(0.0);
-  __android_log_print(ANDROID_LOG_INFO, kTag, "Audio engine initialized at %.2f Hz", sampleRate);
+  __android_log_print(ANDROID_LOG_INFO, kTag, "Audio engine initialized at %.2f Hz, %zu channels, %zu-frame blocks",
+                      sampleRate, graph_->maxSupportedChannels(), graph_->maxSupportedFramesPerBuffer());
 }
 
 /**
@@ -43,21 +70,27 @@ void AudioEngineBridge::initialize(JNIEnv*, double sampleRate, std::uint32_t fra
  */
 void AudioEngineBridge::shutdown() {
   std::lock_guard<std::mutex> lock(mutex_);
+  detachRenderGraph();
+  if (offlineRenderer_) {
+    offlineRenderer_->cancel();
+    offlineRenderer_.reset();
+  }
   graph_.reset();
+  streamer_.reset();
   xruns_.store(0);
   lastRenderDurationMicros_.store(0.0);
-  clipBuffers_.clear();
+  clipRegistry_.clear();
   __android_log_print(ANDROID_LOG_INFO, kTag, "Audio engine shutdown");
 }
 
 /**
  * @brief Renders audio into the provided output buffers and updates render diagnostics.
  *
- * Attempts a non-blocking render of the internal audio graph into the provided channel buffers.
- * If the graph is unavailable, the render lock cannot be obtained, or an exception occurs during
- * rendering, the output buffers are filled with zeros, the xrun counter is incremented, and the
- * last render duration is reset to 0. On successful render the elapsed time in microseconds is
- * stored in the diagnostics state.
+ * Renders the most recently published plan of the internal audio graph into the provided channel
+ * buffers without taking any lock, so control-thread edits never cost a buffer. If the graph is
+ * unavailable the output is silenced; if an exception occurs during rendering the output buffers are
+ * filled with zeros, the xrun counter is incremented, and the last render duration is reset to 0. On
+ * successful render the elapsed time in microseconds is stored in the diagnostics state.
  *
  * @param outputs Array of pointers to per-channel float sample buffers (length == channelCount).
  *                Each buffer must be able to hold frameCount samples.
@@ -66,39 +99,49 @@ void AudioEngineBridge::shutdown() {
  */
 void AudioEngineBridge::render(float** outputs, std::size_t channelCount, std::size_t frameCount) {
   AudioBufferView view(outputs, channelCount, frameCount);
-  std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
-  if (!lock.owns_lock()) {
-    view.fill(0.0F);
-    xruns_.fetch_add(1);
-    lastRenderDurationMicros_.store(0.0);
-    return;
-  }
-  if (!graph_) {
+  renderInFlight_.store(true);
+  SceneGraph* graph = renderGraph_.load();
+  if (graph == nullptr) {
     view.fill(0.0F);
     lastRenderDurationMicros_.store(0.0);
+    renderInFlight_.store(false);
     return;
   }
   const auto start = std::chrono::steady_clock::now();
   try {
-    graph_->render(view);
+    graph->render(view);
   } catch (const std::exception& ex) {
     view.fill(0.0F);
     xruns_.fetch_add(1);
+    graph->recordRenderError();
     lastRenderDurationMicros_.store(0.0);
+    renderInFlight_.store(false);
     __android_log_print(ANDROID_LOG_ERROR, kTag, "Render failed: %s", ex.what());
     return;
   } catch (...) {
     view.fill(0.0F);
     xruns_.fetch_add(1);
+    graph->recordRenderError();
     lastRenderDurationMicros_.store(0.0);
+    renderInFlight_.store(false);
     __android_log_print(ANDROID_LOG_ERROR, kTag, "Render failed with unknown error");
     return;
   }
+  renderInFlight_.store(false);
   const auto end = std::chrono::steady_clock::now();
   const auto micros = std::chrono::duration<double, std::micro>(end - start).count();
   lastRenderDurationMicros_.store(micros);
 }
 
+void AudioEngineBridge::detachRenderGraph() {
+  // Sequentially consistent handshake with render(): once renderGraph_ is null and no render is in
+  // flight, the audio thread can no longer observe graph_.
+  renderGraph_.store(nullptr);
+  while (renderInFlight_.load()) {
+    std::this_thread::yield();
+  }
+}
+
 /**
  * @brief Adds a DSP node to the active scene graph.
  *
@@ -136,33 +179,87 @@ void AudioEngineBridge::disconnect(const std::string& source, const std::string&
   }
 }
 
+void AudioEngineBridge::beginGraphUpdate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (graph_) {
+    graph_->beginUpdate();
+  }
+}
+
+void AudioEngineBridge::commitGraphUpdate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (graph_) {
+    graph_->commit();
+  }
+}
+
+/**
+ * @brief Sets a node parameter as soon as possible.
+ *
+ * A node added since the last published plan takes the value directly on this thread; any other node
+ * receives it at the start of the next block. Unknown parameters are logged and skipped.
+ *
+ * @throws std::runtime_error if the node does not exist or the scheduler queue is full.
+ */
+void AudioEngineBridge::setParameter(const std::string& nodeId, const std::string& parameter, double value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!graph_) {
+    return;
+  }
+  const auto parameterId = graph_->findParameter(nodeId, parameter);
+  if (parameterId == kInvalidParamId) {
+    __android_log_print(ANDROID_LOG_WARN, kTag, "Unknown parameter %s on node %s", parameter.c_str(), nodeId.c_str());
+    return;
+  }
+  graph_->setParameter(nodeId, parameterId, value);
+}
+
 /**
  * @brief Schedules a parameter change for a node to take effect at a specific future frame.
  *
- * If the internal scene graph is not available, the call is a no-op. Exceptions derived from
- * `std::exception` thrown while scheduling are caught and logged; other exception types are not caught.
+ * If the internal scene graph is not available, the call is a no-op. Unknown parameters are logged and
+ * skipped.
  *
  * @param nodeId Identifier of the target node.
  * @param parameter Name of the parameter to set on the node.
  * @param frame Frame index at which the parameter change should be applied.
  * @param value Value to assign to the parameter at the scheduled frame.
+ * @throws std::runtime_error if the node does not exist or the scheduler queue is full.
  */
 void AudioEngineBridge::scheduleParameterAutomation(const std::string& nodeId, const std::string& parameter,
                                                     std::uint64_t frame, double value) {
+  scheduleParameterRamp(nodeId, parameter, frame, value, 0, RampShape::kLinear);
+}
+
+/**
+ * @brief Schedules a per-sample ramp of a node parameter starting at a specific frame.
+ *
+ * Same contract as scheduleParameterAutomation; a zero `durationFrames` degenerates to a step change.
+ * Unknown parameters are logged and skipped; a missing node or a full scheduler queue throws, so callers
+ * can report the dropped event.
+ *
+ * @param durationFrames Number of frames over which the node interpolates towards `value`.
+ * @param shape Interpolation curve used by the node.
+ */
+void AudioEngineBridge::scheduleParameterRamp(const std::string& nodeId, const std::string& parameter,
+                                              std::uint64_t frame, double value, std::uint32_t durationFrames,
+                                              RampShape shape) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (!graph_) {
     return;
   }
-  try {
-    graph_->scheduleAutomation(nodeId,
-                               [parameter, value](DSPNode& node) { node.setParameter(parameter, value); }, frame);
-  } catch (const std::exception& ex) {
-    __android_log_print(ANDROID_LOG_ERROR, kTag, "Failed to schedule automation: %s", ex.what());
+  // Resolve the name here so the audio thread only ever dispatches integer parameter ids.
+  const auto parameterId = graph_->findParameter(nodeId, parameter);
+  if (parameterId == kInvalidParamId) {
+    __android_log_print(ANDROID_LOG_WARN, kTag, "Unknown automation parameter %s on node %s", parameter.c_str(), nodeId.c_str());
+    return;
   }
+  graph_->scheduleRamp(nodeId, parameterId, frame, value, durationFrames, shape);
 }
 
 bool AudioEngineBridge::registerClipBuffer(const std::string& key, double sampleRate, std::size_t channelCount,
-                                           std::size_t frameCount, std::vector<std::vector<float>> channelData) {
+                                           std::size_t frameCount, std::vector<std::vector<float>> channelData,
+                                           SampleFormat storageFormat) {
   if (key.empty() || !std::isfinite(sampleRate) || sampleRate <= 0.0 || channelCount == 0 || frameCount == 0) {
     return false;
   }
@@ -175,17 +272,130 @@ bool AudioEngineBridge::registerClipBuffer(const std::string& key, double sample
     }
   }
 
+  if (storageFormat != SampleFormat::kFloat32) {
+    std::vector<const float*> channels;
+    channels.reserve(channelCount);
+    for (const auto& channel : channelData) {
+      channels.push_back(channel.data());
+    }
+    return encodeClipBuffer(key, sampleRate, frameCount, channels, storageFormat);
+  }
+
   auto buffer = std::make_shared<ClipBuffer>();
   buffer->sampleRate = sampleRate;
   buffer->frameCount = frameCount;
   buffer->channelSamples = std::move(channelData);
-  const std::size_t byteSize = channelCount * frameCount * sizeof(float);
+  clipRegistry_.store(key, std::move(buffer), channelCount * frameCount * sizeof(float));
+  return true;
+}
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto& entry = clipBuffers_[key];
-  entry.buffer = std::move(buffer);
-  entry.byteSize = byteSize;
-  entry.referenceCount += 1;
+/**
+ * @brief Registers caller-owned planar channels encoded as `format` without copying them.
+ *
+ * Each channel pointer must address `frameCount` samples that stay valid for as long as `storage` is
+ * alive. The buffer (and with it `storage`) is released once the key is unregistered and the last clip
+ * player referencing it is gone.
+ */
+bool AudioEngineBridge::adoptClipBuffer(const std::string& key, double sampleRate, std::size_t frameCount,
+                                        std::vector<const void*> channels, std::shared_ptr<const void> storage,
+                                        SampleFormat format) {
+  if (key.empty() || !std::isfinite(sampleRate) || sampleRate <= 0.0 || frameCount == 0 || channels.empty() ||
+      !storage) {
+    return false;
+  }
+  for (const auto* channel : channels) {
+    if (channel == nullptr || reinterpret_cast<std::uintptr_t>(channel) % BytesPerSample(format) != 0) {
+      return false;
+    }
+  }
+
+  auto buffer = std::make_shared<ClipBuffer>();
+  buffer->sampleRate = sampleRate;
+  buffer->frameCount = frameCount;
+  buffer->format = format;
+  const std::size_t byteSize = channels.size() * frameCount * BytesPerSample(format);
+  buffer->adoptedChannels = std::move(channels);
+  buffer->storage = std::move(storage);
+  clipRegistry_.store(key, std::move(buffer), byteSize);
+  return true;
+}
+
+/**
+ * @brief Re-encodes planar Float32 channels into a compact storage format and registers the result.
+ *
+ * int16 halves the footprint at 16-bit resolution; float16 halves it while keeping headroom above full
+ * scale. Players decode back to float while rendering.
+ */
+bool AudioEngineBridge::encodeClipBuffer(const std::string& key, double sampleRate, std::size_t frameCount,
+                                         const std::vector<const float*>& channels, SampleFormat format) {
+  if (format == SampleFormat::kFloat32 || channels.empty() || frameCount == 0) {
+    return false;
+  }
+  auto encoded = std::make_shared<std::vector<std::uint16_t>>(channels.size() * frameCount);
+  std::vector<const void*> pointers(channels.size());
+  for (std::size_t channel = 0; channel < channels.size(); ++channel) {
+    if (channels[channel] == nullptr) {
+      return false;
+    }
+    auto* dest = encoded->data() + channel * frameCount;
+    if (format == SampleFormat::kInt16) {
+      dsp::encodeInt16(reinterpret_cast<std::int16_t*>(dest), channels[channel], frameCount);
+    } else {
+      dsp::encodeFloat16(dest, channels[channel], frameCount);
+    }
+    pointers[channel] = dest;
+  }
+  return adoptClipBuffer(key, sampleRate, frameCount, std::move(pointers), std::move(encoded), format);
+}
+
+/**
+ * @brief Maps planar Float32 channels (`channelCount` runs of `frameCount` samples starting at
+ * `dataOffsetBytes`) from a file or shared-memory descriptor and adopts the mapping.
+ *
+ * The descriptor may be closed as soon as this returns.
+ */
+bool AudioEngineBridge::registerClipBufferFromFd(const std::string& key, double sampleRate, std::size_t channelCount,
+                                                 std::size_t frameCount, int fd, std::size_t dataOffsetBytes,
+                                                 std::string& error) {
+  if (channelCount == 0 || frameCount == 0 || dataOffsetBytes % sizeof(float) != 0) {
+    error = "mapped clips require positive dimensions and a 4-byte aligned offset";
+    return false;
+  }
+  auto mapping = MapFileRegion(fd, dataOffsetBytes, channelCount * frameCount * sizeof(float), error);
+  if (!mapping) {
+    __android_log_print(ANDROID_LOG_WARN, kTag, "Clip buffer %s not mapped: %s", key.c_str(), error.c_str());
+    return false;
+  }
+  const auto* samples = static_cast<const float*>(mapping.get());
+  std::vector<const void*> channels(channelCount);
+  for (std::size_t channel = 0; channel < channelCount; ++channel) {
+    channels[channel] = samples + channel * frameCount;
+  }
+  if (!adoptClipBuffer(key, sampleRate, frameCount, std::move(channels), std::move(mapping))) {
+    error = "invalid clip buffer parameters";
+    return false;
+  }
+  return true;
+}
+
+bool AudioEngineBridge::registerClipStream(const std::string& key, const std::string& path, double sampleRate,
+                                           std::size_t channelCount, std::size_t dataOffsetBytes, std::string& error) {
+  if (key.empty() || path.empty()) {
+    error = "clip streams require a key and a file path";
+    return false;
+  }
+  auto source = ClipFileSource::open(path, channelCount, sampleRate, dataOffsetBytes, error);
+  if (!source) {
+    __android_log_print(ANDROID_LOG_WARN, kTag, "Clip stream %s not registered: %s", key.c_str(), error.c_str());
+    return false;
+  }
+
+  auto buffer = std::make_shared<ClipBuffer>();
+  buffer->sampleRate = sampleRate;
+  buffer->frameCount = source->frameCount();
+  buffer->stream = std::move(source);
+  // Streamed clips are mapped, not resident, so they do not count towards the clip-buffer footprint.
+  clipRegistry_.store(key, std::move(buffer), 0);
   return true;
 }
 
@@ -193,27 +403,108 @@ bool AudioEngineBridge::unregisterClipBuffer(const std::string& key) {
   if (key.empty()) {
     return false;
   }
+  // Unknown keys count as already released.
+  clipRegistry_.release(key);
+  return true;
+}
+
+std::shared_ptr<const AudioEngineBridge::ClipBuffer> AudioEngineBridge::clipBufferForKey(const std::string& key) {
+  return clipRegistry_.find(key);
+}
+
+std::shared_ptr<ClipStream> AudioEngineBridge::createClipStream(std::shared_ptr<const ClipFileSource> source) {
   std::lock_guard<std::mutex> lock(mutex_);
-  auto it = clipBuffers_.find(key);
-  if (it == clipBuffers_.end()) {
-    return true;
+  if (!streamer_ || !source) {
+    return nullptr;
   }
-  auto& entry = it->second;
-  if (entry.referenceCount > 0) {
-    entry.referenceCount -= 1;
+  const auto capacity = static_cast<std::size_t>(std::ceil(source->sampleRate() * kStreamReadAheadSeconds));
+  return streamer_->createStream(std::move(source), capacity);
+}
+
+/**
+ * @brief Starts a faster-than-realtime bounce of the scene graph to a WAV file.
+ *
+ * The realtime callback is detached from the graph for the duration of the bounce and renders silence,
+ * since the graph is rewound and driven by the bounce's own render thread.
+ *
+ * @param path Destination WAV file; created or truncated.
+ * @param options Frame and channel counts, sample format and render workers for the bounce.
+ * @param error Receives the reason when the bounce cannot start.
+ * @return true if the bounce started.
+ */
+bool AudioEngineBridge::startOfflineRender(const std::string& path, const OfflineRenderer::Options& options,
+                                           std::string& error) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!graph_) {
+    error = "audio engine is not initialized";
+    return false;
   }
-  if (entry.referenceCount == 0) {
-    clipBuffers_.erase(it);
+  if (offlineRenderer_ && offlineRenderer_->progress().state == OfflineRenderer::State::kRendering) {
+    error = "an offline render is already running";
+    return false;
   }
-  return true;
+  finishOfflineRender();
+  detachRenderGraph();
+  offlineRenderer_ = std::make_unique<OfflineRenderer>();
+  try {
+    if (offlineRenderer_->start(*graph_, path, options, error)) {
+      __android_log_print(ANDROID_LOG_INFO, kTag, "Offline render started: %llu frames to %s",
+                          static_cast<unsigned long long>(options.frameCount), path.c_str());
+      return true;
+    }
+  } catch (const std::exception& ex) {
+    error = ex.what();
+  }
+  offlineRenderer_.reset();
+  renderGraph_.store(graph_.get());
+  return false;
 }
 
-std::shared_ptr<const AudioEngineBridge::ClipBuffer> AudioEngineBridge::clipBufferForKey(const std::string& key) {
+/**
+ * @brief Cancels a running bounce, deletes its partial file and resumes realtime rendering.
+ */
+void AudioEngineBridge::cancelOfflineRender() {
   std::lock_guard<std::mutex> lock(mutex_);
-  if (const auto it = clipBuffers_.find(key); it != clipBuffers_.end()) {
-    return it->second.buffer;
+  if (offlineRenderer_) {
+    offlineRenderer_->cancel();
+    finishOfflineRender();
+  }
+}
+
+/**
+ * @brief Reports the progress of the current or last bounce.
+ *
+ * Once the bounce has finished, failed or been cancelled, its threads are joined and the graph is
+ * handed back to the realtime callback.
+ *
+ * @return OfflineRenderStatus with the state, rendered, written and total frames, and the failure reason.
+ */
+AudioEngineBridge::OfflineRenderStatus AudioEngineBridge::getOfflineRenderStatus() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!offlineRenderer_) {
+    return {};
+  }
+  const auto progress = offlineRenderer_->progress();
+  if (progress.state != OfflineRenderer::State::kRendering) {
+    finishOfflineRender();
+  }
+  return {progress.state, progress.renderedFrames, progress.writtenFrames, progress.totalFrames,
+          offlineRenderer_->error()};
+}
+
+void AudioEngineBridge::finishOfflineRender() {
+  // Caller holds mutex_. wait() is a no-op once the bounce has been handed back.
+  if (!offlineRenderer_) {
+    return;
+  }
+  try {
+    offlineRenderer_->wait();
+  } catch (const std::exception& ex) {
+    __android_log_print(ANDROID_LOG_ERROR, kTag, "Offline render cleanup failed: %s", ex.what());
+  }
+  if (graph_) {
+    renderGraph_.store(graph_.get());
   }
-  return nullptr;
 }
 
 /**
@@ -225,14 +516,44 @@ std::shared_ptr<const AudioEngineBridge::ClipBuffer> AudioEngineBridge::clipBuff
  * @return RenderDiagnostics Struct containing:
  *  - xruns: number of missed/overrun render calls.
  *  - lastRenderDurationMicros: duration of the last render call in microseconds.
+ *  - scratchBufferCount / scratchBufferBytes: size of the scene graph's pooled node buffers.
+ *  - streamUnderruns: streamed-clip reads that found their frames not yet read ahead.
  */
 AudioEngineBridge::RenderDiagnostics AudioEngineBridge::getDiagnostics() {
-  RenderDiagnostics diagnostics{xruns_.load(), lastRenderDurationMicros_.load(), 0};
+  // Clip bytes are kept as a running total so this never walks the clip registry.
+  RenderDiagnostics diagnostics{xruns_.load(), lastRenderDurationMicros_.load(), clipRegistry_.bytes(), 0, 0, 0};
   std::lock_guard<std::mutex> lock(mutex_);
-  for (const auto& [_, entry] : clipBuffers_) {
-    diagnostics.clipBufferBytes += entry.byteSize;
+  if (graph_) {
+    graph_->reclaimRetiredPlans();
+    diagnostics.scratchBufferCount = graph_->scratchBufferCount();
+    diagnostics.scratchBufferBytes = graph_->scratchBufferBytes();
+  }
+  if (streamer_) {
+    diagnostics.streamUnderruns = streamer_->underruns();
   }
   return diagnostics;
 }
 
+/**
+ * @brief Turns render profiling on or off for the current graph (see `SceneGraph::setProfilingEnabled`).
+ *
+ * The setting belongs to the graph, so `initialize` starts unprofiled again.
+ */
+void AudioEngineBridge::setProfilingEnabled(bool enabled) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (graph_) {
+    graph_->setProfilingEnabled(enabled);
+  }
+}
+
+/**
+ * @brief Summarises block, DSP-load, jitter and per-node timings recorded since profiling was enabled.
+ *
+ * @return The graph's profile report; `enabled` is false while profiling is off or before initialization.
+ */
+RenderProfiler::Report AudioEngineBridge::getRenderProfile() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_ ? graph_->renderProfile() : RenderProfiler::Report{};
+}
+
 }  // namespace daft::audio::bridge
\ No newline at end of file
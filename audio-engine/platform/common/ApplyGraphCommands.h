@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <exception>
+#include <span>
+#include <string>
+
+#include "GraphCommandBuffer.h"
+#include "NodeFactory.h"
+
+/**
+ * Apply an encoded graph command buffer (see GraphCommandBuffer.h) to the bridge's scene graph.
+ *
+ * The whole buffer is decoded before anything is applied, so a malformed buffer changes nothing. The
+ * commands then run in order inside one graph batch, which publishes a single render plan at the end.
+ * Option values get the same coercion as options passed to `addNode` directly. Parameters set on nodes
+ * the buffer creates are applied directly, before the plan holding them is published, so a snapshot
+ * is not bounded by the scheduler queue; automation, ramps and sets on live nodes go through it. Unknown
+ * parameters are skipped, as the per-call bridge methods skip them.
+ *
+ * @param buffer Encoded commands; only read while the call runs.
+ * @param error Set to the reason, prefixed with the failing command's index, when `false` is returned.
+ * @returns `false` on a malformed buffer (nothing applied) or on the first command that fails,
+ * including an event the scheduler queue cannot take (the commands before it stay applied).
+ */
+namespace daft::audio::bridge {
+
+namespace detail {
+inline void setGraphOption(NodeOptions& options, const GraphOption& option) {
+  std::string key = normalize(std::string(option.key));
+  switch (option.kind) {
+    case GraphOptionKind::kNumber:
+      options.setNumeric(std::move(key), option.number);
+      return;
+    case GraphOptionKind::kBoolean:
+      options.setNumeric(std::move(key), option.flag ? 1.0 : 0.0);
+      return;
+    case GraphOptionKind::kString:
+      break;
+  }
+  auto first = option.text.begin();
+  auto last = option.text.end();
+  while (first != last && std::isspace(static_cast<unsigned char>(*first)) != 0) {
+    ++first;
+  }
+  while (last != first && std::isspace(static_cast<unsigned char>(*(last - 1))) != 0) {
+    --last;
+  }
+  if (first == last) {
+    return;
+  }
+  std::string trimmed(first, last);
+  const auto lowered = normalize(trimmed);
+  if (lowered == "true" || lowered == "yes" || lowered == "on") {
+    options.setNumeric(key, 1.0);
+  } else if (lowered == "false" || lowered == "no" || lowered == "off") {
+    options.setNumeric(key, 0.0);
+  } else {
+    try {
+      options.setNumeric(key, std::stod(trimmed));
+    } catch (const std::exception&) {
+      // keep as string only
+    }
+  }
+  options.setString(std::move(key), std::move(trimmed));
+}
+
+inline bool applyGraphCommand(const GraphCommand& command, std::string& error) {
+  const std::string node(command.node);
+  switch (command.op) {
+    case GraphOp::kAddNode: {
+      NodeOptions options;
+      GraphOptionReader reader(command);
+      GraphOption option;
+      while (reader.next(option)) {
+        setGraphOption(options, option);
+      }
+      auto created = CreateNode(std::string(command.name), options, error);
+      if (!created) {
+        return false;
+      }
+      if (!AudioEngineBridge::addNode(node, std::move(created))) {
+        error = "Failed to add node '" + node + "'";
+        return false;
+      }
+      return true;
+    }
+    case GraphOp::kRemoveNode:
+      AudioEngineBridge::removeNode(node);
+      return true;
+    case GraphOp::kConnect:
+      if (!AudioEngineBridge::connect(node, std::string(command.name))) {
+        error = "Failed to connect '" + node + "' -> '" + std::string(command.name) + "'";
+        return false;
+      }
+      return true;
+    case GraphOp::kDisconnect:
+      AudioEngineBridge::disconnect(node, std::string(command.name));
+      return true;
+    case GraphOp::kSetParameter:
+      AudioEngineBridge::setParameter(node, std::string(command.name), command.value);
+      return true;
+    case GraphOp::kScheduleAutomation:
+      AudioEngineBridge::scheduleParameterAutomation(node, std::string(command.name),
+                                                     static_cast<std::uint64_t>(command.frame), command.value);
+      return true;
+    case GraphOp::kScheduleRamp:
+      AudioEngineBridge::scheduleParameterRamp(node, std::string(command.name),
+                                               static_cast<std::uint64_t>(command.frame), command.value,
+                                               command.durationFrames, command.shape);
+      return true;
+  }
+  error = "unknown graph command";
+  return false;
+}
+}  // namespace detail
+
+inline bool ApplyGraphCommands(std::span<const std::uint8_t> buffer, std::string& error) {
+  if (!GraphCommandReader(buffer).validate(error)) {
+    return false;
+  }
+  GraphCommandReader reader(buffer);
+  GraphCommand command;
+  bool ok = true;
+  AudioEngineBridge::beginGraphUpdate();
+  try {
+    while (ok && reader.next(command, error)) {
+      try {
+        ok = detail::applyGraphCommand(command, error);
+      } catch (const std::exception& ex) {
+        error = ex.what();
+        ok = false;
+      }
+      if (!ok) {
+        error = "graph command " + std::to_string(reader.commandsRead() - 1) + ": " + error;
+      }
+    }
+  } catch (...) {
+    AudioEngineBridge::commitGraphUpdate();
+    throw;
+  }
+  try {
+    // Automation for nodes the buffer created is queued by the commit, after the plan adding them.
+    AudioEngineBridge::commitGraphUpdate();
+  } catch (const std::exception& ex) {
+    if (ok) {
+      error = std::string("graph commit: ") + ex.what();
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+}  // namespace daft::audio::bridge
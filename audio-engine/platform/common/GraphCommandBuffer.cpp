@@ -0,0 +1,183 @@
+#include "GraphCommandBuffer.h"
+
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace daft::audio::bridge {
+
+// Fields are copied out byte for byte, so this is the only thing the decoder assumes about the host.
+static_assert(std::endian::native == std::endian::little, "graph command buffers are decoded in place");
+
+namespace {
+
+template <typename T>
+bool ReadValue(std::span<const std::uint8_t> buffer, std::size_t& offset, T& value) {
+  if (buffer.size() - offset < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(&value, buffer.data() + offset, sizeof(T));
+  offset += sizeof(T);
+  return true;
+}
+
+bool ReadStringAt(std::span<const std::uint8_t> buffer, std::size_t& offset, std::string_view& value) {
+  std::uint16_t length = 0;
+  if (!ReadValue(buffer, offset, length) || buffer.size() - offset < length) {
+    return false;
+  }
+  value = {reinterpret_cast<const char*>(buffer.data() + offset), length};
+  offset += length;
+  return true;
+}
+
+bool ReadOptionAt(std::span<const std::uint8_t> buffer, std::size_t& offset, GraphOption& option) {
+  std::uint8_t kind = 0;
+  option = {};
+  if (!ReadStringAt(buffer, offset, option.key) || !ReadValue(buffer, offset, kind)) {
+    return false;
+  }
+  switch (static_cast<GraphOptionKind>(kind)) {
+    case GraphOptionKind::kNumber:
+      option.kind = GraphOptionKind::kNumber;
+      return ReadValue(buffer, offset, option.number) && std::isfinite(option.number);
+    case GraphOptionKind::kString:
+      option.kind = GraphOptionKind::kString;
+      return ReadStringAt(buffer, offset, option.text);
+    case GraphOptionKind::kBoolean: {
+      std::uint8_t flag = 0;
+      option.kind = GraphOptionKind::kBoolean;
+      if (!ReadValue(buffer, offset, flag) || flag > 1) {
+        return false;
+      }
+      option.flag = flag != 0;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+bool GraphCommandReader::readU8(std::uint8_t& value) { return ReadValue(buffer_, offset_, value); }
+bool GraphCommandReader::readU16(std::uint16_t& value) { return ReadValue(buffer_, offset_, value); }
+bool GraphCommandReader::readU32(std::uint32_t& value) { return ReadValue(buffer_, offset_, value); }
+
+bool GraphCommandReader::readF64(double& value) {
+  return ReadValue(buffer_, offset_, value) && std::isfinite(value);
+}
+
+bool GraphCommandReader::readString(std::string_view& value) { return ReadStringAt(buffer_, offset_, value); }
+
+bool GraphCommandReader::readFrame(double& value) {
+  return readF64(value) && value >= 0.0 && value <= 9007199254740992.0 && std::floor(value) == value;
+}
+
+bool GraphCommandReader::skipOptions(std::uint16_t count) {
+  GraphOption option;
+  for (std::uint16_t index = 0; index < count; ++index) {
+    if (!ReadOptionAt(buffer_, offset_, option) || option.key.empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool GraphCommandReader::readHeader(std::string& error) {
+  std::uint32_t magic = 0;
+  std::uint16_t version = 0;
+  std::uint16_t reserved = 0;
+  if (!readU32(magic) || !readU16(version) || !readU16(reserved) || !readU32(commandCount_)) {
+    error = "graph command buffer is shorter than its header";
+    return false;
+  }
+  if (magic != kMagic) {
+    error = "graph command buffer has the wrong magic";
+    return false;
+  }
+  if (version != kVersion || reserved != 0) {
+    error = "unsupported graph command buffer version " + std::to_string(version);
+    return false;
+  }
+  headerRead_ = true;
+  return true;
+}
+
+bool GraphCommandReader::next(GraphCommand& command, std::string& error) {
+  error.clear();
+  if (!headerRead_ && !readHeader(error)) {
+    return false;
+  }
+  if (commandsRead_ == commandCount_) {
+    if (offset_ != buffer_.size()) {
+      error = "graph command buffer has trailing bytes after " + std::to_string(commandCount_) + " commands";
+    }
+    return false;
+  }
+
+  std::uint8_t op = 0;
+  bool ok = readU8(op);
+  command = {};
+  command.op = static_cast<GraphOp>(op);
+  if (ok) {
+    switch (command.op) {
+      case GraphOp::kAddNode: {
+        ok = readString(command.node) && readString(command.name) && readU16(command.optionCount);
+        const auto optionsBegin = offset_;
+        ok = ok && skipOptions(command.optionCount);
+        if (ok) {
+          command.options = buffer_.subspan(optionsBegin, offset_ - optionsBegin);
+        }
+        ok = ok && !command.name.empty();
+        break;
+      }
+      case GraphOp::kRemoveNode:
+        ok = readString(command.node);
+        break;
+      case GraphOp::kConnect:
+      case GraphOp::kDisconnect:
+      case GraphOp::kSetParameter:
+        ok = readString(command.node) && readString(command.name) &&
+             (command.op != GraphOp::kSetParameter || readF64(command.value)) && !command.name.empty();
+        break;
+      case GraphOp::kScheduleAutomation:
+        ok = readString(command.node) && readString(command.name) && readFrame(command.frame) &&
+             readF64(command.value) && !command.name.empty();
+        break;
+      case GraphOp::kScheduleRamp: {
+        std::uint8_t shape = 0;
+        ok = readString(command.node) && readString(command.name) && readFrame(command.frame) &&
+             readF64(command.value) && readU32(command.durationFrames) && readU8(shape) && shape <= 1 &&
+             !command.name.empty();
+        command.shape = shape == 1 ? RampShape::kExponential : RampShape::kLinear;
+        break;
+      }
+      default:
+        error = "graph command " + std::to_string(commandsRead_) + " has unknown opcode " + std::to_string(op);
+        return false;
+    }
+  }
+  if (!ok || command.node.empty()) {
+    error = "graph command " + std::to_string(commandsRead_) + " is truncated or malformed";
+    return false;
+  }
+  ++commandsRead_;
+  return true;
+}
+
+bool GraphCommandReader::validate(std::string& error) {
+  GraphCommand command;
+  while (next(command, error)) {
+  }
+  return error.empty();
+}
+
+bool GraphOptionReader::next(GraphOption& option) {
+  if (remaining_ == 0) {
+    return false;
+  }
+  --remaining_;
+  return ReadOptionAt(options_, offset_, option);
+}
+
+}  // namespace daft::audio::bridge
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "audio_engine/SmoothedValue.h"
+
+/**
+ * Binary graph command buffer, filled by TypeScript and submitted across the bridge in one call.
+ *
+ * Everything is little-endian and packed with no alignment. The buffer starts with a 12-byte header: the
+ * magic "DGCB", a u16 format version (currently 1), a reserved u16 (zero), and a u32 command count. Each
+ * command is a u8 opcode followed by its fields. Strings are a u16 byte length plus UTF-8 bytes. Numbers
+ * are IEEE-754 f64; frames are f64 holding a non-negative integer, as JavaScript numbers do.
+ *
+ *   addNode            id, type, u16 option count, then per option: key, u8 kind, value
+ *                      (number: f64, string: string, boolean: u8)
+ *   removeNode         id
+ *   connect            source, destination
+ *   disconnect         source, destination
+ *   setParameter       node, parameter, value
+ *   scheduleAutomation node, parameter, frame, value
+ *   scheduleRamp       node, parameter, frame, value, u32 duration frames, u8 shape (0 linear, 1 exponential)
+ */
+namespace daft::audio::bridge {
+
+enum class GraphOp : std::uint8_t {
+  kAddNode = 1,
+  kRemoveNode = 2,
+  kConnect = 3,
+  kDisconnect = 4,
+  kSetParameter = 5,
+  kScheduleAutomation = 6,
+  kScheduleRamp = 7,
+};
+
+enum class GraphOptionKind : std::uint8_t { kNumber = 0, kString = 1, kBoolean = 2 };
+
+/** One node option of an `addNode` command; views point into the command buffer. */
+struct GraphOption {
+  std::string_view key;
+  GraphOptionKind kind = GraphOptionKind::kNumber;
+  double number = 0.0;
+  std::string_view text;
+  bool flag = false;
+};
+
+/**
+ * One decoded command. `node` is the node id (the source for connections); `name` is the node type, the
+ * parameter name or the connection destination. Views point into the command buffer, so the buffer must
+ * outlive the command.
+ */
+struct GraphCommand {
+  GraphOp op = GraphOp::kRemoveNode;
+  std::string_view node;
+  std::string_view name;
+  double frame = 0.0;
+  double value = 0.0;
+  std::uint32_t durationFrames = 0;
+  RampShape shape = RampShape::kLinear;
+  std::uint16_t optionCount = 0;
+  /** Encoded options of an `addNode` command, already validated; read them with `GraphOptionReader`. */
+  std::span<const std::uint8_t> options{};
+};
+
+/** Decodes a command buffer in place without allocating; errors are only formatted on malformed input. */
+class GraphCommandReader {
+ public:
+  static constexpr std::uint32_t kMagic = 0x42434744;  // "DGCB" read as a little-endian u32
+  static constexpr std::uint16_t kVersion = 1;
+  static constexpr std::size_t kHeaderBytes = 12;
+
+  explicit GraphCommandReader(std::span<const std::uint8_t> buffer) : buffer_(buffer) {}
+
+  /**
+   * Decode the next command.
+   * @returns `false` after the last command with `error` left empty, or `false` with `error` set when the
+   * header, a command or the trailing length is malformed.
+   */
+  bool next(GraphCommand& command, std::string& error);
+
+  /** Decode every command without applying any. @returns `false` with `error` set on malformed input. */
+  bool validate(std::string& error);
+
+  /** Command count declared by the header; zero until the first `next`. */
+  [[nodiscard]] std::uint32_t commandCount() const { return commandCount_; }
+  [[nodiscard]] std::uint32_t commandsRead() const { return commandsRead_; }
+
+ private:
+  bool readHeader(std::string& error);
+  bool readU8(std::uint8_t& value);
+  bool readU16(std::uint16_t& value);
+  bool readU32(std::uint32_t& value);
+  bool readF64(double& value);
+  bool readString(std::string_view& value);
+  bool readFrame(double& value);
+  bool skipOptions(std::uint16_t count);
+
+  std::span<const std::uint8_t> buffer_;
+  std::size_t offset_ = 0;
+  bool headerRead_ = false;
+  std::uint32_t commandCount_ = 0;
+  std::uint32_t commandsRead_ = 0;
+};
+
+/** Iterates the options of a validated `addNode` command. */
+class GraphOptionReader {
+ public:
+  explicit GraphOptionReader(const GraphCommand& command)
+      : options_(command.options), remaining_(command.optionCount) {}
+
+  /** @returns `false` once every option has been read. */
+  bool next(GraphOption& option);
+
+ private:
+  std::span<const std::uint8_t> options_;
+  std::size_t offset_ = 0;
+  std::uint16_t remaining_;
+};
+
+}  // namespace daft::audio::bridge
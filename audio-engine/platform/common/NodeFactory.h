@@ -9,12 +9,13 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "audio_engine/DSPNode.h"
 #include "audio_engine/PluginNode.h"
+#include "audio_engine/VoicePoolNode.h"
 
 #if defined(__ANDROID__)
 #include "../android/AudioEngineBridge.h"
@@ -28,6 +29,7 @@
  * Creates and configures a concrete daft::audio::DSPNode (e.g., GainNode, SineOscillatorNode, MixerNode)
  * based on a case-insensitive type name and applies parameters from `options`.
  * For mixer nodes the "inputcount" option (if present) determines the number of inputs and is not applied as a parameter.
+ * For voice pools "voicecount" sets the pool size and an optional "bufferkey" plays a resident clip from every voice.
  *
  * @param type Case-insensitive name of the node type to create (e.g., "gain", "sine", "mixer").
  * @param options Mapping of parameter names to numeric and string values to apply to the created node.
@@ -70,17 +72,15 @@ bool parseBoolean(const NodeOptions& options, const std::string& key, bool defau
 std::optional<std::string> stringFromOptions(const NodeOptions& options, const std::string& key);
 
 template <typename T>
-inline void applyParameters(T& node, const NodeOptions& options, const std::initializer_list<std::string>& excluded = {}) {
-  std::unordered_set<std::string> excludedKeys;
-  excludedKeys.reserve(excluded.size());
-  for (const auto& key : excluded) {
-    excludedKeys.insert(key);
-  }
+inline void applyParameters(T& node, const NodeOptions& options, std::initializer_list<std::string_view> excluded = {}) {
   for (const auto& [key, value] : options.numeric) {
-    if (excludedKeys.count(key) > 0) {
+    if (std::find(excluded.begin(), excluded.end(), key) != excluded.end()) {
       continue;
     }
-    node.setParameter(key, value);
+    // Option keys that are not parameters (e.g. creation-only settings) resolve to kInvalidParamId.
+    if (const auto id = node.findParameter(key); id != daft::audio::kInvalidParamId) {
+      node.setParameter(id, value);
+    }
   }
 }
 
@@ -112,6 +112,28 @@ inline std::optional<std::string> clipBufferKeyFromOptions(const NodeOptions& op
   }
   return std::nullopt;
 }
+// Descriptor through which nodes play a resident registry entry; the node keeps the entry alive.
+inline std::optional<daft::audio::ClipPlayerNode::ClipBufferData> residentClipDescriptor(
+    const std::string& key, const std::shared_ptr<const AudioEngineBridge::ClipBuffer>& clipBuffer,
+    std::string& error) {
+  daft::audio::ClipPlayerNode::ClipBufferData descriptor;
+  descriptor.key = key;
+  descriptor.sampleRate = clipBuffer->sampleRate;
+  descriptor.frameCount = clipBuffer->frameCount;
+  descriptor.owner = std::const_pointer_cast<void>(std::static_pointer_cast<const void>(clipBuffer));
+  descriptor.format = clipBuffer->format;
+  const auto channelCount = clipBuffer->channelCount();
+  descriptor.channels.reserve(channelCount);
+  for (std::size_t channel = 0; channel < channelCount; ++channel) {
+    const auto* samples = clipBuffer->channelData(channel);
+    if (samples == nullptr) {
+      error = "clip buffer '" + key + "' has insufficient samples";
+      return std::nullopt;
+    }
+    descriptor.channels.push_back(samples);
+  }
+  return descriptor;
+}
 }  // namespace detail
 
 inline std::unique_ptr<daft::audio::DSPNode> CreateNode(const std::string& type,
@@ -126,6 +148,45 @@ inline std::unique_ptr<daft::audio::DSPNode> CreateNode(const std::string& type,
   if (normalized == "sine" || normalized == "sineoscillator" || normalized == "oscillator") {
     auto node = std::make_unique<daft::audio::SineOscillatorNode>();
     detail::applyParameters(*node, options, {});
+    // The shape may also be given by name; numeric values were applied as the parameter above.
+    if (const auto waveform = options.stringValue("waveform")) {
+      static constexpr std::array<std::string_view, 4> kWaveforms = {"sine", "saw", "square", "triangle"};
+      const auto name = detail::normalize(*waveform);
+      const auto it = std::find(kWaveforms.begin(), kWaveforms.end(), name);
+      if (it == kWaveforms.end()) {
+        error = "oscillator waveform must be sine, saw, square or triangle";
+        return nullptr;
+      }
+      node->setParameter(daft::audio::SineOscillatorNode::kWaveform, static_cast<double>(it - kWaveforms.begin()));
+    }
+    return node;
+  }
+  if (normalized == "voicepool" || normalized == "voices" || normalized == "sampler") {
+    std::size_t voiceCount = 16;
+    if (const auto value = options.numericValue("voicecount")) {
+      voiceCount = detail::toSizeT(*value).value_or(1);
+    }
+    auto node = std::make_unique<daft::audio::VoicePoolNode>(voiceCount);
+    if (const auto key = detail::clipBufferKeyFromOptions(options)) {
+      auto clipBuffer = AudioEngineBridge::clipBufferForKey(*key);
+      if (!clipBuffer) {
+        error = "clip buffer '" + *key + "' is not registered";
+        return nullptr;
+      }
+      if (clipBuffer->stream || clipBuffer->channelCount() == 0 || clipBuffer->frameCount == 0) {
+        error = "voice pool clip buffer '" + *key + "' must be resident audio";
+        return nullptr;
+      }
+      auto descriptor = detail::residentClipDescriptor(*key, clipBuffer, error);
+      if (!descriptor) {
+        return nullptr;
+      }
+      node->setClipBuffer(std::move(*descriptor));
+    } else if (normalized == "sampler") {
+      error = "sampler requires a bufferKey option";
+      return nullptr;
+    }
+    detail::applyParameters(*node, options, {"voicecount", "bufferkey"});
     return node;
   }
   if (normalized == "mixer" || normalized == "mixernode") {
@@ -156,12 +217,6 @@ inline std::unique_ptr<daft::audio::DSPNode> CreateNode(const std::string& type,
       }
     }
 
-    daft::audio::ClipPlayerNode::ClipBufferData descriptor;
-    descriptor.key = *key;
-    descriptor.sampleRate = clipBuffer->sampleRate;
-    descriptor.frameCount = clipBuffer->frameCount;
-    descriptor.owner =
-        std::const_pointer_cast<void>(std::static_pointer_cast<const void>(clipBuffer));
     const auto channelCount = clipBuffer->channelCount();
     if (channelCount == 0 || clipBuffer->frameCount == 0) {
       error = "clip buffer '" + *key + "' has no audio data";
@@ -183,18 +238,26 @@ inline std::unique_ptr<daft::audio::DSPNode> CreateNode(const std::string& type,
         }
       }
     }
-    descriptor.channels.reserve(channelCount);
-    for (std::size_t channel = 0; channel < channelCount; ++channel) {
-      const auto span = clipBuffer->channel(channel);
-      if (span.size() < clipBuffer->frameCount) {
-        error = "clip buffer '" + *key + "' has insufficient samples";
+
+    if (clipBuffer->stream) {
+      // Each player gets its own read-ahead ring over the shared mapping.
+      auto stream = AudioEngineBridge::createClipStream(clipBuffer->stream);
+      if (!stream) {
+        error = "clip buffer '" + *key + "' cannot be streamed";
         return nullptr;
       }
-      descriptor.channels.push_back(span.data());
+      auto node = std::make_unique<daft::audio::ClipPlayerNode>();
+      node->setClipStream(std::move(stream));
+      detail::applyParameters(*node, options, {"bufferkey"});
+      return node;
     }
 
+    auto descriptor = detail::residentClipDescriptor(*key, clipBuffer, error);
+    if (!descriptor) {
+      return nullptr;
+    }
     auto node = std::make_unique<daft::audio::ClipPlayerNode>();
-    node->setClipBuffer(std::move(descriptor));
+    node->setClipBuffer(std::move(*descriptor));
     detail::applyParameters(*node, options, {"bufferkey"});
     return node;
   }
@@ -205,6 +268,11 @@ inline std::unique_ptr<daft::audio::DSPNode> CreateNode(const std::string& type,
       error = "plugin nodes require a hostInstanceId option";
       return nullptr;
     }
+    if (hostId->size() > daft::audio::PluginNode::kMaxHostInstanceIdLength) {
+      error = "plugin hostInstanceId exceeds " + std::to_string(daft::audio::PluginNode::kMaxHostInstanceIdLength) +
+              " characters";
+      return nullptr;
+    }
 
     daft::audio::PluginBusCapabilities capabilities{};
     const std::array<std::pair<const char*, bool*>, 6> capabilityMap = {{
@@ -220,9 +288,20 @@ inline std::unique_ptr<daft::audio::DSPNode> CreateNode(const std::string& type,
     }
 
     auto node = std::make_unique<daft::audio::PluginNode>(*hostId, capabilities);
+    if (detail::parseBoolean(options, "anticipative")) {
+      std::size_t latency = daft::audio::PluginNode::kDefaultAnticipativeFrames;
+      if (const auto value = options.numericValue("anticipationframes")) {
+        latency = detail::toSizeT(*value).value_or(0);
+      }
+      if (latency == 0 || latency > std::numeric_limits<std::uint32_t>::max()) {
+        error = "plugin anticipationFrames must be a positive frame count";
+        return nullptr;
+      }
+      node->enableAnticipation(static_cast<std::uint32_t>(latency));
+    }
     detail::applyParameters(*node, options,
                            {"hostinstanceid", "acceptsaudio", "emitsaudio", "acceptsmidi", "emitsmidi",
-                            "acceptssidechain", "emitssidechain"});
+                            "acceptssidechain", "emitssidechain", "anticipative", "anticipationframes"});
     return node;
   }
 
@@ -5,11 +5,13 @@
 #include <cstdint>
 #include <memory>
 #include <mutex>
-#include <span>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "audio_engine/ClipRegistry.h"
+#include "audio_engine/ClipStream.h"
+#include "audio_engine/OfflineRenderer.h"
+#include "audio_engine/SampleFormat.h"
 #include "audio_engine/SceneGraph.h"
 
 namespace daft::audio::bridge {
@@ -20,23 +22,27 @@ class AudioEngineBridge {
     std::uint64_t xruns;
     double lastRenderDurationMicros;
     std::size_t clipBufferBytes;
+    std::size_t scratchBufferCount;
+    std::size_t scratchBufferBytes;
+    std::uint64_t streamUnderruns;
   };
 
-  struct ClipBuffer {
-    double sampleRate = 0.0;
-    std::size_t frameCount = 0;
-    std::vector<std::vector<float>> channelSamples;
-
-    [[nodiscard]] std::size_t channelCount() const { return channelSamples.size(); }
-    [[nodiscard]] std::span<const float> channel(std::size_t index) const {
-      if (index >= channelSamples.size()) {
-        return {};
-      }
-      return std::span<const float>(channelSamples[index].data(), channelSamples[index].size());
-    }
+  struct OfflineRenderStatus {
+    OfflineRenderer::State state = OfflineRenderer::State::kIdle;
+    std::uint64_t renderedFrames = 0;
+    std::uint64_t writtenFrames = 0;
+    std::uint64_t totalFrames = 0;
+    std::string error;
   };
 
-  static void initialize(double sampleRate, std::uint32_t framesPerBuffer);
+  using ClipBuffer = daft::audio::ClipBuffer;
+
+  // Output channels the platform graph renders unless initialize asks otherwise; the engine has
+  // always fed four hardware channels.
+  static constexpr std::size_t kDefaultMaxChannels = 4;
+
+  static void initialize(double sampleRate, std::uint32_t framesPerBuffer,
+                         std::size_t maxChannels = kDefaultMaxChannels, std::size_t maxFramesPerBuffer = 0);
   static void shutdown();
   static void render(float** outputs, std::size_t channelCount, std::size_t frameCount);
 
@@ -44,26 +50,55 @@ class AudioEngineBridge {
   static void removeNode(const std::string& id);
   static bool connect(const std::string& source, const std::string& destination);
   static void disconnect(const std::string& source, const std::string& destination);
+  static void beginGraphUpdate();
+  static void commitGraphUpdate();
+  static void setParameter(const std::string& nodeId, const std::string& parameter, double value);
   static void scheduleParameterAutomation(const std::string& nodeId, const std::string& parameter,
                                           std::uint64_t frame, double value);
+  static void scheduleParameterRamp(const std::string& nodeId, const std::string& parameter, std::uint64_t frame,
+                                    double value, std::uint32_t durationFrames, RampShape shape);
   static bool registerClipBuffer(const std::string& key, double sampleRate, std::size_t channelCount,
-                                 std::size_t frameCount, std::vector<std::vector<float>> channelData);
+                                 std::size_t frameCount, std::vector<std::vector<float>> channelData,
+                                 SampleFormat storageFormat = SampleFormat::kFloat32);
+  static bool adoptClipBuffer(const std::string& key, double sampleRate, std::size_t frameCount,
+                              std::vector<const void*> channels, std::shared_ptr<const void> storage,
+                              SampleFormat format = SampleFormat::kFloat32);
+  static bool encodeClipBuffer(const std::string& key, double sampleRate, std::size_t frameCount,
+                               const std::vector<const float*>& channels, SampleFormat format);
+  static bool registerClipBufferFromFd(const std::string& key, double sampleRate, std::size_t channelCount,
+                                       std::size_t frameCount, int fd, std::size_t dataOffsetBytes,
+                                       std::string& error);
+  static bool registerClipStream(const std::string& key, const std::string& path, double sampleRate,
+                                 std::size_t channelCount, std::size_t dataOffsetBytes, std::string& error);
   static bool unregisterClipBuffer(const std::string& key);
   static std::shared_ptr<const ClipBuffer> clipBufferForKey(const std::string& key);
+  static std::shared_ptr<ClipStream> createClipStream(std::shared_ptr<const ClipFileSource> source);
+  static bool startOfflineRender(const std::string& path, const OfflineRenderer::Options& options,
+                                 std::string& error);
+  static void cancelOfflineRender();
+  static OfflineRenderStatus getOfflineRenderStatus();
   static RenderDiagnostics getDiagnostics();
+  static void setProfilingEnabled(bool enabled);
+  static RenderProfiler::Report getRenderProfile();
 
  private:
-  struct ClipBufferEntry {
-    std::shared_ptr<ClipBuffer> buffer;
-    std::size_t referenceCount = 0;
-    std::size_t byteSize = 0;
-  };
+  static void detachRenderGraph();
+  static void finishOfflineRender();
 
   static std::unique_ptr<SceneGraph> graph_;
+  // Guards control-thread access to graph_. The render thread never takes it, and clipRegistry_ has its own.
   static std::mutex mutex_;
+  // Render-side view of graph_. Cleared (and waited on via renderInFlight_) before graph_ is replaced.
+  static std::atomic<SceneGraph*> renderGraph_;
+  static std::atomic<bool> renderInFlight_;
   static std::atomic<std::uint64_t> xruns_;
   static std::atomic<double> lastRenderDurationMicros_;
-  static std::unordered_map<std::string, ClipBufferEntry> clipBuffers_;
+  // Lock-free clip lookups for NodeFactory; buffers it drops are freed on its reclaimer thread.
+  static ClipRegistry clipRegistry_;
+  // Background read-ahead thread for streamed clips. Players own their streams, so it may stop first.
+  static std::unique_ptr<ClipStreamer> streamer_;
+  // Bounce in progress or last finished; while it renders, renderGraph_ stays detached from graph_.
+  static std::unique_ptr<OfflineRenderer> offlineRenderer_;
 };
 
 }  // namespace daft::audio::bridge
@@ -4,10 +4,14 @@
 
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <exception>
 #include <mutex>
+#include <thread>
 #include <vector>
 
+#include "audio_engine/DSPKernels.h"
+
 namespace daft::audio::bridge {
 
 namespace {
@@ -15,66 +19,104 @@ os_log_t Logger() {
   static os_log_t log = os_log_create("com.daft.audio", "engine");
   return log;
 }
+
+// Read-ahead held per streamed clip player, in seconds of source audio.
+constexpr double kStreamReadAheadSeconds = 2.0;
 }  // namespace
 
 std::unique_ptr<SceneGraph> AudioEngineBridge::graph_;
 std::mutex AudioEngineBridge::mutex_;
+std::atomic<SceneGraph*> AudioEngineBridge::renderGraph_{nullptr};
+std::atomic<bool> AudioEngineBridge::renderInFlight_{false};
 std::atomic<std::uint64_t> AudioEngineBridge::xruns_{0};
 std::atomic<double> AudioEngineBridge::lastRenderDurationMicros_{0.0};
-std::unordered_map<std::string, AudioEngineBridge::ClipBufferEntry> AudioEngineBridge::clipBuffers_;
+ClipRegistry AudioEngineBridge::clipRegistry_;
+std::unique_ptr<ClipStreamer> AudioEngineBridge::streamer_;
+std::unique_ptr<OfflineRenderer> AudioEngineBridge::offlineRenderer_;
 
-void AudioEngineBridge::initialize(double sampleRate, std::uint32_t framesPerBuffer) {
+void AudioEngineBridge::initialize(double sampleRate, std::uint32_t framesPerBuffer, std::size_t maxChannels,
+                                   std::size_t maxFramesPerBuffer) {
+  // Build the new graph first so invalid limits leave the running one untouched.
+  auto graph = std::make_unique<SceneGraph>(
+      sampleRate, framesPerBuffer, maxChannels,
+      maxFramesPerBuffer == 0 ? SceneGraph::kDefaultMaxFrames : maxFramesPerBuffer);
   std::lock_guard<std::mutex> lock(mutex_);
-  graph_ = std::make_unique<SceneGraph>(sampleRate, framesPerBuffer);
+  detachRenderGraph();
+  if (offlineRenderer_) {
+    offlineRenderer_->cancel();
+    offlineRenderer_.reset();
+  }
+  graph_ = std::move(graph);
+  renderGraph_.store(graph_.get());
+  if (!streamer_) {
+    streamer_ = std::make_unique<ClipStreamer>();
+  }
   xruns_.store(0);
   lastRenderDurationMicros_.store(0.0);
-  os_log(Logger(), "Audio engine initialized at %.2f Hz", sampleRate);
+  os_log(Logger(), "Audio engine initialized at %.2f Hz, %zu channels, %zu-frame blocks", sampleRate,
+         graph_->maxSupportedChannels(), graph_->maxSupportedFramesPerBuffer());
 }
 
 void AudioEngineBridge::shutdown() {
   std::lock_guard<std::mutex> lock(mutex_);
+  detachRenderGraph();
+  if (offlineRenderer_) {
+    offlineRenderer_->cancel();
+    offlineRenderer_.reset();
+  }
   graph_.reset();
+  streamer_.reset();
   xruns_.store(0);
   lastRenderDurationMicros_.store(0.0);
-  clipBuffers_.clear();
+  clipRegistry_.clear();
   os_log(Logger(), "Audio engine shutdown");
 }
 
 void AudioEngineBridge::render(float** outputs, std::size_t channelCount, std::size_t frameCount) {
   AudioBufferView view(outputs, channelCount, frameCount);
-  std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
-  if (!lock.owns_lock()) {
-    view.fill(0.0F);
-    xruns_.fetch_add(1);
-    lastRenderDurationMicros_.store(0.0);
-    return;
-  }
-  if (!graph_) {
+  renderInFlight_.store(true);
+  SceneGraph* graph = renderGraph_.load();
+  if (graph == nullptr) {
     view.fill(0.0F);
     lastRenderDurationMicros_.store(0.0);
+    renderInFlight_.store(false);
     return;
   }
   const auto start = std::chrono::steady_clock::now();
   try {
-    graph_->render(view);
+    graph->render(view);
   } catch (const std::exception& ex) {
     view.fill(0.0F);
     xruns_.fetch_add(1);
+    graph->recordRenderError();
     lastRenderDurationMicros_.store(0.0);
+    renderInFlight_.store(false);
     os_log_error(Logger(), "Render failed: %{public}s", ex.what());
     return;
   } catch (...) {
     view.fill(0.0F);
     xruns_.fetch_add(1);
+    graph->recordRenderError();
     lastRenderDurationMicros_.store(0.0);
+    renderInFlight_.store(false);
     os_log_error(Logger(), "Render failed with unknown error");
     return;
   }
+  renderInFlight_.store(false);
   const auto end = std::chrono::steady_clock::now();
   const auto micros = std::chrono::duration<double, std::micro>(end - start).count();
   lastRenderDurationMicros_.store(micros);
 }
 
+void AudioEngineBridge::detachRenderGraph() {
+  // Sequentially consistent handshake with render(): once renderGraph_ is null and no render is in
+  // flight, the audio thread can no longer observe graph_.
+  renderGraph_.store(nullptr);
+  while (renderInFlight_.load()) {
+    std::this_thread::yield();
+  }
+}
+
 bool AudioEngineBridge::addNode(const std::string& id, std::unique_ptr<DSPNode> node) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (!graph_) {
@@ -105,22 +147,59 @@ void AudioEngineBridge::disconnect(const std::string& source, const std::string&
   }
 }
 
+void AudioEngineBridge::beginGraphUpdate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (graph_) {
+    graph_->beginUpdate();
+  }
+}
+
+void AudioEngineBridge::commitGraphUpdate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (graph_) {
+    graph_->commit();
+  }
+}
+
+void AudioEngineBridge::setParameter(const std::string& nodeId, const std::string& parameter, double value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!graph_) {
+    return;
+  }
+  const auto parameterId = graph_->findParameter(nodeId, parameter);
+  if (parameterId == kInvalidParamId) {
+    os_log_error(Logger(), "Unknown parameter %{public}s on node %{public}s", parameter.c_str(), nodeId.c_str());
+    return;
+  }
+  // Direct on a node no published plan holds yet; otherwise due at the start of the next block.
+  graph_->setParameter(nodeId, parameterId, value);
+}
+
 void AudioEngineBridge::scheduleParameterAutomation(const std::string& nodeId, const std::string& parameter,
                                                     std::uint64_t frame, double value) {
+  scheduleParameterRamp(nodeId, parameter, frame, value, 0, RampShape::kLinear);
+}
+
+void AudioEngineBridge::scheduleParameterRamp(const std::string& nodeId, const std::string& parameter,
+                                              std::uint64_t frame, double value, std::uint32_t durationFrames,
+                                              RampShape shape) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (!graph_) {
     return;
   }
-  try {
-    graph_->scheduleAutomation(nodeId,
-                               [parameter, value](DSPNode& node) { node.setParameter(parameter, value); }, frame);
-  } catch (const std::exception& ex) {
-    os_log_error(Logger(), "Failed to schedule automation: %{public}s", ex.what());
+  // Resolve the name here so the audio thread only ever dispatches integer parameter ids. A missing node
+  // or a full scheduler queue throws, so callers can report the dropped event.
+  const auto parameterId = graph_->findParameter(nodeId, parameter);
+  if (parameterId == kInvalidParamId) {
+    os_log_error(Logger(), "Unknown automation parameter %{public}s on node %{public}s", parameter.c_str(), nodeId.c_str());
+    return;
   }
+  graph_->scheduleRamp(nodeId, parameterId, frame, value, durationFrames, shape);
 }
 
 bool AudioEngineBridge::registerClipBuffer(const std::string& key, double sampleRate, std::size_t channelCount,
-                                           std::size_t frameCount, std::vector<std::vector<float>> channelData) {
+                                           std::size_t frameCount, std::vector<std::vector<float>> channelData,
+                                           SampleFormat storageFormat) {
   if (key.empty() || !std::isfinite(sampleRate) || sampleRate <= 0.0 || channelCount == 0 || frameCount == 0) {
     return false;
   }
@@ -133,17 +212,130 @@ bool AudioEngineBridge::registerClipBuffer(const std::string& key, double sample
     }
   }
 
+  if (storageFormat != SampleFormat::kFloat32) {
+    std::vector<const float*> channels;
+    channels.reserve(channelCount);
+    for (const auto& channel : channelData) {
+      channels.push_back(channel.data());
+    }
+    return encodeClipBuffer(key, sampleRate, frameCount, channels, storageFormat);
+  }
+
   auto buffer = std::make_shared<ClipBuffer>();
   buffer->sampleRate = sampleRate;
   buffer->frameCount = frameCount;
   buffer->channelSamples = std::move(channelData);
-  const std::size_t byteSize = channelCount * frameCount * sizeof(float);
+  clipRegistry_.store(key, std::move(buffer), channelCount * frameCount * sizeof(float));
+  return true;
+}
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto& entry = clipBuffers_[key];
-  entry.buffer = std::move(buffer);
-  entry.byteSize = byteSize;
-  entry.referenceCount += 1;
+/**
+ * @brief Registers caller-owned planar channels encoded as `format` without copying them.
+ *
+ * Each channel pointer must address `frameCount` samples that stay valid for as long as `storage` is
+ * alive. The buffer (and with it `storage`) is released once the key is unregistered and the last clip
+ * player referencing it is gone.
+ */
+bool AudioEngineBridge::adoptClipBuffer(const std::string& key, double sampleRate, std::size_t frameCount,
+                                        std::vector<const void*> channels, std::shared_ptr<const void> storage,
+                                        SampleFormat format) {
+  if (key.empty() || !std::isfinite(sampleRate) || sampleRate <= 0.0 || frameCount == 0 || channels.empty() ||
+      !storage) {
+    return false;
+  }
+  for (const auto* channel : channels) {
+    if (channel == nullptr || reinterpret_cast<std::uintptr_t>(channel) % BytesPerSample(format) != 0) {
+      return false;
+    }
+  }
+
+  auto buffer = std::make_shared<ClipBuffer>();
+  buffer->sampleRate = sampleRate;
+  buffer->frameCount = frameCount;
+  buffer->format = format;
+  const std::size_t byteSize = channels.size() * frameCount * BytesPerSample(format);
+  buffer->adoptedChannels = std::move(channels);
+  buffer->storage = std::move(storage);
+  clipRegistry_.store(key, std::move(buffer), byteSize);
+  return true;
+}
+
+/**
+ * @brief Re-encodes planar Float32 channels into a compact storage format and registers the result.
+ *
+ * int16 halves the footprint at 16-bit resolution; float16 halves it while keeping headroom above full
+ * scale. Players decode back to float while rendering.
+ */
+bool AudioEngineBridge::encodeClipBuffer(const std::string& key, double sampleRate, std::size_t frameCount,
+                                         const std::vector<const float*>& channels, SampleFormat format) {
+  if (format == SampleFormat::kFloat32 || channels.empty() || frameCount == 0) {
+    return false;
+  }
+  auto encoded = std::make_shared<std::vector<std::uint16_t>>(channels.size() * frameCount);
+  std::vector<const void*> pointers(channels.size());
+  for (std::size_t channel = 0; channel < channels.size(); ++channel) {
+    if (channels[channel] == nullptr) {
+      return false;
+    }
+    auto* dest = encoded->data() + channel * frameCount;
+    if (format == SampleFormat::kInt16) {
+      dsp::encodeInt16(reinterpret_cast<std::int16_t*>(dest), channels[channel], frameCount);
+    } else {
+      dsp::encodeFloat16(dest, channels[channel], frameCount);
+    }
+    pointers[channel] = dest;
+  }
+  return adoptClipBuffer(key, sampleRate, frameCount, std::move(pointers), std::move(encoded), format);
+}
+
+/**
+ * @brief Maps planar Float32 channels (`channelCount` runs of `frameCount` samples starting at
+ * `dataOffsetBytes`) from a file or shared-memory descriptor and adopts the mapping.
+ *
+ * The descriptor may be closed as soon as this returns.
+ */
+bool AudioEngineBridge::registerClipBufferFromFd(const std::string& key, double sampleRate, std::size_t channelCount,
+                                                 std::size_t frameCount, int fd, std::size_t dataOffsetBytes,
+                                                 std::string& error) {
+  if (channelCount == 0 || frameCount == 0 || dataOffsetBytes % sizeof(float) != 0) {
+    error = "mapped clips require positive dimensions and a 4-byte aligned offset";
+    return false;
+  }
+  auto mapping = MapFileRegion(fd, dataOffsetBytes, channelCount * frameCount * sizeof(float), error);
+  if (!mapping) {
+    os_log_error(Logger(), "Clip buffer %{public}s not mapped: %{public}s", key.c_str(), error.c_str());
+    return false;
+  }
+  const auto* samples = static_cast<const float*>(mapping.get());
+  std::vector<const void*> channels(channelCount);
+  for (std::size_t channel = 0; channel < channelCount; ++channel) {
+    channels[channel] = samples + channel * frameCount;
+  }
+  if (!adoptClipBuffer(key, sampleRate, frameCount, std::move(channels), std::move(mapping))) {
+    error = "invalid clip buffer parameters";
+    return false;
+  }
+  return true;
+}
+
+bool AudioEngineBridge::registerClipStream(const std::string& key, const std::string& path, double sampleRate,
+                                           std::size_t channelCount, std::size_t dataOffsetBytes, std::string& error) {
+  if (key.empty() || path.empty()) {
+    error = "clip streams require a key and a file path";
+    return false;
+  }
+  auto source = ClipFileSource::open(path, channelCount, sampleRate, dataOffsetBytes, error);
+  if (!source) {
+    os_log_error(Logger(), "Clip stream %{public}s not registered: %{public}s", key.c_str(), error.c_str());
+    return false;
+  }
+
+  auto buffer = std::make_shared<ClipBuffer>();
+  buffer->sampleRate = sampleRate;
+  buffer->frameCount = source->frameCount();
+  buffer->stream = std::move(source);
+  // Streamed clips are mapped, not resident, so they do not count towards the clip-buffer footprint.
+  clipRegistry_.store(key, std::move(buffer), 0);
   return true;
 }
 
@@ -151,36 +343,123 @@ bool AudioEngineBridge::unregisterClipBuffer(const std::string& key) {
   if (key.empty()) {
     return false;
   }
+  // Unknown keys count as already released.
+  clipRegistry_.release(key);
+  return true;
+}
+
+std::shared_ptr<const AudioEngineBridge::ClipBuffer> AudioEngineBridge::clipBufferForKey(const std::string& key) {
+  return clipRegistry_.find(key);
+}
+
+std::shared_ptr<ClipStream> AudioEngineBridge::createClipStream(std::shared_ptr<const ClipFileSource> source) {
   std::lock_guard<std::mutex> lock(mutex_);
-  auto it = clipBuffers_.find(key);
-  if (it == clipBuffers_.end()) {
-    return true;
+  if (!streamer_ || !source) {
+    return nullptr;
   }
-  auto& entry = it->second;
-  if (entry.referenceCount > 0) {
-    entry.referenceCount -= 1;
+  const auto capacity = static_cast<std::size_t>(std::ceil(source->sampleRate() * kStreamReadAheadSeconds));
+  return streamer_->createStream(std::move(source), capacity);
+}
+
+bool AudioEngineBridge::startOfflineRender(const std::string& path, const OfflineRenderer::Options& options,
+                                           std::string& error) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!graph_) {
+    error = "audio engine is not initialized";
+    return false;
   }
-  if (entry.referenceCount == 0) {
-    clipBuffers_.erase(it);
+  if (offlineRenderer_ && offlineRenderer_->progress().state == OfflineRenderer::State::kRendering) {
+    error = "an offline render is already running";
+    return false;
   }
-  return true;
+  finishOfflineRender();
+  // The bounce rewinds the graph and drives it from its own thread; the realtime callback renders silence.
+  detachRenderGraph();
+  offlineRenderer_ = std::make_unique<OfflineRenderer>();
+  try {
+    if (offlineRenderer_->start(*graph_, path, options, error)) {
+      os_log(Logger(), "Offline render started: %llu frames", static_cast<unsigned long long>(options.frameCount));
+      return true;
+    }
+  } catch (const std::exception& ex) {
+    error = ex.what();
+  }
+  offlineRenderer_.reset();
+  renderGraph_.store(graph_.get());
+  return false;
 }
 
-std::shared_ptr<const AudioEngineBridge::ClipBuffer> AudioEngineBridge::clipBufferForKey(const std::string& key) {
+void AudioEngineBridge::cancelOfflineRender() {
   std::lock_guard<std::mutex> lock(mutex_);
-  if (const auto it = clipBuffers_.find(key); it != clipBuffers_.end()) {
-    return it->second.buffer;
+  if (offlineRenderer_) {
+    offlineRenderer_->cancel();
+    finishOfflineRender();
+  }
+}
+
+AudioEngineBridge::OfflineRenderStatus AudioEngineBridge::getOfflineRenderStatus() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!offlineRenderer_) {
+    return {};
+  }
+  const auto progress = offlineRenderer_->progress();
+  if (progress.state != OfflineRenderer::State::kRendering) {
+    finishOfflineRender();
+  }
+  return {progress.state, progress.renderedFrames, progress.writtenFrames, progress.totalFrames,
+          offlineRenderer_->error()};
+}
+
+void AudioEngineBridge::finishOfflineRender() {
+  // Caller holds mutex_. wait() is a no-op once the bounce has been handed back.
+  if (!offlineRenderer_) {
+    return;
+  }
+  try {
+    offlineRenderer_->wait();
+  } catch (const std::exception& ex) {
+    os_log_error(Logger(), "Offline render cleanup failed: %{public}s", ex.what());
+  }
+  if (graph_) {
+    renderGraph_.store(graph_.get());
   }
-  return nullptr;
 }
 
 AudioEngineBridge::RenderDiagnostics AudioEngineBridge::getDiagnostics() {
-  RenderDiagnostics diagnostics{xruns_.load(), lastRenderDurationMicros_.load(), 0};
+  // Clip bytes are kept as a running total so this never walks the clip registry.
+  RenderDiagnostics diagnostics{xruns_.load(), lastRenderDurationMicros_.load(), clipRegistry_.bytes(), 0, 0, 0};
   std::lock_guard<std::mutex> lock(mutex_);
-  for (const auto& [_, entry] : clipBuffers_) {
-    diagnostics.clipBufferBytes += entry.byteSize;
+  if (graph_) {
+    graph_->reclaimRetiredPlans();
+    diagnostics.scratchBufferCount = graph_->scratchBufferCount();
+    diagnostics.scratchBufferBytes = graph_->scratchBufferBytes();
+  }
+  if (streamer_) {
+    diagnostics.streamUnderruns = streamer_->underruns();
   }
   return diagnostics;
 }
 
+/**
+ * @brief Turns render profiling on or off for the current graph (see `SceneGraph::setProfilingEnabled`).
+ *
+ * The setting belongs to the graph, so `initialize` starts unprofiled again.
+ */
+void AudioEngineBridge::setProfilingEnabled(bool enabled) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (graph_) {
+    graph_->setProfilingEnabled(enabled);
+  }
+}
+
+/**
+ * @brief Summarises block, DSP-load, jitter and per-node timings recorded since profiling was enabled.
+ *
+ * @return The graph's profile report; `enabled` is false while profiling is off or before initialization.
+ */
+RenderProfiler::Report AudioEngineBridge::getRenderProfile() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return graph_ ? graph_->renderProfile() : RenderProfiler::Report{};
+}
+
 }  // namespace daft::audio::bridge
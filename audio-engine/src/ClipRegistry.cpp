@@ -0,0 +1,128 @@
+#include "audio_engine/ClipRegistry.h"
+
+#include <utility>
+
+namespace daft::audio {
+
+ClipRegistry::ClipRegistry(std::chrono::milliseconds reclaimInterval)
+    : snapshot_(new Snapshot()), reclaimInterval_(reclaimInterval) {}
+
+ClipRegistry::~ClipRegistry() {
+  {
+    std::lock_guard<std::mutex> lock(reclaimMutex_);
+    stopping_ = true;
+  }
+  reclaimWake_.notify_all();
+  if (reclaimer_.joinable()) {
+    reclaimer_.join();
+  }
+  // Nobody may read a registry that is being destroyed; what the nodes still reference outlives it.
+  delete snapshot_.load(std::memory_order_acquire);
+}
+
+void ClipRegistry::store(const std::string& key, std::shared_ptr<const ClipBuffer> buffer, std::size_t byteSize) {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  auto next = std::make_unique<Snapshot>(*snapshot_.load(std::memory_order_relaxed));
+  auto& entry = (*next)[key];
+  auto replaced = std::exchange(entry.buffer, std::move(buffer));
+  bytes_.fetch_add(byteSize, std::memory_order_relaxed);
+  bytes_.fetch_sub(entry.byteSize, std::memory_order_relaxed);
+  entry.byteSize = byteSize;
+  entry.referenceCount += 1;
+  if (replaced) {
+    retire(std::move(replaced));
+  }
+  publish(std::move(next));
+}
+
+bool ClipRegistry::release(const std::string& key) {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  const auto* current = snapshot_.load(std::memory_order_relaxed);
+  const auto it = current->find(key);
+  if (it == current->end()) {
+    return false;
+  }
+  auto next = std::make_unique<Snapshot>(*current);
+  auto entry = next->find(key);
+  if (entry->second.referenceCount > 1) {
+    entry->second.referenceCount -= 1;
+  } else {
+    bytes_.fetch_sub(entry->second.byteSize, std::memory_order_relaxed);
+    retire(std::move(entry->second.buffer));
+    next->erase(entry);
+  }
+  publish(std::move(next));
+  return true;
+}
+
+void ClipRegistry::clear() {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  for (const auto& [key, entry] : *snapshot_.load(std::memory_order_relaxed)) {
+    retire(entry.buffer);
+  }
+  bytes_.store(0, std::memory_order_relaxed);
+  publish(std::make_unique<Snapshot>());
+}
+
+std::shared_ptr<const ClipBuffer> ClipRegistry::find(const std::string& key) const {
+  // Announcing the read before loading the snapshot keeps the writer from freeing it underneath us:
+  // a writer that sees no readers after its exchange can only be followed by loads of the new one.
+  readers_.fetch_add(1, std::memory_order_seq_cst);
+  const auto* current = snapshot_.load(std::memory_order_seq_cst);
+  std::shared_ptr<const ClipBuffer> buffer;
+  if (const auto it = current->find(key); it != current->end()) {
+    buffer = it->second.buffer;
+  }
+  readers_.fetch_sub(1, std::memory_order_release);
+  return buffer;
+}
+
+std::size_t ClipRegistry::pendingReclaims() const {
+  std::lock_guard<std::mutex> lock(reclaimMutex_);
+  return retired_.size();
+}
+
+void ClipRegistry::publish(std::unique_ptr<Snapshot> next) {
+  const auto* previous = snapshot_.exchange(next.release(), std::memory_order_seq_cst);
+  // Lookups are a hash probe and a reference-count increment, so this grace period is short.
+  while (readers_.load(std::memory_order_acquire) != 0) {
+    std::this_thread::yield();
+  }
+  delete previous;
+}
+
+void ClipRegistry::retire(std::shared_ptr<const ClipBuffer> buffer) {
+  if (!buffer) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(reclaimMutex_);
+    retired_.push_back(std::move(buffer));
+    if (!reclaimer_.joinable()) {
+      reclaimer_ = std::thread([this]() { runReclaimer(); });
+    }
+  }
+  reclaimWake_.notify_all();
+}
+
+void ClipRegistry::runReclaimer() {
+  std::vector<std::shared_ptr<const ClipBuffer>> unused;
+  std::unique_lock<std::mutex> lock(reclaimMutex_);
+  while (!stopping_) {
+    // The registry has forgotten these buffers, so once our reference is the only one no other thread
+    // can take a new one and the buffer is ours to free.
+    std::erase_if(retired_, [&unused](std::shared_ptr<const ClipBuffer>& buffer) {
+      if (buffer.use_count() == 1) {
+        unused.push_back(std::move(buffer));
+        return true;
+      }
+      return false;
+    });
+    lock.unlock();
+    unused.clear();
+    lock.lock();
+    reclaimWake_.wait_for(lock, reclaimInterval_, [this]() { return stopping_; });
+  }
+}
+
+}  // namespace daft::audio
@@ -0,0 +1,271 @@
+#include "audio_engine/ClipStream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace daft::audio {
+
+namespace {
+
+constexpr unsigned kFrameBits = 40;
+constexpr std::uint64_t kFrameMask = (std::uint64_t{1} << kFrameBits) - 1;
+constexpr std::uint64_t kGenerationMask = (std::uint64_t{1} << (64 - kFrameBits)) - 1;
+// Frames read per stream per pass, so one long refill cannot starve the other streams.
+constexpr std::size_t kFillChunkFrames = 16384;
+
+constexpr std::uint64_t PackCursor(std::uint64_t generation, std::uint64_t frame) {
+  return (generation << kFrameBits) | (frame & kFrameMask);
+}
+
+}  // namespace
+
+std::shared_ptr<const void> MapFileRegion(int fd, std::size_t offset, std::size_t length, std::string& error) {
+  if (fd < 0 || length == 0) {
+    error = "mapping requires a valid descriptor and a non-empty range";
+    return nullptr;
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) != 0 || info.st_size < 0 || static_cast<std::size_t>(info.st_size) < offset ||
+      static_cast<std::size_t>(info.st_size) - offset < length) {
+    error = "descriptor is smaller than the requested range";
+    return nullptr;
+  }
+  // mmap offsets must be page aligned; map from the enclosing page and alias the requested byte.
+  const auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  const auto alignedOffset = offset - offset % pageSize;
+  const auto mappedBytes = length + (offset - alignedOffset);
+  void* mapping = ::mmap(nullptr, mappedBytes, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(alignedOffset));
+  if (mapping == MAP_FAILED) {
+    error = "cannot map descriptor";
+    return nullptr;
+  }
+  std::shared_ptr<void> owner(mapping, [mappedBytes](void* address) { ::munmap(address, mappedBytes); });
+  return std::shared_ptr<const void>(owner, static_cast<const char*>(mapping) + (offset - alignedOffset));
+}
+
+std::shared_ptr<ClipFileSource> ClipFileSource::open(const std::string& path, std::size_t channelCount,
+                                                     double sampleRate, std::size_t dataOffsetBytes,
+                                                     std::string& error) {
+  if (channelCount == 0 || !(sampleRate > 0.0)) {
+    error = "stream requires a positive channel count and sample rate";
+    return nullptr;
+  }
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error = "cannot open '" + path + "'";
+    return nullptr;
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+    ::close(fd);
+    error = "cannot stat '" + path + "'";
+    return nullptr;
+  }
+  const auto fileBytes = static_cast<std::size_t>(info.st_size);
+  const auto frameBytes = channelCount * sizeof(float);
+  if (dataOffsetBytes % sizeof(float) != 0 || fileBytes <= dataOffsetBytes ||
+      (fileBytes - dataOffsetBytes) / frameBytes == 0) {
+    ::close(fd);
+    error = "'" + path + "' holds no float PCM frames";
+    return nullptr;
+  }
+  void* mapping = ::mmap(nullptr, fileBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    error = "cannot map '" + path + "'";
+    return nullptr;
+  }
+  ::madvise(mapping, fileBytes, MADV_SEQUENTIAL);
+  const auto* samples = reinterpret_cast<const float*>(static_cast<const char*>(mapping) + dataOffsetBytes);
+  const auto frameCount = (fileBytes - dataOffsetBytes) / frameBytes;
+  return std::shared_ptr<ClipFileSource>(
+      new ClipFileSource(mapping, fileBytes, samples, channelCount, frameCount, sampleRate));
+}
+
+ClipFileSource::ClipFileSource(void* mapping, std::size_t mappedBytes, const float* samples, std::size_t channelCount,
+                               std::size_t frameCount, double sampleRate)
+    : mapping_(mapping),
+      mappedBytes_(mappedBytes),
+      samples_(samples),
+      channelCount_(channelCount),
+      frameCount_(frameCount),
+      sampleRate_(sampleRate) {}
+
+ClipFileSource::~ClipFileSource() { ::munmap(mapping_, mappedBytes_); }
+
+void ClipFileSource::read(std::uint64_t frame, std::size_t count, float* const* channels) const {
+  const auto* interleaved = samples_ + static_cast<std::size_t>(frame) * channelCount_;
+  for (std::size_t ch = 0; ch < channelCount_; ++ch) {
+    auto* dest = channels[ch];
+    for (std::size_t i = 0; i < count; ++i) {
+      dest[i] = interleaved[i * channelCount_ + ch];
+    }
+  }
+}
+
+ClipStream::ClipStream(std::shared_ptr<const ClipFileSource> source, std::size_t capacityFrames,
+                       std::shared_ptr<std::atomic<std::uint64_t>> underrunCounter)
+    : source_(std::move(source)),
+      capacity_(std::max<std::size_t>(1, capacityFrames)),
+      samples_(capacity_ * source_->channelCount(), 0.0F),
+      fillChannels_(source_->channelCount()),
+      underrunCounter_(std::move(underrunCounter)) {}
+
+bool ClipStream::read(std::uint64_t frame, std::size_t count, float* const* channels) noexcept {
+  const auto channelCount = source_->channelCount();
+  if (frame != readFrame_) {
+    requestFrom(frame);
+  }
+  const std::uint64_t totalFrames = source_->frameCount();
+  const auto available =
+      frame < totalFrames ? static_cast<std::size_t>(std::min<std::uint64_t>(count, totalFrames - frame)) : 0;
+
+  if (direct_) {
+    source_->read(frame, available, channels);
+    for (std::size_t ch = 0; ch < channelCount; ++ch) {
+      std::fill(channels[ch] + available, channels[ch] + count, 0.0F);
+    }
+    readFrame_ = frame + count;
+    request_.store(PackCursor(generation_, std::min<std::uint64_t>(readFrame_, totalFrames)),
+                   std::memory_order_release);
+    return true;
+  }
+
+  const auto published = published_.load(std::memory_order_acquire);
+  if ((published >> kFrameBits) != generation_ || (published & kFrameMask) < frame + available) {
+    for (std::size_t ch = 0; ch < channelCount; ++ch) {
+      std::fill_n(channels[ch], count, 0.0F);
+    }
+    underruns_.fetch_add(1, std::memory_order_relaxed);
+    if (underrunCounter_) {
+      underrunCounter_->fetch_add(1, std::memory_order_relaxed);
+    }
+    // Playback moves on regardless; have the producer meet it where the next read will land.
+    requestFrom(frame + count);
+    return false;
+  }
+
+  const auto offset = static_cast<std::size_t>(frame % capacity_);
+  const auto first = std::min(available, capacity_ - offset);
+  for (std::size_t ch = 0; ch < channelCount; ++ch) {
+    const auto* ring = samples_.data() + ch * capacity_;
+    std::memcpy(channels[ch], ring + offset, first * sizeof(float));
+    std::memcpy(channels[ch] + first, ring, (available - first) * sizeof(float));
+    std::fill(channels[ch] + available, channels[ch] + count, 0.0F);
+  }
+  readFrame_ = frame + count;
+  request_.store(PackCursor(generation_, std::min<std::uint64_t>(readFrame_, totalFrames)), std::memory_order_release);
+  return true;
+}
+
+void ClipStream::seek(std::uint64_t frame) noexcept {
+  if (frame != readFrame_) {
+    requestFrom(frame);
+  }
+}
+
+void ClipStream::requestFrom(std::uint64_t frame) noexcept {
+  generation_ = (generation_ + 1) & kGenerationMask;
+  readFrame_ = frame;
+  request_.store(PackCursor(generation_, std::min<std::uint64_t>(frame, source_->frameCount())),
+                 std::memory_order_release);
+}
+
+std::size_t ClipStream::fill(std::size_t maxFrames) {
+  const auto request = request_.load(std::memory_order_acquire);
+  const auto generation = request >> kFrameBits;
+  const auto readFrame = request & kFrameMask;
+  if (generation != fillGeneration_ || readFrame > writeFrame_) {
+    // The player relocated: everything resident belongs to the old position.
+    fillGeneration_ = generation;
+    writeFrame_ = readFrame;
+  }
+
+  const std::uint64_t totalFrames = source_->frameCount();
+  const auto freeFrames = capacity_ - static_cast<std::size_t>(writeFrame_ - readFrame);
+  const auto count = static_cast<std::size_t>(
+      std::min<std::uint64_t>({freeFrames, maxFrames, totalFrames - std::min(writeFrame_, totalFrames)}));
+  if (count == 0) {
+    return 0;
+  }
+
+  const auto channelCount = source_->channelCount();
+  const auto offset = static_cast<std::size_t>(writeFrame_ % capacity_);
+  const auto first = std::min(count, capacity_ - offset);
+  auto& channels = fillChannels_;
+  for (std::size_t ch = 0; ch < channelCount; ++ch) {
+    channels[ch] = samples_.data() + ch * capacity_ + offset;
+  }
+  source_->read(writeFrame_, first, channels.data());
+  if (count > first) {
+    for (std::size_t ch = 0; ch < channelCount; ++ch) {
+      channels[ch] = samples_.data() + ch * capacity_;
+    }
+    source_->read(writeFrame_ + first, count - first, channels.data());
+  }
+  writeFrame_ += count;
+  published_.store(PackCursor(fillGeneration_, writeFrame_), std::memory_order_release);
+  return count;
+}
+
+ClipStreamer::ClipStreamer(std::chrono::milliseconds interval)
+    : interval_(interval), underruns_(std::make_shared<std::atomic<std::uint64_t>>(0)) {
+  thread_ = std::thread([this]() { run(); });
+}
+
+ClipStreamer::~ClipStreamer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  thread_.join();
+}
+
+std::shared_ptr<ClipStream> ClipStreamer::createStream(std::shared_ptr<const ClipFileSource> source,
+                                                       std::size_t capacityFrames) {
+  auto stream = std::make_shared<ClipStream>(std::move(source), capacityFrames, underruns_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_.push_back(stream);
+  }
+  wake_.notify_all();
+  return stream;
+}
+
+void ClipStreamer::run() {
+  std::vector<std::shared_ptr<ClipStream>> live;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    live.clear();
+    std::erase_if(streams_, [&](const std::weak_ptr<ClipStream>& weak) {
+      if (auto stream = weak.lock()) {
+        live.push_back(std::move(stream));
+        return false;
+      }
+      return true;
+    });
+    lock.unlock();
+
+    // Round-robin in bounded chunks until every ring is full, then sleep until the next interval.
+    bool busy = true;
+    while (busy) {
+      busy = false;
+      for (const auto& stream : live) {
+        busy = stream->fill(kFillChunkFrames) > 0 || busy;
+      }
+    }
+    live.clear();
+
+    lock.lock();
+    wake_.wait_for(lock, interval_, [this]() { return stopping_; });
+  }
+}
+
+}  // namespace daft::audio
@@ -0,0 +1,653 @@
+#include "audio_engine/DSPKernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace daft::audio::dsp {
+
+namespace {
+
+// Every kernel is written once against this minimal register abstraction; the scalar tail handles the
+// frames that do not fill a whole register.
+#if defined(__AVX__)
+using Vec = __m256;
+constexpr std::size_t kLanes = 8;
+constexpr const char* kInstructionSet = "avx";
+inline Vec Load(const float* source) { return _mm256_loadu_ps(source); }
+inline void Store(float* dest, Vec value) { _mm256_storeu_ps(dest, value); }
+inline Vec Splat(float value) { return _mm256_set1_ps(value); }
+inline Vec Add(Vec lhs, Vec rhs) { return _mm256_add_ps(lhs, rhs); }
+inline Vec Mul(Vec lhs, Vec rhs) { return _mm256_mul_ps(lhs, rhs); }
+inline Vec Sub(Vec lhs, Vec rhs) { return _mm256_sub_ps(lhs, rhs); }
+inline Vec Max(Vec lhs, Vec rhs) { return _mm256_max_ps(lhs, rhs); }
+inline Vec Abs(Vec value) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0F), value); }
+inline Vec Truncate(Vec value) { return _mm256_cvtepi32_ps(_mm256_cvttps_epi32(value)); }
+#elif defined(__SSE2__) || defined(_M_X64)
+using Vec = __m128;
+constexpr std::size_t kLanes = 4;
+constexpr const char* kInstructionSet = "sse2";
+inline Vec Load(const float* source) { return _mm_loadu_ps(source); }
+inline void Store(float* dest, Vec value) { _mm_storeu_ps(dest, value); }
+inline Vec Splat(float value) { return _mm_set1_ps(value); }
+inline Vec Add(Vec lhs, Vec rhs) { return _mm_add_ps(lhs, rhs); }
+inline Vec Mul(Vec lhs, Vec rhs) { return _mm_mul_ps(lhs, rhs); }
+inline Vec Sub(Vec lhs, Vec rhs) { return _mm_sub_ps(lhs, rhs); }
+inline Vec Max(Vec lhs, Vec rhs) { return _mm_max_ps(lhs, rhs); }
+inline Vec Abs(Vec value) { return _mm_andnot_ps(_mm_set1_ps(-0.0F), value); }
+inline Vec Truncate(Vec value) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(value)); }
+#elif defined(__ARM_NEON)
+using Vec = float32x4_t;
+constexpr std::size_t kLanes = 4;
+constexpr const char* kInstructionSet = "neon";
+inline Vec Load(const float* source) { return vld1q_f32(source); }
+inline void Store(float* dest, Vec value) { vst1q_f32(dest, value); }
+inline Vec Splat(float value) { return vdupq_n_f32(value); }
+inline Vec Add(Vec lhs, Vec rhs) { return vaddq_f32(lhs, rhs); }
+inline Vec Mul(Vec lhs, Vec rhs) { return vmulq_f32(lhs, rhs); }
+inline Vec Sub(Vec lhs, Vec rhs) { return vsubq_f32(lhs, rhs); }
+inline Vec Max(Vec lhs, Vec rhs) { return vmaxq_f32(lhs, rhs); }
+inline Vec Abs(Vec value) { return vabsq_f32(value); }
+inline Vec Truncate(Vec value) { return vcvtq_f32_s32(vcvtq_s32_f32(value)); }
+#else
+using Vec = float;
+constexpr std::size_t kLanes = 1;
+constexpr const char* kInstructionSet = "scalar";
+inline Vec Load(const float* source) { return *source; }
+inline void Store(float* dest, Vec value) { *dest = value; }
+inline Vec Splat(float value) { return value; }
+inline Vec Add(Vec lhs, Vec rhs) { return lhs + rhs; }
+inline Vec Mul(Vec lhs, Vec rhs) { return lhs * rhs; }
+inline Vec Sub(Vec lhs, Vec rhs) { return lhs - rhs; }
+inline Vec Max(Vec lhs, Vec rhs) { return lhs > rhs ? lhs : rhs; }
+inline Vec Abs(Vec value) { return std::fabs(value); }
+inline Vec Truncate(Vec value) { return std::trunc(value); }
+#endif
+
+// {0, 1, ..., kLanes - 1}, the per-lane offsets of a linear ramp.
+inline Vec LaneRamp() {
+  alignas(32) float lanes[kLanes];
+  for (std::size_t lane = 0; lane < kLanes; ++lane) {
+    lanes[lane] = static_cast<float>(lane);
+  }
+  return Load(lanes);
+}
+
+// Oscillator shapes, evaluated on one register of phases in cycles. Every shape starts at the rising zero
+// crossing of a sine, and `inverseIncrement` is the reciprocal of the per-sample phase increment.
+
+// Fractional part of non-negative phases below 2^31.
+inline Vec Wrap(Vec phase) { return Sub(phase, Truncate(phase)); }
+
+// 1 - 4|w - 0.5| on w = phase + 0.25: the naive triangle, which peaks at phase 0.25.
+inline Vec NaiveTriangle(Vec phase) {
+  const Vec shifted = Wrap(Add(phase, Splat(0.25F)));
+  return Sub(Splat(1.0F), Abs(Sub(Mul(shifted, Splat(4.0F)), Splat(2.0F))));
+}
+
+// sin(pi/2 * x) on [-1, 1] from its Taylor series through x^11, accurate to about 6e-8. Applied to the
+// naive triangle this is sin(2 pi phase), with the triangle doing the range reduction.
+inline Vec SinePolynomial(Vec x) {
+  const Vec x2 = Mul(x, x);
+  Vec sum = Splat(-3.598843235212084e-06F);
+  sum = Add(Splat(1.6044118478735975e-04F), Mul(x2, sum));
+  sum = Add(Splat(-4.681754135318687e-03F), Mul(x2, sum));
+  sum = Add(Splat(7.969262624616703e-02F), Mul(x2, sum));
+  sum = Add(Splat(-6.459640975062462e-01F), Mul(x2, sum));
+  sum = Add(Splat(1.5707963267948966F), Mul(x2, sum));
+  return Mul(x, sum);
+}
+
+// How far into the last sample before a discontinuity at phase 0 each lane is, from 1 at the edge down to
+// 0 one increment away. polyBLEP and polyBLAMP residuals are polynomials in this distance.
+inline Vec EdgeProximity(Vec phase, Vec inverseIncrement) {
+  return Max(Sub(Splat(1.0F), Mul(phase, inverseIncrement)), Splat(0.0F));
+}
+
+// 2 x - 1 with its step at phase 0 smoothed by a two-sample polyBLEP residual.
+inline Vec BandLimitedRamp(Vec phase, Vec inverseIncrement) {
+  const Vec after = EdgeProximity(phase, inverseIncrement);
+  const Vec before = EdgeProximity(Sub(Splat(1.0F), phase), inverseIncrement);
+  const Vec naive = Sub(Add(phase, phase), Splat(1.0F));
+  return Add(naive, Sub(Mul(after, after), Mul(before, before)));
+}
+
+// Two-sample polyBLAMP residual of a unit change of slope at phase 0, in samples.
+inline Vec CornerResidual(Vec phase, Vec inverseIncrement) {
+  const Vec after = EdgeProximity(phase, inverseIncrement);
+  const Vec before = EdgeProximity(Sub(Splat(1.0F), phase), inverseIncrement);
+  return Mul(Add(Mul(after, Mul(after, after)), Mul(before, Mul(before, before))), Splat(1.0F / 6.0F));
+}
+
+template <Waveform Shape>
+inline Vec OscillatorShape(Vec phase, Vec increment, Vec inverseIncrement) {
+  if constexpr (Shape == Waveform::kSine) {
+    return SinePolynomial(NaiveTriangle(phase));
+  } else if constexpr (Shape == Waveform::kSaw) {
+    return BandLimitedRamp(Wrap(Add(phase, Splat(0.5F))), inverseIncrement);
+  } else if constexpr (Shape == Waveform::kSquare) {
+    // A saw minus the same saw half a cycle later: +1 over the first half cycle, -1 over the second.
+    return Sub(BandLimitedRamp(Wrap(Add(phase, Splat(0.5F))), inverseIncrement),
+               BandLimitedRamp(phase, inverseIncrement));
+  } else {
+    // The triangle's slope turns by 8 per cycle at its trough (phase 0.75) and by -8 at its peak.
+    const Vec trough = Wrap(Add(phase, Splat(0.25F)));
+    const Vec peak = Wrap(Add(phase, Splat(0.75F)));
+    const Vec corners = Sub(CornerResidual(trough, inverseIncrement), CornerResidual(peak, inverseIncrement));
+    return Add(NaiveTriangle(phase), Mul(Mul(Splat(8.0F), increment), corners));
+  }
+}
+
+// Lanes take their phase from a double-precision accumulator at the start of every register, so a block
+// rendered in pieces matches the same block rendered at once and the phase never drifts.
+template <Waveform Shape>
+double RenderOscillator(float* dest, double phase, double increment, std::size_t count) {
+  const auto laneIncrement = static_cast<float>(increment);
+  const Vec increments = Splat(laneIncrement);
+  // Keeps a stopped oscillator finite; the residuals then only touch lanes sitting exactly on an edge.
+  const Vec inverseIncrement = Splat(1.0F / std::max(laneIncrement, 1e-7F));
+  const Vec offsets = Mul(LaneRamp(), increments);
+  const double step = increment * static_cast<double>(kLanes);
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    const Vec phases = Wrap(Add(Splat(static_cast<float>(phase)), offsets));
+    Store(dest + i, OscillatorShape<Shape>(phases, increments, inverseIncrement));
+    phase += step;
+    if (phase >= 1.0) {
+      phase -= std::floor(phase);
+    }
+  }
+  if (i < count) {
+    alignas(32) float tail[kLanes];
+    const Vec phases = Wrap(Add(Splat(static_cast<float>(phase)), offsets));
+    Store(tail, OscillatorShape<Shape>(phases, increments, inverseIncrement));
+    for (std::size_t lane = 0; i + lane < count; ++lane) {
+      dest[i + lane] = tail[lane];
+    }
+    phase += increment * static_cast<double>(count - i);
+    phase -= std::floor(phase);
+  }
+  return phase;
+}
+
+// Lanes hold voices here rather than frames. Each voice offsets its float phase from the chunk start
+// and resynchronises from its double phase at the next, and every register's output is accumulated
+// into a frame-major scratch that is reduced across lanes once per chunk.
+template <Waveform Shape>
+void MixOscillatorBank(float* dest, double* phases, const double* increments, const float* gains,
+                       const float* gainSteps, std::size_t voiceCount, std::size_t count) {
+  constexpr std::size_t kChunkFrames = 64;
+  alignas(32) float mixed[kChunkFrames * kLanes];
+  alignas(32) float lanePhases[kLanes];
+  alignas(32) float laneIncrements[kLanes];
+  alignas(32) float laneInverseIncrements[kLanes];
+  alignas(32) float laneGains[kLanes];
+  alignas(32) float laneGainSteps[kLanes];
+  for (std::size_t offset = 0; offset < count; offset += kChunkFrames) {
+    const auto frames = std::min(kChunkFrames, count - offset);
+    fill(mixed, 0.0F, frames * kLanes);
+    for (std::size_t first = 0; first < voiceCount; first += kLanes) {
+      // Lanes past the last voice run silent at a standstill.
+      for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        const auto voice = first + lane;
+        const bool used = voice < voiceCount;
+        const double increment = used && increments[voice] > 0.0 ? std::min(increments[voice], 0.5) : 0.0;
+        lanePhases[lane] = used ? static_cast<float>(phases[voice]) : 0.0F;
+        laneIncrements[lane] = static_cast<float>(increment);
+        laneInverseIncrements[lane] = 1.0F / std::max(laneIncrements[lane], 1e-7F);
+        laneGains[lane] = used ? gains[voice] + gainSteps[voice] * static_cast<float>(offset) : 0.0F;
+        laneGainSteps[lane] = used ? gainSteps[voice] : 0.0F;
+        if (used) {
+          phases[voice] += increment * static_cast<double>(frames);
+          if (phases[voice] >= 1.0) {
+            phases[voice] -= std::floor(phases[voice]);
+          }
+        }
+      }
+      const Vec startPhase = Load(lanePhases);
+      const Vec startGain = Load(laneGains);
+      const Vec increment = Load(laneIncrements);
+      const Vec inverseIncrement = Load(laneInverseIncrements);
+      const Vec gainStep = Load(laneGainSteps);
+      // Phase and gain come from the chunk start rather than the previous frame, which keeps the wrap
+      // off the loop-carried path.
+      for (std::size_t frame = 0; frame < frames; ++frame) {
+        const Vec elapsed = Splat(static_cast<float>(frame));
+        const Vec phase = Wrap(Add(startPhase, Mul(elapsed, increment)));
+        const Vec gain = Add(startGain, Mul(elapsed, gainStep));
+        float* slot = mixed + frame * kLanes;
+        Store(slot, Add(Load(slot), Mul(OscillatorShape<Shape>(phase, increment, inverseIncrement), gain)));
+      }
+    }
+    for (std::size_t frame = 0; frame < frames; ++frame) {
+      float sum = 0.0F;
+      for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        sum += mixed[frame * kLanes + lane];
+      }
+      dest[offset + frame] += sum;
+    }
+  }
+}
+
+// The format decoders need integer lanes, which AVX (without AVX2) lacks, so they use 128-bit registers
+// on every x86 target.
+#if defined(__SSE2__) || defined(_M_X64)
+constexpr bool kVectorDecode = true;
+constexpr std::size_t kDecodeLanes = 8;
+
+inline void DecodeInt16Block(float* dest, const std::int16_t* source) {
+  const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+  const __m128 scale = _mm_set1_ps(1.0F / 32768.0F);
+  // Widen by duplicating each lane into the high half, then arithmetic-shift the sign back down.
+  const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+  const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16);
+  _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+  _mm_storeu_ps(dest + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+}
+
+inline __m128 HalfToFloat(__m128i half) {
+  const __m128i sign = _mm_slli_epi32(_mm_and_si128(half, _mm_set1_epi32(0x8000)), 16);
+  const __m128i bits = _mm_slli_epi32(_mm_and_si128(half, _mm_set1_epi32(0x7fff)), 13);
+  // Rebias the exponent by 2^112; this also normalizes half subnormals exactly.
+  const __m128i scaled = _mm_castps_si128(_mm_mul_ps(_mm_castsi128_ps(bits), _mm_set1_ps(0x1p112F)));
+  const __m128i special = _mm_cmpeq_epi32(_mm_and_si128(half, _mm_set1_epi32(0x7c00)), _mm_set1_epi32(0x7c00));
+  const __m128i infOrNan = _mm_or_si128(bits, _mm_set1_epi32(0x7f800000));
+  const __m128i magnitude = _mm_or_si128(_mm_andnot_si128(special, scaled), _mm_and_si128(special, infOrNan));
+  return _mm_castsi128_ps(_mm_or_si128(magnitude, sign));
+}
+
+inline void DecodeFloat16Block(float* dest, const std::uint16_t* source) {
+  const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+  const __m128i zero = _mm_setzero_si128();
+  _mm_storeu_ps(dest, HalfToFloat(_mm_unpacklo_epi16(packed, zero)));
+  _mm_storeu_ps(dest + 4, HalfToFloat(_mm_unpackhi_epi16(packed, zero)));
+}
+#elif defined(__ARM_NEON)
+constexpr bool kVectorDecode = true;
+constexpr std::size_t kDecodeLanes = 8;
+
+inline void DecodeInt16Block(float* dest, const std::int16_t* source) {
+  const int16x8_t packed = vld1q_s16(source);
+  const float32x4_t scale = vdupq_n_f32(1.0F / 32768.0F);
+  vst1q_f32(dest, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(packed))), scale));
+  vst1q_f32(dest + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(packed))), scale));
+}
+
+inline float32x4_t HalfToFloat(uint32x4_t half) {
+  const uint32x4_t sign = vshlq_n_u32(vandq_u32(half, vdupq_n_u32(0x8000)), 16);
+  const uint32x4_t bits = vshlq_n_u32(vandq_u32(half, vdupq_n_u32(0x7fff)), 13);
+  const uint32x4_t scaled = vreinterpretq_u32_f32(vmulq_f32(vreinterpretq_f32_u32(bits), vdupq_n_f32(0x1p112F)));
+  const uint32x4_t special = vceqq_u32(vandq_u32(half, vdupq_n_u32(0x7c00)), vdupq_n_u32(0x7c00));
+  const uint32x4_t magnitude = vbslq_u32(special, vorrq_u32(bits, vdupq_n_u32(0x7f800000)), scaled);
+  return vreinterpretq_f32_u32(vorrq_u32(magnitude, sign));
+}
+
+inline void DecodeFloat16Block(float* dest, const std::uint16_t* source) {
+  const uint16x8_t packed = vld1q_u16(source);
+  vst1q_f32(dest, HalfToFloat(vmovl_u16(vget_low_u16(packed))));
+  vst1q_f32(dest + 4, HalfToFloat(vmovl_u16(vget_high_u16(packed))));
+}
+#else
+constexpr bool kVectorDecode = false;
+constexpr std::size_t kDecodeLanes = 1;
+
+inline void DecodeInt16Block(float*, const std::int16_t*) {}
+inline void DecodeFloat16Block(float*, const std::uint16_t*) {}
+#endif
+
+// Scalar twins of the block decoders, used for tails and as the reference implementation.
+inline float HalfToFloat(std::uint16_t half) {
+  const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000U) << 16;
+  const std::uint32_t bits = static_cast<std::uint32_t>(half & 0x7fffU) << 13;
+  std::uint32_t magnitude = std::bit_cast<std::uint32_t>(std::bit_cast<float>(bits) * 0x1p112F);
+  if ((half & 0x7c00U) == 0x7c00U) {
+    magnitude = bits | 0x7f800000U;
+  }
+  return std::bit_cast<float>(magnitude | sign);
+}
+
+inline std::uint16_t FloatToHalf(float value) {
+  std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+  const std::uint32_t sign = (bits >> 16) & 0x8000U;
+  bits &= 0x7fffffffU;
+  std::uint32_t half = 0;
+  if (bits >= 0x47800000U) {
+    // Beyond the half range (or already infinite/NaN); keep NaNs quiet.
+    half = bits > 0x7f800000U ? 0x7e00U : 0x7c00U;
+  } else if (bits < 0x38800000U) {
+    // Half subnormal or zero: adding 0.5 lines the ten mantissa bits up at the bottom, rounding to even.
+    const float aligned = std::bit_cast<float>(bits) + 0.5F;
+    half = std::bit_cast<std::uint32_t>(aligned) - 0x3f000000U;
+  } else {
+    const std::uint32_t odd = (bits >> 13) & 1U;
+    bits += 0xc8000fffU + odd;  // rebias the exponent by -112 and round to nearest even
+    half = bits >> 13;
+  }
+  return static_cast<std::uint16_t>(half | sign);
+}
+
+// Fixed-shape block loops: constant trip counts in whole registers, which the compiler unrolls.
+template <std::size_t Channels, std::size_t Frames>
+void ClearBlock(float* const* dest, std::size_t, std::size_t) {
+  static_assert(Frames % kLanes == 0, "specialised blocks fill whole registers");
+  const Vec zero = Splat(0.0F);
+  for (std::size_t ch = 0; ch < Channels; ++ch) {
+    for (std::size_t i = 0; i < Frames; i += kLanes) {
+      Store(dest[ch] + i, zero);
+    }
+  }
+}
+
+template <std::size_t Channels, std::size_t Frames>
+void AddBlock(float* const* dest, const float* const* source, std::size_t, std::size_t) {
+  static_assert(Frames % kLanes == 0, "specialised blocks fill whole registers");
+  for (std::size_t ch = 0; ch < Channels; ++ch) {
+    for (std::size_t i = 0; i < Frames; i += kLanes) {
+      Store(dest[ch] + i, Add(Load(dest[ch] + i), Load(source[ch] + i)));
+    }
+  }
+}
+
+void ClearAnyBlock(float* const* dest, std::size_t channels, std::size_t frames) {
+  for (std::size_t ch = 0; ch < channels; ++ch) {
+    fill(dest[ch], 0.0F, frames);
+  }
+}
+
+void AddAnyBlock(float* const* dest, const float* const* source, std::size_t channels, std::size_t frames) {
+  for (std::size_t ch = 0; ch < channels; ++ch) {
+    add(dest[ch], source[ch], frames);
+  }
+}
+
+template <std::size_t Channels, std::size_t Frames>
+constexpr BlockKernels kFixedBlock{&ClearBlock<Channels, Frames>, &AddBlock<Channels, Frames>, true};
+constexpr BlockKernels kAnyBlock{&ClearAnyBlock, &AddAnyBlock, false};
+
+template <std::size_t Channels>
+const BlockKernels& FixedBlockKernels(std::size_t frames) {
+  switch (frames) {
+    case 64:
+      return kFixedBlock<Channels, 64>;
+    case 128:
+      return kFixedBlock<Channels, 128>;
+    case 256:
+      return kFixedBlock<Channels, 256>;
+    default:
+      return kAnyBlock;
+  }
+}
+
+}  // namespace
+
+void fill(float* dest, float value, std::size_t count) {
+  const Vec splat = Splat(value);
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    Store(dest + i, splat);
+  }
+  for (; i < count; ++i) {
+    dest[i] = value;
+  }
+}
+
+void copy(float* dest, const float* source, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    Store(dest + i, Load(source + i));
+  }
+  for (; i < count; ++i) {
+    dest[i] = source[i];
+  }
+}
+
+void copyScaled(float* dest, const float* source, float gain, std::size_t count) {
+  const Vec splat = Splat(gain);
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    Store(dest + i, Mul(Load(source + i), splat));
+  }
+  for (; i < count; ++i) {
+    dest[i] = source[i] * gain;
+  }
+}
+
+void copyMultiplied(float* dest, const float* source, const float* gains, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    Store(dest + i, Mul(Load(source + i), Load(gains + i)));
+  }
+  for (; i < count; ++i) {
+    dest[i] = source[i] * gains[i];
+  }
+}
+
+// Ramp values are recomputed from the index rather than accumulated, so long fades do not drift.
+void copyRamped(float* dest, const float* source, float start, float step, std::size_t count) {
+  const Vec offsets = Mul(LaneRamp(), Splat(step));
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    const Vec ramp = Add(Splat(start + step * static_cast<float>(i)), offsets);
+    Store(dest + i, Mul(Load(source + i), ramp));
+  }
+  for (; i < count; ++i) {
+    dest[i] = source[i] * (start + step * static_cast<float>(i));
+  }
+}
+
+void multiplyRamped(float* dest, float start, float step, std::size_t count) {
+  const Vec offsets = Mul(LaneRamp(), Splat(step));
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    const Vec ramp = Add(Splat(start + step * static_cast<float>(i)), offsets);
+    Store(dest + i, Mul(Load(dest + i), ramp));
+  }
+  for (; i < count; ++i) {
+    dest[i] *= start + step * static_cast<float>(i);
+  }
+}
+
+void add(float* dest, const float* source, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    Store(dest + i, Add(Load(dest + i), Load(source + i)));
+  }
+  for (; i < count; ++i) {
+    dest[i] += source[i];
+  }
+}
+
+void addScaled(float* dest, const float* source, float gain, std::size_t count) {
+  const Vec splat = Splat(gain);
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    Store(dest + i, Add(Load(dest + i), Mul(Load(source + i), splat)));
+  }
+  for (; i < count; ++i) {
+    dest[i] += source[i] * gain;
+  }
+}
+
+void scale(float* dest, float gain, std::size_t count) {
+  const Vec splat = Splat(gain);
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    Store(dest + i, Mul(Load(dest + i), splat));
+  }
+  for (; i < count; ++i) {
+    dest[i] *= gain;
+  }
+}
+
+void multiply(float* dest, const float* gains, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    Store(dest + i, Mul(Load(dest + i), Load(gains + i)));
+  }
+  for (; i < count; ++i) {
+    dest[i] *= gains[i];
+  }
+}
+
+void addMultiplied(float* dest, const float* source, const float* gains, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    Store(dest + i, Add(Load(dest + i), Mul(Load(source + i), Load(gains + i))));
+  }
+  for (; i < count; ++i) {
+    dest[i] += source[i] * gains[i];
+  }
+}
+
+void mixScaled(float* dest, const float* const* sources, const float* gains, std::size_t sourceCount,
+               std::size_t count) {
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    Vec sum = Load(dest + i);
+    for (std::size_t source = 0; source < sourceCount; ++source) {
+      sum = Add(sum, Mul(Load(sources[source] + i), Splat(gains[source])));
+    }
+    Store(dest + i, sum);
+  }
+  for (; i < count; ++i) {
+    float sum = dest[i];
+    for (std::size_t source = 0; source < sourceCount; ++source) {
+      sum += sources[source][i] * gains[source];
+    }
+    dest[i] = sum;
+  }
+}
+
+float dotInterpolated(const float* source, const float* lower, const float* upper, float fraction, std::size_t count) {
+  const Vec lowerWeight = Splat(1.0F - fraction);
+  const Vec upperWeight = Splat(fraction);
+  Vec sum = Splat(0.0F);
+  std::size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    const Vec coefficients = Add(Mul(Load(lower + i), lowerWeight), Mul(Load(upper + i), upperWeight));
+    sum = Add(sum, Mul(Load(source + i), coefficients));
+  }
+  alignas(32) float lanes[kLanes];
+  Store(lanes, sum);
+  float total = 0.0F;
+  for (const float lane : lanes) {
+    total += lane;
+  }
+  for (; i < count; ++i) {
+    total += source[i] * (lower[i] * (1.0F - fraction) + upper[i] * fraction);
+  }
+  return total;
+}
+
+void decodeInt16(float* dest, const std::int16_t* source, std::size_t count) {
+  std::size_t i = 0;
+  if constexpr (kVectorDecode) {
+    for (; i + kDecodeLanes <= count; i += kDecodeLanes) {
+      DecodeInt16Block(dest + i, source + i);
+    }
+  }
+  for (; i < count; ++i) {
+    dest[i] = static_cast<float>(source[i]) * (1.0F / 32768.0F);
+  }
+}
+
+void decodeFloat16(float* dest, const std::uint16_t* source, std::size_t count) {
+  std::size_t i = 0;
+  if constexpr (kVectorDecode) {
+    for (; i + kDecodeLanes <= count; i += kDecodeLanes) {
+      DecodeFloat16Block(dest + i, source + i);
+    }
+  }
+  for (; i < count; ++i) {
+    dest[i] = HalfToFloat(source[i]);
+  }
+}
+
+double oscillator(Waveform waveform, float* dest, double phase, double increment, std::size_t count) {
+  // Also maps a NaN increment to a stopped oscillator.
+  increment = increment > 0.0 ? std::min(increment, 0.5) : 0.0;
+  phase -= std::floor(phase);
+  switch (waveform) {
+    case Waveform::kSine:
+      return RenderOscillator<Waveform::kSine>(dest, phase, increment, count);
+    case Waveform::kSaw:
+      return RenderOscillator<Waveform::kSaw>(dest, phase, increment, count);
+    case Waveform::kSquare:
+      return RenderOscillator<Waveform::kSquare>(dest, phase, increment, count);
+    case Waveform::kTriangle:
+      return RenderOscillator<Waveform::kTriangle>(dest, phase, increment, count);
+  }
+  return phase;
+}
+
+void mixOscillators(Waveform waveform, float* dest, double* phases, const double* increments, const float* gains,
+                    const float* gainSteps, std::size_t voiceCount, std::size_t count) {
+  switch (waveform) {
+    case Waveform::kSine:
+      MixOscillatorBank<Waveform::kSine>(dest, phases, increments, gains, gainSteps, voiceCount, count);
+      break;
+    case Waveform::kSaw:
+      MixOscillatorBank<Waveform::kSaw>(dest, phases, increments, gains, gainSteps, voiceCount, count);
+      break;
+    case Waveform::kSquare:
+      MixOscillatorBank<Waveform::kSquare>(dest, phases, increments, gains, gainSteps, voiceCount, count);
+      break;
+    case Waveform::kTriangle:
+      MixOscillatorBank<Waveform::kTriangle>(dest, phases, increments, gains, gainSteps, voiceCount, count);
+      break;
+  }
+}
+
+void decode(SampleFormat format, const void* source, std::size_t offset, float* dest, std::size_t count) {
+  switch (format) {
+    case SampleFormat::kFloat32:
+      copy(dest, static_cast<const float*>(source) + offset, count);
+      break;
+    case SampleFormat::kInt16:
+      decodeInt16(dest, static_cast<const std::int16_t*>(source) + offset, count);
+      break;
+    case SampleFormat::kFloat16:
+      decodeFloat16(dest, static_cast<const std::uint16_t*>(source) + offset, count);
+      break;
+  }
+}
+
+void encodeInt16(std::int16_t* dest, const float* source, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    const float scaled = std::nearbyint(source[i] * 32768.0F);
+    // NaN fails both comparisons and is stored as silence.
+    dest[i] = scaled >= 32767.0F ? std::int16_t{32767}
+              : scaled <= -32768.0F ? std::int16_t{-32768}
+              : scaled == scaled   ? static_cast<std::int16_t>(scaled)
+                                   : std::int16_t{0};
+  }
+}
+
+void encodeFloat16(std::uint16_t* dest, const float* source, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    dest[i] = FloatToHalf(source[i]);
+  }
+}
+
+const BlockKernels& blockKernels(std::size_t channels, std::size_t frames) {
+  switch (channels) {
+    case 1:
+      return FixedBlockKernels<1>(frames);
+    case 2:
+      return FixedBlockKernels<2>(frames);
+    default:
+      return kAnyBlock;
+  }
+}
+
+const char* instructionSet() { return kInstructionSet; }
+
+}  // namespace daft::audio::dsp
@@ -1,26 +1,101 @@
 #include "audio_engine/DSPNode.h"
 
+#include "audio_engine/ClipStream.h"
+#include "audio_engine/DSPKernels.h"
+
 #include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <cstring>
 #include <limits>
-#include <numbers>
 
 namespace daft::audio {
 
+namespace {
+// Ramped gains are rendered into a stack envelope this many frames at a time.
+constexpr std::size_t kEnvelopeFrames = 64;
+
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+  return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char lhs, char rhs) {
+           return std::tolower(static_cast<unsigned char>(lhs)) == std::tolower(static_cast<unsigned char>(rhs));
+         });
+}
+
+// Balance law for stereo buses: panning towards one side attenuates the other, centre is unity.
+float PanGain(double pan, std::size_t channel, std::size_t channelCount) {
+  if (channelCount != 2) {
+    return 1.0F;
+  }
+  return static_cast<float>(channel == 0 ? std::min(1.0, 1.0 - pan) : std::min(1.0, 1.0 + pan));
+}
+}  // namespace
+
+void DSPNode::setParameter(const std::string& name, double value) {
+  if (const auto id = findParameter(name); id != kInvalidParamId) {
+    setParameter(id, value);
+  }
+}
+
+void DSPNode::processInputs(std::span<const AudioBufferView> inputs, AudioBufferView output) {
+  output.fill(0.0F);
+  for (const auto& input : inputs) {
+    if (!input.isSilent()) {
+      output.addBufferInPlace(input);
+    }
+  }
+  process(output);
+}
+
+ParamId DSPNode::findParameter(std::string_view name) const {
+  for (const auto& descriptor : parameters()) {
+    if (EqualsIgnoreCase(descriptor.name, name)) {
+      return descriptor.id;
+    }
+  }
+  return kInvalidParamId;
+}
+
+bool DSPNode::isControlOnly(ParamId id) const {
+  for (const auto& descriptor : parameters()) {
+    if (descriptor.id == id) {
+      return descriptor.controlOnly;
+    }
+  }
+  return false;
+}
+
 void GainNode::process(AudioBufferView buffer) {
   const auto frames = buffer.frameCount();
   const auto channels = buffer.channelCount();
-  for (std::size_t ch = 0; ch < channels; ++ch) {
-    auto channelData = buffer.channel(ch);
-    for (std::size_t i = 0; i < frames; ++i) {
-      channelData[i] = static_cast<float>(channelData[i] * gain_);
+  if (gain_.isRamping()) {
+    float envelope[kEnvelopeFrames];
+    for (std::size_t offset = 0; offset < frames; offset += kEnvelopeFrames) {
+      const auto count = std::min(kEnvelopeFrames, frames - offset);
+      gain_.fill(envelope, count);
+      for (std::size_t ch = 0; ch < channels; ++ch) {
+        dsp::multiply(buffer.channel(ch).data() + offset, envelope, count);
+      }
     }
+    return;
+  }
+  const auto gain = static_cast<float>(gain_.current());
+  if (gain == 1.0F) {
+    return;
+  }
+  for (std::size_t ch = 0; ch < channels; ++ch) {
+    dsp::scale(buffer.channel(ch).data(), gain, frames);
   }
 }
 
-void GainNode::setParameter(const std::string& name, double value) {
-  if (name == "gain") {
-    gain_ = value;
+void GainNode::setParameter(ParamId id, double value) {
+  if (id == kGain) {
+    gain_.setValue(value);
+  }
+}
+
+void GainNode::rampParameter(ParamId id, double target, std::uint32_t frames, RampShape shape) {
+  if (id == kGain) {
+    gain_.rampTo(target, frames, shape);
   }
 }
 
@@ -30,73 +105,221 @@ void SineOscillatorNode::prepare(double sampleRate) {
 }
 
 void SineOscillatorNode::process(AudioBufferView buffer) {
-  const double rate = sampleRate();
-  const double phaseDelta = (2.0 * std::numbers::pi * frequency_) / rate;
-  for (std::size_t i = 0; i < buffer.frameCount(); ++i) {
-    const float value = static_cast<float>(std::sin(phase_));
-    phase_ += phaseDelta;
-    if (phase_ > 2.0 * std::numbers::pi) {
-      phase_ -= 2.0 * std::numbers::pi;
-    }
-    for (std::size_t ch = 0; ch < buffer.channelCount(); ++ch) {
-      buffer.channel(ch)[i] = value;
-    }
+  const auto channels = buffer.channelCount();
+  if (channels == 0) {
+    return;
+  }
+  auto first = buffer.channel(0);
+  phase_ = dsp::oscillator(waveform_, first.data(), phase_, frequency_ / sampleRate(), first.size());
+  for (std::size_t ch = 1; ch < channels; ++ch) {
+    dsp::copy(buffer.channel(ch).data(), first.data(), first.size());
   }
 }
 
-void SineOscillatorNode::setParameter(const std::string& name, double value) {
-  if (name == "frequency") {
-    frequency_ = value;
+void SineOscillatorNode::setParameter(ParamId id, double value) {
+  switch (id) {
+    case kFrequency:
+      frequency_ = value;
+      break;
+    case kWaveform:
+      // Rounds to the nearest shape; NaN fails every comparison and selects the sine.
+      waveform_ = value >= 2.5   ? dsp::Waveform::kTriangle
+                  : value >= 1.5 ? dsp::Waveform::kSquare
+                  : value >= 0.5 ? dsp::Waveform::kSaw
+                                 : dsp::Waveform::kSine;
+      break;
+    default:
+      break;
   }
 }
 
-MixerNode::MixerNode(std::size_t inputCount) : inputs_(inputCount) {}
+MixerNode::MixerNode(std::size_t inputCount) : strips_(std::min(inputCount, kMaxInputs)) {
+  parameterNames_.reserve(2 * strips_.size());
+  parameters_.reserve(1 + 2 * strips_.size());
+  parameters_.push_back({kGain, "gain", 0.0, 16.0, 1.0, ParameterSmoothing::kLinear});
+  for (std::size_t input = 0; input < strips_.size(); ++input) {
+    const auto prefix = "input" + std::to_string(input);
+    // Reserved up front, so the views taken below stay valid.
+    const auto& gainName = parameterNames_.emplace_back(prefix + ".gain");
+    parameters_.push_back({inputGain(input), gainName, 0.0, 16.0, 1.0, ParameterSmoothing::kLinear});
+    const auto& panName = parameterNames_.emplace_back(prefix + ".pan");
+    parameters_.push_back({inputPan(input), panName, -1.0, 1.0, 0.0, ParameterSmoothing::kNone});
+  }
+}
 
 void MixerNode::process(AudioBufferView buffer) {
+  if (gain_.isRamping()) {
+    float envelope[kEnvelopeFrames];
+    for (std::size_t offset = 0; offset < buffer.frameCount(); offset += kEnvelopeFrames) {
+      const auto count = std::min(kEnvelopeFrames, buffer.frameCount() - offset);
+      gain_.fill(envelope, count);
+      for (std::size_t ch = 0; ch < buffer.channelCount(); ++ch) {
+        dsp::multiply(buffer.channel(ch).data() + offset, envelope, count);
+      }
+    }
+    return;
+  }
+  const auto gain = static_cast<float>(gain_.current());
+  if (gain == 1.0F) {
+    return;
+  }
   for (std::size_t ch = 0; ch < buffer.channelCount(); ++ch) {
-    auto channelData = buffer.channel(ch);
-    std::fill(channelData.begin(), channelData.end(), 0.0F);
+    dsp::scale(buffer.channel(ch).data(), gain, buffer.frameCount());
+  }
+}
+
+void MixerNode::processInputs(std::span<const AudioBufferView> inputs, AudioBufferView output) {
+  const auto frames = output.frameCount();
+  const auto channels = output.channelCount();
+  const float* sources[kMaxInputs];
+  float gains[kMaxInputs];
+
+  // Strips holding a steady gain are accumulated per output channel in batches of up to kMaxInputs
+  // sources; muted strips cost nothing.
+  for (std::size_t ch = 0; ch < channels; ++ch) {
+    auto* dest = output.channel(ch).data();
+    dsp::fill(dest, 0.0F, frames);
+    std::size_t batch = 0;
+    for (std::size_t input = 0; input < inputs.size(); ++input) {
+      if (inputs[input].isSilent()) {
+        continue;
+      }
+      float gain = 1.0F;
+      if (input < strips_.size()) {
+        const auto& strip = strips_[input];
+        if (strip.gain.isRamping()) {
+          continue;
+        }
+        gain = static_cast<float>(strip.gain.current()) * PanGain(strip.pan, ch, channels);
+      }
+      if (gain == 0.0F) {
+        continue;
+      }
+      sources[batch] = inputs[input].channel(ch).data();
+      gains[batch] = gain;
+      if (++batch == kMaxInputs) {
+        dsp::mixScaled(dest, sources, gains, batch, frames);
+        batch = 0;
+      }
+    }
+    dsp::mixScaled(dest, sources, gains, batch, frames);
   }
 
-  for (const auto& input : inputs_) {
-    if (input.size() != buffer.frameCount()) {
+  for (std::size_t input = 0; input < strips_.size(); ++input) {
+    auto& strip = strips_[input];
+    if (!strip.gain.isRamping()) {
       continue;
     }
-    for (std::size_t i = 0; i < buffer.frameCount(); ++i) {
-      const float sample = input[i] * static_cast<float>(gain_);
-      for (std::size_t ch = 0; ch < buffer.channelCount(); ++ch) {
-        buffer.channel(ch)[i] += sample;
+    if (input < inputs.size() && !inputs[input].isSilent()) {
+      mixRampingStrip(strip, inputs[input], output);
+    } else {
+      strip.gain.skip(frames);
+    }
+  }
+
+  process(output);
+}
+
+void MixerNode::mixRampingStrip(Strip& strip, const AudioBufferView& input, AudioBufferView& output) {
+  const auto frames = output.frameCount();
+  const auto channels = output.channelCount();
+  float envelope[kEnvelopeFrames];
+  float panned[kEnvelopeFrames];
+  for (std::size_t offset = 0; offset < frames; offset += kEnvelopeFrames) {
+    const auto count = std::min(kEnvelopeFrames, frames - offset);
+    strip.gain.fill(envelope, count);
+    for (std::size_t ch = 0; ch < channels; ++ch) {
+      const float pan = PanGain(strip.pan, ch, channels);
+      const float* gains = envelope;
+      if (pan != 1.0F) {
+        dsp::copy(panned, envelope, count);
+        dsp::scale(panned, pan, count);
+        gains = panned;
       }
+      dsp::addMultiplied(output.channel(ch).data() + offset, input.channel(ch).data() + offset, gains, count);
     }
   }
 }
 
-void MixerNode::setParameter(const std::string& name, double value) {
-  if (name == "gain") {
-    gain_ = value;
+void MixerNode::skipSilence(std::size_t frameCount) {
+  gain_.skip(frameCount);
+  for (auto& strip : strips_) {
+    strip.gain.skip(frameCount);
   }
 }
 
-void MixerNode::updateInput(std::size_t index, std::span<const float> input) {
-  if (index >= inputs_.size()) {
+MixerNode::Strip* MixerNode::stripForParameter(ParamId id) {
+  if (id < kFirstInputParameter) {
+    return nullptr;
+  }
+  const auto index = static_cast<std::size_t>(id - kFirstInputParameter) / 2;
+  return index < strips_.size() ? &strips_[index] : nullptr;
+}
+
+void MixerNode::setParameter(ParamId id, double value) {
+  if (!std::isfinite(value)) {
     return;
   }
-  inputs_[index] = input;
+  if (id == kGain) {
+    gain_.setValue(value);
+    return;
+  }
+  if (auto* strip = stripForParameter(id)) {
+    if ((id - kFirstInputParameter) % 2 == 0) {
+      strip->gain.setValue(value);
+    } else {
+      strip->pan = std::clamp(value, -1.0, 1.0);
+    }
+  }
+}
+
+void MixerNode::rampParameter(ParamId id, double target, std::uint32_t frames, RampShape shape) {
+  if (!std::isfinite(target)) {
+    return;
+  }
+  if (id == kGain) {
+    gain_.rampTo(target, frames, shape);
+    return;
+  }
+  auto* strip = stripForParameter(id);
+  if (strip != nullptr && (id - kFirstInputParameter) % 2 == 0) {
+    strip->gain.rampTo(target, frames, shape);
+    return;
+  }
+  DSPNode::rampParameter(id, target, frames, shape);
 }
 
 void ClipPlayerNode::prepare(double sampleRate) {
   DSPNode::prepare(sampleRate);
+  PrepareResampler();
   processedFrames_ = 0;
+  sourcePosition_ = 0.0;
+  windowFrames_ = 0;
 }
 
-void ClipPlayerNode::reset() { processedFrames_ = 0; }
+void ClipPlayerNode::reset() {
+  processedFrames_ = 0;
+  sourcePosition_ = 0.0;
+  windowFrames_ = 0;
+  if (stream_) {
+    stream_->seek(0);
+  }
+}
 
 void ClipPlayerNode::setClipBuffer(ClipBufferData data) {
   if (data.frameCount == 0 || data.channels.empty()) {
     data.clear();
   }
   clipBuffer_ = std::move(data);
+  stream_.reset();
+  residentChannels_.clear();
+  allocateScratch(clipBuffer_.channelCount());
   if (!clipBuffer_.empty()) {
+    if (clipBuffer_.format == SampleFormat::kFloat32) {
+      for (const auto* channel : clipBuffer_.channels) {
+        residentChannels_.push_back(static_cast<const float*>(channel));
+      }
+    }
     declaredBufferSampleRate_ = clipBuffer_.sampleRate;
     declaredBufferFrames_ = clipBuffer_.frameCount;
     declaredBufferChannels_ = clipBuffer_.channelCount();
@@ -107,102 +330,358 @@ void ClipPlayerNode::setClipBuffer(ClipBufferData data) {
   }
 }
 
-void ClipPlayerNode::process(AudioBufferView buffer) {
-  const auto frameCount = buffer.frameCount();
-  if (frameCount == 0) {
+void ClipPlayerNode::setClipStream(std::shared_ptr<ClipStream> stream) {
+  clipBuffer_.clear();
+  residentChannels_.clear();
+  stream_ = std::move(stream);
+  if (!stream_ || stream_->frameCount() == 0 || stream_->channelCount() == 0) {
+    stream_.reset();
+    allocateScratch(0);
+    declaredBufferSampleRate_ = 0.0;
+    declaredBufferFrames_ = 0;
+    declaredBufferChannels_ = 0;
     return;
   }
-  if (clipBuffer_.empty()) {
-    processedFrames_ += frameCount;
-    return;
+  stream_->setDirect(offline_);
+  allocateScratch(stream_->channelCount());
+  declaredBufferSampleRate_ = stream_->sampleRate();
+  declaredBufferFrames_ = stream_->frameCount();
+  declaredBufferChannels_ = stream_->channelCount();
+}
+
+void ClipPlayerNode::setOfflineRendering(bool offline) {
+  offline_ = offline;
+  if (stream_) {
+    stream_->setDirect(offline);
   }
+}
 
-  const auto outputChannels = buffer.channelCount();
-  const auto bufferChannels = clipBuffer_.channelCount();
-  if (outputChannels == 0 || bufferChannels == 0 || clipBuffer_.frameCount == 0) {
-    processedFrames_ += frameCount;
-    return;
+void ClipPlayerNode::allocateScratch(std::size_t channelCount) {
+  // Every clip gets resampling scratch, since `playbackrate` may leave 1:1 on the audio thread.
+  decodedSamples_.assign(channelCount * kDecodeChunkFrames, 0.0F);
+  decodedChannels_.resize(channelCount);
+  windowSamples_.assign(channelCount * kResampleWindowFrames, 0.0F);
+  windowChannels_.resize(channelCount);
+  fetchChannels_.resize(channelCount);
+  for (std::size_t channel = 0; channel < channelCount; ++channel) {
+    decodedChannels_[channel] = decodedSamples_.data() + channel * kDecodeChunkFrames;
+    windowChannels_[channel] = windowSamples_.data() + channel * kResampleWindowFrames;
   }
+  windowFrames_ = 0;
+}
 
-  const std::uint64_t startFrame = startFrame_;
+std::size_t ClipPlayerNode::sourceChannelCount() const noexcept {
+  return stream_ ? stream_->channelCount() : clipBuffer_.channelCount();
+}
+
+std::uint64_t ClipPlayerNode::sourceFrameCount() const noexcept {
+  if (stream_) {
+    return stream_->frameCount();
+  }
+  return clipBuffer_.empty() ? 0 : static_cast<std::uint64_t>(clipBuffer_.frameCount);
+}
+
+double ClipPlayerNode::sourceSampleRate() const noexcept {
+  const double rate = stream_ ? stream_->sampleRate() : clipBuffer_.sampleRate;
+  if (rate > 0.0) {
+    return rate;
+  }
+  return declaredBufferSampleRate_ > 0.0 ? declaredBufferSampleRate_ : sampleRate();
+}
+
+double ClipPlayerNode::resampleStep() const noexcept {
+  return std::min(sourceSampleRate() / sampleRate() * playbackRate_, kMaxResampleStep);
+}
+
+bool ClipPlayerNode::resamples(std::uint64_t blockStart, double step) const noexcept {
+  // A clip at 1:1 whose position still matches the timeline is read directly; after any varispeed the
+  // position is fractional or offset and stays with the resampler.
+  const double position = blockStart <= startFrame_ ? 0.0 : sourcePosition_;
+  const double cued = blockStart <= startFrame_ ? 0.0 : static_cast<double>(blockStart - startFrame_);
+  return step != 1.0 || position != cued;
+}
+
+std::uint64_t ClipPlayerNode::playbackEnd(std::uint64_t blockStart, double step, bool resampled) const noexcept {
   const std::uint64_t endFrame = std::max(startFrame_, endFrame_);
-  const std::uint64_t bufferFrameCount = static_cast<std::uint64_t>(clipBuffer_.frameCount);
-  const std::uint64_t effectiveEnd = std::min<std::uint64_t>(endFrame, startFrame + bufferFrameCount);
-  const std::uint64_t playbackFrames = effectiveEnd > startFrame ? (effectiveEnd - startFrame) : 0;
-  const std::uint64_t fadeOutStart =
-      (fadeOutFrames_ >= playbackFrames || playbackFrames == 0) ? startFrame : (effectiveEnd - fadeOutFrames_);
-
-  for (std::size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
-    const std::uint64_t absoluteFrame = processedFrames_ + frameIndex;
-    if (absoluteFrame < startFrame || absoluteFrame >= effectiveEnd) {
-      continue;
-    }
+  const std::uint64_t frames = sourceFrameCount();
+  if (!resampled) {
+    return std::min<std::uint64_t>(endFrame, startFrame_ + frames);
+  }
+  // The end follows from the frames left at the current step, so it moves with varispeed.
+  const std::uint64_t playhead = std::max(blockStart, startFrame_);
+  const double position = blockStart <= startFrame_ ? 0.0 : sourcePosition_;
+  const double remaining = (static_cast<double>(frames) - position) / step;
+  const auto outputFrames = remaining > 0.0 ? static_cast<std::uint64_t>(std::ceil(remaining - 1e-9)) : 0;
+  return std::min<std::uint64_t>(endFrame, playhead + outputFrames);
+}
 
-    const std::uint64_t bufferFrame = absoluteFrame - startFrame;
-    if (bufferFrame >= bufferFrameCount) {
-      continue;
+void ClipPlayerNode::fetchSource(std::int64_t first, std::size_t count, std::size_t offset) {
+  const auto channelCount = sourceChannelCount();
+  const auto total = static_cast<std::int64_t>(sourceFrameCount());
+  const auto last = first + static_cast<std::int64_t>(count);
+  const auto validFirst = std::clamp<std::int64_t>(first, 0, total);
+  const auto validLast = std::clamp<std::int64_t>(last, validFirst, total);
+  const auto lead = static_cast<std::size_t>(std::max<std::int64_t>(0, std::min(validFirst, last) - first));
+  const auto valid = static_cast<std::size_t>(validLast - validFirst);
+  for (std::size_t channel = 0; channel < channelCount; ++channel) {
+    auto* dest = windowChannels_[channel] + offset;
+    // Frames before the clip start and past its end read as silence, so the filter rings out cleanly.
+    dsp::fill(dest, 0.0F, lead);
+    dsp::fill(dest + lead + valid, 0.0F, count - lead - valid);
+    fetchChannels_[channel] = dest + lead;
+  }
+  if (valid == 0) {
+    return;
+  }
+  if (stream_) {
+    stream_->read(static_cast<std::uint64_t>(validFirst), valid, fetchChannels_.data());
+    return;
+  }
+  for (std::size_t channel = 0; channel < channelCount; ++channel) {
+    if (const auto* samples = clipBuffer_.channels[channel]; samples != nullptr) {
+      dsp::decode(clipBuffer_.format, samples, static_cast<std::size_t>(validFirst), fetchChannels_[channel], valid);
+    } else {
+      dsp::fill(fetchChannels_[channel], 0.0F, valid);
     }
+  }
+}
 
-    double amplitude = gain_;
-    if (fadeInFrames_ > 0 && absoluteFrame < startFrame + fadeInFrames_) {
-      const std::uint64_t offset = absoluteFrame - startFrame;
-      amplitude *= static_cast<double>(offset + 1) / static_cast<double>(fadeInFrames_);
-    }
-    if (fadeOutFrames_ > 0 && absoluteFrame >= fadeOutStart) {
-      const std::uint64_t remaining = effectiveEnd > absoluteFrame ? (effectiveEnd - absoluteFrame) : 0;
-      const auto divisor = std::max<std::uint64_t>(1, std::min(fadeOutFrames_, playbackFrames));
-      amplitude *= static_cast<double>(remaining) / static_cast<double>(divisor);
-    }
+void ClipPlayerNode::resampleChunk(std::size_t count, double step) {
+  const auto quality = resampleQuality_;
+  const double position = sourcePosition_;
+  const auto behind = static_cast<std::int64_t>(ResampleLookBehind(quality));
+  const auto ahead = static_cast<std::int64_t>(ResampleLookAhead(quality));
+  const auto first = static_cast<std::int64_t>(std::floor(position)) - behind;
+  const auto last = static_cast<std::int64_t>(std::floor(position + step * static_cast<double>(count - 1))) + ahead + 1;
 
-    for (std::size_t channel = 0; channel < outputChannels; ++channel) {
-      const std::size_t sourceChannel =
-          bufferChannels == 1 ? 0 : std::min(channel, bufferChannels - 1);
-      const auto* source = clipBuffer_.channels[sourceChannel];
-      if (source == nullptr) {
-        continue;
-      }
-      const float sample = source[static_cast<std::size_t>(bufferFrame)];
-      buffer.channel(channel)[frameIndex] = static_cast<float>(sample * amplitude);
+  // Slide the window forward, keeping the filter context it already holds; anything else refetches.
+  const auto windowEnd = windowStart_ + static_cast<std::int64_t>(windowFrames_);
+  if (first < windowStart_ || first > windowEnd) {
+    windowStart_ = first;
+    windowFrames_ = 0;
+  } else if (first > windowStart_) {
+    const auto shift = static_cast<std::size_t>(first - windowStart_);
+    for (auto* channel : windowChannels_) {
+      std::memmove(channel, channel + shift, (windowFrames_ - shift) * sizeof(float));
     }
+    windowFrames_ -= shift;
+    windowStart_ = first;
+  }
+  const auto resident = windowStart_ + static_cast<std::int64_t>(windowFrames_);
+  if (last > resident) {
+    const auto missing = static_cast<std::size_t>(last - resident);
+    fetchSource(resident, missing, windowFrames_);
+    windowFrames_ += missing;
   }
 
-  processedFrames_ += frameCount;
+  const double windowPosition = position - static_cast<double>(windowStart_);
+  for (std::size_t channel = 0; channel < windowChannels_.size(); ++channel) {
+    Resample(windowChannels_[channel], windowPosition, step, decodedChannels_[channel], count, quality);
+  }
+  sourcePosition_ = position + step * static_cast<double>(count);
 }
 
-void ClipPlayerNode::setParameter(const std::string& name, double value) {
-  if (name == "startframe") {
-    startFrame_ = sanitizeFrameValue(value);
+void ClipPlayerNode::process(AudioBufferView buffer) {
+  const auto frameCount = buffer.frameCount();
+  if (frameCount == 0) {
     return;
   }
-  if (name == "endframe") {
-    endFrame_ = sanitizeFrameValue(value);
+  const auto outputChannels = buffer.channelCount();
+  const auto bufferChannels = sourceChannelCount();
+  const std::uint64_t bufferFrameCount = sourceFrameCount();
+  if (outputChannels == 0 || bufferChannels == 0 || bufferFrameCount == 0) {
+    gain_.skip(frameCount);
+    processedFrames_ += frameCount;
     return;
   }
-  if (name == "fadeinframes") {
-    fadeInFrames_ = sanitizeCountValue(value);
-    return;
+
+  const std::uint64_t blockStart = processedFrames_;
+  const std::uint64_t blockEnd = blockStart + frameCount;
+  const std::uint64_t startFrame = startFrame_;
+  if (blockStart <= startFrame) {
+    sourcePosition_ = 0.0;
   }
-  if (name == "fadeoutframes") {
-    fadeOutFrames_ = sanitizeCountValue(value);
-    return;
+  const double step = resampleStep();
+  const bool resampled = resamples(blockStart, step);
+  const std::uint64_t effectiveEnd = playbackEnd(blockStart, step, resampled);
+  const std::uint64_t playbackFrames = effectiveEnd - startFrame;
+  const std::uint64_t fadeInEnd = startFrame + std::min(fadeInFrames_, playbackFrames);
+  const std::uint64_t fadeOutStart = fadeOutFrames_ == 0               ? effectiveEnd
+                                     : fadeOutFrames_ >= playbackFrames ? startFrame
+                                                                        : effectiveEnd - fadeOutFrames_;
+  const auto fadeOutDivisor =
+      static_cast<double>(std::max<std::uint64_t>(1, std::min(fadeOutFrames_, playbackFrames)));
+
+  // The block splits once into silence before the clip, the clip window [first, last) and silence after
+  // it; the window is cut at the fade boundaries so each piece is a straight scaled copy or linear ramp.
+  const std::uint64_t first = std::clamp(startFrame, blockStart, blockEnd);
+  const std::uint64_t last = std::clamp(effectiveEnd, first, blockEnd);
+  // The gain ramp advances on every frame so it stays aligned with the timeline outside the clip too.
+  gain_.skip(static_cast<std::size_t>(first - blockStart));
+
+  // Float32 clips at 1:1 are read in place. Streamed and compact clips are pulled into scratch, and
+  // resampled clips rendered into it, one chunk at a time; the scratch is indexed from the chunk start.
+  const bool decodes = resampled || residentChannels_.empty();
+  const float* const* sources = decodes ? decodedChannels_.data() : residentChannels_.data();
+  std::uint64_t chunkFrames = std::max<std::uint64_t>(1, last - first);
+  if (resampled) {
+    const auto context = ResampleLookBehind(resampleQuality_) + ResampleLookAhead(resampleQuality_) + 2;
+    const auto reach = static_cast<std::uint64_t>(static_cast<double>(kResampleWindowFrames - context) / step) + 1;
+    chunkFrames = std::min<std::uint64_t>(kDecodeChunkFrames, reach);
+  } else if (decodes) {
+    chunkFrames = kDecodeChunkFrames;
   }
-  if (name == "gain") {
-    if (std::isfinite(value)) {
-      gain_ = value;
+  float envelope[kEnvelopeFrames];
+
+  for (std::uint64_t chunk = first; chunk < last; chunk += chunkFrames) {
+    const std::uint64_t chunkEnd = std::min(last, chunk + chunkFrames);
+    const std::uint64_t sourceBase = decodes ? chunk - startFrame : 0;
+    const auto count = static_cast<std::size_t>(chunkEnd - chunk);
+    if (resampled) {
+      resampleChunk(count, step);
+    } else if (stream_) {
+      stream_->read(sourceBase, count, decodedChannels_.data());
+    } else if (decodes) {
+      for (std::size_t channel = 0; channel < bufferChannels; ++channel) {
+        if (const auto* encoded = clipBuffer_.channels[channel]; encoded != nullptr) {
+          dsp::decode(clipBuffer_.format, encoded, static_cast<std::size_t>(sourceBase), decodedChannels_[channel],
+                      count);
+        } else {
+          dsp::fill(decodedChannels_[channel], 0.0F, count);
+        }
+      }
+    }
+    for (std::uint64_t piece = chunk; piece < chunkEnd;) {
+      const bool fadingIn = piece < fadeInEnd;
+      const bool fadingOut = piece >= fadeOutStart;
+      const bool ramping = gain_.isRamping();
+      std::uint64_t pieceEnd = chunkEnd;
+      if (fadingIn) {
+        pieceEnd = std::min(pieceEnd, fadeInEnd);
+      }
+      if (!fadingOut) {
+        pieceEnd = std::min(pieceEnd, fadeOutStart);
+      }
+      if (ramping) {
+        pieceEnd = std::min<std::uint64_t>(pieceEnd, piece + kEnvelopeFrames);
+      }
+      const auto count = static_cast<std::size_t>(pieceEnd - piece);
+      const auto outputOffset = static_cast<std::size_t>(piece - blockStart);
+      const auto sourceOffset = static_cast<std::size_t>(piece - startFrame - sourceBase);
+
+      float gain = 1.0F;
+      if (ramping) {
+        gain_.fill(envelope, count);
+      } else {
+        gain = static_cast<float>(gain_.current());
+      }
+      const double fadeInFrames = static_cast<double>(fadeInFrames_);
+      const auto fadeInStartGain = static_cast<float>(static_cast<double>(piece - startFrame + 1) / fadeInFrames);
+      const auto fadeInStep = static_cast<float>(1.0 / fadeInFrames);
+      const auto fadeOutStartGain = static_cast<float>(static_cast<double>(effectiveEnd - piece) / fadeOutDivisor);
+      const auto fadeOutStep = static_cast<float>(-1.0 / fadeOutDivisor);
+
+      for (std::size_t channel = 0; channel < outputChannels; ++channel) {
+        const auto* source = sources[std::min(channel, bufferChannels - 1)];
+        if (source == nullptr) {
+          continue;
+        }
+        source += sourceOffset;
+        auto* dest = buffer.channel(channel).data() + outputOffset;
+        if (ramping) {
+          dsp::copyMultiplied(dest, source, envelope, count);
+          if (fadingIn) {
+            dsp::multiplyRamped(dest, fadeInStartGain, fadeInStep, count);
+          }
+          if (fadingOut) {
+            dsp::multiplyRamped(dest, fadeOutStartGain, fadeOutStep, count);
+          }
+        } else if (fadingIn) {
+          dsp::copyRamped(dest, source, gain * fadeInStartGain, gain * fadeInStep, count);
+          if (fadingOut) {
+            dsp::multiplyRamped(dest, fadeOutStartGain, fadeOutStep, count);
+          }
+        } else if (fadingOut) {
+          dsp::copyRamped(dest, source, gain * fadeOutStartGain, gain * fadeOutStep, count);
+        } else {
+          dsp::copyScaled(dest, source, gain, count);
+        }
+      }
+      piece = pieceEnd;
     }
-    return;
   }
-  if (name == "buffersamplerate") {
-    declaredBufferSampleRate_ = std::isfinite(value) && value > 0.0 ? value : 0.0;
-    return;
+
+  gain_.skip(static_cast<std::size_t>(blockEnd - last));
+  if (!resampled) {
+    sourcePosition_ += static_cast<double>(last - first);
   }
-  if (name == "bufferchannels") {
-    declaredBufferChannels_ = sanitizeCountValue(value);
-    return;
+  processedFrames_ += frameCount;
+}
+
+bool ClipPlayerNode::isIdle(std::size_t frameCount) const {
+  if (sourceFrameCount() == 0) {
+    return true;
   }
-  if (name == "bufferframes") {
-    declaredBufferFrames_ = sanitizeFrameValue(value);
+  const double step = resampleStep();
+  const auto effectiveEnd = playbackEnd(processedFrames_, step, resamples(processedFrames_, step));
+  return processedFrames_ + frameCount <= startFrame_ || processedFrames_ >= effectiveEnd;
+}
+
+void ClipPlayerNode::skipSilence(std::size_t frameCount) {
+  gain_.skip(frameCount);
+  processedFrames_ += frameCount;
+}
+
+void ClipPlayerNode::setParameter(ParamId id, double value) {
+  switch (id) {
+    case kStartFrame:
+      startFrame_ = sanitizeFrameValue(value);
+      // Moving a playing clip re-derives its position from the timeline at the current rate.
+      sourcePosition_ =
+          processedFrames_ > startFrame_ ? static_cast<double>(processedFrames_ - startFrame_) * resampleStep() : 0.0;
+      break;
+    case kEndFrame:
+      endFrame_ = sanitizeFrameValue(value);
+      break;
+    case kFadeInFrames:
+      fadeInFrames_ = sanitizeCountValue(value);
+      break;
+    case kFadeOutFrames:
+      fadeOutFrames_ = sanitizeCountValue(value);
+      break;
+    case kGain:
+      if (std::isfinite(value)) {
+        gain_.setValue(value);
+      }
+      break;
+    case kBufferSampleRate:
+      declaredBufferSampleRate_ = std::isfinite(value) && value > 0.0 ? value : 0.0;
+      break;
+    case kBufferChannels:
+      declaredBufferChannels_ = sanitizeCountValue(value);
+      break;
+    case kBufferFrames:
+      declaredBufferFrames_ = sanitizeFrameValue(value);
+      break;
+    case kPlaybackRate:
+      if (std::isfinite(value)) {
+        playbackRate_ = std::clamp(value, kParameters[kPlaybackRate].minValue, kParameters[kPlaybackRate].maxValue);
+      }
+      break;
+    case kResampleQuality:
+      resampleQuality_ = value < 0.5 ? ResampleQuality::kLinear : ResampleQuality::kSinc;
+      break;
+    default:
+      break;
+  }
+}
+
+void ClipPlayerNode::rampParameter(ParamId id, double target, std::uint32_t frames, RampShape shape) {
+  if (id == kGain && std::isfinite(target)) {
+    gain_.rampTo(target, frames, shape);
+    return;
   }
+  DSPNode::rampParameter(id, target, frames, shape);
 }
 
 std::uint64_t ClipPlayerNode::sanitizeFrameValue(double value) {
@@ -0,0 +1,364 @@
+#include "audio_engine/OfflineRenderer.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "audio_engine/AudioBuffer.h"
+#include "audio_engine/DSPKernels.h"
+#include "audio_engine/SceneGraph.h"
+
+namespace daft::audio {
+
+namespace {
+
+// Samples go to disk in native byte order; every platform the engine ships on is little-endian.
+static_assert(std::endian::native == std::endian::little, "WAV output assumes a little-endian host");
+
+constexpr std::size_t kWavHeaderBytes = 44;
+constexpr std::uint16_t kWavFormatPcm = 1;
+constexpr std::uint16_t kWavFormatIeeeFloat = 3;
+// RIFF sizes are 32-bit and count the header fields after the first eight bytes.
+constexpr std::uint64_t kMaxWavDataBytes = std::numeric_limits<std::uint32_t>::max() - (kWavHeaderBytes - 8);
+
+void PutTag(std::uint8_t* at, const char* tag) { std::memcpy(at, tag, 4); }
+
+void PutU16(std::uint8_t* at, std::uint16_t value) {
+  at[0] = static_cast<std::uint8_t>(value);
+  at[1] = static_cast<std::uint8_t>(value >> 8);
+}
+
+void PutU32(std::uint8_t* at, std::uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    at[i] = static_cast<std::uint8_t>(value >> (8 * i));
+  }
+}
+
+bool WriteAll(int fd, const void* data, std::size_t bytes) {
+  const auto* cursor = static_cast<const std::uint8_t*>(data);
+  while (bytes > 0) {
+    const auto written = ::write(fd, cursor, bytes);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return false;
+    }
+    cursor += written;
+    bytes -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+
+}  // namespace
+
+WavFileWriter::~WavFileWriter() {
+  std::string ignored;
+  close(ignored);
+}
+
+bool WavFileWriter::open(const std::string& path, std::size_t channelCount, double sampleRate, SampleFormat format,
+                         std::string& error) {
+  if (isOpen()) {
+    error = "writer is already open";
+    return false;
+  }
+  if (format == SampleFormat::kFloat16) {
+    error = "WAV output supports float32 and int16 samples";
+    return false;
+  }
+  if (channelCount == 0 || channelCount > std::numeric_limits<std::uint16_t>::max() || !(sampleRate > 0.0) ||
+      sampleRate > std::numeric_limits<std::uint32_t>::max()) {
+    error = "WAV output requires a positive channel count and sample rate";
+    return false;
+  }
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    error = "cannot create '" + path + "'";
+    return false;
+  }
+
+  // Sizes stay zero until `close` patches them.
+  const auto bytesPerSample = static_cast<std::uint16_t>(BytesPerSample(format));
+  const auto blockAlign = static_cast<std::uint16_t>(channelCount * bytesPerSample);
+  const auto rate = static_cast<std::uint32_t>(sampleRate);
+  std::array<std::uint8_t, kWavHeaderBytes> header{};
+  PutTag(&header[0], "RIFF");
+  PutTag(&header[8], "WAVE");
+  PutTag(&header[12], "fmt ");
+  PutU32(&header[16], 16);
+  PutU16(&header[20], format == SampleFormat::kFloat32 ? kWavFormatIeeeFloat : kWavFormatPcm);
+  PutU16(&header[22], static_cast<std::uint16_t>(channelCount));
+  PutU32(&header[24], rate);
+  PutU32(&header[28], rate * blockAlign);
+  PutU16(&header[32], blockAlign);
+  PutU16(&header[34], static_cast<std::uint16_t>(8 * bytesPerSample));
+  PutTag(&header[36], "data");
+  if (!WriteAll(fd, header.data(), header.size())) {
+    ::close(fd);
+    error = "cannot write to '" + path + "'";
+    return false;
+  }
+
+  fd_ = fd;
+  channelCount_ = channelCount;
+  format_ = format;
+  framesWritten_ = 0;
+  return true;
+}
+
+bool WavFileWriter::write(const float* interleaved, std::size_t frames, std::string& error) {
+  if (!isOpen()) {
+    error = "writer is not open";
+    return false;
+  }
+  const auto samples = frames * channelCount_;
+  const auto frameBytes = channelCount_ * BytesPerSample(format_);
+  if ((framesWritten_ + frames) * frameBytes > kMaxWavDataBytes) {
+    error = "render exceeds the 4 GB WAV size limit";
+    return false;
+  }
+  bool written = false;
+  if (format_ == SampleFormat::kFloat32) {
+    written = WriteAll(fd_, interleaved, samples * sizeof(float));
+  } else {
+    encoded_.resize(samples);
+    dsp::encodeInt16(encoded_.data(), interleaved, samples);
+    written = WriteAll(fd_, encoded_.data(), samples * sizeof(std::int16_t));
+  }
+  if (!written) {
+    error = "cannot write samples";
+    return false;
+  }
+  framesWritten_ += frames;
+  return true;
+}
+
+bool WavFileWriter::close(std::string& error) {
+  if (!isOpen()) {
+    return true;
+  }
+  const auto dataBytes = static_cast<std::uint32_t>(framesWritten_ * channelCount_ * BytesPerSample(format_));
+  std::array<std::uint8_t, 4> riffSize{};
+  std::array<std::uint8_t, 4> dataSize{};
+  PutU32(riffSize.data(), dataBytes + static_cast<std::uint32_t>(kWavHeaderBytes - 8));
+  PutU32(dataSize.data(), dataBytes);
+  const bool patched = ::pwrite(fd_, riffSize.data(), riffSize.size(), 4) == 4 &&
+                       ::pwrite(fd_, dataSize.data(), dataSize.size(), kWavHeaderBytes - 4) == 4;
+  const bool closed = ::close(fd_) == 0;
+  fd_ = -1;
+  if (!patched || !closed) {
+    error = "cannot finalize WAV file";
+    return false;
+  }
+  return true;
+}
+
+OfflineRenderer::~OfflineRenderer() {
+  cancel();
+  wait();
+}
+
+bool OfflineRenderer::start(SceneGraph& graph, const std::string& path, const Options& options, std::string& error) {
+  if (graph_ != nullptr) {
+    error = "an offline render is already running";
+    return false;
+  }
+  if (options.frameCount == 0 || options.channelCount == 0 ||
+      options.channelCount > graph.maxSupportedChannels()) {
+    error = "offline render requires a frame count and 1-" + std::to_string(graph.maxSupportedChannels()) +
+            " channels";
+    return false;
+  }
+  if (!writer_.open(path, options.channelCount, graph.sampleRate(), options.format, error)) {
+    return false;
+  }
+
+  graph_ = &graph;
+  options_ = options;
+  const auto maxBlock = graph.maxSupportedFramesPerBuffer();
+  options_.blockFrames = options.blockFrames == 0 ? maxBlock : std::min(options.blockFrames, maxBlock);
+  path_ = path;
+  previousOffline_ = graph.offlineRendering();
+  previousWorkers_ = graph.renderWorkerCount();
+  if (options.workerCount > 0) {
+    graph.setRenderWorkerCount(options.workerCount);
+  }
+  graph.setOfflineRendering(true);
+  graph.resetTimeline();
+
+  // Whole blocks per chunk, so chunk boundaries never split a graph block.
+  const auto chunkFrames = std::max<std::size_t>(1, kChunkFrames / options_.blockFrames) * options_.blockFrames;
+  chunks_.assign(kChunkCount, Chunk{std::vector<float>(chunkFrames * options_.channelCount), 0});
+  producedChunks_ = 0;
+  consumedChunks_ = 0;
+  renderDone_ = false;
+  error_.clear();
+  cancelled_.store(false, std::memory_order_relaxed);
+  renderedFrames_.store(0, std::memory_order_relaxed);
+  writtenFrames_.store(0, std::memory_order_relaxed);
+  totalFrames_.store(options_.frameCount, std::memory_order_relaxed);
+  state_.store(State::kRendering, std::memory_order_release);
+  renderThread_ = std::thread([this]() { runRender(); });
+  writerThread_ = std::thread([this]() { runWriter(); });
+  return true;
+}
+
+void OfflineRenderer::cancel() noexcept {
+  cancelled_.store(true, std::memory_order_release);
+  {
+    // Taking the lock orders the flag against a thread about to sleep on either condition.
+    std::lock_guard<std::mutex> lock(mutex_);
+  }
+  chunkReady_.notify_all();
+  chunkFree_.notify_all();
+}
+
+OfflineRenderer::State OfflineRenderer::wait() {
+  if (renderThread_.joinable()) {
+    renderThread_.join();
+  }
+  if (writerThread_.joinable()) {
+    writerThread_.join();
+  }
+  if (graph_ != nullptr) {
+    graph_->setOfflineRendering(previousOffline_);
+    if (options_.workerCount > 0) {
+      graph_->setRenderWorkerCount(previousWorkers_);
+    }
+    graph_->resetTimeline();
+    graph_ = nullptr;
+    chunks_.clear();
+  }
+  return state_.load(std::memory_order_acquire);
+}
+
+OfflineRenderer::Progress OfflineRenderer::progress() const {
+  return {state_.load(std::memory_order_acquire), renderedFrames_.load(std::memory_order_relaxed),
+          writtenFrames_.load(std::memory_order_relaxed), totalFrames_.load(std::memory_order_relaxed)};
+}
+
+std::string OfflineRenderer::error() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return error_;
+}
+
+void OfflineRenderer::fail(std::string message) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto expected = State::kRendering;
+    if (state_.compare_exchange_strong(expected, State::kFailed, std::memory_order_acq_rel)) {
+      error_ = std::move(message);
+    }
+  }
+  chunkReady_.notify_all();
+  chunkFree_.notify_all();
+}
+
+void OfflineRenderer::runRender() {
+  const auto channels = options_.channelCount;
+  const auto blockFrames = options_.blockFrames;
+  std::vector<float> planar(channels * blockFrames);
+  std::vector<float*> pointers(channels);
+  for (std::size_t ch = 0; ch < channels; ++ch) {
+    pointers[ch] = planar.data() + ch * blockFrames;
+  }
+  const auto stopped = [this]() {
+    return cancelled_.load(std::memory_order_acquire) || state_.load(std::memory_order_acquire) != State::kRendering;
+  };
+
+  try {
+    std::uint64_t frame = 0;
+    while (frame < options_.frameCount && !stopped()) {
+      Chunk* chunk = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        chunkFree_.wait(lock, [&]() { return producedChunks_ - consumedChunks_ < kChunkCount || stopped(); });
+        if (stopped()) {
+          break;
+        }
+        chunk = &chunks_[producedChunks_ % kChunkCount];
+      }
+      const auto capacity = chunk->samples.size() / channels;
+      const auto chunkFrames = static_cast<std::size_t>(std::min<std::uint64_t>(capacity, options_.frameCount - frame));
+      for (std::size_t offset = 0; offset < chunkFrames && !stopped(); offset += blockFrames) {
+        const auto frames = std::min(blockFrames, chunkFrames - offset);
+        graph_->render(AudioBufferView(pointers.data(), channels, frames));
+        float* dest = chunk->samples.data() + offset * channels;
+        for (std::size_t i = 0; i < frames; ++i) {
+          for (std::size_t ch = 0; ch < channels; ++ch) {
+            dest[i * channels + ch] = pointers[ch][i];
+          }
+        }
+        renderedFrames_.store(frame + offset + frames, std::memory_order_relaxed);
+      }
+      if (stopped()) {
+        break;
+      }
+      chunk->frames = chunkFrames;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++producedChunks_;
+      }
+      chunkReady_.notify_one();
+      frame += chunkFrames;
+    }
+  } catch (const std::exception& e) {
+    fail(std::string("render failed: ") + e.what());
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    renderDone_ = true;
+  }
+  chunkReady_.notify_one();
+}
+
+void OfflineRenderer::runWriter() {
+  std::string writeError;
+  while (true) {
+    const Chunk* chunk = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      chunkReady_.wait(lock, [&]() {
+        return consumedChunks_ < producedChunks_ || renderDone_ || cancelled_.load(std::memory_order_acquire);
+      });
+      if (cancelled_.load(std::memory_order_acquire) || consumedChunks_ == producedChunks_) {
+        break;
+      }
+      chunk = &chunks_[consumedChunks_ % kChunkCount];
+    }
+    if (!writer_.write(chunk->samples.data(), chunk->frames, writeError)) {
+      fail(writeError);
+      break;
+    }
+    writtenFrames_.fetch_add(chunk->frames, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++consumedChunks_;
+    }
+    chunkFree_.notify_one();
+  }
+
+  if (!writer_.close(writeError)) {
+    fail(writeError);
+  }
+  auto expected = State::kRendering;
+  const auto finished = !cancelled_.load(std::memory_order_acquire) &&
+                        writtenFrames_.load(std::memory_order_relaxed) == options_.frameCount;
+  state_.compare_exchange_strong(expected, finished ? State::kFinished : State::kCancelled,
+                                 std::memory_order_acq_rel);
+  if (state_.load(std::memory_order_acquire) != State::kFinished) {
+    ::unlink(path_.c_str());
+  }
+}
+
+}  // namespace daft::audio
@@ -1,5 +1,6 @@
 #include "audio_engine/PluginHost.h"
 
+#include <algorithm>
 #include <atomic>
 
 namespace daft::audio {
@@ -7,6 +8,11 @@ namespace daft::audio {
 namespace {
 std::atomic<PluginHostBridge::RenderCallback> gRenderCallback{nullptr};
 std::atomic<void*> gRenderUserData{nullptr};
+std::atomic<PluginHostBridge::BatchRenderCallback> gBatchRenderCallback{nullptr};
+std::atomic<void*> gBatchRenderUserData{nullptr};
+std::atomic<PluginHostBridge::ResolveCallback> gResolveCallback{nullptr};
+std::atomic<void*> gResolveUserData{nullptr};
+std::atomic<std::uint64_t> gHandleGeneration{0};
 }  // namespace
 
 void PluginHostBridge::SetRenderCallback(RenderCallback callback, void* userData) noexcept {
@@ -31,4 +37,63 @@ std::optional<PluginRenderResult> PluginHostBridge::Render(PluginRenderRequest&
   }
 }
 
+void PluginHostBridge::SetBatchRenderCallback(BatchRenderCallback callback, void* userData) noexcept {
+  gBatchRenderUserData.store(userData, std::memory_order_release);
+  gBatchRenderCallback.store(callback, std::memory_order_release);
+}
+
+void PluginHostBridge::ClearBatchRenderCallback() noexcept { SetBatchRenderCallback(nullptr, nullptr); }
+
+bool PluginHostBridge::HasBatchRenderCallback() noexcept {
+  return gBatchRenderCallback.load(std::memory_order_acquire) != nullptr;
+}
+
+bool PluginHostBridge::RenderBatch(std::span<PluginRenderRequest* const> requests,
+                                   std::span<PluginRenderResult> results) noexcept {
+  const auto count = std::min(requests.size(), results.size());
+  if (const auto batch = gBatchRenderCallback.load(std::memory_order_acquire)) {
+    const auto userData = gBatchRenderUserData.load(std::memory_order_acquire);
+    try {
+      batch(requests.data(), results.data(), count, userData);
+    } catch (...) {
+      std::fill_n(results.begin(), count, PluginRenderResult{false, false});
+    }
+    return true;
+  }
+  if (gRenderCallback.load(std::memory_order_acquire) == nullptr) {
+    return false;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    results[i] = Render(*requests[i]).value_or(PluginRenderResult{false, false});
+  }
+  return true;
+}
+
+void PluginHostBridge::SetResolveCallback(ResolveCallback callback, void* userData) noexcept {
+  gResolveUserData.store(userData, std::memory_order_release);
+  gResolveCallback.store(callback, std::memory_order_release);
+  InvalidateHandles();
+}
+
+void PluginHostBridge::ClearResolveCallback() noexcept { SetResolveCallback(nullptr, nullptr); }
+
+PluginInstanceHandle PluginHostBridge::Resolve(std::string_view hostInstanceId) noexcept {
+  const auto callback = gResolveCallback.load(std::memory_order_acquire);
+  if (!callback || hostInstanceId.empty()) {
+    return kInvalidPluginInstanceHandle;
+  }
+  const auto userData = gResolveUserData.load(std::memory_order_acquire);
+  try {
+    return callback(hostInstanceId, userData);
+  } catch (...) {
+    return kInvalidPluginInstanceHandle;
+  }
+}
+
+void PluginHostBridge::InvalidateHandles() noexcept { gHandleGeneration.fetch_add(1, std::memory_order_acq_rel); }
+
+std::uint64_t PluginHostBridge::HandleGeneration() noexcept {
+  return gHandleGeneration.load(std::memory_order_acquire);
+}
+
 }  // namespace daft::audio
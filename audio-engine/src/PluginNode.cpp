@@ -1,12 +1,17 @@
 #include "audio_engine/PluginNode.h"
 
 #include <algorithm>
-#include <cctype>
+#include <charconv>
 #include <cmath>
 #include <cstdio>
 #include <cstdint>
 #include <limits>
+#include <thread>
 #include <utility>
+#include <vector>
+
+#include "audio_engine/DSPKernels.h"
+#include "audio_engine/RealtimeSafety.h"
 
 #if defined(__ANDROID__)
 #include <android/log.h>
@@ -20,8 +25,10 @@ namespace {
 constexpr const char* kLogTag = "DaftAudioEngine";
 
 #if defined(__ANDROID__)
-void LogPluginError(const char* message, const std::string& instanceId) {
-  __android_log_print(ANDROID_LOG_ERROR, kLogTag, "%s (hostInstanceId=%s)", message, instanceId.c_str());
+void LogPluginError(const char* message, std::string_view instanceId) {
+  CheckRealtimeSafe("plugin error logging");
+  __android_log_print(ANDROID_LOG_ERROR, kLogTag, "%s (hostInstanceId=%.*s)", message,
+                      static_cast<int>(instanceId.size()), instanceId.data());
 }
 #elif defined(__APPLE__)
 os_log_t PluginLogger() {
@@ -29,96 +36,524 @@ os_log_t PluginLogger() {
   return logger;
 }
 
-void LogPluginError(const char* message, const std::string& instanceId) {
-  os_log_error(PluginLogger(), "%{public}s (hostInstanceId=%{public}s)", message, instanceId.c_str());
+void LogPluginError(const char* message, std::string_view instanceId) {
+  CheckRealtimeSafe("plugin error logging");
+  os_log_error(PluginLogger(), "%{public}s (hostInstanceId=%{public}.*s)", message,
+               static_cast<int>(instanceId.size()), instanceId.data());
 }
 #else
-void LogPluginError(const char* message, const std::string& instanceId) {
-  std::fprintf(stderr, "PluginNode error: %s (hostInstanceId=%s)\n", message, instanceId.c_str());
+void LogPluginError(const char* message, std::string_view instanceId) {
+  CheckRealtimeSafe("plugin error logging");
+  std::fprintf(stderr, "PluginNode error: %s (hostInstanceId=%.*s)\n", message, static_cast<int>(instanceId.size()),
+               instanceId.data());
 }
 #endif
 }  // namespace
 
-PluginNode::PluginNode(std::string hostInstanceId, PluginBusCapabilities capabilities)
-    : hostInstanceId_(std::move(hostInstanceId)), capabilities_(capabilities) {}
+/**
+ * Worker-side state of the anticipative mode. The audio thread writes input frame `f` of its own
+ * timeline to ring slot `f % capacity` and queues one job per block; the worker renders the job and
+ * writes the result to slot `(f + latency) % capacity` of the output ring, so output position `q`
+ * plays input frame `q - latency`. Positions before the first `latency` frames play silence. With
+ * `capacity` covering the latency plus two blocks, neither side overwrites a slot the other has yet
+ * to read unless the worker falls a full ring behind, which it detects and renders as silence.
+ */
+struct PluginNode::Anticipation {
+  struct Job {
+    std::uint64_t frame = 0;
+    std::uint32_t frameCount = 0;
+    std::uint32_t channelCount = 0;
+    std::uint32_t eventCount = 0;
+    bool bypassed = false;
+    double sampleRate = 0.0;
+  };
+  static constexpr std::size_t kMaxJobs = 64;
+
+  Anticipation(std::uint32_t latencyFrames, std::size_t channelCount, std::size_t blockFrames)
+      : latency(latencyFrames),
+        channels(channelCount),
+        maxFrames(blockFrames),
+        capacity(latencyFrames + 2 * blockFrames),
+        input(channelCount * capacity, 0.0F),
+        output(channelCount * capacity, 0.0F),
+        primedUntil(latencyFrames),
+        scratch(channelCount * blockFrames, 0.0F),
+        scratchChannels(channelCount, nullptr) {}
+
+  [[nodiscard]] float* inputChannel(std::size_t channel) { return input.data() + channel * capacity; }
+  [[nodiscard]] float* outputChannel(std::size_t channel) { return output.data() + channel * capacity; }
+
+  const std::uint32_t latency;
+  const std::size_t channels;
+  const std::size_t maxFrames;
+  const std::size_t capacity;
+  std::vector<float> input;
+  std::vector<float> output;
+
+  // Audio thread. Output positions before `primedUntil` play silence: the first `latency` frames, and
+  // the first `latency` frames after a reset, which would otherwise replay audio from before it.
+  std::uint64_t writeFrame = 0;
+  std::uint64_t primedUntil = 0;
+  std::uint32_t sentBinding = std::numeric_limits<std::uint32_t>::max();
+
+  SpscQueue<Job, kMaxJobs> jobs{};
+  SpscQueue<PluginEvent, PluginEventList::kCapacity * 4> events{};
+  SpscQueue<Binding, 4> bindings{};
+  std::atomic<std::uint64_t> pushedFrames{0};
+  std::atomic<std::uint64_t> renderedFrames{0};
+  std::atomic<std::uint64_t> underruns{0};
+  std::atomic<std::uint32_t> wake{0};
+  std::atomic<bool> stopping{false};
+
+  // Worker thread.
+  std::uint64_t nextFrame = 0;
+  Binding binding{};
+  std::vector<float> scratch;
+  std::vector<float*> scratchChannels;
+  PluginEventList workerEvents;
+  PluginEventList discardedEvents;
+  std::thread thread;
+};
+
+namespace {
+// Copy `count` samples between a linear buffer and a ring of `capacity` samples starting at `position`.
+void WriteRing(float* ring, std::size_t capacity, std::uint64_t position, const float* source, std::size_t count) {
+  const auto start = static_cast<std::size_t>(position % capacity);
+  const auto first = std::min(count, capacity - start);
+  dsp::copy(ring + start, source, first);
+  dsp::copy(ring, source + first, count - first);
+}
+
+void ReadRing(const float* ring, std::size_t capacity, std::uint64_t position, float* dest, std::size_t count) {
+  const auto start = static_cast<std::size_t>(position % capacity);
+  const auto first = std::min(count, capacity - start);
+  dsp::copy(dest, ring + start, first);
+  dsp::copy(dest + first, ring, count - first);
+}
+}  // namespace
+
+PluginNode::PluginNode(std::string hostInstanceId, PluginBusCapabilities capabilities) : capabilities_(capabilities) {
+  setHostInstanceId(std::move(hostInstanceId));
+}
+
+PluginNode::~PluginNode() { stopAnticipation(); }
+
+void PluginNode::enableAnticipation(std::uint32_t latencyFrames) {
+  if (anticipation_ || latencyFrames == 0) {
+    return;
+  }
+  startAnticipation(latencyFrames);
+}
+
+void PluginNode::setRenderLimits(std::size_t maxChannels, std::size_t maxFrames) {
+  if (maxChannels == maxChannels_ && maxFrames == maxFrames_) {
+    return;
+  }
+  maxChannels_ = maxChannels;
+  maxFrames_ = maxFrames;
+  if (anticipation_) {
+    // Nothing renders the node here, so the rings can be rebuilt; the new ones start primed.
+    const auto latency = anticipation_->latency;
+    stopAnticipation();
+    startAnticipation(latency);
+  }
+}
+
+void PluginNode::startAnticipation(std::uint32_t latencyFrames) {
+  anticipation_ = std::make_unique<Anticipation>(latencyFrames, maxChannels_, maxFrames_);
+  anticipation_->thread = std::thread([this]() { runAnticipationWorker(); });
+}
+
+void PluginNode::stopAnticipation() noexcept {
+  if (!anticipation_) {
+    return;
+  }
+  anticipation_->stopping.store(true, std::memory_order_release);
+  anticipation_->wake.fetch_add(1, std::memory_order_release);
+  anticipation_->wake.notify_one();
+  anticipation_->thread.join();
+  anticipation_.reset();
+}
+
+std::uint32_t PluginNode::latencyFrames() const noexcept {
+  const auto anticipated = anticipation_ ? anticipation_->latency : 0;
+  return bypassed() ? anticipated : anticipated + pluginLatency_.load(std::memory_order_relaxed);
+}
+
+std::uint32_t PluginNode::maxLatencyFrames() const noexcept {
+  return (anticipation_ ? anticipation_->latency : 0) + kMaxReportedLatencyFrames;
+}
+
+std::uint64_t PluginNode::anticipationUnderruns() const noexcept {
+  return anticipation_ ? anticipation_->underruns.load(std::memory_order_relaxed) : 0;
+}
 
 void PluginNode::prepare(double sampleRate) {
   DSPNode::prepare(sampleRate);
   resetFailureFlags();
+  // The host may only know the instance by now, or may have invalidated earlier handles.
+  bind();
+}
+
+void PluginNode::reset() {
+  resetFailureFlags();
+  processedFrames_ = 0;
+  pendingCount_ = 0;
+  if (anticipation_) {
+    anticipation_->primedUntil = anticipation_->writeFrame + anticipation_->latency;
+  }
+}
+
+void PluginNode::process(AudioBufferView buffer) { render(buffer, {}); }
+
+void PluginNode::processInputs(std::span<const AudioBufferView> inputs, AudioBufferView output) {
+  if (inputs.empty() || inputs.front().isSilent()) {
+    output.fill(0.0F);
+  } else {
+    for (std::size_t ch = 0; ch < output.channelCount(); ++ch) {
+      dsp::copy(output.channel(ch).data(), inputs.front().channel(ch).data(), output.frameCount());
+    }
+  }
+  render(output, inputs.empty() ? inputs : inputs.subspan(1));
 }
 
-void PluginNode::reset() { resetFailureFlags(); }
+void PluginNode::render(AudioBufferView buffer, std::span<const AudioBufferView> sidechains) {
+  const auto blockStart = processedFrames_;
+  processedFrames_ += buffer.frameCount();
+  collectEvents(blockStart, buffer.frameCount());
+  outputEvents_.clear();
 
-void PluginNode::process(AudioBufferView buffer) {
   if (buffer.frameCount() == 0 || buffer.channelCount() == 0) {
     return;
   }
 
+  if (anticipation_) {
+    renderAnticipated(buffer);
+    return;
+  }
+
   if (bypassed_.load(std::memory_order_acquire)) {
     return;
   }
 
-  if (hostInstanceId_.empty()) {
-    logHostUnavailable();
+  const auto& binding = adoptBinding();
+  const std::string_view instanceId{binding.id.data(), binding.length};
+  if (binding.length == 0) {
+    logHostUnavailable(instanceId);
+    return;
+  }
+
+  const bool handleValid = binding.generation == PluginHostBridge::HandleGeneration();
+  const auto handle = handleValid ? binding.handle : kInvalidPluginInstanceHandle;
+  request_ = {instanceId, buffer, sampleRate(), capabilities_, false, &inputEvents_, &outputEvents_, sidechains,
+              handle};
+  if (deferRender_) {
+    requestPending_ = true;
+    return;
+  }
+  finishRender(PluginHostBridge::Render(request_));
+}
+
+void PluginNode::renderAnticipated(AudioBufferView buffer) noexcept {
+  auto& state = *anticipation_;
+  const auto frames = buffer.frameCount();
+  const auto start = state.writeFrame;
+  state.writeFrame += frames;
+  if (frames > state.maxFrames || buffer.channelCount() > state.channels) {
+    // Only outside a graph, which sizes the rings to its limits. The worker sees the skipped frames as
+    // a gap and renders them as silence.
+    buffer.fill(0.0F);
+    state.underruns.fetch_add(1, std::memory_order_relaxed);
     return;
   }
 
-  PluginRenderRequest request{hostInstanceId_, buffer, sampleRate(), capabilities_, false};
-  const auto result = PluginHostBridge::Render(request);
+  adoptBinding();
+  if (state.sentBinding != adoptedBindings_ && state.bindings.push(bindings_[readBinding_])) {
+    state.sentBinding = adoptedBindings_;
+  }
+  while (offline_ && state.jobs.full()) {
+    state.renderedFrames.wait(state.renderedFrames.load(std::memory_order_acquire), std::memory_order_acquire);
+  }
+  if (state.jobs.full()) {
+    // The worker is far behind; these frames play as silence once it catches up.
+    state.underruns.fetch_add(1, std::memory_order_relaxed);
+    state.pushedFrames.store(start + frames, std::memory_order_release);
+    buffer.fill(0.0F);
+    return;
+  }
+
+  const auto channels = buffer.channelCount();
+  for (std::size_t ch = 0; ch < channels; ++ch) {
+    WriteRing(state.inputChannel(ch), state.capacity, start, buffer.channel(ch).data(), frames);
+  }
+  std::uint32_t eventCount = 0;
+  for (const auto& event : inputEvents_.events()) {
+    if (!state.events.push(event)) {
+      break;
+    }
+    ++eventCount;
+  }
+  const Anticipation::Job job{start, static_cast<std::uint32_t>(frames), static_cast<std::uint32_t>(channels),
+                              eventCount, bypassed_.load(std::memory_order_acquire), sampleRate()};
+  state.jobs.push(job);
+  state.pushedFrames.store(start + frames, std::memory_order_release);
+  state.wake.fetch_add(1, std::memory_order_release);
+  state.wake.notify_one();
+
+  // Output position q plays input frame q - latency; positions before primedUntil are primed silence.
+  const auto primed = start < state.primedUntil ? std::min<std::uint64_t>(frames, state.primedUntil - start) : 0;
+  auto rendered = state.renderedFrames.load(std::memory_order_acquire);
+  // Offline there is no deadline; the job just queued lets the worker reach every frame this block plays.
+  while (offline_ && rendered + state.latency < start + frames) {
+    state.renderedFrames.wait(rendered, std::memory_order_acquire);
+    rendered = state.renderedFrames.load(std::memory_order_acquire);
+  }
+  const auto ready = rendered + state.latency;
+  const auto available = ready > start ? std::min<std::uint64_t>(frames, ready - start) : 0;
+  const auto head = static_cast<std::size_t>(primed);
+  const auto end = static_cast<std::size_t>(std::max(primed, available));
+  for (std::size_t ch = 0; ch < channels; ++ch) {
+    auto* dest = buffer.channel(ch).data();
+    dsp::fill(dest, 0.0F, head);
+    ReadRing(state.outputChannel(ch), state.capacity, start + head, dest + head, end - head);
+    dsp::fill(dest + end, 0.0F, frames - end);
+  }
+  if (end < frames) {
+    state.underruns.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void PluginNode::runAnticipationWorker() {
+  auto& state = *anticipation_;
+  while (true) {
+    const auto seen = state.wake.load(std::memory_order_acquire);
+    while (const auto job = state.jobs.pop()) {
+      while (const auto binding = state.bindings.pop()) {
+        state.binding = *binding;
+      }
+      state.workerEvents.clear();
+      for (std::uint32_t i = 0; i < job->eventCount; ++i) {
+        if (const auto event = state.events.pop()) {
+          state.workerEvents.push(*event);
+        }
+      }
+
+      // Frames the audio thread never queued (a dropped job or an oversized block) render as silence.
+      const auto gap = std::min<std::uint64_t>(job->frame - std::min(job->frame, state.nextFrame), state.capacity);
+      for (std::size_t ch = 0; ch < state.channels; ++ch) {
+        for (std::uint64_t frame = job->frame - gap; frame < job->frame; ++frame) {
+          state.outputChannel(ch)[(frame + state.latency) % state.capacity] = 0.0F;
+        }
+      }
+
+      const auto frames = job->frameCount;
+      auto& channels = state.scratchChannels;
+      for (std::size_t ch = 0; ch < job->channelCount; ++ch) {
+        channels[ch] = state.scratch.data() + ch * state.maxFrames;
+        ReadRing(state.inputChannel(ch), state.capacity, job->frame, channels[ch], frames);
+      }
+      // A worker a full ring behind may have read input the audio thread was already overwriting.
+      const bool intact =
+          state.pushedFrames.load(std::memory_order_acquire) + state.maxFrames <= job->frame + state.capacity;
+      AudioBufferView view(channels.data(), job->channelCount, frames);
+      if (!intact) {
+        view.fill(0.0F);
+      } else if (!job->bypassed && state.binding.length > 0) {
+        const auto handle = state.binding.generation == PluginHostBridge::HandleGeneration()
+                                ? state.binding.handle
+                                : kInvalidPluginInstanceHandle;
+        state.discardedEvents.clear();
+        PluginRenderRequest request{{state.binding.id.data(), state.binding.length},
+                                    view,
+                                    job->sampleRate,
+                                    capabilities_,
+                                    false,
+                                    &state.workerEvents,
+                                    &state.discardedEvents,
+                                    {},
+                                    handle};
+        // Log the id this job rendered; bindings_ belongs to the audio and control threads.
+        applyRenderResult(PluginHostBridge::Render(request), request.hostInstanceId);
+      }
+      for (std::size_t ch = 0; ch < job->channelCount; ++ch) {
+        WriteRing(state.outputChannel(ch), state.capacity, job->frame + state.latency, channels[ch], frames);
+      }
+      state.nextFrame = job->frame + frames;
+      state.renderedFrames.store(state.nextFrame, std::memory_order_release);
+      state.renderedFrames.notify_one();
+    }
+    if (state.stopping.load(std::memory_order_acquire)) {
+      return;
+    }
+    state.wake.wait(seen, std::memory_order_acquire);
+  }
+}
+
+PluginRenderRequest* PluginNode::takeDeferredRequest() noexcept {
+  deferRender_ = false;
+  if (!requestPending_) {
+    return nullptr;
+  }
+  requestPending_ = false;
+  return &request_;
+}
+
+void PluginNode::finishRender(const std::optional<PluginRenderResult>& result) noexcept {
+  applyRenderResult(result, request_.hostInstanceId);
+}
+
+void PluginNode::applyRenderResult(const std::optional<PluginRenderResult>& result,
+                                   std::string_view instanceId) noexcept {
   if (!result.has_value()) {
-    logHostUnavailable();
+    logHostUnavailable(instanceId);
     return;
   }
 
   hostUnavailableLogged_.store(false, std::memory_order_release);
 
   if (!result->success) {
-    logRenderFailure();
+    logRenderFailure(instanceId);
     return;
   }
 
   renderFailureLogged_.store(false, std::memory_order_release);
+  if (result->tailFrames) {
+    tailFrames_.store(*result->tailFrames, std::memory_order_relaxed);
+  }
+  if (result->latencyFrames) {
+    pluginLatency_.store(std::min(*result->latencyFrames, kMaxReportedLatencyFrames), std::memory_order_relaxed);
+  }
+}
 
-  if (result->pluginBypassed) {
-    return;
+void PluginNode::drainInbox() noexcept {
+  while (pendingCount_ < kMaxQueuedEvents) {
+    const auto queued = inbox_.pop();
+    if (!queued) {
+      break;
+    }
+    const auto end = pending_.begin() + static_cast<std::ptrdiff_t>(pendingCount_);
+    const auto at = std::upper_bound(pending_.begin(), end, queued->frame,
+                                     [](std::uint64_t frame, const TimedEvent& event) { return frame < event.frame; });
+    std::move_backward(at, end, end + 1);
+    *at = *queued;
+    ++pendingCount_;
   }
 }
 
-void PluginNode::setParameter(const std::string& name, double value) {
-  const auto lowered = toLower(name);
-  if (lowered == "bypass" || lowered == "bypassed") {
+void PluginNode::collectEvents(std::uint64_t blockStart, std::size_t frameCount) noexcept {
+  drainInbox();
+  inputEvents_.clear();
+  const auto blockEnd = blockStart + frameCount;
+  std::size_t due = 0;
+  for (; due < pendingCount_ && pending_[due].frame < blockEnd; ++due) {
+    auto event = pending_[due].event;
+    const auto frame = std::max(pending_[due].frame, blockStart);
+    event.sampleOffset = static_cast<std::uint32_t>(frame - blockStart);
+    inputEvents_.push(event);
+  }
+  const auto first = pending_.begin();
+  std::move(first + static_cast<std::ptrdiff_t>(due), first + static_cast<std::ptrdiff_t>(pendingCount_), first);
+  pendingCount_ -= due;
+}
+
+void PluginNode::setParameter(ParamId id, double value) {
+  if (id == kBypass || id == kBypassed) {
     setBypassed(truthy(value));
     return;
   }
-  if (lowered == "hostinstanceid" && std::isfinite(value)) {
+  if (id == kTailFrames) {
+    auto tail = kInfiniteTail;
+    if (std::isfinite(value) && value >= 0.0) {
+      tail = static_cast<std::uint64_t>(std::llround(value));
+    }
+    tailFrames_.store(tail, std::memory_order_relaxed);
+    return;
+  }
+  if (id == kLatencyFrames) {
+    const auto latency = std::isfinite(value) ? std::clamp(value, 0.0, double{kMaxReportedLatencyFrames}) : 0.0;
+    pluginLatency_.store(static_cast<std::uint32_t>(std::llround(latency)), std::memory_order_relaxed);
+    return;
+  }
+  if (id == kHostInstanceId && std::isfinite(value)) {
     const auto rounded = static_cast<std::uint64_t>(std::llround(std::fabs(value)));
     if (rounded > 0) {
-      setHostInstanceId(std::to_string(rounded));
+      char digits[20];
+      const auto formatted = std::to_chars(digits, digits + sizeof(digits), rounded);
+      setHostInstanceId(std::string(digits, formatted.ptr));
     }
     return;
   }
 }
 
-void PluginNode::setHostInstanceId(std::string hostInstanceId) {
+bool PluginNode::isIdle(std::size_t frameCount) const {
+  if (!capabilities_.acceptsAudio || capabilities_.acceptsMidi || !inbox_.empty()) {
+    return false;
+  }
+  return pendingCount_ == 0 || pending_.front().frame >= processedFrames_ + frameCount;
+}
+
+void PluginNode::skipSilence(std::size_t frameCount) {
+  processedFrames_ += frameCount;
+  drainInbox();
+  outputEvents_.clear();
+}
+
+std::uint64_t PluginNode::tailFrames() const {
+  // A bypassed plugin passes its input straight through, delayed by the anticipation latency if any.
+  const std::uint64_t latency = latencyFrames();
+  if (bypassed()) {
+    return latency;
+  }
+  const auto tail = tailFrames_.load(std::memory_order_relaxed);
+  return tail > kInfiniteTail - latency ? kInfiniteTail : tail + latency;
+}
+
+bool PluginNode::setHostInstanceId(std::string hostInstanceId) {
+  if (hostInstanceId.size() > kMaxHostInstanceIdLength) {
+    return false;
+  }
   hostInstanceId_ = std::move(hostInstanceId);
+  bind();
   hostUnavailableLogged_.store(false, std::memory_order_release);
+  return true;
+}
+
+void PluginNode::bind() {
+  auto& binding = bindings_[writeBinding_];
+  binding.length = std::min(hostInstanceId_.size(), kMaxHostInstanceIdLength);
+  std::copy_n(hostInstanceId_.data(), binding.length, binding.id.data());
+  // Read the generation first: an invalidation racing with the resolve then retires this handle too.
+  binding.generation = PluginHostBridge::HandleGeneration();
+  binding.handle = PluginHostBridge::Resolve(hostInstanceId_);
+  instanceHandle_ = binding.handle;
+  const auto fresh = static_cast<std::uint8_t>(writeBinding_ | kFreshBinding);
+  writeBinding_ = static_cast<std::uint8_t>(sharedBinding_.exchange(fresh, std::memory_order_acq_rel) & ~kFreshBinding);
+}
+
+const PluginNode::Binding& PluginNode::adoptBinding() noexcept {
+  if ((sharedBinding_.load(std::memory_order_relaxed) & kFreshBinding) != 0) {
+    readBinding_ = static_cast<std::uint8_t>(sharedBinding_.exchange(readBinding_, std::memory_order_acq_rel) &
+                                             ~kFreshBinding);
+    ++adoptedBindings_;
+  }
+  return bindings_[readBinding_];
 }
 
 void PluginNode::setBypassed(bool bypassed) noexcept {
   bypassed_.store(bypassed, std::memory_order_release);
 }
 
-void PluginNode::logHostUnavailable() const noexcept {
+void PluginNode::logHostUnavailable(std::string_view instanceId) const noexcept {
   bool expected = false;
   if (hostUnavailableLogged_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-    LogPluginError("Plugin host unavailable", hostInstanceId_);
+    LogPluginError("Plugin host unavailable", instanceId);
   }
 }
 
-void PluginNode::logRenderFailure() const noexcept {
+void PluginNode::logRenderFailure(std::string_view instanceId) const noexcept {
   bool expected = false;
   if (renderFailureLogged_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-    LogPluginError("Plugin host render failed", hostInstanceId_);
+    LogPluginError("Plugin host render failed", instanceId);
   }
 }
 
@@ -129,9 +564,4 @@ void PluginNode::resetFailureFlags() noexcept {
 
 bool PluginNode::truthy(double value) noexcept { return std::fabs(value) > std::numeric_limits<double>::epsilon(); }
 
-std::string PluginNode::toLower(std::string value) {
-  std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-  return value;
-}
-
 }  // namespace daft::audio
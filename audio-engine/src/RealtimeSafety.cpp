@@ -0,0 +1,244 @@
+#include "audio_engine/RealtimeSafety.h"
+
+#if defined(DAFT_AUDIO_ENGINE_REALTIME_CHECKS)
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#include <unistd.h>
+#define DAFT_REALTIME_BACKTRACE 1
+#endif
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+#define DAFT_REALTIME_SANITIZED 1
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define DAFT_REALTIME_SANITIZED 1
+#endif
+
+#if !defined(DAFT_REALTIME_SANITIZED) && defined(__GLIBC__)
+#include <dlfcn.h>
+#include <pthread.h>
+#define DAFT_REALTIME_INTERPOSE_LIBC 1
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* pointer, std::size_t size);
+}
+#endif
+
+namespace daft::audio {
+namespace {
+
+// Plain thread_locals with constant initialisers: reading them never allocates or takes a lock, which is
+// what lets the allocation and lock hooks consult them.
+constinit thread_local int tRealtimeDepth = 0;
+constinit thread_local int tExemptionDepth = 0;
+constinit thread_local bool tReporting = false;
+std::atomic<std::uint64_t> gViolations{0};
+
+void PrintViolation(const char* operation) noexcept {
+  gViolations.fetch_add(1, std::memory_order_relaxed);
+  std::fprintf(stderr, "Realtime-safety violation: %s on the audio thread\n", operation);
+#if defined(DAFT_REALTIME_BACKTRACE)
+  void* frames[48];
+  const int depth = backtrace(frames, 48);
+  // Skip this frame and the check that called it.
+  if (depth > 2) {
+    backtrace_symbols_fd(frames + 2, depth - 2, STDERR_FILENO);
+  }
+#endif
+}
+
+std::atomic<RealtimeViolationHandler> gHandler{&PrintViolation};
+
+#if !defined(DAFT_REALTIME_SANITIZED)
+void* Allocate(std::size_t size) {
+  CheckRealtimeSafe("operator new");
+#if defined(DAFT_REALTIME_INTERPOSE_LIBC)
+  // Straight to glibc so the malloc hook below does not report the same allocation again.
+  void* pointer = __libc_malloc(size == 0 ? 1 : size);
+#else
+  void* pointer = std::malloc(size == 0 ? 1 : size);
+#endif
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+void* AllocateAligned(std::size_t size, std::align_val_t alignment) {
+  CheckRealtimeSafe("operator new");
+  const auto align = static_cast<std::size_t>(alignment);
+  // aligned_alloc wants a size that is a multiple of the alignment.
+  void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align);
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+#endif
+
+}  // namespace
+
+ScopedRealtimeThread::ScopedRealtimeThread(bool active) noexcept : active_(active) {
+  if (active_) {
+    ++tRealtimeDepth;
+  }
+}
+
+ScopedRealtimeThread::~ScopedRealtimeThread() {
+  if (active_) {
+    --tRealtimeDepth;
+  }
+}
+
+ScopedRealtimeExemption::ScopedRealtimeExemption() noexcept { ++tExemptionDepth; }
+
+ScopedRealtimeExemption::~ScopedRealtimeExemption() { --tExemptionDepth; }
+
+bool IsRealtimeThread() noexcept { return tRealtimeDepth > 0; }
+
+void CheckRealtimeSafe(const char* operation) noexcept {
+  if (tRealtimeDepth > 0 && tExemptionDepth == 0 && !tReporting) {
+    // Printing and unwinding allocate in turn; the flag keeps them from reporting themselves.
+    tReporting = true;
+    gHandler.load(std::memory_order_acquire)(operation);
+    tReporting = false;
+  }
+}
+
+std::uint64_t RealtimeViolationCount() noexcept { return gViolations.load(std::memory_order_relaxed); }
+
+RealtimeViolationHandler SetRealtimeViolationHandler(RealtimeViolationHandler handler) noexcept {
+  return gHandler.exchange(handler != nullptr ? handler : &PrintViolation, std::memory_order_acq_rel);
+}
+
+bool RealtimeAllocationChecksInstalled() noexcept {
+#if defined(DAFT_REALTIME_SANITIZED)
+  return false;
+#else
+  return true;
+#endif
+}
+
+bool RealtimeLockChecksInstalled() noexcept {
+#if defined(DAFT_REALTIME_INTERPOSE_LIBC)
+  return true;
+#else
+  return false;
+#endif
+}
+
+}  // namespace daft::audio
+
+#if !defined(DAFT_REALTIME_SANITIZED)
+
+void* operator new(std::size_t size) { return daft::audio::Allocate(size); }
+void* operator new[](std::size_t size) { return daft::audio::Allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return daft::audio::AllocateAligned(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return daft::audio::AllocateAligned(size, alignment);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return daft::audio::Allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return daft::audio::Allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  try {
+    return daft::audio::AllocateAligned(size, alignment);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  try {
+    return daft::audio::AllocateAligned(size, alignment);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { std::free(pointer); }
+
+#endif
+
+#if defined(DAFT_REALTIME_INTERPOSE_LIBC)
+
+namespace {
+
+using MutexLock = int (*)(pthread_mutex_t*);
+
+// Resolved without a function-local static, whose guard could itself lock.
+std::atomic<MutexLock> gMutexLock{nullptr};
+
+MutexLock RealMutexLock() noexcept {
+  auto lock = gMutexLock.load(std::memory_order_acquire);
+  if (lock == nullptr) {
+    lock = reinterpret_cast<MutexLock>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    gMutexLock.store(lock, std::memory_order_release);
+  }
+  return lock;
+}
+
+[[maybe_unused]] const MutexLock kResolvedAtStartup = RealMutexLock();
+
+}  // namespace
+
+extern "C" {
+
+void* malloc(std::size_t size) noexcept {
+  daft::audio::CheckRealtimeSafe("malloc");
+  return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept {
+  daft::audio::CheckRealtimeSafe("calloc");
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size) noexcept {
+  daft::audio::CheckRealtimeSafe("realloc");
+  return __libc_realloc(pointer, size);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept {
+  daft::audio::CheckRealtimeSafe("pthread_mutex_lock");
+  return RealMutexLock()(mutex);
+}
+
+}  // extern "C"
+
+#endif
+
+#endif  // DAFT_AUDIO_ENGINE_REALTIME_CHECKS
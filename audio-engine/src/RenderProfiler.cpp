@@ -0,0 +1,200 @@
+#include "audio_engine/RenderProfiler.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace daft::audio {
+
+std::size_t LogHistogram::bucketOf(std::uint64_t value) {
+  if (value < kSubBuckets) {
+    return static_cast<std::size_t>(value);
+  }
+  const auto exponent = static_cast<std::size_t>(std::bit_width(value)) - 1;
+  if (exponent > kMaxExponent) {
+    return kBucketCount - 1;
+  }
+  const auto sub = static_cast<std::size_t>(value >> (exponent - 3)) & (kSubBuckets - 1);
+  return (exponent - 2) * kSubBuckets + sub;
+}
+
+std::uint64_t LogHistogram::bucketUpperBound(std::size_t bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  const auto exponent = bucket / kSubBuckets + 2;
+  const auto sub = bucket % kSubBuckets;
+  const auto width = std::uint64_t{1} << (exponent - 3);
+  return (kSubBuckets + sub) * width + width - 1;
+}
+
+void LogHistogram::record(std::uint64_t value) {
+  ++buckets_[bucketOf(value)];
+  ++count_;
+  sum_ += value;
+  max_ = std::max(max_, value);
+}
+
+std::uint64_t LogHistogram::percentile(double fraction) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  // Rank of the sample at `fraction`, counting from one.
+  const auto rank = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(count_))));
+  std::uint64_t seen = 0;
+  for (std::size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+    seen += buckets_[bucket];
+    if (seen >= rank) {
+      // The last bucket is open-ended, so only the maximum bounds it.
+      return bucket + 1 == kBucketCount ? max_ : std::min(bucketUpperBound(bucket), max_);
+    }
+  }
+  return max_;
+}
+
+namespace {
+
+RenderProfiler::Summary Summarise(const LogHistogram& histogram, double scale) {
+  RenderProfiler::Summary summary;
+  summary.count = histogram.count();
+  summary.mean = histogram.mean() * scale;
+  summary.p50 = static_cast<double>(histogram.percentile(0.50)) * scale;
+  summary.p95 = static_cast<double>(histogram.percentile(0.95)) * scale;
+  summary.p99 = static_cast<double>(histogram.percentile(0.99)) * scale;
+  summary.max = static_cast<double>(histogram.max()) * scale;
+  return summary;
+}
+
+std::uint64_t Nanos(RenderProfiler::Clock::duration duration) {
+  const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+  return nanos > 0 ? static_cast<std::uint64_t>(nanos) : 0;
+}
+
+}  // namespace
+
+RenderProfiler::RenderProfiler(double sampleRate, std::chrono::milliseconds interval)
+    : sampleRate_(sampleRate), interval_(interval) {
+  thread_ = std::thread([this]() { run(); });
+}
+
+RenderProfiler::~RenderProfiler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  thread_.join();
+}
+
+void RenderProfiler::recordBlock(Clock::time_point start, Clock::time_point end, std::uint32_t frames) {
+  Record record;
+  record.kind = RecordKind::kBlock;
+  record.frames = frames;
+  record.nanos = Nanos(end - start);
+  if (lastBlockFrames_ > 0) {
+    // The previous callback covered lastBlockFrames_ of audio, so that is when this one was due.
+    const auto expected = static_cast<double>(lastBlockFrames_) * 1e9 / sampleRate_;
+    const auto interval = static_cast<double>(Nanos(start - lastBlockStart_));
+    record.jitterNanos = static_cast<std::uint64_t>(std::abs(interval - expected));
+    record.hasJitter = true;
+  }
+  lastBlockStart_ = start;
+  lastBlockFrames_ = frames;
+  push(record);
+}
+
+void RenderProfiler::recordNode(NodeHandle handle, std::uint32_t generation, std::uint64_t nanos) {
+  Record record;
+  record.kind = RecordKind::kNode;
+  record.handle = handle;
+  record.generation = generation;
+  record.nanos = nanos;
+  push(record);
+}
+
+void RenderProfiler::recordRenderError() {
+  Record record;
+  record.kind = RecordKind::kRenderError;
+  push(record);
+  // The failed block never reported its end, so the next callback is not measured against it.
+  lastBlockFrames_ = 0;
+}
+
+void RenderProfiler::push(const Record& record) {
+  if (!ring_.push(record)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void RenderProfiler::drain() {
+  while (auto record = ring_.pop()) {
+    switch (record->kind) {
+      case RecordKind::kBlock: {
+        blockNanos_.record(record->nanos);
+        const auto budget = static_cast<double>(record->frames) * 1e9 / sampleRate_;
+        const auto load = budget > 0.0 ? static_cast<double>(record->nanos) / budget : 0.0;
+        loadPpm_.record(static_cast<std::uint64_t>(load * 1e6));
+        if (load > 1.0) {
+          ++overloads_;
+        }
+        if (record->hasJitter) {
+          jitterNanos_.record(record->jitterNanos);
+        }
+        break;
+      }
+      case RecordKind::kNode: {
+        if (record->handle >= nodes_.size()) {
+          nodes_.resize(record->handle + 1);
+        }
+        auto& stats = nodes_[record->handle];
+        if (stats.generation != record->generation) {
+          // The handle was recycled for another node; its history belongs to the old one.
+          stats.generation = record->generation;
+          stats.nanos.clear();
+        }
+        stats.nanos.record(record->nanos);
+        break;
+      }
+      case RecordKind::kRenderError:
+        ++renderErrors_;
+        break;
+    }
+  }
+}
+
+void RenderProfiler::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    drain();
+    wake_.wait_for(lock, interval_, [this]() { return stopping_; });
+  }
+}
+
+RenderProfiler::Report RenderProfiler::report(std::span<const NodeLabel> nodes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  drain();
+  Report report;
+  report.enabled = true;
+  report.blocks = blockNanos_.count();
+  report.renderMicros = Summarise(blockNanos_, 1e-3);
+  report.dspLoad = Summarise(loadPpm_, 1e-6);
+  report.callbackJitterMicros = Summarise(jitterNanos_, 1e-3);
+  report.overloads = overloads_;
+  report.renderErrors = renderErrors_;
+  report.droppedRecords = dropped_.load(std::memory_order_relaxed);
+  report.nodes.reserve(nodes.size());
+  for (const auto& label : nodes) {
+    if (label.handle >= nodes_.size() || nodes_[label.handle].generation != label.generation ||
+        nodes_[label.handle].nanos.count() == 0) {
+      continue;
+    }
+    report.nodes.push_back({std::string(label.id), Summarise(nodes_[label.handle].nanos, 1e-3)});
+  }
+  std::sort(report.nodes.begin(), report.nodes.end(), [](const NodeProfile& lhs, const NodeProfile& rhs) {
+    return lhs.renderMicros.mean > rhs.renderMicros.mean;
+  });
+  return report;
+}
+
+}  // namespace daft::audio
@@ -0,0 +1,161 @@
+#include "audio_engine/RenderWorkerPool.h"
+
+#include <algorithm>
+
+#include "audio_engine/RealtimeSafety.h"
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <sys/qos.h>
+#endif
+
+namespace daft::audio {
+
+namespace {
+
+constexpr std::uint64_t PackRange(std::uint32_t next, std::uint32_t end) {
+  return (static_cast<std::uint64_t>(end) << 32U) | next;
+}
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+// Best effort: a worker that cannot be pinned or promoted still renders correctly, just with more jitter.
+void ConfigureWorkerThread(std::size_t participant) {
+#if defined(__linux__) || defined(__ANDROID__)
+  const auto cores = std::max(1U, std::thread::hardware_concurrency());
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(static_cast<int>(participant % cores), &cpus);
+  sched_setaffinity(0, sizeof(cpus), &cpus);
+  sched_param param{};
+  param.sched_priority = sched_get_priority_max(SCHED_FIFO) / 2;
+  pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#elif defined(__APPLE__)
+  (void)participant;
+  pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+#else
+  (void)participant;
+#endif
+}
+
+}  // namespace
+
+RenderWorkerPool::RenderWorkerPool(std::size_t workerCount) : cursors_(workerCount + 1) {
+  workers_.reserve(workerCount);
+  for (std::size_t worker = 0; worker < workerCount; ++worker) {
+    // Participant 0 is the thread calling run(); workers take the following slots.
+    workers_.emplace_back([this, participant = worker + 1]() { workerLoop(participant); });
+  }
+}
+
+RenderWorkerPool::~RenderWorkerPool() {
+  stopping_.store(true);
+  epoch_.fetch_add(1);
+  epoch_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+bool RenderWorkerPool::run(const Job& job) {
+  if (job.levelCount == 0) {
+    return true;
+  }
+  job_ = job;
+  jobIsRealtime_.store(IsRealtimeThread(), std::memory_order_relaxed);
+  failed_.store(false);
+  blockDone_.store(false);
+  openLevel(0);
+  epoch_.fetch_add(1);
+  epoch_.notify_all();
+
+  while (!blockDone_.load()) {
+    if (!runOne(0)) {
+      CpuRelax();
+    }
+  }
+  return !failed_.load();
+}
+
+void RenderWorkerPool::workerLoop(std::size_t participant) {
+  ConfigureWorkerThread(participant);
+  std::uint32_t seen = 0;
+  while (true) {
+    epoch_.wait(seen);
+    seen = epoch_.load();
+    if (stopping_.load()) {
+      return;
+    }
+    // Workers share the deadline of whichever thread handed them the block.
+    const ScopedRealtimeThread realtime(jobIsRealtime_.load(std::memory_order_relaxed));
+    while (!blockDone_.load()) {
+      if (!runOne(participant)) {
+        CpuRelax();
+      }
+    }
+  }
+}
+
+bool RenderWorkerPool::runOne(std::size_t participant) {
+  const auto participants = cursors_.size();
+  for (std::size_t offset = 0; offset < participants; ++offset) {
+    auto& cursor = cursors_[(participant + offset) % participants].range;
+    auto packed = cursor.load();
+    while (static_cast<std::uint32_t>(packed) < static_cast<std::uint32_t>(packed >> 32U)) {
+      if (cursor.compare_exchange_weak(packed, packed + 1)) {
+        try {
+          job_.runTask(job_.context, static_cast<std::uint32_t>(packed));
+        } catch (...) {
+          failed_.store(true);
+        }
+        completeTask();
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void RenderWorkerPool::openLevel(std::size_t level) {
+  const auto begin = job_.levelOffsets[level];
+  const auto end = job_.levelOffsets[level + 1];
+  const auto participants = static_cast<std::uint32_t>(cursors_.size());
+  const auto chunk = (end - begin + participants - 1) / participants;
+
+  remaining_.store(end - begin);
+  currentLevel_.store(level);
+  for (std::uint32_t participant = 0; participant < participants; ++participant) {
+    const auto first = std::min(end, begin + participant * chunk);
+    const auto last = std::min(end, first + chunk);
+    cursors_[participant].range.store(PackRange(first, last));
+  }
+}
+
+void RenderWorkerPool::completeTask() {
+  if (remaining_.fetch_sub(1) != 1) {
+    return;
+  }
+  // Last task of the level: nobody else can touch the level now, so close it and open the next one.
+  const auto level = currentLevel_.load();
+  try {
+    job_.finishLevel(job_.context, level);
+  } catch (...) {
+    failed_.store(true);
+  }
+  if (level + 1 < job_.levelCount) {
+    openLevel(level + 1);
+  } else {
+    blockDone_.store(true);
+  }
+}
+
+}  // namespace daft::audio
@@ -0,0 +1,120 @@
+#include "audio_engine/Resampler.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "audio_engine/DSPKernels.h"
+
+namespace daft::audio {
+
+namespace {
+
+constexpr std::size_t kHalfTaps = 16;
+constexpr std::size_t kTaps = 2 * kHalfTaps;
+// Fractional positions between two rows are interpolated, so 128 rows keep the error below the
+// stopband of the window.
+constexpr std::size_t kPhases = 128;
+constexpr double kKaiserBeta = 8.0;
+// Passband edge as a fraction of the Nyquist frequency of the slower of the two rates.
+constexpr double kPassband = 0.9;
+// Each table serves every step up to its own; faster playback falls back to the last one.
+constexpr std::array<double, 8> kStepBands{1.0, 1.25, 1.5, 2.0, 3.0, 4.0, 8.0, 16.0};
+
+static_assert(ResampleLookBehind(ResampleQuality::kSinc) == kHalfTaps - 1);
+static_assert(ResampleLookAhead(ResampleQuality::kSinc) == kHalfTaps);
+
+double BesselI0(double x) {
+  double sum = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 32; ++k) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+// Rows of kTaps coefficients for phases 0, 1/kPhases, ..., 1 (the extra row lets every phase
+// interpolate towards its successor). Tap k weighs source frame floor(position) - (kHalfTaps - 1) + k.
+std::vector<float> BuildTable(double step) {
+  const double cutoff = kPassband / std::max(1.0, step);
+  std::vector<float> table((kPhases + 1) * kTaps);
+  const double window = BesselI0(kKaiserBeta);
+  for (std::size_t row = 0; row <= kPhases; ++row) {
+    const double phase = static_cast<double>(row) / static_cast<double>(kPhases);
+    std::array<double, kTaps> taps{};
+    double sum = 0.0;
+    for (std::size_t k = 0; k < kTaps; ++k) {
+      const double distance = static_cast<double>(k) - static_cast<double>(kHalfTaps - 1) - phase;
+      const double x = distance / static_cast<double>(kHalfTaps);
+      if (std::abs(x) >= 1.0) {
+        continue;
+      }
+      const double argument = std::numbers::pi * cutoff * distance;
+      const double sinc = distance == 0.0 ? 1.0 : std::sin(argument) / argument;
+      taps[k] = cutoff * sinc * BesselI0(kKaiserBeta * std::sqrt(1.0 - x * x)) / window;
+      sum += taps[k];
+    }
+    // Unity gain at DC for every phase, so a constant input does not pick up a ripple at the step rate.
+    for (std::size_t k = 0; k < kTaps; ++k) {
+      table[row * kTaps + k] = static_cast<float>(taps[k] / sum);
+    }
+  }
+  return table;
+}
+
+const std::vector<std::vector<float>>& Tables() {
+  static const std::vector<std::vector<float>> tables = [] {
+    std::vector<std::vector<float>> built;
+    built.reserve(kStepBands.size());
+    for (const double band : kStepBands) {
+      built.push_back(BuildTable(band));
+    }
+    return built;
+  }();
+  return tables;
+}
+
+const float* TableFor(double step) {
+  const auto& tables = Tables();
+  for (std::size_t band = 0; band < kStepBands.size(); ++band) {
+    if (step <= kStepBands[band]) {
+      return tables[band].data();
+    }
+  }
+  return tables.back().data();
+}
+
+}  // namespace
+
+double Resample(const float* source, double position, double step, float* dest, std::size_t count,
+                ResampleQuality quality) {
+  // Positions are recomputed from the start of the run rather than accumulated.
+  if (quality == ResampleQuality::kLinear) {
+    for (std::size_t i = 0; i < count; ++i) {
+      const double at = position + step * static_cast<double>(i);
+      const auto index = static_cast<std::size_t>(at);
+      const auto fraction = static_cast<float>(at - static_cast<double>(index));
+      dest[i] = source[index] + (source[index + 1] - source[index]) * fraction;
+    }
+    return position + step * static_cast<double>(count);
+  }
+
+  const float* table = TableFor(step);
+  for (std::size_t i = 0; i < count; ++i) {
+    const double at = position + step * static_cast<double>(i);
+    const auto index = static_cast<std::size_t>(at);
+    const double phase = (at - static_cast<double>(index)) * static_cast<double>(kPhases);
+    const auto row = std::min(static_cast<std::size_t>(phase), kPhases - 1);
+    const auto* lower = table + row * kTaps;
+    dest[i] = dsp::dotInterpolated(source + index - (kHalfTaps - 1), lower, lower + kTaps,
+                                   static_cast<float>(phase - static_cast<double>(row)), kTaps);
+  }
+  return position + step * static_cast<double>(count);
+}
+
+void PrepareResampler() { static_cast<void>(Tables()); }
+
+}  // namespace daft::audio
@@ -1,217 +1,1171 @@
 #include "audio_engine/SceneGraph.h"
 
 #include <algorithm>
+#include <chrono>
+#include <utility>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <stdexcept>
-#include <unordered_map>
-#include <unordered_set>
+#include <string>
 #include <vector>
 
+#include "audio_engine/DSPKernels.h"
+#include "audio_engine/RealtimeSafety.h"
+
 namespace daft::audio {
 
-SceneGraph::SceneGraph(double sampleRate, std::uint32_t framesPerBuffer)
+// Render order and edge layout shared by the serial and parallel plan compilers. Indexed by handle.
+struct SceneGraph::Topology {
+  std::vector<NodeHandle> order;
+  std::vector<std::uint32_t> position;
+  std::vector<std::uint32_t> adjacencyOffsets;
+  std::vector<NodeHandle> adjacency;
+  std::vector<std::uint32_t> inboundOffsets;
+  std::vector<NodeHandle> inbound;
+  std::vector<bool> pinned;
+  std::vector<bool> feedsOutput;
+};
+
+struct SceneGraph::ParallelBlock {
+  RenderPlan* plan;
+  AudioBufferView* output;
+  bool batchPlugins;
+};
+
+SceneGraph::SceneGraph(double sampleRate, std::uint32_t framesPerBuffer, std::size_t maxChannels,
+                       std::size_t maxFramesPerBuffer)
     : sampleRate_(sampleRate),
+      maxChannels_(maxChannels),
+      maxFrames_(std::max<std::size_t>(framesPerBuffer, maxFramesPerBuffer)),
       clock_(sampleRate, framesPerBuffer),
-      scheduler_(clock_) {}
+      scheduler_(clock_) {
+  if (maxChannels_ == 0 || maxChannels_ > kChannelLimit || maxFrames_ == 0 || maxFrames_ > kFrameLimit) {
+    throw std::invalid_argument("SceneGraph supports 1-" + std::to_string(kChannelLimit) + " channels and up to " +
+                                std::to_string(kFrameLimit) + " frames per buffer");
+  }
+  sliceChannels_.resize(maxChannels_);
+}
+
+SceneGraph::~SceneGraph() {
+  // The owner guarantees the audio thread has stopped calling render() by now.
+  delete pendingPlan_.exchange(nullptr, std::memory_order_acq_rel);
+  delete activePlan_;
+  activePlan_ = nullptr;
+  reclaimRetiredPlans();
+}
 
 bool SceneGraph::addNode(const std::string& id, std::unique_ptr<DSPNode> node) {
-  if (!node) {
+  if (!node || handles_.count(id) > 0) {
     return false;
   }
+  node->setRenderLimits(maxChannels_, maxFrames_);
   node->prepare(sampleRate_);
-  const auto result = nodes_.emplace(id, std::move(node));
-  if (result.second) {
-    nodeBuffers_.try_emplace(id);
-    rebuildTopology();
+  node->setOfflineRendering(offline_);
+
+  NodeHandle handle = kInvalidNodeHandle;
+  if (!freeHandles_.empty()) {
+    handle = freeHandles_.back();
+    freeHandles_.pop_back();
+  } else {
+    handle = static_cast<NodeHandle>(nodes_.size());
+    nodes_.emplace_back();
+    generations_.push_back(0);
+    inputs_.emplace_back();
+    outputs_.emplace_back();
+    feedsBus_.push_back(false);
+    published_.push_back(false);
+    position_.push_back(0);
+    visited_.push_back(0);
   }
-  return result.second;
+  nodes_[handle] = std::shared_ptr<DSPNode>(std::move(node));
+  published_[handle] = false;
+  handles_.emplace(id, handle);
+  // A node without edges may render anywhere; the end of the order disturbs nobody.
+  position_[handle] = static_cast<std::uint32_t>(order_.size());
+  order_.push_back(handle);
+  topologyChanged();
+  return true;
 }
 
 void SceneGraph::removeNode(const std::string& id) {
-  nodes_.erase(id);
-  nodeBuffers_.erase(id);
-  connections_.erase(std::remove_if(connections_.begin(), connections_.end(),
-                                    [&](const auto& conn) {
-                                      return conn.source == id || conn.destination == id;
-                                    }),
-                     connections_.end());
-  rebuildTopology();
+  const auto it = handles_.find(id);
+  if (it == handles_.end()) {
+    return;
+  }
+  const NodeHandle handle = it->second;
+  handles_.erase(it);
+  nodes_[handle].reset();
+  ++generations_[handle];
+  freeHandles_.push_back(handle);
+
+  const auto erase = [](std::vector<NodeHandle>& edges, NodeHandle node) {
+    edges.erase(std::remove(edges.begin(), edges.end(), node), edges.end());
+  };
+  for (const NodeHandle destination : outputs_[handle]) {
+    if (destination != handle) {
+      erase(inputs_[destination], handle);
+    }
+  }
+  for (const NodeHandle source : inputs_[handle]) {
+    if (source != handle) {
+      erase(outputs_[source], handle);
+    }
+  }
+  feedbackStale_ = feedbackStale_ || !inputs_[handle].empty() || !outputs_[handle].empty();
+  inputs_[handle].clear();
+  outputs_[handle].clear();
+  if (feedsBus_[handle]) {
+    feedsBus_[handle] = false;
+    --busConnections_;
+  }
+  // Dropping a node keeps every remaining edge pointing forward.
+  order_.erase(order_.begin() + position_[handle]);
+  for (auto index = position_[handle]; index < order_.size(); ++index) {
+    position_[order_[index]] = index;
+  }
+  topologyChanged();
 }
 
 bool SceneGraph::connect(const std::string& source, const std::string& destination) {
-  if (!nodes_.count(source)) {
+  const NodeHandle sourceHandle = findNode(source);
+  if (sourceHandle == kInvalidNodeHandle) {
     return false;
   }
-  if (destination != kOutputBusId && !nodes_.count(destination)) {
+  if (destination == kOutputBusId) {
+    if (feedsBus_[sourceHandle]) {
+      return false;
+    }
+    feedsBus_[sourceHandle] = true;
+    ++busConnections_;
+    topologyChanged();
+    return true;
+  }
+  const NodeHandle destinationHandle = findNode(destination);
+  if (destinationHandle == kInvalidNodeHandle) {
     return false;
   }
-  const auto duplicate = std::find_if(connections_.begin(), connections_.end(),
-                                      [&](const Connection& conn) {
-                                        return conn.source == source && conn.destination == destination;
-                                      }) != connections_.end();
-  if (duplicate) {
+  auto& outputs = outputs_[sourceHandle];
+  if (std::find(outputs.begin(), outputs.end(), destinationHandle) != outputs.end()) {
     return false;
   }
-  connections_.push_back({source, destination});
-  rebuildTopology();
+  outputs.push_back(destinationHandle);
+  inputs_[destinationHandle].push_back(sourceHandle);
+  orderEdge(sourceHandle, destinationHandle);
+  topologyChanged();
   return true;
 }
 
 void SceneGraph::disconnect(const std::string& source, const std::string& destination) {
-  connections_.erase(std::remove_if(connections_.begin(), connections_.end(),
-                                    [&](const auto& conn) {
-                                      return conn.source == source && conn.destination == destination;
-                                    }),
-                     connections_.end());
+  const NodeHandle sourceHandle = findNode(source);
+  const NodeHandle destinationHandle = destination == kOutputBusId ? kOutputBusHandle : findNode(destination);
+  if (sourceHandle != kInvalidNodeHandle && destinationHandle == kOutputBusHandle) {
+    if (feedsBus_[sourceHandle]) {
+      feedsBus_[sourceHandle] = false;
+      --busConnections_;
+    }
+  } else if (sourceHandle != kInvalidNodeHandle && destinationHandle != kInvalidNodeHandle) {
+    auto& outputs = outputs_[sourceHandle];
+    const auto edge = std::find(outputs.begin(), outputs.end(), destinationHandle);
+    if (edge != outputs.end()) {
+      outputs.erase(edge);
+      auto& inputs = inputs_[destinationHandle];
+      inputs.erase(std::find(inputs.begin(), inputs.end(), sourceHandle));
+      feedbackStale_ = true;
+    }
+  }
+  topologyChanged();
+}
+
+void SceneGraph::beginUpdate() { ++updateDepth_; }
+
+void SceneGraph::commit() {
+  if (updateDepth_ == 0) {
+    return;
+  }
+  if (--updateDepth_ == 0 && planStale_) {
+    rebuildTopology();
+  }
+}
+
+void SceneGraph::topologyChanged() {
+  if (updateDepth_ > 0) {
+    planStale_ = true;
+    return;
+  }
   rebuildTopology();
 }
 
+bool SceneGraph::orderEdge(NodeHandle source, NodeHandle destination) {
+  const auto lower = position_[destination];
+  const auto upper = position_[source];
+  if (lower > upper) {
+    return true;
+  }
+  if (source == destination) {
+    return false;
+  }
+  if (++visitEpoch_ == 0) {
+    std::fill(visited_.begin(), visited_.end(), 0U);
+    visitEpoch_ = 1;
+  }
+
+  // Pearce-Kelly: only nodes placed between the two endpoints can be out of order. Collect those the
+  // destination reaches and those reaching the source, following forward edges only.
+  std::vector<NodeHandle> reached{destination};
+  visited_[destination] = visitEpoch_;
+  for (std::size_t index = 0; index < reached.size(); ++index) {
+    const NodeHandle current = reached[index];
+    for (const NodeHandle next : outputs_[current]) {
+      if (position_[next] <= position_[current] || position_[next] > upper || visited_[next] == visitEpoch_) {
+        continue;
+      }
+      if (next == source) {
+        // The edge closes a cycle; the order stays and the edge becomes a feedback edge.
+        return false;
+      }
+      visited_[next] = visitEpoch_;
+      reached.push_back(next);
+    }
+  }
+  std::vector<NodeHandle> reaching{source};
+  visited_[source] = visitEpoch_;
+  for (std::size_t index = 0; index < reaching.size(); ++index) {
+    const NodeHandle current = reaching[index];
+    for (const NodeHandle previous : inputs_[current]) {
+      if (position_[previous] >= position_[current] || position_[previous] <= lower ||
+          visited_[previous] == visitEpoch_) {
+        continue;
+      }
+      visited_[previous] = visitEpoch_;
+      reaching.push_back(previous);
+    }
+  }
+
+  // Hand the freed positions to the source side first, each side keeping its relative order.
+  const auto byPosition = [this](NodeHandle lhs, NodeHandle rhs) { return position_[lhs] < position_[rhs]; };
+  std::sort(reaching.begin(), reaching.end(), byPosition);
+  std::sort(reached.begin(), reached.end(), byPosition);
+  std::vector<std::uint32_t> slots;
+  slots.reserve(reaching.size() + reached.size());
+  for (const auto* side : {&reaching, &reached}) {
+    for (const NodeHandle node : *side) {
+      slots.push_back(position_[node]);
+    }
+  }
+  std::sort(slots.begin(), slots.end());
+  std::size_t slot = 0;
+  for (const auto* side : {&reaching, &reached}) {
+    for (const NodeHandle node : *side) {
+      position_[node] = slots[slot++];
+      order_[position_[node]] = node;
+    }
+  }
+  return true;
+}
+
+void SceneGraph::reorderFeedbackEdges() {
+  for (const NodeHandle source : std::vector<NodeHandle>(order_)) {
+    for (const NodeHandle destination : outputs_[source]) {
+      if (position_[destination] <= position_[source]) {
+        orderEdge(source, destination);
+      }
+    }
+  }
+  feedbackStale_ = false;
+}
+
+SceneGraph::NodeHandle SceneGraph::findNode(const std::string& id) const {
+  if (const auto it = handles_.find(id); it != handles_.end()) {
+    return it->second;
+  }
+  return kInvalidNodeHandle;
+}
+
 void SceneGraph::render(AudioBufferView outputBuffer) {
-  if (outputBuffer.channelCount() > kMaxChannels || outputBuffer.frameCount() > kMaxFrames) {
-    outputBuffer.fill(0.0F);
+  // Offline bounces have no deadline and may block on plugin workers.
+  const ScopedRealtimeThread realtime(!offline_);
+  outputBuffer.fill(0.0F);
+
+  // Channels past the graph's limit stay silent.
+  const auto channelCount = std::min(outputBuffer.channelCount(), maxChannels_);
+  const auto frameCount = outputBuffer.frameCount();
+
+  // Drain before adopting a plan: an event is queued after the plan containing its node was published,
+  // so any event seen here resolves against the plan acquired below.
+  scheduler_.drainInbox();
+  RenderPlan* plan = acquirePlan();
+  const bool profiling = plan != nullptr && plan->profiler;
+  const auto start = profiling ? RenderProfiler::Clock::now() : RenderProfiler::Clock::time_point{};
+  if (plan != nullptr) {
+    ensureNodeBuffers(*plan, channelCount);
+    outputLatency_.store(updateCompensation(*plan), std::memory_order_relaxed);
+  }
+  clock_.setFramesPerBuffer(static_cast<std::uint32_t>(frameCount));
+
+  // Split the block at scheduled event frames so every automation point lands on its exact sample
+  // without forcing small hardware buffers, and wherever it outgrows the node buffers.
+  std::size_t offset = 0;
+  while (offset < frameCount) {
+    scheduler_.dispatchDueEvents([plan](const ScheduledEvent& event) { applyEvent(plan, event); });
+    const auto now = clock_.frameTime();
+    const auto nextEvent = scheduler_.nextEventFrame();
+    std::size_t sliceFrames = std::min(frameCount - offset, maxFrames_);
+    if (nextEvent > now && nextEvent - now < sliceFrames) {
+      sliceFrames = static_cast<std::size_t>(nextEvent - now);
+    }
+
+    if (plan != nullptr) {
+      for (std::size_t ch = 0; ch < channelCount; ++ch) {
+        sliceChannels_[ch] = outputBuffer.channel(ch).data() + offset;
+      }
+      AudioBufferView slice(sliceChannels_.data(), channelCount, sliceFrames);
+      renderPlan(*plan, slice);
+    }
+    clock_.advanceBy(static_cast<std::uint32_t>(sliceFrames));
+    offset += sliceFrames;
+  }
+  if (profiling) {
+    recordProfile(*plan, start, frameCount);
+  }
+}
+
+void SceneGraph::recordProfile(RenderPlan& plan, RenderProfiler::Clock::time_point start, std::size_t frameCount) {
+  auto& profiler = *plan.profiler;
+  profiler.recordBlock(start, RenderProfiler::Clock::now(), static_cast<std::uint32_t>(frameCount));
+  for (std::size_t index = 0; index < plan.steps.size(); ++index) {
+    const auto handle = plan.steps[index].handle;
+    profiler.recordNode(handle, plan.handleNodes[handle].generation, plan.stepNanos[index]);
+    plan.stepNanos[index] = 0;
+  }
+}
+
+void SceneGraph::recordRenderError() {
+  if (activePlan_ != nullptr && activePlan_->profiler) {
+    activePlan_->profiler->recordRenderError();
+    // Time spent before the failure would otherwise be billed to the next block.
+    std::fill(activePlan_->stepNanos.begin(), activePlan_->stepNanos.end(), 0);
+  }
+}
+
+void SceneGraph::renderPlan(RenderPlan& plan, AudioBufferView& outputBuffer) {
+  plan.kernels = &dsp::blockKernels(outputBuffer.channelCount(), outputBuffer.frameCount());
+  if (plan.workers) {
+    // Sampled once per sub-block so every level of it agrees on whether plugin steps are deferred.
+    const bool batchPlugins = !plan.batchPlugins.empty() && PluginHostBridge::HasBatchRenderCallback();
+    if (batchPlugins) {
+      for (auto* plugin : plan.batchPlugins) {
+        plugin->deferRender();
+      }
+    }
+    ParallelBlock block{&plan, &outputBuffer, batchPlugins};
+    RenderWorkerPool::Job job;
+    job.levelOffsets = plan.levelOffsets.data();
+    job.levelCount = plan.levelOffsets.size() - 1;
+    job.runTask = &SceneGraph::renderParallelTask;
+    job.finishLevel = &SceneGraph::finishParallelLevel;
+    job.context = &block;
+    if (!plan.workers->run(job)) {
+      throw std::runtime_error("Parallel render task failed");
+    }
     return;
   }
-  scheduler_.dispatchDueEvents();
-  outputBuffer.fill(0.0F);
+  for (const auto& step : plan.steps) {
+    renderStep(plan, step, outputBuffer);
+  }
+}
+
+void SceneGraph::renderStep(RenderPlan& plan, const PlanStep& step, AudioBufferView& outputBuffer) {
+  if (!plan.profiler) {
+    processStep(plan, step, outputBuffer);
+    return;
+  }
+  // Each step renders on one participant per sub-block, so its slot needs no synchronisation.
+  const auto start = RenderProfiler::Clock::now();
+  processStep(plan, step, outputBuffer);
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(RenderProfiler::Clock::now() - start);
+  plan.stepNanos[static_cast<std::size_t>(&step - plan.steps.data())] += static_cast<std::uint64_t>(elapsed.count());
+}
 
+void SceneGraph::processStep(RenderPlan& plan, const PlanStep& step, AudioBufferView& outputBuffer) {
   const auto channelCount = outputBuffer.channelCount();
   const auto frameCount = outputBuffer.frameCount();
+  const auto* input = plan.inputBuffers.data() + step.firstInput;
+  const auto* delays = plan.inputDelays.data() + step.firstInput;
+  auto* silent = plan.silentBuffers.data();
+  auto& quietFrames = plan.quietFrames[static_cast<std::size_t>(&step - plan.steps.data())];
 
-  ensureNodeBuffers(channelCount, frameCount);
+  // A delayed edge stays audible until the line has played out what its source sent before falling silent.
+  bool inputsSilent = true;
+  for (std::uint32_t i = 0; i < step.inputCount; ++i) {
+    const auto* line = activeDelay(plan, delays[i]);
+    inputsSilent = inputsSilent && silent[input[i]] != 0 && (line == nullptr || line->flushed(true));
+  }
+  if (inputsSilent && quietFrames >= step.node->tailFrames() && step.node->isIdle(frameCount)) {
+    // Nothing audible goes in or comes out: skip the clear, the sums and the node itself.
+    step.node->skipSilence(frameCount);
+    silent[step.buffer] = 1;
+    if (auto* line = step.feedsOutput ? activeDelay(plan, step.outputDelay) : nullptr) {
+      sumDelayed(plan, *line, plan.buffers[step.buffer].view(channelCount, frameCount), true, outputBuffer);
+    }
+    return;
+  }
+  quietFrames = inputsSilent ? quietFrames + std::min<std::uint64_t>(frameCount, ~quietFrames) : 0;
 
-  for (const auto& nodeId : renderOrder_) {
-    const auto nodeIt = nodes_.find(nodeId);
-    if (nodeIt == nodes_.end()) {
-      continue;
+  auto view = plan.buffers[step.buffer].view(channelCount, frameCount);
+  if (step.mixesInputs) {
+    auto* inputViews = plan.inputViews.data() + step.firstInput;
+    for (std::uint32_t i = 0; i < step.inputCount; ++i) {
+      const bool inputSilent = silent[input[i]] != 0;
+      inputViews[i] = plan.buffers[input[i]].view(channelCount, frameCount);
+      auto* line = activeDelay(plan, delays[i]);
+      if (line != nullptr && !line->flushed(inputSilent)) {
+        auto delayed = line->output.view(channelCount, frameCount);
+        line->process(inputViews[i], inputSilent, delayed);
+        inputViews[i] = delayed;
+      }
+      inputViews[i].setSilent(inputSilent && (line == nullptr || line->flushed(true)));
+    }
+    step.node->processInputs({inputViews, step.inputCount}, view);
+  } else {
+    std::uint32_t i = 0;
+    if (step.inPlace) {
+      i = 1;
     }
-    auto bufferIt = nodeBuffers_.find(nodeId);
-    if (bufferIt == nodeBuffers_.end()) {
-      continue;
+    if (!step.inPlace || silent[step.buffer] != 0) {
+      plan.kernels->clear(view.channels(), channelCount, frameCount);
     }
+    if (auto* line = step.inPlace ? activeDelay(plan, delays[0]) : nullptr) {
+      const bool inputSilent = silent[step.buffer] != 0;
+      if (!line->flushed(inputSilent)) {
+        line->process(view, inputSilent, view);
+      }
+    }
+    for (; i < step.inputCount; ++i) {
+      const bool inputSilent = silent[input[i]] != 0;
+      const auto source = plan.buffers[input[i]].view(channelCount, frameCount);
+      if (auto* line = activeDelay(plan, delays[i])) {
+        sumDelayed(plan, *line, source, inputSilent, view);
+      } else if (!inputSilent) {
+        plan.kernels->add(view.channels(), source.channels(), channelCount, frameCount);
+      }
+    }
+    step.node->process(view);
+  }
+  silent[step.buffer] = 0;
+  // Sum into the output immediately so the slot can be recycled by later steps.
+  if (step.feedsOutput) {
+    if (auto* line = activeDelay(plan, step.outputDelay)) {
+      sumDelayed(plan, *line, view, false, outputBuffer);
+    } else {
+      plan.kernels->add(outputBuffer.channels(), view.channels(), channelCount, frameCount);
+    }
+  }
+}
 
-    auto view = bufferIt->second.view(channelCount);
-    view.fill(0.0F);
+SceneGraph::DelayLine* SceneGraph::activeDelay(RenderPlan& plan, std::uint32_t line) {
+  return line != kNone && plan.delayLines[line].active() ? &plan.delayLines[line] : nullptr;
+}
 
-    if (const auto inboundIt = inboundEdges_.find(nodeId); inboundIt != inboundEdges_.end()) {
-      for (const auto& sourceId : inboundIt->second) {
-        if (auto sourceIt = nodeBuffers_.find(sourceId); sourceIt != nodeBuffers_.end()) {
-          view.addBufferInPlace(sourceIt->second.view(channelCount));
-        }
-      }
+void SceneGraph::sumDelayed(const RenderPlan& plan, DelayLine& line, const AudioBufferView& source,
+                            bool sourceSilent, AudioBufferView& output) {
+  if (line.flushed(sourceSilent)) {
+    return;
+  }
+  auto delayed = line.output.view(output.channelCount(), output.frameCount());
+  line.process(source, sourceSilent, delayed);
+  plan.kernels->add(output.channels(), delayed.channels(), output.channelCount(), output.frameCount());
+}
+
+void SceneGraph::DelayLine::retune(std::uint32_t frames) {
+  if (frames == delay) {
+    return;
+  }
+  // The history no longer lines up with the new delay; restart from silence rather than replay it.
+  delay = frames;
+  dsp::fill(ring.data(), 0.0F, ring.size());
+  writeFrame = 0;
+  silentFrames = 0;
+}
+
+void SceneGraph::DelayLine::process(const AudioBufferView& source, bool sourceSilent, AudioBufferView& dest) {
+  const auto frames = dest.frameCount();
+  silentFrames = sourceSilent ? silentFrames + frames : 0;
+  // Write the block first so delays shorter than the block read the part just written; the ring holds
+  // maxDelay plus one full block, so the read range is never overwritten by the write.
+  const auto write = static_cast<std::size_t>(writeFrame % capacity);
+  const auto read = (write + capacity - delay) % capacity;
+  const auto writeHead = std::min(frames, capacity - write);
+  const auto readHead = std::min(frames, capacity - read);
+  for (std::size_t ch = 0; ch < dest.channelCount(); ++ch) {
+    float* channel = ring.data() + ch * capacity;
+    if (sourceSilent) {
+      dsp::fill(channel + write, 0.0F, writeHead);
+      dsp::fill(channel, 0.0F, frames - writeHead);
+    } else {
+      const float* samples = source.channel(ch).data();
+      dsp::copy(channel + write, samples, writeHead);
+      dsp::copy(channel, samples + writeHead, frames - writeHead);
     }
+    float* out = dest.channel(ch).data();
+    dsp::copy(out, channel + read, readHead);
+    dsp::copy(out + readHead, channel, frames - readHead);
+  }
+  writeFrame += frames;
+}
+
+void SceneGraph::renderParallelTask(void* context, std::uint32_t task) {
+  auto& block = *static_cast<ParallelBlock*>(context);
+  renderStep(*block.plan, block.plan->steps[task], *block.output);
+}
+
+void SceneGraph::finishParallelLevel(void* context, std::size_t level) {
+  auto& block = *static_cast<ParallelBlock*>(context);
+  auto& plan = *block.plan;
+  if (block.batchPlugins) {
+    renderPluginBatch(plan, level);
+  }
+  const auto channelCount = block.output->channelCount();
+  const auto frameCount = block.output->frameCount();
+  for (auto index = plan.levelOutputOffsets[level]; index < plan.levelOutputOffsets[level + 1]; ++index) {
+    const auto buffer = plan.outputBuffers[index];
+    const bool bufferSilent = plan.silentBuffers[buffer] != 0;
+    const auto source = plan.buffers[buffer].view(channelCount, frameCount);
+    if (auto* line = activeDelay(plan, plan.steps[plan.outputSteps[index]].outputDelay)) {
+      sumDelayed(plan, *line, source, bufferSilent, *block.output);
+    } else if (!bufferSilent) {
+      plan.kernels->add(block.output->channels(), source.channels(), channelCount, frameCount);
+    }
+  }
+}
+
+void SceneGraph::renderPluginBatch(RenderPlan& plan, std::size_t level) {
+  std::size_t count = 0;
+  for (auto index = plan.levelBatchOffsets[level]; index < plan.levelBatchOffsets[level + 1]; ++index) {
+    auto* plugin = plan.batchPlugins[index];
+    // Bypassed, skipped or unaddressed plugins prepared no request; this also clears their deferral.
+    if (auto* request = plugin->takeDeferredRequest()) {
+      plan.batchNodes[count] = plugin;
+      plan.batchRequests[count] = request;
+      ++count;
+    }
+  }
+  if (count == 0) {
+    return;
+  }
+  const bool rendered = PluginHostBridge::RenderBatch({plan.batchRequests.data(), count},
+                                                      {plan.batchResults.data(), count});
+  for (std::size_t i = 0; i < count; ++i) {
+    plan.batchNodes[i]->finishRender(rendered ? std::optional(plan.batchResults[i]) : std::nullopt);
+  }
+}
 
-    nodeIt->second->process(view);
+void SceneGraph::setRenderWorkerCount(std::size_t workerCount) {
+  if (workerCount == renderWorkerCount()) {
+    return;
+  }
+  workerPool_ = workerCount > 0 ? std::make_shared<RenderWorkerPool>(workerCount) : nullptr;
+  topologyChanged();
+}
+
+void SceneGraph::setProfilingEnabled(bool enabled) {
+  if (enabled == profilingEnabled()) {
+    return;
+  }
+  profiler_ = enabled ? std::make_shared<RenderProfiler>(sampleRate_) : nullptr;
+  topologyChanged();
+}
+
+RenderProfiler::Report SceneGraph::renderProfile() {
+  if (!profiler_) {
+    return {};
+  }
+  std::vector<RenderProfiler::NodeLabel> labels;
+  labels.reserve(handles_.size());
+  for (const auto& [id, handle] : handles_) {
+    labels.push_back({id, handle, generations_[handle]});
   }
+  return profiler_->report(labels);
+}
 
-  for (const auto& sourceId : outputSources_) {
-    if (auto it = nodeBuffers_.find(sourceId); it != nodeBuffers_.end()) {
-      outputBuffer.addBufferInPlace(it->second.view(channelCount));
+void SceneGraph::setOfflineRendering(bool offline) {
+  offline_ = offline;
+  for (const auto& node : nodes_) {
+    if (node) {
+      node->setOfflineRendering(offline);
     }
   }
+}
 
-  clock_.advanceBy(static_cast<std::uint32_t>(frameCount));
+void SceneGraph::resetTimeline() {
+  for (const auto& node : nodes_) {
+    if (node) {
+      node->reset();
+    }
+  }
+  clock_.setFrameTime(0);
+  rebuildTopology();
 }
 
-void SceneGraph::scheduleAutomation(const std::string& nodeId, std::function<void(DSPNode&)> cb,
-                                    std::uint64_t frame) {
-  auto it = nodes_.find(nodeId);
-  if (it == nodes_.end()) {
+void SceneGraph::reclaimRetiredPlans() {
+  while (auto retired = retiredPlans_.pop()) {
+    delete *retired;
+  }
+}
+
+ParamId SceneGraph::findParameter(const std::string& nodeId, std::string_view name) const {
+  const NodeHandle handle = findNode(nodeId);
+  return handle == kInvalidNodeHandle ? kInvalidParamId : nodes_[handle]->findParameter(name);
+}
+
+void SceneGraph::setParameter(const std::string& nodeId, ParamId parameter, double value) {
+  const NodeHandle handle = findNode(nodeId);
+  if (handle == kInvalidNodeHandle) {
     throw std::runtime_error("Node not found");
   }
+  if (!published_[handle] || nodes_[handle]->isControlOnly(parameter)) {
+    nodes_[handle]->setParameter(parameter, value);
+    return;
+  }
+  // Frame zero is always due, so the change lands at the start of the next block.
+  scheduleRamp(nodeId, parameter, 0, value, 0, RampShape::kLinear);
+}
 
-  const bool ok = scheduler_.schedule({frame, [node = it->second.get(), cb = std::move(cb)]() mutable {
-                                          cb(*node);
-                                        }});
-  if (!ok) {
+void SceneGraph::scheduleAutomation(const std::string& nodeId, ParamId parameter, std::uint64_t frame,
+                                    double value) {
+  scheduleRamp(nodeId, parameter, frame, value, 0, RampShape::kLinear);
+}
+
+void SceneGraph::scheduleRamp(const std::string& nodeId, ParamId parameter, std::uint64_t frame, double target,
+                              std::uint32_t durationFrames, RampShape shape) {
+  const NodeHandle handle = findNode(nodeId);
+  if (handle == kInvalidNodeHandle) {
+    throw std::runtime_error("Node not found");
+  }
+  if (nodes_[handle]->isControlOnly(parameter)) {
+    // Applying it would allocate or call out on the audio thread.
+    throw std::invalid_argument("Parameter cannot be automated; set it from a control thread");
+  }
+  const ScheduledEvent event{frame, handle, generations_[handle], parameter, target, durationFrames, shape};
+  if (!published_[handle]) {
+    // Events resolve against the plan adopted with them, so one aimed at a node the audio thread has not
+    // seen waits for the plan that adds it: the batch's commit, or a publish right now outside one.
+    deferredEvents_.push_back(event);
+    if (updateDepth_ == 0) {
+      rebuildTopology();
+    }
+    return;
+  }
+  if (!scheduler_.schedule(event)) {
     throw std::runtime_error("Scheduler queue is full");
   }
 }
 
+void SceneGraph::applyEvent(const RenderPlan* plan, const ScheduledEvent& event) {
+  if (plan == nullptr || event.node >= plan->handleNodes.size()) {
+    return;
+  }
+  const auto& target = plan->handleNodes[event.node];
+  if (target.node == nullptr || target.generation != event.generation) {
+    return;
+  }
+  if (event.rampFrames > 0) {
+    target.node->rampParameter(event.parameter, event.value, event.rampFrames, event.rampShape);
+  } else {
+    target.node->setParameter(event.parameter, event.value);
+  }
+}
+
 void SceneGraph::rebuildTopology() {
-  inboundEdges_.clear();
-  outputSources_.clear();
-  renderOrder_.clear();
+  planStale_ = false;
+  if (feedbackStale_) {
+    reorderFeedbackEdges();
+  }
+  auto plan = std::make_unique<RenderPlan>();
+  const std::size_t handleCount = nodes_.size();
+  const bool hasExplicitOutput = busConnections_ > 0;
 
-  if (nodes_.empty()) {
-    return;
+  // Flatten both edge directions into CSR layouts so compilation runs on contiguous integer arrays.
+  std::vector<std::uint32_t> adjacencyOffsets(handleCount + 1, 0U);
+  std::vector<std::uint32_t> inboundOffsets(handleCount + 1, 0U);
+  for (std::size_t handle = 0; handle < handleCount; ++handle) {
+    adjacencyOffsets[handle + 1] = adjacencyOffsets[handle] + static_cast<std::uint32_t>(outputs_[handle].size());
+    inboundOffsets[handle + 1] = inboundOffsets[handle] + static_cast<std::uint32_t>(inputs_[handle].size());
+  }
+  std::vector<NodeHandle> adjacency;
+  std::vector<NodeHandle> inbound;
+  adjacency.reserve(adjacencyOffsets.back());
+  inbound.reserve(inboundOffsets.back());
+  for (std::size_t handle = 0; handle < handleCount; ++handle) {
+    adjacency.insert(adjacency.end(), outputs_[handle].begin(), outputs_[handle].end());
+    inbound.insert(inbound.end(), inputs_[handle].begin(), inputs_[handle].end());
+  }
+
+  Topology topology;
+  topology.order = order_;
+  topology.position = position_;
+  topology.adjacencyOffsets = std::move(adjacencyOffsets);
+  topology.adjacency = std::move(adjacency);
+  topology.inboundOffsets = std::move(inboundOffsets);
+  topology.inbound = std::move(inbound);
+  const auto& sortedOrder = topology.order;
+
+  // Feedback edges (inputs rendered later in the order, only possible inside cycles) read the
+  // previous block's output, so their sources keep a dedicated slot in every plan flavour.
+  topology.pinned.assign(handleCount, false);
+  for (const NodeHandle handle : sortedOrder) {
+    for (auto edge = topology.inboundOffsets[handle]; edge < topology.inboundOffsets[handle + 1]; ++edge) {
+      const NodeHandle source = topology.inbound[edge];
+      if (topology.position[source] >= topology.position[handle]) {
+        topology.pinned[source] = true;
+      }
+    }
+  }
+  topology.feedsOutput.assign(handleCount, false);
+  for (const NodeHandle handle : sortedOrder) {
+    topology.feedsOutput[handle] = hasExplicitOutput ? feedsBus_[handle] : outputs_[handle].empty();
   }
 
-  std::unordered_map<std::string, std::size_t> indegree;
-  indegree.reserve(nodes_.size());
-  for (const auto& [id, _] : nodes_) {
-    indegree.emplace(id, 0U);
+  plan->handleNodes.resize(handleCount);
+  for (NodeHandle handle = 0; handle < handleCount; ++handle) {
+    plan->handleNodes[handle] = {nodes_[handle].get(), generations_[handle]};
   }
 
-  std::unordered_map<std::string, std::vector<std::string>> adjacency;
-  adjacency.reserve(nodes_.size());
+  if (workerPool_) {
+    compileParallelPlan(topology, *plan);
+  } else {
+    compileSerialPlan(topology, *plan);
+  }
+  prepareCompensation(*plan, maxChannels_, maxFrames_);
+  for (auto& buffer : plan->buffers) {
+    buffer.allocate(maxChannels_, maxFrames_);
+  }
+  plan->inputViews.assign(plan->inputBuffers.size(), AudioBufferView(nullptr, 0, 0));
+  // Fresh slots hold zeros, which is exactly what a silent flag promises feedback readers.
+  plan->silentBuffers.assign(plan->buffers.size(), 1);
+  plan->quietFrames.assign(plan->steps.size(), 0);
+  if (profiler_) {
+    plan->profiler = profiler_;
+    plan->stepNanos.assign(plan->steps.size(), 0);
+  }
+  scratchBufferCount_.store(plan->buffers.size(), std::memory_order_relaxed);
+
+  ++compiledPlans_;
+  publishPlan(std::move(plan));
+  flushDeferredEvents();
+}
 
-  std::unordered_set<std::string> sourcesFeedingOutput;
+void SceneGraph::compileSerialPlan(const Topology& topology, RenderPlan& plan) {
+  const auto& order = topology.order;
+  const auto& position = topology.position;
+  const auto& inboundOffsets = topology.inboundOffsets;
+  const auto& inbound = topology.inbound;
+  const auto& pinned = topology.pinned;
+  const std::size_t handleCount = position.size();
 
-  for (const auto& connection : connections_) {
-    if (!nodes_.count(connection.source)) {
-      continue;
+  // Liveness: a node's output is alive from its own step until the last step that reads it.
+  std::vector<std::uint32_t> lastUse(position);
+  for (const NodeHandle handle : order) {
+    for (auto edge = inboundOffsets[handle]; edge < inboundOffsets[handle + 1]; ++edge) {
+      const NodeHandle source = inbound[edge];
+      if (position[source] < position[handle]) {
+        lastUse[source] = std::max(lastUse[source], position[handle]);
+      }
     }
-    if (connection.destination == kOutputBusId) {
-      sourcesFeedingOutput.insert(connection.source);
-      continue;
+  }
+
+  constexpr std::uint32_t kUnassigned = std::numeric_limits<std::uint32_t>::max();
+  std::vector<std::uint32_t> slotForHandle(handleCount, kUnassigned);
+  std::vector<std::uint32_t> freeSlots;
+  std::uint32_t slotCount = 0;
+  for (const NodeHandle handle : order) {
+    if (pinned[handle]) {
+      slotForHandle[handle] = slotCount++;
     }
-    if (!nodes_.count(connection.destination)) {
-      continue;
+  }
+  const auto allocateSlot = [&]() {
+    if (freeSlots.empty()) {
+      return slotCount++;
     }
-    adjacency[connection.source].push_back(connection.destination);
-    inboundEdges_[connection.destination].push_back(connection.source);
-    ++indegree[connection.destination];
+    const auto slot = freeSlots.back();
+    freeSlots.pop_back();
+    return slot;
+  };
+
+  plan.owners.reserve(order.size());
+  plan.steps.reserve(order.size());
+  plan.inputBuffers.reserve(inbound.size());
+  std::vector<NodeHandle> expiring;
+  for (const NodeHandle handle : order) {
+    const auto current = position[handle];
+    PlanStep step;
+    step.node = nodes_[handle].get();
+    step.handle = handle;
+    step.mixesInputs = step.node->mixesInputs();
+    step.firstInput = static_cast<std::uint32_t>(plan.inputBuffers.size());
+
+    expiring.clear();
+    for (auto edge = inboundOffsets[handle]; edge < inboundOffsets[handle + 1]; ++edge) {
+      const NodeHandle source = inbound[edge];
+      if (!pinned[source] && lastUse[source] == current) {
+        expiring.push_back(source);
+      }
+    }
+
+    if (pinned[handle]) {
+      step.buffer = slotForHandle[handle];
+    } else if (!expiring.empty() && !step.mixesInputs) {
+      // Render in place on top of an input nobody reads after this step.
+      step.buffer = slotForHandle[expiring.front()];
+      step.inPlace = true;
+      plan.inputBuffers.push_back(step.buffer);
+      plan.inputSteps.push_back(position[expiring.front()]);
+    } else {
+      step.buffer = allocateSlot();
+    }
+    slotForHandle[handle] = step.buffer;
+
+    for (auto edge = inboundOffsets[handle]; edge < inboundOffsets[handle + 1]; ++edge) {
+      const NodeHandle source = inbound[edge];
+      const auto sourceSlot = slotForHandle[source];
+      if (sourceSlot == kUnassigned || (step.inPlace && source == expiring.front())) {
+        continue;
+      }
+      plan.inputBuffers.push_back(sourceSlot);
+      // Serial steps are indexed by position; feedback edges read the previous block and stay undelayed.
+      plan.inputSteps.push_back(position[source] < current ? position[source] : kNone);
+    }
+    step.inputCount = static_cast<std::uint32_t>(plan.inputBuffers.size()) - step.firstInput;
+
+    for (const NodeHandle source : expiring) {
+      if (slotForHandle[source] != step.buffer) {
+        freeSlots.push_back(slotForHandle[source]);
+      }
+    }
+
+    step.feedsOutput = topology.feedsOutput[handle];
+    if (step.feedsOutput) {
+      plan.outputSteps.push_back(current);
+    }
+    if (!pinned[handle] && lastUse[handle] == current) {
+      // Nothing downstream reads this output; the slot is free once the step has summed into the bus.
+      freeSlots.push_back(step.buffer);
+    }
+
+    plan.steps.push_back(step);
+    plan.owners.push_back(nodes_[handle]);
   }
+  plan.buffers.resize(slotCount);
+}
+
+void SceneGraph::compileParallelPlan(const Topology& topology, RenderPlan& plan) {
+  const auto& order = topology.order;
+  const auto& position = topology.position;
+  const auto& inboundOffsets = topology.inboundOffsets;
+  const auto& inbound = topology.inbound;
+  const auto& pinned = topology.pinned;
+  const std::size_t handleCount = position.size();
 
-  std::vector<std::string> queue;
-  queue.reserve(nodes_.size());
-  for (const auto& [id, degree] : indegree) {
-    if (degree == 0U) {
-      queue.push_back(id);
+  // Dependency levels: a node runs one level after every input rendered earlier in the order, and
+  // one level after every consumer of its feedback edges so those still read the previous block.
+  std::vector<std::uint32_t> level(handleCount, 0U);
+  std::uint32_t levelCount = 0;
+  for (const NodeHandle handle : order) {
+    std::uint32_t nodeLevel = 0;
+    for (auto edge = inboundOffsets[handle]; edge < inboundOffsets[handle + 1]; ++edge) {
+      const NodeHandle source = inbound[edge];
+      if (position[source] < position[handle]) {
+        nodeLevel = std::max(nodeLevel, level[source] + 1);
+      }
+    }
+    for (auto edge = topology.adjacencyOffsets[handle]; edge < topology.adjacencyOffsets[handle + 1]; ++edge) {
+      const NodeHandle destination = topology.adjacency[edge];
+      if (position[destination] < position[handle]) {
+        nodeLevel = std::max(nodeLevel, level[destination] + 1);
+      }
     }
+    level[handle] = nodeLevel;
+    levelCount = std::max(levelCount, nodeLevel + 1);
   }
 
-  std::size_t index = 0;
-  while (index < queue.size()) {
-    const auto current = queue[index++];
-    renderOrder_.push_back(current);
+  std::vector<NodeHandle> levelOrder(order);
+  std::stable_sort(levelOrder.begin(), levelOrder.end(),
+                   [&](NodeHandle a, NodeHandle b) { return level[a] < level[b]; });
 
-    if (const auto adjIt = adjacency.find(current); adjIt != adjacency.end()) {
-      for (const auto& dest : adjIt->second) {
-        auto degIt = indegree.find(dest);
-        if (degIt != indegree.end() && degIt->second > 0U) {
-          --degIt->second;
-          if (degIt->second == 0U) {
-            queue.push_back(dest);
-          }
-        }
+  // Liveness at level granularity: slots are released only once the level of their last reader has
+  // finished, so steps running concurrently never share a buffer.
+  std::vector<std::uint32_t> lastUse(level);
+  for (const NodeHandle handle : order) {
+    for (auto edge = inboundOffsets[handle]; edge < inboundOffsets[handle + 1]; ++edge) {
+      const NodeHandle source = inbound[edge];
+      if (position[source] < position[handle]) {
+        lastUse[source] = std::max(lastUse[source], level[handle]);
       }
     }
   }
 
-  for (const auto& [id, degree] : indegree) {
-    if (degree > 0U && std::find(renderOrder_.begin(), renderOrder_.end(), id) == renderOrder_.end()) {
-      renderOrder_.push_back(id);
+  std::vector<std::vector<NodeHandle>> expiringAtLevel(levelCount);
+  for (const NodeHandle handle : order) {
+    if (!pinned[handle]) {
+      expiringAtLevel[lastUse[handle]].push_back(handle);
     }
   }
 
-  if (!sourcesFeedingOutput.empty()) {
-    outputSources_.assign(sourcesFeedingOutput.begin(), sourcesFeedingOutput.end());
-  } else {
-    outputSources_.clear();
-    for (const auto& [id, _] : nodes_) {
-      if (!adjacency.count(id)) {
-        outputSources_.push_back(id);
+  std::vector<std::uint32_t> slotForHandle(handleCount, 0U);
+  std::vector<std::uint32_t> stepForHandle(handleCount, kNone);
+  std::vector<std::uint32_t> freeSlots;
+  std::uint32_t slotCount = 0;
+  for (const NodeHandle handle : order) {
+    if (pinned[handle]) {
+      slotForHandle[handle] = slotCount++;
+    }
+  }
+
+  plan.owners.reserve(order.size());
+  plan.steps.reserve(order.size());
+  plan.inputBuffers.reserve(inbound.size());
+  plan.levelOffsets.reserve(levelCount + 1);
+  plan.levelOutputOffsets.reserve(levelCount + 1);
+  plan.levelBatchOffsets.reserve(levelCount + 1);
+  std::size_t largestBatch = 0;
+  std::size_t cursor = 0;
+  for (std::uint32_t current = 0; current < levelCount; ++current) {
+    plan.levelOffsets.push_back(static_cast<std::uint32_t>(plan.steps.size()));
+    plan.levelOutputOffsets.push_back(static_cast<std::uint32_t>(plan.outputBuffers.size()));
+    plan.levelBatchOffsets.push_back(static_cast<std::uint32_t>(plan.batchPlugins.size()));
+
+    for (; cursor < levelOrder.size() && level[levelOrder[cursor]] == current; ++cursor) {
+      const NodeHandle handle = levelOrder[cursor];
+      PlanStep step;
+      step.node = nodes_[handle].get();
+      step.handle = handle;
+      step.mixesInputs = step.node->mixesInputs();
+      if (pinned[handle]) {
+        step.buffer = slotForHandle[handle];
+      } else if (freeSlots.empty()) {
+        step.buffer = slotCount++;
+      } else {
+        step.buffer = freeSlots.back();
+        freeSlots.pop_back();
       }
+      slotForHandle[handle] = step.buffer;
+      stepForHandle[handle] = static_cast<std::uint32_t>(plan.steps.size());
+      step.firstInput = static_cast<std::uint32_t>(plan.inputBuffers.size());
+      for (auto edge = inboundOffsets[handle]; edge < inboundOffsets[handle + 1]; ++edge) {
+        const NodeHandle source = inbound[edge];
+        plan.inputBuffers.push_back(slotForHandle[source]);
+        plan.inputSteps.push_back(position[source] < position[handle] ? stepForHandle[source] : kNone);
+      }
+      step.inputCount = static_cast<std::uint32_t>(plan.inputBuffers.size()) - step.firstInput;
+      // Feeders are summed serially by finishParallelLevel, so the step itself never touches the bus.
+      if (topology.feedsOutput[handle]) {
+        plan.outputBuffers.push_back(step.buffer);
+        plan.outputSteps.push_back(stepForHandle[handle]);
+      }
+      plan.steps.push_back(step);
+      plan.owners.push_back(nodes_[handle]);
+      // Anticipative plugins already render off this thread and are never deferred.
+      if (auto* plugin = dynamic_cast<PluginNode*>(step.node); plugin != nullptr && !plugin->anticipative()) {
+        plan.batchPlugins.push_back(plugin);
+      }
+    }
+    // A lone plugin gains nothing from batching and keeps rendering on whichever worker picks it up.
+    const std::size_t levelBatch = plan.batchPlugins.size() - plan.levelBatchOffsets.back();
+    if (levelBatch < 2) {
+      plan.batchPlugins.resize(plan.levelBatchOffsets.back());
+    }
+    largestBatch = std::max(largestBatch, levelBatch < 2 ? 0 : levelBatch);
+
+    // Outputs whose last reader ran in this level become reusable from the next level on.
+    for (const NodeHandle handle : expiringAtLevel[current]) {
+      freeSlots.push_back(slotForHandle[handle]);
     }
   }
+  plan.levelOffsets.push_back(static_cast<std::uint32_t>(plan.steps.size()));
+  plan.levelOutputOffsets.push_back(static_cast<std::uint32_t>(plan.outputBuffers.size()));
+  plan.levelBatchOffsets.push_back(static_cast<std::uint32_t>(plan.batchPlugins.size()));
+  plan.batchNodes.resize(largestBatch);
+  plan.batchRequests.resize(largestBatch);
+  plan.batchResults.resize(largestBatch);
+  plan.buffers.resize(slotCount);
+  plan.workers = workerPool_;
 }
 
-void SceneGraph::ensureNodeBuffers(std::size_t channelCount, std::size_t frameCount) {
-  for (const auto& [id, _] : nodes_) {
-    auto& buffer = nodeBuffers_[id];
-    buffer.configure(channelCount, frameCount);
+void SceneGraph::prepareCompensation(RenderPlan& plan, std::size_t maxChannels, std::size_t maxFrames) {
+  const auto stepCount = plan.steps.size();
+  // Upper bound of every step's path latency. An edge into a join is held back by at most the largest
+  // bound among the join's other inputs, so only edges that can lag get a line, each sized accordingly.
+  std::vector<std::uint64_t> bounds(stepCount, 0U);
+  const auto addLine = [&plan, maxChannels, maxFrames](std::uint64_t maxDelay) {
+    DelayLine line;
+    line.maxDelay = static_cast<std::uint32_t>(std::min<std::uint64_t>(maxDelay, kMaxCompensationFrames));
+    line.capacity = line.maxDelay + maxFrames;
+    line.ring.assign(maxChannels * line.capacity, 0.0F);
+    line.output.allocate(maxChannels, maxFrames);
+    plan.delayLines.push_back(std::move(line));
+    return static_cast<std::uint32_t>(plan.delayLines.size() - 1);
+  };
+  // Largest and second largest bound among a join's inputs; each edge defers to the largest other one.
+  const auto topTwo = [&bounds](auto first, auto last) {
+    std::pair<std::uint64_t, std::uint64_t> top{0U, 0U};
+    for (; first != last; ++first) {
+      if (*first == kNone) {
+        continue;
+      }
+      const auto bound = bounds[*first];
+      top = bound > top.first ? std::pair{bound, top.first} : std::pair{top.first, std::max(top.second, bound)};
+    }
+    return top;
+  };
+  const auto otherBound = [&bounds](std::pair<std::uint64_t, std::uint64_t> top, std::uint32_t stepIndex) {
+    return bounds[stepIndex] == top.first ? top.second : top.first;
+  };
+
+  plan.inputDelays.assign(plan.inputBuffers.size(), kNone);
+  for (std::size_t index = 0; index < stepCount; ++index) {
+    const auto& step = plan.steps[index];
+    const auto first = plan.inputSteps.begin() + step.firstInput;
+    const auto last = first + step.inputCount;
+    const auto top = topTwo(first, last);
+    if (const auto maxLatency = step.node->maxLatencyFrames(); maxLatency > 0) {
+      plan.latencySteps.push_back(static_cast<std::uint32_t>(index));
+      bounds[index] = top.first + maxLatency;
+    } else {
+      bounds[index] = top.first;
+    }
+    for (auto input = first; input != last; ++input) {
+      if (*input != kNone) {
+        if (const auto maxDelay = otherBound(top, *input); maxDelay > 0) {
+          plan.inputDelays[static_cast<std::size_t>(input - plan.inputSteps.begin())] = addLine(maxDelay);
+        }
+      }
+    }
   }
-  clock_.setFramesPerBuffer(static_cast<std::uint32_t>(frameCount));
+  const auto top = topTwo(plan.outputSteps.begin(), plan.outputSteps.end());
+  for (const auto stepIndex : plan.outputSteps) {
+    if (const auto maxDelay = otherBound(top, stepIndex); maxDelay > 0) {
+      plan.steps[stepIndex].outputDelay = addLine(maxDelay);
+    }
+  }
+  plan.nodeLatencies.assign(stepCount, 0U);
+  plan.pathLatencies.assign(stepCount, 0U);
+}
+
+std::uint64_t SceneGraph::updateCompensation(RenderPlan& plan) {
+  bool changed = !plan.compensated;
+  for (const auto index : plan.latencySteps) {
+    const auto latency = plan.steps[index].node->latencyFrames();
+    changed = changed || latency != plan.nodeLatencies[index];
+    plan.nodeLatencies[index] = latency;
+  }
+  if (!changed) {
+    return plan.outputLatency;
+  }
+  plan.compensated = true;
+
+  // Steps are in dependency order, so every producer's path latency is final before its readers'.
+  const auto compensate = [&plan](std::uint32_t line, std::uint64_t lead) {
+    if (line != kNone) {
+      auto& delay = plan.delayLines[line];
+      delay.retune(static_cast<std::uint32_t>(std::min<std::uint64_t>(lead, delay.maxDelay)));
+    }
+  };
+  auto& paths = plan.pathLatencies;
+  for (std::size_t index = 0; index < plan.steps.size(); ++index) {
+    const auto& step = plan.steps[index];
+    std::uint64_t arrival = 0;
+    for (auto input = step.firstInput; input < step.firstInput + step.inputCount; ++input) {
+      if (plan.inputSteps[input] != kNone) {
+        arrival = std::max(arrival, paths[plan.inputSteps[input]]);
+      }
+    }
+    for (auto input = step.firstInput; input < step.firstInput + step.inputCount; ++input) {
+      if (plan.inputSteps[input] != kNone) {
+        compensate(plan.inputDelays[input], arrival - paths[plan.inputSteps[input]]);
+      }
+    }
+    paths[index] = arrival + plan.nodeLatencies[index];
+  }
+  std::uint64_t outputLatency = 0;
+  for (const auto index : plan.outputSteps) {
+    outputLatency = std::max(outputLatency, paths[index]);
+  }
+  for (const auto index : plan.outputSteps) {
+    compensate(plan.steps[index].outputDelay, outputLatency - paths[index]);
+  }
+  plan.outputLatency = outputLatency;
+  return outputLatency;
+}
+
+void SceneGraph::publishPlan(std::unique_ptr<RenderPlan> plan) {
+  reclaimRetiredPlans();
+  std::fill(published_.begin(), published_.end(), true);
+  // A plan still sitting in pendingPlan_ was never observed by the audio thread, so the control thread
+  // can destroy it directly.
+  delete pendingPlan_.exchange(plan.release(), std::memory_order_acq_rel);
+}
+
+void SceneGraph::flushDeferredEvents() {
+  if (deferredEvents_.empty()) {
+    return;
+  }
+  // The plan holding the events' nodes is published, so the audio thread adopts it before draining them.
+  std::size_t queued = 0;
+  while (queued < deferredEvents_.size() && scheduler_.schedule(deferredEvents_[queued])) {
+    ++queued;
+  }
+  const bool overflowed = queued < deferredEvents_.size();
+  deferredEvents_.clear();
+  if (overflowed) {
+    throw std::runtime_error("Scheduler queue is full");
+  }
+}
+
+SceneGraph::RenderPlan* SceneGraph::acquirePlan() {
+  if (pendingPlan_.load(std::memory_order_relaxed) == nullptr) {
+    return activePlan_;
+  }
+  // Keep rendering the current plan until the control thread has drained the retire queue; the audio
+  // thread must never be the one to free a plan.
+  if (activePlan_ != nullptr && retiredPlans_.full()) {
+    return activePlan_;
+  }
+  if (auto* next = pendingPlan_.exchange(nullptr, std::memory_order_acq_rel)) {
+    if (activePlan_ != nullptr) {
+      retiredPlans_.push(activePlan_);
+    }
+    activePlan_ = next;
+  }
+  return activePlan_;
+}
+
+void SceneGraph::NodeBuffer::allocate(std::size_t maxChannels, std::size_t maxFrames) {
+  constexpr std::size_t kAlignmentFloats = dsp::kBufferAlignment / sizeof(float);
+  stride = (maxFrames + kAlignmentFloats - 1) / kAlignmentFloats * kAlignmentFloats;
+  // One spare line of floats lets configure() start the first channel on an aligned address.
+  storage.assign(maxChannels * stride + kAlignmentFloats, 0.0F);
+  channelPointers.assign(maxChannels, nullptr);
+}
+
+void SceneGraph::NodeBuffer::configure(std::size_t channelCount) {
+  const auto misalignment = reinterpret_cast<std::uintptr_t>(storage.data()) % dsp::kBufferAlignment;
+  float* base = storage.data() + (dsp::kBufferAlignment - misalignment) % dsp::kBufferAlignment / sizeof(float);
+  for (std::size_t ch = 0; ch < channelPointers.size(); ++ch) {
+    channelPointers[ch] = ch < channelCount ? base + ch * stride : nullptr;
+  }
+}
+
+void SceneGraph::ensureNodeBuffers(RenderPlan& plan, std::size_t channelCount) {
+  if (plan.configuredChannels == channelCount) {
+    return;
+  }
+  for (auto& buffer : plan.buffers) {
+    buffer.configure(channelCount);
+  }
+  for (auto& line : plan.delayLines) {
+    line.output.configure(channelCount);
+  }
+  plan.configuredChannels = channelCount;
 }
 
 }  // namespace daft::audio
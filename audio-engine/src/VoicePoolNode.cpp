@@ -0,0 +1,245 @@
+#include "audio_engine/VoicePoolNode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace daft::audio {
+
+VoicePoolNode::VoicePoolNode(std::size_t voiceCount) : voiceCount_(std::clamp<std::size_t>(voiceCount, 1, kMaxVoices)) {
+  notes_.fill(kFreeVoice);
+}
+
+void VoicePoolNode::prepare(double sampleRate) {
+  DSPNode::prepare(sampleRate);
+  reset();
+}
+
+void VoicePoolNode::reset() {
+  notes_.fill(kFreeVoice);
+  activeVoices_ = 0;
+}
+
+void VoicePoolNode::setClipBuffer(ClipPlayerNode::ClipBufferData data) {
+  reset();
+  clip_ = data.empty() ? ClipPlayerNode::ClipBufferData{} : std::move(data);
+  sourceScratch_.assign(clip_.channelCount() * kSourceFrames, 0.0F);
+}
+
+void VoicePoolNode::setParameter(ParamId id, double value) {
+  switch (id) {
+    case kNoteOn:
+      // NaN fails the comparison and is ignored.
+      if (value >= 0.0) {
+        const auto packed = static_cast<int>(std::min(value, 16383.0) + 0.5);
+        const int velocity = packed % 128;
+        if (velocity == 0) {
+          noteOff(packed / 128);
+        } else {
+          noteOn(packed / 128, static_cast<float>(velocity) / 127.0F);
+        }
+      }
+      break;
+    case kNoteOff:
+      if (value >= 0.0) {
+        noteOff(static_cast<int>(std::min(value, 127.0) + 0.5));
+      }
+      break;
+    case kAllNotesOff:
+      releaseAll();
+      break;
+    case kWaveform:
+      waveform_ = value >= 2.5   ? dsp::Waveform::kTriangle
+                  : value >= 1.5 ? dsp::Waveform::kSquare
+                  : value >= 0.5 ? dsp::Waveform::kSaw
+                                 : dsp::Waveform::kSine;
+      break;
+    case kAttack:
+      attackSeconds_ = value > 0.0 ? value : 0.0;
+      break;
+    case kRelease:
+      releaseSeconds_ = value > 0.0 ? value : 0.0;
+      break;
+    case kGain:
+      gain_ = value > 0.0 ? static_cast<float>(value) : 0.0F;
+      break;
+    case kRootNote:
+      if (std::isfinite(value)) {
+        rootNote_ = value;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+double VoicePoolNode::noteIncrement(int note) const {
+  if (clip_.empty()) {
+    return 440.0 * std::exp2((note - 69) / 12.0) / sampleRate();
+  }
+  const double step = std::exp2((note - rootNote_) / 12.0) * clip_.sampleRate / sampleRate();
+  return std::min(step, kMaxSampleStep);
+}
+
+std::size_t VoicePoolNode::allocateVoice() {
+  std::size_t oldest = 0;
+  std::size_t oldestReleased = kMaxVoices;
+  for (std::size_t voice = 0; voice < voiceCount_; ++voice) {
+    if (notes_[voice] == kFreeVoice) {
+      return voice;
+    }
+    if (released_[voice] && (oldestReleased == kMaxVoices || ages_[voice] < ages_[oldestReleased])) {
+      oldestReleased = voice;
+    }
+    if (ages_[voice] < ages_[oldest]) {
+      oldest = voice;
+    }
+  }
+  stolenVoices_ += 1;
+  return oldestReleased != kMaxVoices ? oldestReleased : oldest;
+}
+
+void VoicePoolNode::noteOn(int note, float velocity) {
+  const auto voice = allocateVoice();
+  if (notes_[voice] == kFreeVoice) {
+    activeVoices_ += 1;
+    levels_[voice] = 0.0F;
+    positions_[voice] = 0.0;
+  } else if (!clip_.empty()) {
+    // A stolen oscillator keeps its phase; a stolen clip voice has to start the clip over.
+    positions_[voice] = 0.0;
+  }
+  notes_[voice] = static_cast<std::int16_t>(note);
+  ages_[voice] = nextAge_++;
+  velocities_[voice] = velocity;
+  released_[voice] = false;
+  increments_[voice] = noteIncrement(note);
+  const double attackFrames = attackSeconds_ * sampleRate();
+  if (attackFrames < 1.0) {
+    levels_[voice] = 1.0F;
+    levelSteps_[voice] = 0.0F;
+  } else {
+    levelSteps_[voice] = static_cast<float>(1.0 / attackFrames);
+  }
+}
+
+void VoicePoolNode::noteOff(int note) {
+  const double releaseFrames = releaseSeconds_ * sampleRate();
+  for (std::size_t voice = 0; voice < voiceCount_; ++voice) {
+    if (notes_[voice] != note || released_[voice]) {
+      continue;
+    }
+    released_[voice] = true;
+    // Releases shorter than a frame ramp out over the next chunk instead of clicking.
+    levelSteps_[voice] = releaseFrames < 1.0 ? -1.0F : static_cast<float>(-levels_[voice] / releaseFrames);
+  }
+}
+
+void VoicePoolNode::releaseAll() {
+  for (std::size_t voice = 0; voice < voiceCount_; ++voice) {
+    if (notes_[voice] != kFreeVoice) {
+      noteOff(notes_[voice]);
+    }
+  }
+}
+
+void VoicePoolNode::freeVoice(std::size_t voice) {
+  notes_[voice] = kFreeVoice;
+  activeVoices_ -= 1;
+}
+
+void VoicePoolNode::packBatch(std::size_t frames) {
+  batchSize_ = 0;
+  const auto frameCount = static_cast<float>(frames);
+  for (std::size_t voice = 0; voice < voiceCount_; ++voice) {
+    if (notes_[voice] == kFreeVoice) {
+      continue;
+    }
+    // Envelopes are piecewise linear between chunk boundaries.
+    const float start = levels_[voice];
+    const float end = std::clamp(start + levelSteps_[voice] * frameCount, 0.0F, 1.0F);
+    const float scale = velocities_[voice] * gain_;
+    batchVoices_[batchSize_] = static_cast<std::uint8_t>(voice);
+    batchPositions_[batchSize_] = positions_[voice];
+    batchIncrements_[batchSize_] = increments_[voice];
+    batchGains_[batchSize_] = start * scale;
+    batchGainSteps_[batchSize_] = (end - start) * scale / frameCount;
+    levels_[voice] = end;
+    batchSize_ += 1;
+  }
+}
+
+void VoicePoolNode::process(AudioBufferView buffer) {
+  const auto channels = buffer.channelCount();
+  const auto frames = buffer.frameCount();
+  for (std::size_t ch = 0; ch < channels; ++ch) {
+    dsp::fill(buffer.channel(ch).data(), 0.0F, frames);
+  }
+  if (channels == 0) {
+    return;
+  }
+  for (std::size_t offset = 0; offset < frames && activeVoices_ > 0; offset += kChunkFrames) {
+    const auto count = std::min(kChunkFrames, frames - offset);
+    packBatch(count);
+    if (clip_.empty()) {
+      renderOscillatorBatch(buffer, offset, count);
+    } else {
+      renderClipBatch(buffer, offset, count);
+    }
+    for (std::size_t i = 0; i < batchSize_; ++i) {
+      const auto voice = batchVoices_[i];
+      positions_[voice] = batchPositions_[i];
+      const bool faded = released_[voice] && levels_[voice] <= 0.0F;
+      const bool clipEnded = !clip_.empty() && positions_[voice] >= static_cast<double>(clip_.frameCount);
+      if (faded || clipEnded) {
+        freeVoice(voice);
+      }
+    }
+  }
+}
+
+void VoicePoolNode::renderOscillatorBatch(AudioBufferView& buffer, std::size_t offset, std::size_t frames) {
+  float* first = buffer.channel(0).data() + offset;
+  dsp::mixOscillators(waveform_, first, batchPositions_.data(), batchIncrements_.data(), batchGains_.data(),
+                      batchGainSteps_.data(), batchSize_, frames);
+  for (std::size_t ch = 1; ch < buffer.channelCount(); ++ch) {
+    dsp::copy(buffer.channel(ch).data() + offset, first, frames);
+  }
+}
+
+void VoicePoolNode::renderClipBatch(AudioBufferView& buffer, std::size_t offset, std::size_t frames) {
+  const auto outputChannels = buffer.channelCount();
+  const auto clipChannels = clip_.channelCount();
+  for (std::size_t i = 0; i < batchSize_; ++i) {
+    const double start = batchPositions_[i];
+    const double step = batchIncrements_[i];
+    // Two-point interpolation reads one frame past the last position, and the step bound keeps the
+    // span within the scratch.
+    const auto first = static_cast<std::size_t>(start);
+    const auto last = static_cast<std::size_t>(start + step * static_cast<double>(frames - 1)) + 1;
+    const auto span = std::min(last + 1 - first, kSourceFrames);
+    const auto available = first < clip_.frameCount ? std::min(span, clip_.frameCount - first) : 0;
+    for (std::size_t channel = 0; channel < std::min(clipChannels, outputChannels); ++channel) {
+      float* source = sourceScratch_.data() + channel * kSourceFrames;
+      dsp::decode(clip_.format, clip_.channels[channel], first, source, available);
+      dsp::fill(source + available, 0.0F, span - available);
+      const double origin = start - static_cast<double>(first);
+      for (std::size_t frame = 0; frame < frames; ++frame) {
+        const double position = origin + step * static_cast<double>(frame);
+        const auto index = static_cast<std::size_t>(position);
+        const auto fraction = static_cast<float>(position - static_cast<double>(index));
+        voiceScratch_[frame] = source[index] + (source[index + 1] - source[index]) * fraction;
+      }
+      dsp::multiplyRamped(voiceScratch_.data(), batchGains_[i], batchGainSteps_[i], frames);
+      // Output channels past the clip's last channel repeat it, as in ClipPlayerNode.
+      for (std::size_t ch = channel; ch < outputChannels; ++ch) {
+        if (std::min(ch, clipChannels - 1) == channel) {
+          dsp::add(buffer.channel(ch).data() + offset, voiceScratch_.data(), frames);
+        }
+      }
+    }
+    batchPositions_[i] = start + step * static_cast<double>(frames);
+  }
+}
+
+}  // namespace daft::audio
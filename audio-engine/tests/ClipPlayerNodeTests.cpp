@@ -1,11 +1,15 @@
 #include "audio_engine/AudioBuffer.h"
+#include "audio_engine/DSPKernels.h"
 #include "audio_engine/DSPNode.h"
+#include "audio_engine/SmoothedValue.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace daft::audio::tests {
@@ -104,12 +108,115 @@ void TestResetAllowsReplay() {
                 "Playback repeats after reset");
 }
 
+void TestCompactFormatsDecodeWhilePlaying() {
+  // 300 frames spans several vector blocks plus a tail, and the clip starts mid-block.
+  std::vector<float> source(300);
+  for (std::size_t i = 0; i < source.size(); ++i) {
+    source[i] = std::sin(static_cast<float>(i) * 0.05F) * 0.9F;
+  }
+  const std::pair<SampleFormat, float> formats[] = {{SampleFormat::kInt16, 1.0F / 32768.0F},
+                                                     {SampleFormat::kFloat16, 1.0F / 1024.0F}};
+  for (const auto& [format, tolerance] : formats) {
+    auto storage = std::make_shared<std::vector<std::uint16_t>>(source.size());
+    if (format == SampleFormat::kInt16) {
+      dsp::encodeInt16(reinterpret_cast<std::int16_t*>(storage->data()), source.data(), source.size());
+    } else {
+      dsp::encodeFloat16(storage->data(), source.data(), source.size());
+    }
+    ClipPlayerNode::ClipBufferData data;
+    data.key = "compact";
+    data.sampleRate = 48000.0;
+    data.frameCount = source.size();
+    data.format = format;
+    data.channels = {storage->data()};
+    data.owner = storage;
+
+    ClipPlayerNode node;
+    node.prepare(48000.0);
+    node.setClipBuffer(std::move(data));
+    node.setParameter("startframe", 5.0);
+    node.setParameter("endframe", 1000.0);
+
+    std::vector<float> rendered;
+    for (int block = 0; block < 3; ++block) {
+      const auto samples = RenderBlock(node, 128);
+      rendered.insert(rendered.end(), samples.begin(), samples.end());
+    }
+    std::vector<float> expected(rendered.size(), 0.0F);
+    std::copy(source.begin(), source.end(), expected.begin() + 5);
+    AssertSamples(rendered, expected, tolerance, format == SampleFormat::kInt16 ? "int16 clip" : "float16 clip");
+  }
+}
+
+void TestRegionsMatchPerFrameReference() {
+  // Overlapping fades, a gain ramp and a clip window that starts and ends mid-block exercise every
+  // region boundary; a third output channel reuses the clip's last channel.
+  constexpr std::size_t kClipFrames = 400;
+  constexpr std::uint64_t kStart = 37;
+  constexpr std::uint64_t kFadeIn = 150;
+  constexpr std::uint64_t kFadeOut = 300;
+  std::vector<std::vector<float>> channels(2, std::vector<float>(kClipFrames));
+  for (std::size_t i = 0; i < kClipFrames; ++i) {
+    channels[0][i] = std::sin(static_cast<float>(i) * 0.03F);
+    channels[1][i] = 0.5F - static_cast<float>(i) * 0.001F;
+  }
+
+  ClipPlayerNode node;
+  node.prepare(48000.0);
+  node.setClipBuffer(CreateClipBuffer(channels, 48000.0));
+  node.setParameter("startframe", static_cast<double>(kStart));
+  node.setParameter("endframe", 1000.0);
+  node.setParameter("fadeinframes", static_cast<double>(kFadeIn));
+  node.setParameter("fadeoutframes", static_cast<double>(kFadeOut));
+  node.setParameter("gain", 0.8);
+  node.rampParameter(ClipPlayerNode::kGain, 0.2, 200, RampShape::kLinear);
+  SmoothedValue gain{0.8};
+  gain.rampTo(0.2, 200, RampShape::kLinear);
+
+  constexpr std::uint64_t kEnd = kStart + kClipFrames;
+  std::uint64_t timeline = 0;
+  for (const std::size_t blockFrames : {std::size_t{20}, std::size_t{128}, std::size_t{97}, std::size_t{128},
+                                        std::size_t{100}, std::size_t{64}}) {
+    StackAudioBuffer<3, 128> buffer;
+    buffer.setFrameCount(blockFrames);
+    buffer.clear();
+    float* pointers[] = {buffer.channel(0), buffer.channel(1), buffer.channel(2)};
+    node.process(AudioBufferView(pointers, 3, blockFrames));
+
+    for (std::size_t i = 0; i < blockFrames; ++i, ++timeline) {
+      double amplitude = gain.next();
+      if (timeline < kStart || timeline >= kEnd) {
+        amplitude = 0.0;
+      } else {
+        const auto offset = timeline - kStart;
+        if (offset < kFadeIn) {
+          amplitude *= static_cast<double>(offset + 1) / static_cast<double>(kFadeIn);
+        }
+        if (timeline >= kEnd - kFadeOut) {
+          amplitude *= static_cast<double>(kEnd - timeline) / static_cast<double>(kFadeOut);
+        }
+      }
+      for (std::size_t channel = 0; channel < 3; ++channel) {
+        const auto& source = channels[std::min<std::size_t>(channel, 1)];
+        const float expected =
+            amplitude == 0.0 ? 0.0F : static_cast<float>(source[timeline - kStart] * amplitude);
+        if (std::fabs(buffer.channel(channel)[i] - expected) > 1e-5F) {
+          throw std::runtime_error("Clip regions diverge from the per-frame reference at frame " +
+                                   std::to_string(timeline) + " channel " + std::to_string(channel));
+        }
+      }
+    }
+  }
+}
+
 }  // namespace
 
 void RunClipPlayerNodeTests() {
   TestPlaybackScheduling();
   TestFades();
   TestResetAllowsReplay();
+  TestCompactFormatsDecodeWhilePlaying();
+  TestRegionsMatchPerFrameReference();
 }
 
 }  // namespace daft::audio::tests
@@ -0,0 +1,137 @@
+#include "audio_engine/ClipRegistry.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace daft::audio::tests {
+namespace {
+
+std::shared_ptr<ClipBuffer> MakeBuffer(std::size_t frames) {
+  auto buffer = std::make_shared<ClipBuffer>();
+  buffer->sampleRate = 48000.0;
+  buffer->frameCount = frames;
+  buffer->channelSamples.assign(1, std::vector<float>(frames, 0.5F));
+  return buffer;
+}
+
+// Polls `condition` for up to a second, long enough for any reclaim interval the tests use.
+template <typename Condition>
+bool WaitFor(Condition condition) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+void TestReferenceCountsAndBytes() {
+  ClipRegistry registry;
+  registry.store("a", MakeBuffer(16), 64);
+  registry.store("b", MakeBuffer(8), 32);
+  if (registry.bytes() != 96) {
+    throw std::runtime_error("Registry should count the bytes of both clips");
+  }
+
+  // Re-registering a key replaces its buffer and size and takes another reference.
+  auto replacement = MakeBuffer(4);
+  registry.store("a", replacement, 16);
+  if (registry.find("a") != replacement || registry.bytes() != 48) {
+    throw std::runtime_error("Re-registering a key should replace its buffer and byte size");
+  }
+  if (!registry.release("a") || registry.find("a") != replacement) {
+    throw std::runtime_error("Key should stay registered while it holds another reference");
+  }
+  if (!registry.release("a") || registry.find("a") || registry.bytes() != 32) {
+    throw std::runtime_error("Last release should remove the key and its bytes");
+  }
+  if (registry.release("a")) {
+    throw std::runtime_error("Releasing an unknown key should report it");
+  }
+
+  registry.clear();
+  if (registry.find("b") || registry.bytes() != 0) {
+    throw std::runtime_error("Clearing should drop every key");
+  }
+}
+
+void TestLookupsRaceWithEdits() {
+  ClipRegistry registry(std::chrono::milliseconds(1));
+  registry.store("stable", MakeBuffer(4), 16);
+  std::atomic<bool> done{false};
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> readers;
+  for (int reader = 0; reader < 3; ++reader) {
+    readers.emplace_back([&]() {
+      while (!done.load()) {
+        const auto stable = registry.find("stable");
+        if (!stable || stable->frameCount != 4) {
+          failed.store(true);
+        }
+        if (const auto churn = registry.find("churn"); churn && churn->channelData(0) == nullptr) {
+          failed.store(true);
+        }
+        static_cast<void>(registry.bytes());
+      }
+    });
+  }
+  for (int edit = 0; edit < 2000; ++edit) {
+    registry.store("churn", MakeBuffer(32), 128);
+    registry.release("churn");
+  }
+  done.store(true);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  if (failed.load() || registry.bytes() != 16) {
+    throw std::runtime_error("Lookups should see consistent snapshots while writers edit the registry");
+  }
+}
+
+void TestReleasedBuffersAreFreedByTheReclaimer() {
+  ClipRegistry registry(std::chrono::milliseconds(1));
+  std::atomic<bool> freed{false};
+  std::thread::id freedOn;
+  auto buffer = MakeBuffer(4);
+  buffer->storage = std::shared_ptr<const void>(new int(0), [&](const void* storage) {
+    freedOn = std::this_thread::get_id();
+    delete static_cast<const int*>(storage);
+    freed.store(true);
+  });
+  registry.store("clip", buffer, 16);
+
+  // Stands in for a ClipPlayerNode whose ClipBufferData::owner outlives the registry entry.
+  auto player = registry.find("clip");
+  buffer.reset();
+  registry.release("clip");
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  if (freed.load() || registry.pendingReclaims() != 1) {
+    throw std::runtime_error("Buffer should stay alive while a player references it");
+  }
+
+  // Dropping the last outside reference must leave the free to the reclaimer thread.
+  player.reset();
+  if (!WaitFor([&]() { return freed.load(); }) || freedOn == std::this_thread::get_id()) {
+    throw std::runtime_error("Reclaimer thread should free the released buffer");
+  }
+  if (!WaitFor([&]() { return registry.pendingReclaims() == 0; })) {
+    throw std::runtime_error("Reclaimer should forget freed buffers");
+  }
+}
+
+}  // namespace
+
+void RunClipRegistryTests() {
+  TestReferenceCountsAndBytes();
+  TestLookupsRaceWithEdits();
+  TestReleasedBuffersAreFreedByTheReclaimer();
+}
+
+}  // namespace daft::audio::tests
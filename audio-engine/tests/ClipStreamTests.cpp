@@ -0,0 +1,230 @@
+#include "audio_engine/AudioBuffer.h"
+#include "audio_engine/ClipStream.h"
+#include "audio_engine/DSPNode.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace daft::audio::tests {
+namespace {
+
+constexpr std::size_t kChannels = 2;
+constexpr std::size_t kFrames = 300;
+constexpr std::uint32_t kHeaderBytes = 8;
+constexpr std::size_t kStartFrame = 16;
+
+float ExpectedSample(std::size_t channel, std::size_t frame) {
+  return static_cast<float>(frame) * 0.001F + (channel == 0 ? 0.0F : 0.5F);
+}
+
+// Writes an interleaved float cache file behind a small header, the layout ClipFileSource maps.
+class TempClipFile {
+ public:
+  TempClipFile() : path_(std::filesystem::temp_directory_path() / "daft_clip_stream_test.f32") {
+    std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+    const std::uint32_t header[2] = {0x44414654, static_cast<std::uint32_t>(kFrames)};
+    out.write(reinterpret_cast<const char*>(header), kHeaderBytes);
+    for (std::size_t frame = 0; frame < kFrames; ++frame) {
+      for (std::size_t channel = 0; channel < kChannels; ++channel) {
+        const float sample = ExpectedSample(channel, frame);
+        out.write(reinterpret_cast<const char*>(&sample), sizeof(sample));
+      }
+    }
+  }
+  ~TempClipFile() { std::filesystem::remove(path_); }
+
+  [[nodiscard]] std::string path() const { return path_.string(); }
+
+ private:
+  std::filesystem::path path_;
+};
+
+std::shared_ptr<ClipFileSource> OpenSource(const TempClipFile& file) {
+  std::string error;
+  auto source = ClipFileSource::open(file.path(), kChannels, 48000.0, kHeaderBytes, error);
+  if (!source) {
+    throw std::runtime_error("Failed to map clip file: " + error);
+  }
+  return source;
+}
+
+std::vector<std::vector<float>> RenderBlock(ClipPlayerNode& node, std::size_t frameCount) {
+  StackAudioBuffer<kChannels, 128> buffer;
+  buffer.setFrameCount(frameCount);
+  buffer.clear();
+  float* pointers[] = {buffer.channel(0), buffer.channel(1)};
+  node.process(AudioBufferView(pointers, kChannels, frameCount));
+  std::vector<std::vector<float>> channels;
+  for (std::size_t channel = 0; channel < kChannels; ++channel) {
+    channels.emplace_back(buffer.channel(channel), buffer.channel(channel) + frameCount);
+  }
+  return channels;
+}
+
+// Expects the clip placed at kStartFrame on a timeline whose block begins at `timelineFrame`.
+void AssertBlock(const std::vector<std::vector<float>>& block, std::size_t timelineFrame, const std::string& context) {
+  for (std::size_t channel = 0; channel < block.size(); ++channel) {
+    for (std::size_t i = 0; i < block[channel].size(); ++i) {
+      const auto frame = timelineFrame + i;
+      const auto expected = frame >= kStartFrame && frame - kStartFrame < kFrames
+                                ? ExpectedSample(channel, frame - kStartFrame)
+                                : 0.0F;
+      if (std::abs(block[channel][i] - expected) > 1e-6F) {
+        throw std::runtime_error(context + ": channel " + std::to_string(channel) + " frame " + std::to_string(i) +
+                                 " expected " + std::to_string(expected) + " got " +
+                                 std::to_string(block[channel][i]));
+      }
+    }
+  }
+}
+
+void AssertSilent(const std::vector<std::vector<float>>& block, const std::string& context) {
+  for (const auto& channel : block) {
+    for (const float sample : channel) {
+      if (sample != 0.0F) {
+        throw std::runtime_error(context + ": expected silence");
+      }
+    }
+  }
+}
+
+void TestStreamedPlaybackMatchesFile() {
+  TempClipFile file;
+  auto source = OpenSource(file);
+  if (source->frameCount() != kFrames || source->channelCount() != kChannels) {
+    throw std::runtime_error("Mapped clip reports the wrong shape");
+  }
+
+  // Drive the producer by hand so the ring state is deterministic.
+  auto stream = std::make_shared<ClipStream>(source, 96);
+  ClipPlayerNode node;
+  node.prepare(48000.0);
+  node.setClipStream(stream);
+  node.setParameter("startframe", static_cast<double>(kStartFrame));
+  node.setParameter("endframe", 1000.0);
+
+  stream->fill(96);
+  AssertBlock(RenderBlock(node, 64), 0, "Streamed lead-in");
+  // The lead-in consumed clip frames 0-47, freeing room for the producer to read 96-143.
+  stream->fill(96);
+  AssertBlock(RenderBlock(node, 64), 64, "Streamed continuation");
+  if (stream->underruns() != 0) {
+    throw std::runtime_error("Read-ahead playback must not underrun");
+  }
+
+  // Without a refill the ring runs dry: the block is silent and the underrun is counted.
+  AssertSilent(RenderBlock(node, 64), "Underrun block");
+  if (stream->underruns() != 1) {
+    throw std::runtime_error("Underrun was not counted");
+  }
+
+  // The producer resumes where playback continues rather than where it stalled.
+  stream->fill(96);
+  AssertBlock(RenderBlock(node, 64), 192, "Resumed after underrun");
+
+  // Reset relocates the stream to the clip start.
+  node.reset();
+  stream->fill(96);
+  AssertBlock(RenderBlock(node, 32), 0, "Replay after reset");
+  if (stream->underruns() != 1) {
+    throw std::runtime_error("Reset must not count as an underrun");
+  }
+}
+
+void TestOfflineReadsBypassTheRing() {
+  TempClipFile file;
+  auto source = OpenSource(file);
+  auto stream = std::make_shared<ClipStream>(source, 96);
+  ClipPlayerNode node;
+  node.prepare(48000.0);
+  node.setClipStream(stream);
+  node.setParameter("startframe", static_cast<double>(kStartFrame));
+  node.setParameter("endframe", 1000.0);
+  node.setOfflineRendering(true);
+
+  // Nothing was ever filled, yet every block plays: offline reads copy straight from the mapping.
+  for (std::size_t block = 0; block < 4; ++block) {
+    AssertBlock(RenderBlock(node, 64), block * 64, "Offline block " + std::to_string(block));
+  }
+  if (stream->underruns() != 0) {
+    throw std::runtime_error("Offline streamed playback must not underrun");
+  }
+
+  // Back in realtime the ring refills from where the offline reads stopped.
+  node.setOfflineRendering(false);
+  stream->fill(96);
+  AssertBlock(RenderBlock(node, 64), 256, "Realtime block after offline render");
+}
+
+void TestStreamerFillsInBackground() {
+  TempClipFile file;
+  auto source = OpenSource(file);
+  ClipStreamer streamer(std::chrono::milliseconds(1));
+  auto stream = streamer.createStream(source, kFrames);
+
+  std::vector<float> left(kFrames);
+  std::vector<float> right(kFrames);
+  float* channels[] = {left.data(), right.data()};
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  if (!stream->read(0, kFrames, channels)) {
+    throw std::runtime_error("Streamer did not read ahead");
+  }
+  AssertBlock({left, right}, kStartFrame, "Background read-ahead");
+  if (streamer.underruns() != 0) {
+    throw std::runtime_error("Streamer reported unexpected underruns");
+  }
+}
+
+void TestMappedRegionAdoptsFileBytes() {
+  TempClipFile file;
+  const int fd = ::open(file.path().c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open clip file");
+  }
+  std::string error;
+  // An offset that is not page aligned must still address the requested byte.
+  auto region = MapFileRegion(fd, kHeaderBytes, kFrames * kChannels * sizeof(float), error);
+  auto overrun = MapFileRegion(fd, kHeaderBytes, kFrames * kChannels * sizeof(float) + 1, error);
+  ::close(fd);
+  if (!region || overrun) {
+    throw std::runtime_error("Mapped region bounds are not enforced: " + error);
+  }
+  const auto* samples = static_cast<const float*>(region.get());
+  for (std::size_t frame = 0; frame < kFrames; ++frame) {
+    for (std::size_t channel = 0; channel < kChannels; ++channel) {
+      if (samples[frame * kChannels + channel] != ExpectedSample(channel, frame)) {
+        throw std::runtime_error("Mapped region does not match the file contents");
+      }
+    }
+  }
+}
+
+void TestMissingFileIsRejected() {
+  std::string error;
+  if (ClipFileSource::open("/nonexistent/daft.f32", 2, 48000.0, 0, error) != nullptr || error.empty()) {
+    throw std::runtime_error("Opening a missing file must fail with an error");
+  }
+}
+
+}  // namespace
+
+void RunClipStreamTests() {
+  TestStreamedPlaybackMatchesFile();
+  TestOfflineReadsBypassTheRing();
+  TestStreamerFillsInBackground();
+  TestMappedRegionAdoptsFileBytes();
+  TestMissingFileIsRejected();
+}
+
+}  // namespace daft::audio::tests
@@ -0,0 +1,310 @@
+#include "audio_engine/DSPKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace daft::audio::tests {
+namespace {
+
+std::vector<float> Ramp(std::size_t count, float start, float step) {
+  std::vector<float> values(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    values[i] = start + step * static_cast<float>(i);
+  }
+  return values;
+}
+
+void AssertNear(const std::vector<float>& actual, const std::vector<float>& expected, const std::string& context) {
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    if (std::fabs(actual[i] - expected[i]) > 1e-5F) {
+      throw std::runtime_error(context + " (" + dsp::instructionSet() + "): sample " + std::to_string(i) +
+                               " expected " + std::to_string(expected[i]) + " got " + std::to_string(actual[i]));
+    }
+  }
+}
+
+void TestKernelsMatchScalarReference() {
+  // Odd lengths and an unaligned start exercise both the vector body and the scalar tail.
+  for (const std::size_t count : {std::size_t{0}, std::size_t{1}, std::size_t{7}, std::size_t{33}, std::size_t{257}}) {
+    const auto label = " with " + std::to_string(count) + " frames";
+    const auto source = Ramp(count + 1, -1.0F, 0.01F);
+    const auto gains = Ramp(count + 1, 0.5F, 0.002F);
+    const auto base = Ramp(count + 1, 0.25F, -0.003F);
+    std::vector<float> expected(count);
+
+    auto dest = base;
+    dsp::add(dest.data() + 1, source.data() + 1, count);
+    for (std::size_t i = 0; i < count; ++i) {
+      expected[i] = base[i + 1] + source[i + 1];
+    }
+    AssertNear({dest.begin() + 1, dest.end()}, expected, "add" + label);
+
+    dest = base;
+    dsp::addScaled(dest.data() + 1, source.data() + 1, 0.75F, count);
+    for (std::size_t i = 0; i < count; ++i) {
+      expected[i] = base[i + 1] + source[i + 1] * 0.75F;
+    }
+    AssertNear({dest.begin() + 1, dest.end()}, expected, "addScaled" + label);
+
+    dest = base;
+    dsp::addMultiplied(dest.data() + 1, source.data() + 1, gains.data() + 1, count);
+    for (std::size_t i = 0; i < count; ++i) {
+      expected[i] = base[i + 1] + source[i + 1] * gains[i + 1];
+    }
+    AssertNear({dest.begin() + 1, dest.end()}, expected, "addMultiplied" + label);
+
+    dest = base;
+    dsp::scale(dest.data() + 1, -2.0F, count);
+    for (std::size_t i = 0; i < count; ++i) {
+      expected[i] = base[i + 1] * -2.0F;
+    }
+    AssertNear({dest.begin() + 1, dest.end()}, expected, "scale" + label);
+
+    dest = base;
+    dsp::multiply(dest.data() + 1, gains.data() + 1, count);
+    for (std::size_t i = 0; i < count; ++i) {
+      expected[i] = base[i + 1] * gains[i + 1];
+    }
+    AssertNear({dest.begin() + 1, dest.end()}, expected, "multiply" + label);
+
+    dest = base;
+    const auto other = Ramp(count + 1, 2.0F, -0.004F);
+    const float* sources[] = {source.data() + 1, gains.data() + 1, other.data() + 1};
+    const float weights[] = {0.5F, -1.0F, 0.25F};
+    dsp::mixScaled(dest.data() + 1, sources, weights, 3, count);
+    for (std::size_t i = 0; i < count; ++i) {
+      expected[i] = base[i + 1] + source[i + 1] * 0.5F - gains[i + 1] + other[i + 1] * 0.25F;
+    }
+    AssertNear({dest.begin() + 1, dest.end()}, expected, "mixScaled" + label);
+
+    dest = base;
+    dsp::copy(dest.data() + 1, source.data() + 1, count);
+    AssertNear({dest.begin() + 1, dest.end()}, {source.begin() + 1, source.end()}, "copy" + label);
+
+    dsp::fill(dest.data() + 1, 0.125F, count);
+    AssertNear({dest.begin() + 1, dest.end()}, std::vector<float>(count, 0.125F), "fill" + label);
+    if (dest.front() != base.front()) {
+      throw std::runtime_error("Kernels must not write before the destination range");
+    }
+  }
+}
+
+void TestSampleFormatsRoundTrip() {
+  // Values exactly representable in both formats must survive encode and decode unchanged.
+  const std::vector<float> exact{0.0F, -0.0F, 0.5F, -1.0F, 0.25F, -0.75F, 0.125F, 0.0009765625F};
+  std::vector<std::int16_t> pcm(exact.size());
+  std::vector<std::uint16_t> half(exact.size());
+  std::vector<float> decoded(exact.size());
+  dsp::encodeInt16(pcm.data(), exact.data(), exact.size());
+  dsp::decodeInt16(decoded.data(), pcm.data(), exact.size());
+  AssertNear(decoded, exact, "int16 round trip");
+  dsp::encodeFloat16(half.data(), exact.data(), exact.size());
+  dsp::decodeFloat16(decoded.data(), half.data(), exact.size());
+  AssertNear(decoded, exact, "float16 round trip");
+
+  // int16 clamps to its range; float16 keeps headroom, saturates to infinity and keeps subnormals.
+  const std::vector<float> edges{2.0F, -2.0F, 65504.0F, 1e6F, 5.9604645e-8F, -3.0F, 1024.5F, 1.0F};
+  pcm.resize(edges.size());
+  half.resize(edges.size());
+  dsp::encodeInt16(pcm.data(), edges.data(), edges.size());
+  if (pcm[0] != 32767 || pcm[1] != -32768) {
+    throw std::runtime_error("int16 encoding must clamp out-of-range samples");
+  }
+  dsp::encodeFloat16(half.data(), edges.data(), edges.size());
+  const std::vector<std::uint16_t> expectedHalf{0x4000, 0xc000, 0x7bff, 0x7c00, 0x0001, 0xc200, 0x6400, 0x3c00};
+  for (std::size_t i = 0; i < edges.size(); ++i) {
+    if (half[i] != expectedHalf[i]) {
+      throw std::runtime_error("float16 encoding of " + std::to_string(edges[i]) + " produced " +
+                               std::to_string(half[i]));
+    }
+  }
+
+  // Every half bit pattern decodes identically through the vector blocks and the scalar tail.
+  std::vector<std::uint16_t> patterns(65536);
+  for (std::size_t i = 0; i < patterns.size(); ++i) {
+    patterns[i] = static_cast<std::uint16_t>(i);
+  }
+  std::vector<float> wide(patterns.size());
+  std::vector<float> narrow(patterns.size());
+  dsp::decodeFloat16(wide.data(), patterns.data(), patterns.size());
+  for (std::size_t i = 0; i < patterns.size(); ++i) {
+    dsp::decodeFloat16(&narrow[i], &patterns[i], 1);
+    const bool bothNan = std::isnan(wide[i]) && std::isnan(narrow[i]);
+    if (!bothNan && std::memcmp(&wide[i], &narrow[i], sizeof(float)) != 0) {
+      throw std::runtime_error("float16 vector decode differs from scalar for pattern " + std::to_string(i));
+    }
+  }
+  if (wide[0x7c00] != std::numeric_limits<float>::infinity() || wide[0x0400] != 6.1035156e-5F ||
+      !std::isnan(wide[0x7e00])) {
+    throw std::runtime_error("float16 decode mishandles special values");
+  }
+}
+
+void TestBlockKernelsMatchAnyShape() {
+  // The specialised shapes, plus shapes that must fall back to the runtime-sized loops.
+  for (const std::size_t channels : {std::size_t{1}, std::size_t{2}, std::size_t{3}}) {
+    for (const std::size_t frames : {std::size_t{64}, std::size_t{128}, std::size_t{256}, std::size_t{100}}) {
+      const auto label = " for " + std::to_string(channels) + "x" + std::to_string(frames);
+      const auto& kernels = dsp::blockKernels(channels, frames);
+      if (kernels.specialised != (channels <= 2 && frames != 100)) {
+        throw std::runtime_error("Unexpected block kernel selection" + label);
+      }
+      std::vector<std::vector<float>> dest(channels);
+      std::vector<std::vector<float>> source(channels);
+      std::vector<float*> destPointers(channels);
+      std::vector<const float*> sourcePointers(channels);
+      for (std::size_t ch = 0; ch < channels; ++ch) {
+        dest[ch] = Ramp(frames, 0.25F * static_cast<float>(ch), 0.001F);
+        source[ch] = Ramp(frames, -0.5F, 0.002F * static_cast<float>(ch + 1));
+        destPointers[ch] = dest[ch].data();
+        sourcePointers[ch] = source[ch].data();
+      }
+      kernels.add(destPointers.data(), sourcePointers.data(), channels, frames);
+      for (std::size_t ch = 0; ch < channels; ++ch) {
+        auto expected = Ramp(frames, 0.25F * static_cast<float>(ch), 0.001F);
+        for (std::size_t i = 0; i < frames; ++i) {
+          expected[i] += source[ch][i];
+        }
+        AssertNear(dest[ch], expected, "block add" + label);
+      }
+      kernels.clear(destPointers.data(), channels, frames);
+      for (std::size_t ch = 0; ch < channels; ++ch) {
+        AssertNear(dest[ch], std::vector<float>(frames, 0.0F), "block clear" + label);
+      }
+    }
+  }
+}
+
+// Share of a signal's energy outside the harmonics of a tone completing `cycles` periods over its length,
+// in dB. Aliased partials of such a tone fold onto other DFT bins.
+double AliasEnergyDb(const std::vector<float>& signal, std::size_t cycles) {
+  const std::size_t count = signal.size();
+  double total = 0.0;
+  double aliased = 0.0;
+  for (std::size_t bin = 1; bin <= count / 2; ++bin) {
+    double re = 0.0;
+    double im = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+      const double angle = 2.0 * std::numbers::pi * static_cast<double>((bin * i) % count) / static_cast<double>(count);
+      re += signal[i] * std::cos(angle);
+      im += signal[i] * std::sin(angle);
+    }
+    total += re * re + im * im;
+    aliased += bin % cycles == 0 ? 0.0 : re * re + im * im;
+  }
+  return 10.0 * std::log10(aliased / total);
+}
+
+void TestOscillatorsAreBandLimited() {
+  // 97 cycles over 2400 frames, about 1.9 kHz at 48 kHz: a dozen partials fit below Nyquist.
+  constexpr std::size_t kFrames = 2400;
+  constexpr std::size_t kCycles = 97;
+  constexpr double kIncrement = static_cast<double>(kCycles) / kFrames;
+  std::vector<float> sine(kFrames);
+  dsp::oscillator(dsp::Waveform::kSine, sine.data(), 0.0, kIncrement, kFrames);
+  for (std::size_t i = 0; i < kFrames; ++i) {
+    const double expected = std::sin(2.0 * std::numbers::pi * std::fmod(static_cast<double>(i) * kIncrement, 1.0));
+    if (std::fabs(sine[i] - expected) > 2e-6) {
+      throw std::runtime_error(std::string("Polynomial sine diverges from std::sin (") + dsp::instructionSet() + ")");
+    }
+  }
+
+  struct Shape {
+    dsp::Waveform waveform;
+    const char* name;
+    double (*naive)(double phase);
+  };
+  const Shape shapes[] = {
+      {dsp::Waveform::kSaw, "saw", [](double phase) { return 2.0 * std::fmod(phase + 0.5, 1.0) - 1.0; }},
+      {dsp::Waveform::kSquare, "square", [](double phase) { return phase < 0.5 ? 1.0 : -1.0; }},
+      {dsp::Waveform::kTriangle, "triangle",
+       [](double phase) { return 1.0 - 4.0 * std::fabs(std::fmod(phase + 0.25, 1.0) - 0.5); }},
+  };
+  for (const auto& shape : shapes) {
+    std::vector<float> bandLimited(kFrames);
+    std::vector<float> naive(kFrames);
+    dsp::oscillator(shape.waveform, bandLimited.data(), 0.0, kIncrement, kFrames);
+    for (std::size_t i = 0; i < kFrames; ++i) {
+      const double phase = std::fmod(static_cast<double>(i) * kIncrement, 1.0);
+      naive[i] = static_cast<float>(shape.naive(phase));
+      if (std::fabs(bandLimited[i] - naive[i]) > 1.0F + 1e-5F) {
+        throw std::runtime_error(std::string("Band-limited ") + shape.name + " strays from its shape");
+      }
+    }
+    if (AliasEnergyDb(bandLimited, kCycles) > AliasEnergyDb(naive, kCycles) - 10.0) {
+      throw std::runtime_error(std::string("Band-limited ") + shape.name + " should alias at least 10 dB less");
+    }
+  }
+
+  // Rendering in pieces continues the phase exactly where the previous piece stopped.
+  std::vector<float> whole(1000);
+  std::vector<float> pieces(1000);
+  dsp::oscillator(dsp::Waveform::kSaw, whole.data(), 0.3, 0.01, whole.size());
+  double phase = 0.3;
+  for (std::size_t offset = 0; offset < pieces.size(); offset += 256) {
+    const auto count = std::min<std::size_t>(256, pieces.size() - offset);
+    phase = dsp::oscillator(dsp::Waveform::kSaw, pieces.data() + offset, phase, 0.01, count);
+  }
+  AssertNear(pieces, whole, "Oscillator rendered in pieces");
+  if (std::fabs(phase - std::fmod(0.3 + 1000 * 0.01, 1.0)) > 1e-9) {
+    throw std::runtime_error("Oscillator should return the phase after its last sample");
+  }
+}
+
+void TestOscillatorBankMatchesSingleOscillators() {
+  // Eleven voices fill whole registers and leave a partial one at every lane width.
+  constexpr std::size_t kVoices = 11;
+  constexpr std::size_t kFrames = 200;
+  for (const auto waveform : {dsp::Waveform::kSine, dsp::Waveform::kSaw, dsp::Waveform::kTriangle}) {
+    std::vector<double> phases(kVoices);
+    std::vector<double> increments(kVoices);
+    std::vector<float> gains(kVoices);
+    std::vector<float> gainSteps(kVoices);
+    std::vector<float> expected(kFrames, 0.25F);
+    std::vector<float> voice(kFrames);
+    for (std::size_t v = 0; v < kVoices; ++v) {
+      phases[v] = 0.07 * static_cast<double>(v);
+      increments[v] = 0.003 + 0.011 * static_cast<double>(v);
+      gains[v] = 0.1F;
+      gainSteps[v] = 0.0005F * static_cast<float>(v);
+      dsp::oscillator(waveform, voice.data(), phases[v], increments[v], kFrames);
+      for (std::size_t i = 0; i < kFrames; ++i) {
+        expected[i] += (gains[v] + gainSteps[v] * static_cast<float>(i)) * voice[i];
+      }
+    }
+    std::vector<float> mixed(kFrames, 0.25F);
+    dsp::mixOscillators(waveform, mixed.data(), phases.data(), increments.data(), gains.data(), gainSteps.data(),
+                        kVoices, kFrames);
+    // Voices step their phase in float within a chunk, so eleven of them drift apart slightly near edges.
+    for (std::size_t i = 0; i < kFrames; ++i) {
+      if (std::fabs(mixed[i] - expected[i]) > 1e-4F) {
+        throw std::runtime_error(std::string("Oscillator bank (") + dsp::instructionSet() + "): frame " +
+                                 std::to_string(i) + " expected " + std::to_string(expected[i]) + " got " +
+                                 std::to_string(mixed[i]));
+      }
+    }
+    if (std::fabs(phases[3] - std::fmod(0.21 + 0.036 * kFrames, 1.0)) > 1e-9) {
+      throw std::runtime_error("Oscillator bank should advance every voice's phase");
+    }
+  }
+}
+
+}  // namespace
+
+void RunDSPKernelsTests() {
+  TestKernelsMatchScalarReference();
+  TestBlockKernelsMatchAnyShape();
+  TestSampleFormatsRoundTrip();
+  TestOscillatorsAreBandLimited();
+  TestOscillatorBankMatchesSingleOscillators();
+}
+
+}  // namespace daft::audio::tests
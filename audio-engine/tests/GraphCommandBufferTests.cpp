@@ -0,0 +1,134 @@
+#include "../platform/common/GraphCommandBuffer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace daft::audio::tests {
+namespace {
+
+using bridge::GraphCommand;
+using bridge::GraphCommandReader;
+using bridge::GraphOp;
+using bridge::GraphOption;
+using bridge::GraphOptionKind;
+using bridge::GraphOptionReader;
+
+// Mirrors the TypeScript encoder closely enough to build buffers by hand.
+class Encoder {
+ public:
+  explicit Encoder(std::uint32_t commandCount, std::uint16_t version = GraphCommandReader::kVersion) {
+    put(GraphCommandReader::kMagic);
+    put(version);
+    put(std::uint16_t{0});
+    put(commandCount);
+  }
+
+  template <typename T>
+  Encoder& put(T value) {
+    const auto offset = bytes.size();
+    bytes.resize(offset + sizeof(T));
+    std::memcpy(bytes.data() + offset, &value, sizeof(T));
+    return *this;
+  }
+  Encoder& op(GraphOp value) { return put(static_cast<std::uint8_t>(value)); }
+  Encoder& text(std::string_view value) {
+    put(static_cast<std::uint16_t>(value.size()));
+    bytes.insert(bytes.end(), value.begin(), value.end());
+    return *this;
+  }
+
+  std::vector<std::uint8_t> bytes;
+};
+
+void Expect(bool condition, const std::string& message) {
+  if (!condition) {
+    throw std::runtime_error(message);
+  }
+}
+
+void TestDecodesEveryCommand() {
+  Encoder encoder(5);
+  encoder.op(GraphOp::kAddNode).text("clip").text("clipPlayer").put(std::uint16_t{3});
+  encoder.text("bufferKey").put(static_cast<std::uint8_t>(GraphOptionKind::kString)).text("kick");
+  encoder.text("gain").put(static_cast<std::uint8_t>(GraphOptionKind::kNumber)).put(0.5);
+  encoder.text("loop").put(static_cast<std::uint8_t>(GraphOptionKind::kBoolean)).put(std::uint8_t{1});
+  encoder.op(GraphOp::kConnect).text("clip").text("__output__");
+  encoder.op(GraphOp::kSetParameter).text("clip").text("gain").put(0.25);
+  encoder.op(GraphOp::kScheduleRamp).text("clip").text("gain").put(96000.0).put(1.0);
+  encoder.put(std::uint32_t{480}).put(std::uint8_t{1});
+  encoder.op(GraphOp::kRemoveNode).text("old");
+
+  GraphCommandReader reader(encoder.bytes);
+  GraphCommand command;
+  std::string error;
+  Expect(reader.next(command, error) && command.op == GraphOp::kAddNode && command.node == "clip" &&
+             command.name == "clipPlayer" && command.optionCount == 3 && reader.commandCount() == 5,
+         "addNode should decode its id, type and option count");
+  GraphOptionReader options(command);
+  GraphOption option;
+  Expect(options.next(option) && option.key == "bufferKey" && option.kind == GraphOptionKind::kString &&
+             option.text == "kick",
+         "String option should decode");
+  Expect(options.next(option) && option.kind == GraphOptionKind::kNumber && option.number == 0.5,
+         "Number option should decode");
+  Expect(options.next(option) && option.kind == GraphOptionKind::kBoolean && option.flag && !options.next(option),
+         "Boolean option should decode and end the list");
+
+  Expect(reader.next(command, error) && command.op == GraphOp::kConnect && command.name == "__output__",
+         "connect should decode its endpoints");
+  Expect(reader.next(command, error) && command.op == GraphOp::kSetParameter && command.value == 0.25,
+         "setParameter should decode its value");
+  Expect(reader.next(command, error) && command.op == GraphOp::kScheduleRamp && command.frame == 96000.0 &&
+             command.value == 1.0 && command.durationFrames == 480 && command.shape == RampShape::kExponential,
+         "scheduleRamp should decode every field");
+  Expect(reader.next(command, error) && command.op == GraphOp::kRemoveNode && command.node == "old",
+         "removeNode should decode its id");
+  Expect(!reader.next(command, error) && error.empty() && reader.commandsRead() == 5,
+         "Reader should stop cleanly after the declared commands");
+  // Views point into the buffer rather than into copies.
+  Expect(command.node.data() >= reinterpret_cast<const char*>(encoder.bytes.data()) &&
+             command.node.data() < reinterpret_cast<const char*>(encoder.bytes.data() + encoder.bytes.size()),
+         "Decoded strings should view the command buffer");
+}
+
+void ExpectRejected(const std::vector<std::uint8_t>& bytes, const std::string& context) {
+  std::string error;
+  Expect(!GraphCommandReader(bytes).validate(error) && !error.empty(), context + " should be rejected");
+}
+
+void TestRejectsMalformedBuffers() {
+  std::string error;
+  Expect(GraphCommandReader(Encoder(0).bytes).validate(error), "An empty command list is valid");
+  ExpectRejected({0x44, 0x47}, "A truncated header");
+
+  auto badMagic = Encoder(0).bytes;
+  badMagic[0] = 'X';
+  ExpectRejected(badMagic, "A wrong magic");
+  ExpectRejected(Encoder(0, 2).bytes, "A future version");
+
+  auto truncated = Encoder(1).op(GraphOp::kConnect).text("a").bytes;
+  truncated.push_back(9);
+  ExpectRejected(truncated, "A connection without its destination");
+  ExpectRejected(Encoder(1).op(static_cast<GraphOp>(42)).text("a").bytes, "An unknown opcode");
+  ExpectRejected(Encoder(2).op(GraphOp::kRemoveNode).text("a").bytes, "A buffer with fewer commands than declared");
+  ExpectRejected(Encoder(1).op(GraphOp::kRemoveNode).text("a").put(std::uint8_t{0}).bytes, "Trailing bytes");
+  ExpectRejected(Encoder(1).op(GraphOp::kRemoveNode).text("").bytes, "An empty node id");
+  ExpectRejected(Encoder(1).op(GraphOp::kScheduleAutomation).text("a").text("gain").put(1.5).put(1.0).bytes,
+                 "A fractional frame");
+  ExpectRejected(Encoder(1).op(GraphOp::kAddNode).text("a").text("gain").put(std::uint16_t{1}).text("gain")
+                     .put(std::uint8_t{7}).bytes,
+                 "An unknown option kind");
+}
+
+}  // namespace
+
+void RunGraphCommandBufferTests() {
+  TestDecodesEveryCommand();
+  TestRejectsMalformedBuffers();
+}
+
+}  // namespace daft::audio::tests
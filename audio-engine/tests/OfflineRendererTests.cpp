@@ -0,0 +1,230 @@
+#include "audio_engine/OfflineRenderer.h"
+#include "audio_engine/SceneGraph.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace daft::audio::tests {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+// Deliberately not a multiple of the graph block or of a writer chunk.
+constexpr std::uint64_t kBounceFrames = 40000;
+constexpr std::uint64_t kAutomationFrame = 30001;
+
+// Writes its own frame position (scaled) plus an automatable offset; `reset` rewinds it.
+class PositionNode final : public DSPNode {
+ public:
+  void process(AudioBufferView buffer) override {
+    for (std::size_t i = 0; i < buffer.frameCount(); ++i) {
+      const auto value = static_cast<float>(position_ + i) * 1e-5F + offset_;
+      for (std::size_t ch = 0; ch < buffer.channelCount(); ++ch) {
+        buffer.channel(ch)[i] += ch == 0 ? value : -value;
+      }
+    }
+    position_ += buffer.frameCount();
+  }
+  void reset() override { position_ = 0; }
+
+  static constexpr std::array<ParameterDescriptor, 1> kParameters{{
+      {0, "offset", -1.0, 1.0, 0.0, ParameterSmoothing::kNone},
+  }};
+
+  using DSPNode::setParameter;
+  [[nodiscard]] std::span<const ParameterDescriptor> parameters() const override { return kParameters; }
+  void setParameter(ParamId id, double value) override {
+    if (id == 0) {
+      offset_ = static_cast<float>(value);
+    }
+  }
+
+ private:
+  std::uint64_t position_ = 0;
+  float offset_ = 0.0F;
+};
+
+// Holds the render thread inside its first block until the test opens the gate.
+class GateNode final : public DSPNode {
+ public:
+  explicit GateNode(std::atomic<bool>& open) : open_(open) {}
+
+  void process(AudioBufferView) override {
+    open_.wait(false, std::memory_order_acquire);
+  }
+
+ private:
+  std::atomic<bool>& open_;
+};
+
+float ExpectedSample(std::size_t channel, std::uint64_t frame) {
+  const auto value = static_cast<float>(frame) * 1e-5F + (frame >= kAutomationFrame ? 0.5F : 0.0F);
+  return channel == 0 ? value : -value;
+}
+
+std::filesystem::path TempPath(const std::string& name) { return std::filesystem::temp_directory_path() / name; }
+
+std::vector<char> ReadFile(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+template <typename T>
+T ReadLittleEndian(const std::vector<char>& bytes, std::size_t offset) {
+  T value{};
+  std::memcpy(&value, bytes.data() + offset, sizeof(T));
+  return value;
+}
+
+void BuildPositionGraph(SceneGraph& graph) {
+  graph.addNode("source", std::make_unique<PositionNode>());
+  graph.connect("source", std::string(SceneGraph::kOutputBusId));
+}
+
+OfflineRenderer::State Bounce(SceneGraph& graph, const std::filesystem::path& path,
+                              const OfflineRenderer::Options& options) {
+  // Parameters keep their values across a rewind, so the lane is written from the top.
+  const auto offset = graph.findParameter("source", "offset");
+  graph.scheduleAutomation("source", offset, 0, 0.0);
+  graph.scheduleAutomation("source", offset, kAutomationFrame, 0.5);
+  OfflineRenderer renderer;
+  std::string error;
+  if (!renderer.start(graph, path.string(), options, error)) {
+    throw std::runtime_error("Offline render failed to start: " + error);
+  }
+  const auto state = renderer.wait();
+  const auto progress = renderer.progress();
+  if (state == OfflineRenderer::State::kFinished &&
+      (progress.renderedFrames != options.frameCount || progress.writtenFrames != options.frameCount)) {
+    throw std::runtime_error("Finished bounce must report every frame rendered and written");
+  }
+  return state;
+}
+
+void TestBounceWritesWaveFile() {
+  const auto path = TempPath("daft_offline_bounce_test.wav");
+  SceneGraph graph(kSampleRate, 256);
+  BuildPositionGraph(graph);
+  // Pretend realtime playback already ran, so the bounce has to rewind.
+  std::vector<float> left(256);
+  std::vector<float> right(256);
+  float* channels[] = {left.data(), right.data()};
+  graph.render(AudioBufferView(channels, 2, 256));
+
+  OfflineRenderer::Options options;
+  options.frameCount = kBounceFrames;
+  options.workerCount = 2;
+  if (Bounce(graph, path, options) != OfflineRenderer::State::kFinished) {
+    throw std::runtime_error("Offline render did not finish");
+  }
+  if (graph.offlineRendering() || graph.renderWorkerCount() != 0) {
+    throw std::runtime_error("Offline render must hand the graph back in realtime mode");
+  }
+
+  const auto bytes = ReadFile(path);
+  const std::size_t dataBytes = kBounceFrames * 2 * sizeof(float);
+  if (bytes.size() != 44 + dataBytes || std::memcmp(bytes.data(), "RIFF", 4) != 0 ||
+      std::memcmp(bytes.data() + 8, "WAVEfmt ", 8) != 0 || std::memcmp(bytes.data() + 36, "data", 4) != 0) {
+    throw std::runtime_error("Bounce did not produce a WAV file of the expected size");
+  }
+  if (ReadLittleEndian<std::uint32_t>(bytes, 4) != 36 + dataBytes ||
+      ReadLittleEndian<std::uint32_t>(bytes, 40) != dataBytes || ReadLittleEndian<std::uint16_t>(bytes, 20) != 3 ||
+      ReadLittleEndian<std::uint16_t>(bytes, 22) != 2 || ReadLittleEndian<std::uint32_t>(bytes, 24) != 48000) {
+    throw std::runtime_error("WAV header fields are wrong");
+  }
+  for (std::uint64_t frame = 0; frame < kBounceFrames; ++frame) {
+    for (std::size_t ch = 0; ch < 2; ++ch) {
+      const auto sample = ReadLittleEndian<float>(bytes, 44 + (frame * 2 + ch) * sizeof(float));
+      if (sample != ExpectedSample(ch, frame)) {
+        throw std::runtime_error("Bounced sample " + std::to_string(frame) + "/" + std::to_string(ch) + " expected " +
+                                 std::to_string(ExpectedSample(ch, frame)) + " got " + std::to_string(sample));
+      }
+    }
+  }
+  std::filesystem::remove(path);
+}
+
+void TestBounceIsDeterministic() {
+  const auto first = TempPath("daft_offline_bounce_a.wav");
+  const auto second = TempPath("daft_offline_bounce_b.wav");
+  SceneGraph graph(kSampleRate, 128);
+  BuildPositionGraph(graph);
+
+  OfflineRenderer::Options options;
+  options.frameCount = kBounceFrames;
+  options.format = SampleFormat::kInt16;
+  options.blockFrames = 300;
+  Bounce(graph, first, options);
+  Bounce(graph, second, options);
+  const auto firstBytes = ReadFile(first);
+  if (firstBytes.size() != 44 + kBounceFrames * 2 * sizeof(std::int16_t) || firstBytes != ReadFile(second)) {
+    throw std::runtime_error("Bouncing the same graph twice must produce identical files");
+  }
+  std::filesystem::remove(first);
+  std::filesystem::remove(second);
+}
+
+void TestCancelDeletesPartialFile() {
+  const auto path = TempPath("daft_offline_bounce_cancel.wav");
+  std::atomic<bool> open{false};
+  SceneGraph graph(kSampleRate, 256);
+  graph.addNode("gate", std::make_unique<GateNode>(open));
+  graph.connect("gate", std::string(SceneGraph::kOutputBusId));
+
+  OfflineRenderer renderer;
+  OfflineRenderer::Options options;
+  options.frameCount = 10 * 48000;
+  std::string error;
+  if (!renderer.start(graph, path.string(), options, error)) {
+    throw std::runtime_error("Offline render failed to start: " + error);
+  }
+  if (renderer.start(graph, path.string(), options, error) || error.empty()) {
+    throw std::runtime_error("A second bounce must be rejected while one is running");
+  }
+  renderer.cancel();
+  open.store(true, std::memory_order_release);
+  open.notify_all();
+  if (renderer.wait() != OfflineRenderer::State::kCancelled || std::filesystem::exists(path)) {
+    throw std::runtime_error("Cancelled bounce must end cancelled and delete its file");
+  }
+}
+
+void TestInvalidOptionsAreRejected() {
+  SceneGraph graph(kSampleRate, 256);
+  OfflineRenderer renderer;
+  OfflineRenderer::Options options;
+  options.frameCount = 1000;
+  options.format = SampleFormat::kFloat16;
+  std::string error;
+  if (renderer.start(graph, TempPath("daft_offline_bounce_invalid.wav").string(), options, error) ||
+      error.empty()) {
+    throw std::runtime_error("Float16 WAV output must be rejected");
+  }
+  options.format = SampleFormat::kFloat32;
+  options.channelCount = graph.maxSupportedChannels() + 1;
+  if (renderer.start(graph, TempPath("daft_offline_bounce_invalid.wav").string(), options, error)) {
+    throw std::runtime_error("Channel counts above the graph limit must be rejected");
+  }
+  if (renderer.start(graph, "/nonexistent/daft/bounce.wav", {1000}, error) || graph.offlineRendering()) {
+    throw std::runtime_error("An unwritable path must be rejected without touching the graph");
+  }
+}
+
+}  // namespace
+
+void RunOfflineRendererTests() {
+  TestBounceWritesWaveFile();
+  TestBounceIsDeterministic();
+  TestCancelDeletesPartialFile();
+  TestInvalidOptionsAreRejected();
+}
+
+}  // namespace daft::audio::tests
@@ -1,9 +1,16 @@
 #include "audio_engine/PluginNode.h"
+#include "audio_engine/SceneGraph.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace daft::audio::tests {
@@ -48,6 +55,12 @@ void AssertSamples(const std::vector<float>& actual, const std::vector<float>& e
   }
 }
 
+// Source writing a constant to every channel.
+class DcNode final : public DSPNode {
+ public:
+  void process(AudioBufferView buffer) override { buffer.fill(1.0F); }
+};
+
 std::vector<float> RenderBuffer(PluginNode& node) {
   float channelData[4] = {0.25F, 0.5F, 0.75F, 1.0F};
   float* channels[] = {channelData};
@@ -233,6 +246,470 @@ void TestSetParameterUpdatesHostInstanceId() {
   if (node.hostInstanceId() != "42") {
     throw std::runtime_error("hostInstanceId parameter should update node host instance identifier");
   }
+
+  // Rebinding resolves through the host, so the graph never lets it reach the audio thread.
+  auto plugin = std::make_unique<PluginNode>("initial-instance", capabilities);
+  auto* bound = plugin.get();
+  SceneGraph graph(48000.0, 4);
+  graph.addNode("plugin", std::move(plugin));
+  const auto parameter = graph.findParameter("plugin", "hostinstanceid");
+  bool rejected = false;
+  try {
+    graph.scheduleAutomation("plugin", parameter, 0, 7.0);
+  } catch (const std::invalid_argument&) {
+    rejected = true;
+  }
+  if (!rejected) {
+    throw std::runtime_error("hostInstanceId must not be schedulable as automation");
+  }
+  graph.setParameter("plugin", parameter, 7.0);
+  if (bound->hostInstanceId() != "7") {
+    throw std::runtime_error("Setting hostInstanceId on a live node should rebind on the control thread");
+  }
+}
+
+struct EventContext {
+  std::vector<std::vector<PluginEvent>> blocks;
+  std::size_t sidechainCount = 0;
+  float sidechainSample = 0.0F;
+};
+
+PluginRenderResult RecordingRenderCallback(PluginRenderRequest& request, void* userData) {
+  auto* context = static_cast<EventContext*>(userData);
+  const auto events = request.inputEvents->events();
+  context->blocks.emplace_back(events.begin(), events.end());
+  context->sidechainCount = request.sidechainBuffers.size();
+  if (!request.sidechainBuffers.empty()) {
+    context->sidechainSample = request.sidechainBuffers.front().channel(0)[0];
+  }
+  // Echo every MIDI input one frame later, the way an arpeggiator or MIDI effect would.
+  for (const auto& event : events) {
+    if (event.type == PluginEventType::kMidi) {
+      request.outputEvents->push(PluginEvent::Midi(event.sampleOffset + 1, event.midi[0], event.midi[1]));
+    }
+  }
+  return PluginRenderResult{true, false};
+}
+
+void TestQueuedEventsCarrySampleOffsets() {
+  EventContext context;
+  PluginHostBridge::SetRenderCallback(&RecordingRenderCallback, &context);
+
+  PluginBusCapabilities capabilities{};
+  capabilities.acceptsMidi = true;
+  capabilities.emitsMidi = true;
+  capabilities.emitsAudio = true;
+  PluginNode node("instrument", capabilities);
+  node.prepare(48000.0);
+
+  if (!node.queueEvent(6, PluginEvent::Parameter(0, 7, 0.5F)) ||
+      !node.queueEvent(2, PluginEvent::Midi(0, 0x90, 60, 100)) || !node.queueEvent(2, PluginEvent::Midi(0, 0x80, 60))) {
+    throw std::runtime_error("Queueing plugin events failed");
+  }
+  RenderBuffer(node);
+  RenderBuffer(node);
+  if (context.blocks.size() != 2 || context.blocks[0].size() != 2 || context.blocks[1].size() != 1) {
+    throw std::runtime_error("Events were not delivered with the blocks containing their frames");
+  }
+  const auto& first = context.blocks[0];
+  if (first[0].sampleOffset != 2 || first[0].midi[0] != 0x90 || first[1].sampleOffset != 2 ||
+      first[1].midi[0] != 0x80) {
+    throw std::runtime_error("MIDI events lost their offsets or their queueing order");
+  }
+  const auto& parameter = context.blocks[1][0];
+  if (parameter.type != PluginEventType::kParameter || parameter.sampleOffset != 2 || parameter.parameterId != 7 ||
+      parameter.value != 0.5F) {
+    throw std::runtime_error("Parameter change was not delivered at its sample offset");
+  }
+  if (node.outputEvents().size() != 0) {
+    throw std::runtime_error("Output events must be cleared at the start of every block");
+  }
+
+  // An event whose frame already passed plays at the start of the next block.
+  node.queueEvent(1, PluginEvent::Midi(0, 0x90, 64, 90));
+  RenderBuffer(node);
+  if (context.blocks[2].size() != 1 || context.blocks[2][0].sampleOffset != 0) {
+    throw std::runtime_error("Late events must play at offset zero");
+  }
+  const auto output = node.outputEvents().events();
+  if (output.size() != 1 || output[0].sampleOffset != 1 || output[0].midi[1] != 64) {
+    throw std::runtime_error("Host MIDI output was not returned through the output event list");
+  }
+
+  PluginHostBridge::ClearRenderCallback();
+}
+
+void TestSidechainInputsReachHost() {
+  EventContext context;
+  PluginHostBridge::SetRenderCallback(&RecordingRenderCallback, &context);
+
+  PluginBusCapabilities capabilities{};
+  capabilities.acceptsAudio = true;
+  capabilities.emitsAudio = true;
+  capabilities.acceptsSidechain = true;
+  PluginNode node("compressor", capabilities);
+  node.prepare(48000.0);
+  if (!node.mixesInputs()) {
+    throw std::runtime_error("Sidechain-capable plugins must receive their inputs separately");
+  }
+
+  float mainData[4] = {0.1F, 0.2F, 0.3F, 0.4F};
+  float keyData[4] = {0.9F, 0.9F, 0.9F, 0.9F};
+  float outputData[4] = {};
+  float* mainChannels[] = {mainData};
+  float* keyChannels[] = {keyData};
+  float* outputChannels[] = {outputData};
+  const AudioBufferView inputs[] = {AudioBufferView(mainChannels, 1, 4), AudioBufferView(keyChannels, 1, 4)};
+  node.processInputs(inputs, AudioBufferView(outputChannels, 1, 4));
+  AssertSamples({outputData, outputData + 4}, {0.1F, 0.2F, 0.3F, 0.4F}, 1e-6F, "Main bus feeds the plugin buffer");
+  if (context.sidechainCount != 1 || context.sidechainSample != 0.9F) {
+    throw std::runtime_error("Sidechain input was not forwarded to the host");
+  }
+
+  PluginHostBridge::ClearRenderCallback();
+}
+
+struct BatchContext {
+  int batchCalls = 0;
+  std::size_t largestBatch = 0;
+};
+
+void FillBatchRenderCallback(PluginRenderRequest* const* requests, PluginRenderResult* results, std::size_t count,
+                             void* userData) {
+  auto* context = static_cast<BatchContext*>(userData);
+  ++context->batchCalls;
+  context->largestBatch = std::max(context->largestBatch, count);
+  for (std::size_t i = 0; i < count; ++i) {
+    requests[i]->audioBuffer.fill(0.25F);
+    results[i] = PluginRenderResult{true, false};
+  }
+}
+
+void TestParallelLevelRendersPluginsInOneBatch() {
+  BatchContext context;
+  PluginHostBridge::SetBatchRenderCallback(&FillBatchRenderCallback, &context);
+
+  PluginBusCapabilities capabilities{};
+  capabilities.acceptsMidi = true;
+  capabilities.emitsAudio = true;
+  SceneGraph graph(48000.0, 16);
+  graph.setRenderWorkerCount(2);
+  for (const auto* id : {"synth-a", "synth-b", "synth-c"}) {
+    graph.addNode(id, std::make_unique<PluginNode>(id, capabilities));
+    graph.connect(id, std::string(SceneGraph::kOutputBusId));
+  }
+
+  std::vector<float> left(16);
+  float* channels[] = {left.data()};
+  graph.render(AudioBufferView(channels, 1, 16));
+  AssertSamples(left, std::vector<float>(16, 0.75F), 1e-6F, "Batched plugins sum into the output");
+  if (context.batchCalls != 1 || context.largestBatch != 3) {
+    throw std::runtime_error("Independent plugins should render in a single batch call");
+  }
+
+  // Without a batch callback every plugin goes through the per-instance callback again.
+  PluginHostBridge::ClearBatchRenderCallback();
+  RenderContext single;
+  PluginHostBridge::SetRenderCallback(&GainRenderCallback, &single);
+  graph.render(AudioBufferView(channels, 1, 16));
+  if (context.batchCalls != 1 || single.callCount != 3) {
+    throw std::runtime_error("Plugins must fall back to per-instance rendering");
+  }
+
+  PluginHostBridge::ClearRenderCallback();
+  graph.setRenderWorkerCount(0);
+}
+
+void TestRenderBatchFallsBackToSingleCallback() {
+  RenderContext context;
+  context.gain = 2.0F;
+  PluginHostBridge::SetRenderCallback(&GainRenderCallback, &context);
+
+  float first[1] = {0.5F};
+  float second[1] = {0.25F};
+  float* firstChannels[] = {first};
+  float* secondChannels[] = {second};
+  PluginRenderRequest a{"a", AudioBufferView(firstChannels, 1, 1), 48000.0};
+  PluginRenderRequest b{"b", AudioBufferView(secondChannels, 1, 1), 48000.0};
+  PluginRenderRequest* requests[] = {&a, &b};
+  PluginRenderResult results[2];
+  if (!PluginHostBridge::RenderBatch(requests, results) || !results[0].success || !results[1].success ||
+      context.callCount != 2 || first[0] != 1.0F || second[0] != 0.5F) {
+    throw std::runtime_error("RenderBatch must render each request through the single callback");
+  }
+
+  PluginHostBridge::ClearRenderCallback();
+  if (PluginHostBridge::RenderBatch(requests, results)) {
+    throw std::runtime_error("RenderBatch must report a missing host");
+  }
+}
+
+struct ResolveContext {
+  int resolveCalls = 0;
+  std::vector<PluginInstanceHandle> renderedHandles;
+};
+
+PluginInstanceHandle ResolveById(std::string_view hostInstanceId, void* userData) {
+  ++static_cast<ResolveContext*>(userData)->resolveCalls;
+  return hostInstanceId == "synth" ? 11 : hostInstanceId == "42" ? 42 : kInvalidPluginInstanceHandle;
+}
+
+PluginRenderResult RecordHandleCallback(PluginRenderRequest& request, void* userData) {
+  auto* context = static_cast<ResolveContext*>(userData);
+  context->renderedHandles.push_back(request.instanceHandle);
+  return PluginRenderResult{true, false};
+}
+
+void TestInstanceHandleResolvedOnBind() {
+  ResolveContext context;
+  PluginHostBridge::SetResolveCallback(&ResolveById, &context);
+  PluginHostBridge::SetRenderCallback(&RecordHandleCallback, &context);
+
+  PluginBusCapabilities capabilities{};
+  capabilities.emitsAudio = true;
+  PluginNode node("synth", capabilities);
+  node.prepare(48000.0);
+  const int boundCalls = context.resolveCalls;
+  RenderBuffer(node);
+  RenderBuffer(node);
+  if (context.resolveCalls != boundCalls || node.instanceHandle() != 11 ||
+      context.renderedHandles != std::vector<PluginInstanceHandle>{11, 11}) {
+    throw std::runtime_error("Renders must reuse the handle resolved when the node was bound");
+  }
+
+  // Rebinding swaps the id and its handle together.
+  node.setParameter("hostInstanceId", 42.0);
+  RenderBuffer(node);
+  if (context.renderedHandles.back() != 42) {
+    throw std::runtime_error("Rebinding did not publish the new handle");
+  }
+
+  // Invalidated handles are withheld until the node is bound again.
+  PluginHostBridge::InvalidateHandles();
+  RenderBuffer(node);
+  if (context.renderedHandles.back() != kInvalidPluginInstanceHandle) {
+    throw std::runtime_error("Invalidated handles must not reach the host");
+  }
+  node.prepare(48000.0);
+  RenderBuffer(node);
+  if (context.renderedHandles.back() != 42) {
+    throw std::runtime_error("Preparing the node must resolve its handle again");
+  }
+
+  const std::string overlong(PluginNode::kMaxHostInstanceIdLength + 1, 'x');
+  if (node.setHostInstanceId(overlong) || node.hostInstanceId() != "42") {
+    throw std::runtime_error("Overlong host instance ids must be rejected");
+  }
+
+  PluginHostBridge::ClearRenderCallback();
+  PluginHostBridge::ClearResolveCallback();
+}
+
+PluginRenderResult SlowRenderCallback(PluginRenderRequest&, void*) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  return PluginRenderResult{true, false};
+}
+
+void TestAnticipativeModeDelaysByLatency() {
+  RenderContext context;
+  context.gain = 2.0F;
+  PluginHostBridge::SetRenderCallback(&GainRenderCallback, &context);
+
+  constexpr std::size_t kBlock = 16;
+  PluginBusCapabilities capabilities{};
+  capabilities.acceptsAudio = true;
+  capabilities.emitsAudio = true;
+  {
+    PluginNode node("convolver", capabilities);
+    node.enableAnticipation(2 * kBlock);
+    node.prepare(48000.0);
+    if (!node.anticipative() || node.latencyFrames() != 2 * kBlock) {
+      throw std::runtime_error("Anticipative mode must report its latency");
+    }
+
+    for (std::size_t block = 0; block < 6; ++block) {
+      std::vector<float> samples(kBlock);
+      for (std::size_t i = 0; i < kBlock; ++i) {
+        samples[i] = static_cast<float>(block * kBlock + i) * 0.001F;
+      }
+      float* channels[] = {samples.data()};
+      node.process(AudioBufferView(channels, 1, kBlock));
+      std::vector<float> expected(kBlock, 0.0F);
+      if (block >= 2) {
+        for (std::size_t i = 0; i < kBlock; ++i) {
+          expected[i] = static_cast<float>((block - 2) * kBlock + i) * 0.002F;
+        }
+      }
+      AssertSamples(samples, expected, 1e-6F, "Anticipated block " + std::to_string(block));
+      // Give the worker the block period it would have in a live callback.
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    if (node.anticipationUnderruns() != 0) {
+      throw std::runtime_error("Anticipative rendering should keep up without underruns");
+    }
+  }
+  // Destroying the node joins its worker, so every host call has finished.
+  if (context.callCount != 6) {
+    throw std::runtime_error("Every anticipated block should reach the host once");
+  }
+
+  PluginHostBridge::ClearRenderCallback();
+}
+
+void TestAnticipativeModeCountsLateBlocks() {
+  PluginHostBridge::SetRenderCallback(&SlowRenderCallback, nullptr);
+  PluginBusCapabilities capabilities{};
+  capabilities.acceptsAudio = true;
+  capabilities.emitsAudio = true;
+  {
+    PluginNode node("amp-model", capabilities);
+    node.enableAnticipation(4);
+    node.prepare(48000.0);
+    RenderBuffer(node);
+    const auto late = RenderBuffer(node);
+    AssertSamples(late, {0.0F, 0.0F, 0.0F, 0.0F}, 0.0F, "Late anticipated block");
+    if (node.anticipationUnderruns() != 1) {
+      throw std::runtime_error("A block the worker has not finished must count as an underrun");
+    }
+  }
+  {
+    // Offline there is no deadline: the same slow host delays the block instead of silencing it.
+    PluginNode node("amp-model", capabilities);
+    node.enableAnticipation(4);
+    node.prepare(48000.0);
+    node.setOfflineRendering(true);
+    RenderBuffer(node);
+    AssertSamples(RenderBuffer(node), {0.25F, 0.5F, 0.75F, 1.0F}, 0.0F, "Offline anticipated block");
+    if (node.anticipationUnderruns() != 0) {
+      throw std::runtime_error("Offline anticipative rendering must wait for the worker");
+    }
+  }
+  PluginHostBridge::ClearRenderCallback();
+}
+
+void TestAnticipationFollowsGraphLimits() {
+  RenderContext context;
+  context.gain = 2.0F;
+  PluginHostBridge::SetRenderCallback(&GainRenderCallback, &context);
+  PluginBusCapabilities capabilities{};
+  capabilities.acceptsAudio = true;
+  capabilities.emitsAudio = true;
+
+  // Eight channels and 4096-frame blocks exceed the default rings; the graph resizes them on addNode.
+  constexpr std::size_t kChannels = 8;
+  constexpr std::size_t kFrames = 4096;
+  constexpr std::uint32_t kLatency = 16;
+  auto plugin = std::make_unique<PluginNode>("reverb", capabilities);
+  auto* node = plugin.get();
+  plugin->enableAnticipation(kLatency);
+  SceneGraph graph(48000.0, 256, kChannels, kFrames);
+  graph.addNode("dc", std::make_unique<DcNode>());
+  graph.addNode("reverb", std::move(plugin));
+  graph.connect("dc", "reverb");
+  graph.connect("reverb", std::string(SceneGraph::kOutputBusId));
+  graph.setOfflineRendering(true);
+
+  std::vector<float> samples(kChannels * kFrames, -1.0F);
+  std::vector<float*> channels(kChannels);
+  for (std::size_t ch = 0; ch < kChannels; ++ch) {
+    channels[ch] = samples.data() + ch * kFrames;
+  }
+  graph.render(AudioBufferView(channels.data(), kChannels, kFrames));
+  for (std::size_t ch = 0; ch < kChannels; ++ch) {
+    for (std::size_t i = 0; i < kFrames; ++i) {
+      const float expected = i < kLatency ? 0.0F : 2.0F;
+      if (channels[ch][i] != expected) {
+        throw std::runtime_error("Anticipated channel " + std::to_string(ch) + " frame " + std::to_string(i) +
+                                 " expected " + std::to_string(expected) + " got " +
+                                 std::to_string(channels[ch][i]));
+      }
+    }
+  }
+  if (node->anticipationUnderruns() != 0) {
+    throw std::runtime_error("Blocks within the graph's limits must not underrun");
+  }
+  graph.setOfflineRendering(false);
+  PluginHostBridge::ClearRenderCallback();
+}
+
+void TestAnticipationRebindsWhileHostUnavailable() {
+  PluginHostBridge::ClearRenderCallback();
+  PluginBusCapabilities capabilities{};
+  capabilities.acceptsAudio = true;
+  capabilities.emitsAudio = true;
+
+  // Live pacing, so the worker logs failed renders while the audio thread adopts the control thread's
+  // rebinds. It must log the id of the binding it rendered with, never read the slots those two trade.
+  constexpr std::size_t kBlocks = 256;
+  constexpr int kRebinds = 32;
+  PluginNode node("tape-a", capabilities);
+  node.enableAnticipation(64);
+  node.prepare(48000.0);
+  std::atomic<bool> rendering{true};
+  std::thread audio([&] {
+    for (std::size_t block = 0; block < kBlocks; ++block) {
+      RenderBuffer(node);
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    rendering.store(false, std::memory_order_release);
+  });
+  for (int i = 0; i < kRebinds && rendering.load(std::memory_order_acquire); ++i) {
+    node.setHostInstanceId(i % 2 == 0 ? "tape-b" : "tape-a");
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+  }
+  audio.join();
+
+  // Offline, every block waits for the worker, which passes audio through while the host is away.
+  node.setOfflineRendering(true);
+  for (int block = 0; block < 16; ++block) {
+    RenderBuffer(node);
+  }
+  AssertSamples(RenderBuffer(node), {0.25F, 0.5F, 0.75F, 1.0F}, 0.0F, "Unhosted anticipated block");
+}
+
+PluginRenderResult LookaheadRenderCallback(PluginRenderRequest&, void* userData) {
+  PluginRenderResult result{true, false};
+  result.latencyFrames = *static_cast<std::uint32_t*>(userData);
+  return result;
+}
+
+void TestReportedLatencyReachesGraph() {
+  std::uint32_t hostLatency = 96;
+  PluginHostBridge::SetRenderCallback(&LookaheadRenderCallback, &hostLatency);
+  PluginBusCapabilities capabilities{};
+  capabilities.acceptsAudio = true;
+  capabilities.emitsAudio = true;
+
+  auto plugin = std::make_unique<PluginNode>("limiter", capabilities);
+  auto* node = plugin.get();
+  node->setParameter(PluginNode::kLatencyFrames, 32.0);
+  if (node->latencyFrames() != 32 || node->maxLatencyFrames() != PluginNode::kMaxReportedLatencyFrames) {
+    throw std::runtime_error("Declared plugin latency should be reported before the first render");
+  }
+
+  SceneGraph graph(48000.0, 4);
+  graph.addNode("limiter", std::move(plugin));
+  graph.addNode("dry", std::make_unique<GainNode>());
+  graph.connect("limiter", std::string(SceneGraph::kOutputBusId));
+  graph.connect("dry", std::string(SceneGraph::kOutputBusId));
+  std::vector<float> samples(4);
+  float* channels[] = {samples.data()};
+  graph.render(AudioBufferView(channels, 1, 4));
+  if (node->latencyFrames() != 96) {
+    throw std::runtime_error("Host-reported latency should replace the declared one");
+  }
+  // The graph applies a changed latency from the block after the host reported it.
+  graph.render(AudioBufferView(channels, 1, 4));
+  if (graph.outputLatencyFrames() != 96) {
+    throw std::runtime_error("Output latency should include the plugin's reported latency");
+  }
+  node->setBypassed(true);
+  graph.render(AudioBufferView(channels, 1, 4));
+  if (node->latencyFrames() != 0 || graph.outputLatencyFrames() != 0) {
+    throw std::runtime_error("A bypassed plugin passes through without latency");
+  }
+
+  PluginHostBridge::ClearRenderCallback();
 }
 
 }  // namespace
@@ -246,6 +723,16 @@ void RunPluginNodeTests() {
   TestBypassSkipsHost();
   TestBypassToggleDuringProcessing();
   TestSetParameterUpdatesHostInstanceId();
+  TestQueuedEventsCarrySampleOffsets();
+  TestSidechainInputsReachHost();
+  TestParallelLevelRendersPluginsInOneBatch();
+  TestRenderBatchFallsBackToSingleCallback();
+  TestInstanceHandleResolvedOnBind();
+  TestAnticipativeModeDelaysByLatency();
+  TestAnticipativeModeCountsLateBlocks();
+  TestAnticipationFollowsGraphLimits();
+  TestAnticipationRebindsWhileHostUnavailable();
+  TestReportedLatencyReachesGraph();
 }
 
 }  // namespace daft::audio::tests
@@ -0,0 +1,151 @@
+#include "audio_engine/RealtimeSafety.h"
+#include "audio_engine/SceneGraph.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace daft::audio::tests {
+
+#if defined(DAFT_AUDIO_ENGINE_REALTIME_CHECKS)
+namespace {
+
+constexpr std::size_t kFrames = 128;
+
+std::atomic<int> gViolations{0};
+std::atomic<int> gWorkerViolations{0};
+std::thread::id gMainThread;
+
+void CountViolation(const char*) noexcept {
+  gViolations.fetch_add(1);
+  if (std::this_thread::get_id() != gMainThread) {
+    gWorkerViolations.fetch_add(1);
+  }
+}
+
+// Swaps in the counting handler so deliberate violations do not fail the run.
+class CountingHandler {
+ public:
+  CountingHandler() : previous_(SetRealtimeViolationHandler(&CountViolation)) {
+    gViolations = 0;
+    gWorkerViolations = 0;
+    gMainThread = std::this_thread::get_id();
+  }
+  ~CountingHandler() { SetRealtimeViolationHandler(previous_); }
+
+  CountingHandler(const CountingHandler&) = delete;
+  CountingHandler& operator=(const CountingHandler&) = delete;
+
+ private:
+  RealtimeViolationHandler previous_;
+};
+
+// Reports itself, then stays busy long enough for render workers to wake up and claim some nodes.
+class UnsafeNode final : public DSPNode {
+ public:
+  void process(AudioBufferView) override {
+    CheckRealtimeSafe("UnsafeNode::process");
+    const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(50);
+    while (std::chrono::steady_clock::now() < until) {
+    }
+  }
+};
+
+void Expect(bool condition, const std::string& message) {
+  if (!condition) {
+    throw std::runtime_error(message);
+  }
+}
+
+void Render(SceneGraph& graph) {
+  std::vector<float> left(kFrames);
+  std::vector<float> right(kFrames);
+  float* channels[] = {left.data(), right.data()};
+  graph.render(AudioBufferView(channels, 2, kFrames));
+}
+
+// Expectations are checked after each scope closes: building their messages allocates.
+void TestScopesMarkTheThread() {
+  const CountingHandler handler;
+  CheckRealtimeSafe("unmarked");
+  Expect(gViolations == 0 && !IsRealtimeThread(), "Unmarked threads should not report");
+  bool marked = false;
+  {
+    const ScopedRealtimeThread realtime;
+    marked = IsRealtimeThread();
+    CheckRealtimeSafe("marked");
+    {
+      const ScopedRealtimeExemption exemption;
+      CheckRealtimeSafe("exempt");
+    }
+    const ScopedRealtimeThread inactive(false);
+  }
+  Expect(marked && !IsRealtimeThread(), "The scope should mark the thread while it lives");
+  Expect(gViolations == 1, "Only the marked, non-exempt check should report");
+}
+
+void TestTrapsAllocationsAndLocks() {
+  const CountingHandler handler;
+  std::mutex mutex;
+  int afterAllocation = 0;
+  {
+    const ScopedRealtimeThread realtime;
+    auto value = std::make_unique<int>(1);
+    afterAllocation = gViolations;
+    const std::lock_guard<std::mutex> lock(mutex);
+  }
+  const int afterLock = gViolations;
+  if (RealtimeAllocationChecksInstalled()) {
+    Expect(afterAllocation == 1, "operator new on a marked thread should be reported");
+  }
+  if (RealtimeLockChecksInstalled()) {
+    Expect(afterLock == afterAllocation + 1, "Locking a mutex on a marked thread should be reported");
+  }
+  auto unmarked = std::make_unique<int>(2);
+  const std::lock_guard<std::mutex> lock(mutex);
+  Expect(gViolations == afterLock, "Unmarked allocations and locks should not be reported");
+}
+
+void TestRenderMarksAudioAndWorkerThreads() {
+  const CountingHandler handler;
+  SceneGraph graph(48000.0, kFrames);
+  for (int i = 0; i < 8; ++i) {
+    const auto id = "unsafe" + std::to_string(i);
+    graph.addNode(id, std::make_unique<UnsafeNode>());
+    graph.connect(id, std::string(SceneGraph::kOutputBusId));
+  }
+
+  Render(graph);
+  Expect(gViolations == 8 && gWorkerViolations == 0, "Serial render should check every node on the audio thread");
+
+  graph.setRenderWorkerCount(2);
+  gViolations = 0;
+  for (int block = 0; block < 50 && gWorkerViolations == 0; ++block) {
+    Render(graph);
+  }
+  Expect(gWorkerViolations > 0, "Render workers should inherit the audio thread's mark");
+
+  graph.setOfflineRendering(true);
+  gViolations = 0;
+  Render(graph);
+  Expect(gViolations == 0, "Offline renders have no deadline and should not be checked");
+  graph.setOfflineRendering(false);
+}
+
+}  // namespace
+#endif
+
+void RunRealtimeSafetyTests() {
+#if defined(DAFT_AUDIO_ENGINE_REALTIME_CHECKS)
+  TestScopesMarkTheThread();
+  TestTrapsAllocationsAndLocks();
+  TestRenderMarksAudioAndWorkerThreads();
+#endif
+}
+
+}  // namespace daft::audio::tests
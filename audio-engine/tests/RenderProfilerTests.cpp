@@ -0,0 +1,129 @@
+#include "audio_engine/RenderProfiler.h"
+#include "audio_engine/SceneGraph.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace daft::audio::tests {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kFrames = 256;
+
+// Burns a fixed amount of wall-clock time per block, standing in for an expensive node.
+class BusyNode final : public DSPNode {
+ public:
+  explicit BusyNode(std::chrono::microseconds cost) : cost_(cost) {}
+
+  void process(AudioBufferView) override {
+    const auto until = std::chrono::steady_clock::now() + cost_;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+  }
+
+ private:
+  std::chrono::microseconds cost_;
+};
+
+void Expect(bool condition, const std::string& message) {
+  if (!condition) {
+    throw std::runtime_error(message);
+  }
+}
+
+void RenderBlocks(SceneGraph& graph, std::size_t blocks) {
+  std::vector<float> left(kFrames);
+  std::vector<float> right(kFrames);
+  float* channels[] = {left.data(), right.data()};
+  for (std::size_t i = 0; i < blocks; ++i) {
+    graph.render(AudioBufferView(channels, 2, kFrames));
+  }
+}
+
+void TestHistogramPercentiles() {
+  LogHistogram histogram;
+  Expect(histogram.percentile(0.5) == 0 && histogram.mean() == 0.0, "An empty histogram reports zeros");
+  for (std::uint64_t value = 1; value <= 1000; ++value) {
+    histogram.record(value);
+  }
+  const auto p50 = static_cast<double>(histogram.percentile(0.5));
+  const auto p99 = static_cast<double>(histogram.percentile(0.99));
+  Expect(histogram.count() == 1000 && histogram.max() == 1000 && histogram.mean() == 500.5,
+         "Histogram should track count, max and mean exactly");
+  Expect(p50 >= 500.0 && p50 <= 500.0 * 1.125, "p50 should be within one bucket above the true median");
+  Expect(p99 >= 990.0 && p99 <= 1000.0, "p99 should be capped at the largest sample");
+  Expect(histogram.percentile(0.0) == 1, "The smallest bucket is exact");
+
+  LogHistogram huge;
+  huge.record(~std::uint64_t{0});
+  Expect(huge.percentile(1.0) == ~std::uint64_t{0}, "Values past the last bucket are clamped to the maximum");
+}
+
+void TestProfilesBlocksAndNodes(std::size_t workers) {
+  SceneGraph graph(kSampleRate, kFrames);
+  graph.addNode("slow", std::make_unique<BusyNode>(std::chrono::microseconds(300)));
+  graph.addNode("fast", std::make_unique<BusyNode>(std::chrono::microseconds(0)));
+  graph.connect("slow", std::string(SceneGraph::kOutputBusId));
+  graph.connect("fast", std::string(SceneGraph::kOutputBusId));
+  graph.setRenderWorkerCount(workers);
+
+  Expect(!graph.renderProfile().enabled, "Profiling should be off by default");
+  RenderBlocks(graph, 4);
+  graph.setProfilingEnabled(true);
+  RenderBlocks(graph, 20);
+  graph.recordRenderError();
+  RenderBlocks(graph, 1);
+
+  const auto report = graph.renderProfile();
+  const auto context = " (" + std::to_string(workers) + " workers)";
+  Expect(report.enabled && report.blocks == 21 && report.droppedRecords == 0,
+         "Every profiled block should be recorded" + context);
+  Expect(report.renderMicros.mean >= 300.0 && report.renderMicros.p99 >= report.renderMicros.p50,
+         "Block render time should include the slow node" + context);
+  // A preempted block may still overrun on a busy host, so only the median is held to the budget.
+  Expect(report.dspLoad.mean > 0.0 && report.dspLoad.p50 < 1.0 && report.overloads < report.blocks,
+         "DSP load should be a fraction of the block duration" + context);
+  // The error resets the callback chain, so the block after it has no jitter sample.
+  Expect(report.callbackJitterMicros.count == 19 && report.renderErrors == 1,
+         "Jitter should be measured between consecutive callbacks" + context);
+  Expect(report.nodes.size() == 2 && report.nodes[0].id == "slow" && report.nodes[1].id == "fast",
+         "Nodes should be reported slowest first" + context);
+  Expect(report.nodes[0].renderMicros.count == 21 && report.nodes[0].renderMicros.p50 >= 300.0 &&
+             report.nodes[1].renderMicros.mean < report.nodes[0].renderMicros.mean,
+         "Per-node render time should be attributed to the node that spent it" + context);
+
+  graph.removeNode("fast");
+  Expect(graph.renderProfile().nodes.size() == 1, "Removed nodes should drop out of the profile");
+  graph.setProfilingEnabled(false);
+  Expect(!graph.renderProfile().enabled, "Disabling should drop the profile");
+  RenderBlocks(graph, 2);
+  graph.setProfilingEnabled(true);
+  Expect(graph.renderProfile().blocks == 0, "Re-enabling should start from empty histograms");
+}
+
+void TestOverloadsAreCounted() {
+  SceneGraph graph(kSampleRate, kFrames);
+  // Longer than the 5.3 ms a 256-frame block lasts at 48 kHz.
+  graph.addNode("overload", std::make_unique<BusyNode>(std::chrono::microseconds(6000)));
+  graph.connect("overload", std::string(SceneGraph::kOutputBusId));
+  graph.setProfilingEnabled(true);
+  RenderBlocks(graph, 3);
+  const auto report = graph.renderProfile();
+  Expect(report.overloads == 3 && report.dspLoad.p50 > 1.0, "Blocks past their deadline should count as overloads");
+}
+
+}  // namespace
+
+void RunRenderProfilerTests() {
+  TestHistogramPercentiles();
+  TestProfilesBlocksAndNodes(0);
+  TestProfilesBlocksAndNodes(2);
+  TestOverloadsAreCounted();
+}
+
+}  // namespace daft::audio::tests
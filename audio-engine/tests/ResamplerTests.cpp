@@ -0,0 +1,152 @@
+#include "audio_engine/AudioBuffer.h"
+#include "audio_engine/DSPNode.h"
+#include "audio_engine/Resampler.h"
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace daft::audio::tests {
+namespace {
+
+constexpr double kEngineRate = 48000.0;
+
+std::vector<float> Sine(std::size_t frames, double frequency, double sampleRate) {
+  std::vector<float> samples(frames);
+  for (std::size_t i = 0; i < frames; ++i) {
+    samples[i] = static_cast<float>(std::sin(2.0 * std::numbers::pi * frequency * static_cast<double>(i) / sampleRate));
+  }
+  return samples;
+}
+
+ClipPlayerNode::ClipBufferData CreateClip(std::vector<float> samples, double sampleRate) {
+  auto storage = std::make_shared<std::vector<float>>(std::move(samples));
+  ClipPlayerNode::ClipBufferData data;
+  data.key = "resampled";
+  data.sampleRate = sampleRate;
+  data.frameCount = storage->size();
+  data.channels = {storage->data()};
+  data.owner = storage;
+  return data;
+}
+
+std::vector<float> Render(ClipPlayerNode& node, std::size_t frames) {
+  std::vector<float> rendered;
+  while (rendered.size() < frames) {
+    StackAudioBuffer<1, 128> buffer;
+    const auto count = std::min<std::size_t>(128, frames - rendered.size());
+    buffer.setFrameCount(count);
+    buffer.clear();
+    float* channels[] = {buffer.channel(0)};
+    node.process(AudioBufferView(channels, 1, count));
+    rendered.insert(rendered.end(), buffer.channel(0), buffer.channel(0) + count);
+  }
+  return rendered;
+}
+
+void TestConversionTracksAnalyticSine() {
+  // A 44.1 kHz clip in a 48 kHz session must come out as the same tone sampled at 48 kHz.
+  constexpr double kClipRate = 44100.0;
+  constexpr double kFrequency = 1000.0;
+  const std::pair<ResampleQuality, float> qualities[] = {{ResampleQuality::kSinc, 5e-4F},
+                                                          {ResampleQuality::kLinear, 5e-3F}};
+  for (const auto& [quality, tolerance] : qualities) {
+    ClipPlayerNode node;
+    node.prepare(kEngineRate);
+    node.setClipBuffer(CreateClip(Sine(4410, kFrequency, kClipRate), kClipRate));
+    node.setParameter("endframe", 1e6);
+    node.setParameter("resamplequality", quality == ResampleQuality::kSinc ? 1.0 : 0.0);
+
+    const auto rendered = Render(node, 4900);
+    const auto expected = Sine(rendered.size(), kFrequency, kEngineRate);
+    // Skip the filter's ramp-in and ring-out against the clip edges.
+    for (std::size_t i = 64; i < 4700; ++i) {
+      if (std::fabs(rendered[i] - expected[i]) > tolerance) {
+        throw std::runtime_error(std::string(quality == ResampleQuality::kSinc ? "Sinc" : "Linear") +
+                                 " conversion diverges at frame " + std::to_string(i) + ": expected " +
+                                 std::to_string(expected[i]) + " got " + std::to_string(rendered[i]));
+      }
+    }
+    // 4410 clip frames last 4800 session frames.
+    if (rendered[4799] == 0.0F || rendered[4800] != 0.0F) {
+      throw std::runtime_error("Converted clip has the wrong duration");
+    }
+  }
+}
+
+void TestVarispeedChangesDurationAndHoldsLevel() {
+  ClipPlayerNode node;
+  node.prepare(kEngineRate);
+  node.setClipBuffer(CreateClip(std::vector<float>(1000, 0.5F), kEngineRate));
+  node.setParameter("startframe", 10.0);
+  node.setParameter("endframe", 1e6);
+  node.setParameter("playbackrate", 2.0);
+
+  const auto rendered = Render(node, 600);
+  for (std::size_t i = 0; i < rendered.size(); ++i) {
+    const bool playing = i >= 10 && i < 510;
+    // The filter settles within its half-length of each clip edge.
+    const bool settled = i >= 10 + 16 && i < 510 - 16;
+    if ((!playing && rendered[i] != 0.0F) || (settled && std::fabs(rendered[i] - 0.5F) > 1e-3F)) {
+      throw std::runtime_error("Double-speed playback is wrong at frame " + std::to_string(i) + ": got " +
+                               std::to_string(rendered[i]));
+    }
+  }
+
+  // Returning to 1:1 mid-clip continues from the fractional position instead of jumping.
+  std::vector<float> ramp(400);
+  for (std::size_t i = 0; i < ramp.size(); ++i) {
+    ramp[i] = static_cast<float>(i) / 400.0F;
+  }
+  ClipPlayerNode varispeed;
+  varispeed.prepare(kEngineRate);
+  varispeed.setClipBuffer(CreateClip(ramp, kEngineRate));
+  varispeed.setParameter("endframe", 1e6);
+  varispeed.setParameter("resamplequality", 0.0);
+  varispeed.setParameter("playbackrate", 0.5);
+  Render(varispeed, 128);
+  varispeed.setParameter("playbackrate", 1.0);
+  const auto resumed = Render(varispeed, 64);
+  if (std::fabs(resumed.front() - 64.0F / 400.0F) > 1e-5F || std::fabs(resumed[10] - 74.0F / 400.0F) > 1e-5F) {
+    throw std::runtime_error("Varispeed lost the clip position: got " + std::to_string(resumed.front()));
+  }
+}
+
+void TestPassbandGainAndStopband() {
+  PrepareResampler();
+  // DC passes at unity for every step band; a tone above the output Nyquist is suppressed when
+  // downsampling by two.
+  std::vector<float> source(2048 + 64, 1.0F);
+  std::vector<float> dest(1000);
+  for (const double step : {0.5, 1.0, 1.3, 2.0, 3.7}) {
+    Resample(source.data(), 20.25, step, dest.data(), 500, ResampleQuality::kSinc);
+    for (std::size_t i = 0; i < 500; ++i) {
+      if (std::fabs(dest[i] - 1.0F) > 1e-4F) {
+        throw std::runtime_error("Resampler DC gain is not unity at step " + std::to_string(step));
+      }
+    }
+  }
+  const auto tone = Sine(source.size(), 0.4, 1.0);  // 0.8 of the input Nyquist, above the output one
+  Resample(tone.data(), 20.0, 2.0, dest.data(), 1000, ResampleQuality::kSinc);
+  float peak = 0.0F;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    peak = std::max(peak, std::fabs(dest[i]));
+  }
+  if (peak > 0.01F) {
+    throw std::runtime_error("Downsampling let an out-of-band tone alias through: peak " + std::to_string(peak));
+  }
+}
+
+}  // namespace
+
+void RunResamplerTests() {
+  TestConversionTracksAnalyticSine();
+  TestVarispeedChangesDurationAndHoldsLevel();
+  TestPassbandGainAndStopband();
+}
+
+}  // namespace daft::audio::tests
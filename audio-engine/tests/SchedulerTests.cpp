@@ -1,5 +1,6 @@
 #include "audio_engine/Scheduler.h"
 
+#include <limits>
 #include <stdexcept>
 #include <vector>
 
@@ -8,55 +9,73 @@ namespace daft::audio::tests {
 void RunSchedulerTests() {
   RenderClock clock(48000.0, 64);
   RealTimeScheduler<8> scheduler(clock);
+  const ParamId parameter = GainNode::kGain;
+  std::vector<double> dispatched;
+  const auto record = [&](const ScheduledEvent& event) {
+    if (event.parameter != parameter) {
+      throw std::runtime_error("Event parameter was not preserved");
+    }
+    dispatched.push_back(event.value);
+  };
+  const auto dispatch = [&]() {
+    scheduler.drainInbox();
+    scheduler.dispatchDueEvents(record);
+  };
 
-  bool immediateTriggered = false;
-  scheduler.schedule({clock.frameTime(), [&]() { immediateTriggered = true; }});
-  scheduler.dispatchDueEvents();
-  if (!immediateTriggered) {
+  scheduler.schedule({clock.frameTime(), 0, 0, parameter, 1.0});
+  dispatch();
+  if (dispatched != std::vector<double>{1.0}) {
     throw std::runtime_error("Immediate event was not dispatched");
   }
 
-  bool delayedTriggered = false;
-  scheduler.schedule({clock.frameTime() + 128, [&]() { delayedTriggered = true; }});
-  scheduler.dispatchDueEvents();
-  if (delayedTriggered) {
+  dispatched.clear();
+  scheduler.schedule({clock.frameTime() + 128, 0, 0, parameter, 2.0});
+  dispatch();
+  if (!dispatched.empty()) {
     throw std::runtime_error("Delayed event dispatched too early");
   }
   clock.advanceBy(64);
-  scheduler.dispatchDueEvents();
-  if (delayedTriggered) {
+  dispatch();
+  if (!dispatched.empty()) {
     throw std::runtime_error("Delayed event dispatched before frame reached");
   }
   clock.advanceBy(64);
-  scheduler.dispatchDueEvents();
-  if (!delayedTriggered) {
+  dispatch();
+  if (dispatched != std::vector<double>{2.0}) {
     throw std::runtime_error("Delayed event was not dispatched");
   }
 
+  dispatched.clear();
   const auto baseFrame = clock.frameTime();
-  std::vector<int> order;
-  scheduler.schedule({baseFrame + 32, [&]() { order.push_back(1); }});
-  scheduler.schedule({baseFrame + 64, [&]() { order.push_back(2); }});
-  scheduler.schedule({baseFrame + 96, [&]() { order.push_back(3); }});
-  scheduler.dispatchDueEvents();
-  if (!order.empty()) {
+  scheduler.schedule({baseFrame + 96, 0, 0, parameter, 3.0});
+  scheduler.schedule({baseFrame + 32, 0, 0, parameter, 1.0});
+  scheduler.schedule({baseFrame + 64, 0, 0, parameter, 2.0});
+  scheduler.schedule({baseFrame + 64, 0, 0, parameter, 2.5});
+  dispatch();
+  if (!dispatched.empty()) {
     throw std::runtime_error("Future events dispatched too early");
   }
+  if (scheduler.nextEventFrame() != baseFrame + 32) {
+    throw std::runtime_error("Next event frame should report the earliest pending event");
+  }
   clock.advanceBy(32);
-  scheduler.dispatchDueEvents();
-  if (order != std::vector<int>{1}) {
+  dispatch();
+  if (dispatched != std::vector<double>{1.0}) {
     throw std::runtime_error("Event ordering incorrect at first dispatch");
   }
   clock.advanceBy(32);
-  scheduler.dispatchDueEvents();
-  if (order != std::vector<int>{1, 2}) {
-    throw std::runtime_error("Event ordering incorrect at second dispatch");
+  dispatch();
+  if (dispatched != std::vector<double>{1.0, 2.0, 2.5}) {
+    throw std::runtime_error("Events sharing a frame should dispatch in scheduling order");
   }
   clock.advanceBy(64);
-  scheduler.dispatchDueEvents();
-  if (order != std::vector<int>{1, 2, 3}) {
+  dispatch();
+  if (dispatched != std::vector<double>{1.0, 2.0, 2.5, 3.0}) {
     throw std::runtime_error("Unexpected events dispatched");
   }
+  if (scheduler.nextEventFrame() != std::numeric_limits<std::uint64_t>::max() || scheduler.pendingCount() != 0) {
+    throw std::runtime_error("Drained scheduler should report no pending event");
+  }
 }
 
 }  // namespace daft::audio::tests
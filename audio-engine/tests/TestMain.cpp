@@ -1,20 +1,47 @@
 #include <exception>
 #include <iostream>
 
+#include "audio_engine/RealtimeSafety.h"
+
 namespace daft::audio::tests {
 void RunSchedulerTests();
+void RunDSPKernelsTests();
 void RunClipPlayerNodeTests();
+void RunClipRegistryTests();
+void RunClipStreamTests();
+void RunGraphCommandBufferTests();
 void RunPluginNodeTests();
+void RunOfflineRendererTests();
+void RunRealtimeSafetyTests();
+void RunRenderProfilerTests();
+void RunResamplerTests();
+void RunSceneGraphTests();
+void RunVoicePoolNodeTests();
 }  // namespace daft::audio::tests
 
 int main() {
   try {
     daft::audio::tests::RunSchedulerTests();
+    daft::audio::tests::RunDSPKernelsTests();
     daft::audio::tests::RunClipPlayerNodeTests();
+    daft::audio::tests::RunClipRegistryTests();
+    daft::audio::tests::RunClipStreamTests();
+    daft::audio::tests::RunGraphCommandBufferTests();
     daft::audio::tests::RunPluginNodeTests();
+    daft::audio::tests::RunOfflineRendererTests();
+    daft::audio::tests::RunRealtimeSafetyTests();
+    daft::audio::tests::RunRenderProfilerTests();
+    daft::audio::tests::RunResamplerTests();
+    daft::audio::tests::RunSceneGraphTests();
+    daft::audio::tests::RunVoicePoolNodeTests();
   } catch (const std::exception& ex) {
     std::cerr << "Test failure: " << ex.what() << std::endl;
     return 1;
   }
+  // Every render in the suite runs under the realtime checks; each violation was printed with its stack.
+  if (const auto violations = daft::audio::RealtimeViolationCount(); violations > 0) {
+    std::cerr << "Test failure: " << violations << " realtime-safety violation(s) on the audio thread" << std::endl;
+    return 1;
+  }
   return 0;
 }
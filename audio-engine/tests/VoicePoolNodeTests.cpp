@@ -0,0 +1,167 @@
+#include "audio_engine/AudioBuffer.h"
+#include "audio_engine/DSPKernels.h"
+#include "audio_engine/SceneGraph.h"
+#include "audio_engine/VoicePoolNode.h"
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace daft::audio::tests {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+
+double NoteOn(int note, int velocity) { return note * 128.0 + velocity; }
+
+std::vector<std::vector<float>> Render(DSPNode& node, std::size_t channels, std::size_t frames) {
+  std::vector<std::vector<float>> samples(channels, std::vector<float>(frames, 1.0F));
+  std::vector<float*> pointers;
+  for (auto& channel : samples) {
+    pointers.push_back(channel.data());
+  }
+  node.process(AudioBufferView(pointers.data(), channels, frames));
+  return samples;
+}
+
+void AssertNear(const std::vector<float>& actual, const std::vector<float>& expected, float epsilon,
+                const std::string& context) {
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    if (std::fabs(actual[i] - expected[i]) > epsilon) {
+      throw std::runtime_error(context + ": frame " + std::to_string(i) + " expected " + std::to_string(expected[i]) +
+                               " got " + std::to_string(actual[i]));
+    }
+  }
+}
+
+void TestOscillatorVoicesFollowNotes() {
+  VoicePoolNode pool(8);
+  pool.prepare(kSampleRate);
+  pool.setParameter(VoicePoolNode::kAttack, 0.0);
+  pool.setParameter(VoicePoolNode::kRelease, 0.0);
+  if (!pool.isIdle(256)) {
+    throw std::runtime_error("A pool without notes should be idle");
+  }
+
+  // A4 at full velocity is a unit 440 Hz sine on every channel.
+  pool.setParameter(VoicePoolNode::kNoteOn, NoteOn(69, 127));
+  const auto block = Render(pool, 2, 300);
+  std::vector<float> expected(300);
+  dsp::oscillator(dsp::Waveform::kSine, expected.data(), 0.0, 440.0 / kSampleRate, expected.size());
+  AssertNear(block[0], expected, 1e-4F, "Voice for A4");
+  AssertNear(block[1], expected, 1e-4F, "Voice copied to the right channel");
+
+  // Velocity 0 is a note-off; a zero release fades out over one chunk and frees the voice.
+  pool.setParameter(VoicePoolNode::kNoteOn, NoteOn(69, 0));
+  Render(pool, 2, 64);
+  const auto silent = Render(pool, 2, 64);
+  if (pool.activeVoiceCount() != 0 || !pool.isIdle(64) || silent[0][10] != 0.0F) {
+    throw std::runtime_error("Released voice should fall silent and return to the pool");
+  }
+}
+
+void TestVoicesAreStolenOldestReleasedFirst() {
+  VoicePoolNode pool(2);
+  pool.prepare(kSampleRate);
+  pool.setParameter(VoicePoolNode::kNoteOn, NoteOn(60, 100));
+  pool.setParameter(VoicePoolNode::kNoteOn, NoteOn(64, 100));
+  pool.setParameter(VoicePoolNode::kNoteOn, NoteOn(67, 100));
+  if (pool.activeVoiceCount() != 2 || pool.stolenVoiceCount() != 1) {
+    throw std::runtime_error("A third note in a two-voice pool should steal a voice");
+  }
+  // Note 60 lost its voice, so releasing it leaves the other two sounding.
+  pool.setParameter(VoicePoolNode::kRelease, 0.0);
+  pool.setParameter(VoicePoolNode::kNoteOff, 60.0);
+  Render(pool, 1, 128);
+  if (pool.activeVoiceCount() != 2) {
+    throw std::runtime_error("The oldest voice should have been stolen");
+  }
+
+  // With 67 released, the next note takes its voice rather than the older but held 64.
+  pool.setParameter(VoicePoolNode::kRelease, 1.0);
+  pool.setParameter(VoicePoolNode::kNoteOff, 67.0);
+  pool.setParameter(VoicePoolNode::kNoteOn, NoteOn(72, 100));
+  pool.setParameter(VoicePoolNode::kRelease, 0.0);
+  pool.setParameter(VoicePoolNode::kNoteOff, 64.0);
+  Render(pool, 1, 128);
+  if (pool.activeVoiceCount() != 1 || pool.stolenVoiceCount() != 2) {
+    throw std::runtime_error("A released voice should be stolen before a held one");
+  }
+  pool.setParameter(VoicePoolNode::kAllNotesOff, 1.0);
+  Render(pool, 1, 128);
+  if (pool.activeVoiceCount() != 0) {
+    throw std::runtime_error("All-notes-off should release every voice");
+  }
+}
+
+void TestClipVoicesTransposeFromRootNote() {
+  constexpr std::size_t kClipFrames = 4096;
+  auto storage = std::make_shared<std::vector<float>>(kClipFrames);
+  for (std::size_t frame = 0; frame < kClipFrames; ++frame) {
+    (*storage)[frame] = static_cast<float>(frame) / kClipFrames;
+  }
+  ClipPlayerNode::ClipBufferData clip;
+  clip.key = "pad";
+  clip.sampleRate = kSampleRate;
+  clip.frameCount = kClipFrames;
+  clip.owner = storage;
+  clip.channels.push_back(storage->data());
+
+  VoicePoolNode pool(4);
+  pool.prepare(kSampleRate);
+  pool.setClipBuffer(clip);
+  pool.setParameter(VoicePoolNode::kAttack, 0.0);
+  pool.setParameter(VoicePoolNode::kRootNote, 60.0);
+  // An octave above the root plays the clip at twice its speed.
+  pool.setParameter(VoicePoolNode::kNoteOn, NoteOn(72, 127));
+  const auto block = Render(pool, 2, 200);
+  std::vector<float> expected(200);
+  for (std::size_t frame = 0; frame < expected.size(); ++frame) {
+    expected[frame] = (*storage)[2 * frame];
+  }
+  AssertNear(block[0], expected, 1e-5F, "Clip voice an octave up");
+  AssertNear(block[1], expected, 1e-5F, "Mono clip voice on the right channel");
+
+  // The voice returns to the pool once it runs off the end of the clip.
+  Render(pool, 2, kClipFrames);
+  if (pool.activeVoiceCount() != 0) {
+    throw std::runtime_error("Clip voice should end with its clip");
+  }
+}
+
+void TestNotesStartSampleAccuratelyInGraph() {
+  SceneGraph graph(kSampleRate, 256);
+  auto pool = std::make_unique<VoicePoolNode>(4);
+  pool->setParameter(VoicePoolNode::kAttack, 0.0);
+  graph.addNode("synth", std::move(pool));
+  graph.connect("synth", std::string(SceneGraph::kOutputBusId));
+  graph.scheduleAutomation("synth", VoicePoolNode::kNoteOn, 100, NoteOn(81, 127));
+
+  std::vector<float> left(256);
+  std::vector<float> right(256);
+  float* channels[] = {left.data(), right.data()};
+  graph.render(AudioBufferView(channels, 2, 256));
+  for (std::size_t frame = 0; frame < 101; ++frame) {
+    if (left[frame] != 0.0F) {
+      throw std::runtime_error("Voice should stay silent until its note-on frame");
+    }
+  }
+  // A5 starts at a rising zero crossing, so the frame after the note-on is already positive.
+  if (!(left[101] > 0.0F) || right[101] != left[101]) {
+    throw std::runtime_error("Voice should start on its note-on frame");
+  }
+}
+
+}  // namespace
+
+void RunVoicePoolNodeTests() {
+  TestOscillatorVoicesFollowNotes();
+  TestVoicesAreStolenOldestReleasedFirst();
+  TestClipVoicesTransposeFromRootNote();
+  TestNotesStartSampleAccuratelyInGraph();
+}
+
+}  // namespace daft::audio::tests
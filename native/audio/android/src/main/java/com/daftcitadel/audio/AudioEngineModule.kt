@@ -14,7 +14,9 @@ import java.util.concurrent.atomic.AtomicBoolean
 import java.util.Locale
 import kotlin.math.abs
 import kotlin.math.roundToLong
+import android.os.ParcelFileDescriptor
 import android.util.Base64
+import java.io.File
 import java.nio.ByteBuffer
 import java.nio.ByteOrder
 
@@ -27,6 +29,7 @@ class AudioEngineModule(private val reactContext: ReactApplicationContext) :
   }
 
   private val maxFramesPerBuffer: Int by lazy { nativeMaxFramesPerBuffer() }
+  private val maxChannels: Int by lazy { nativeMaxChannels() }
 
   /**
  * The module's name as exposed to React Native.
@@ -40,15 +43,24 @@ override fun getName(): String = NAME
    *
    * Validates inputs and rejects the provided Promise with `"invalid_arguments"` when:
    * - `sampleRate` is not finite or not greater than 0,
-   * - `framesPerBuffer` is not finite, not greater than 0, not an integer value, or exceeds the engine's maximum frames per buffer.
+   * - `framesPerBuffer` is not finite, not greater than 0, not an integer value, or exceeds the engine's maximum frames per buffer,
+   * - `maxChannels` or `maxFramesPerBuffer` is negative, not an integer value, or exceeds the engine's limits.
    * If native initialization fails the Promise is rejected with `"initialize_failed"`. On success the Promise is resolved with `null`.
    *
    * @param sampleRate Sample rate in hertz; must be > 0 and finite.
    * @param framesPerBuffer Desired buffer size in frames; must be an integer > 0 and ≤ the engine's maximum frames per buffer.
+   * @param maxChannels Output channels the graph renders; 0 keeps the engine default of four.
+   * @param maxFramesPerBuffer Longest block the graph renders at once, e.g. for large offline bounces; 0 keeps the default.
    * @param promise Promise resolved to `null` on success or rejected with an error code on failure.
    */
   @ReactMethod
-  fun initialize(sampleRate: Double, framesPerBuffer: Double, promise: Promise) {
+  fun initialize(
+    sampleRate: Double,
+    framesPerBuffer: Double,
+    maxChannels: Double,
+    maxFramesPerBuffer: Double,
+    promise: Promise
+  ) {
     if (!sampleRate.isFinite() || sampleRate <= 0.0) {
       promise.reject("invalid_arguments", "sampleRate must be positive and finite")
       return
@@ -62,7 +74,7 @@ override fun getName(): String = NAME
       promise.reject("invalid_arguments", "framesPerBuffer must be an integer value")
       return
     }
-    val maxFrames = maxFramesPerBuffer
+    val maxFrames = this.maxFramesPerBuffer
     if (framesInt == 0 || framesInt > maxFrames) {
       promise.reject(
         "invalid_arguments",
@@ -70,8 +82,18 @@ override fun getName(): String = NAME
       )
       return
     }
+    val channelLimit = parseLimit(maxChannels, this.maxChannels)
+    if (channelLimit == null) {
+      promise.reject("invalid_arguments", "maxChannels must be an integer between 0 and ${this.maxChannels}")
+      return
+    }
+    val blockLimit = parseLimit(maxFramesPerBuffer, maxFrames)
+    if (blockLimit == null) {
+      promise.reject("invalid_arguments", "maxFramesPerBuffer must be an integer between 0 and $maxFrames")
+      return
+    }
     try {
-      nativeInitialize(sampleRate, framesInt)
+      nativeInitialize(sampleRate, framesInt, channelLimit, blockLimit)
       promise.resolve(null)
     } catch (error: Exception) {
       promise.reject("initialize_failed", error)
@@ -135,6 +157,9 @@ override fun getName(): String = NAME
    * - Base64-encoded Float32 PCM strings,
    * - Node-style Buffer maps ({ type: "Buffer", data: number[] }).
    *
+   * `storageFormat` ("float32" by default, "int16" or "float16") selects how the engine keeps the
+   * samples resident; the compact formats halve the clip's memory and are decoded during playback.
+   *
    * On validation failure the promise is rejected with `"invalid_arguments"`; native errors yield
    * `"register_clip_failed"`.
    */
@@ -145,6 +170,7 @@ override fun getName(): String = NAME
     channels: Double,
     frames: Double,
     channelData: ReadableArray,
+    storageFormat: String?,
     promise: Promise
   ) {
     val sanitizedKey = bufferKey.trim()
@@ -190,17 +216,29 @@ override fun getName(): String = NAME
       promise.reject("invalid_arguments", "channelData length must equal channels")
       return
     }
+    val format = storageFormat?.trim().orEmpty().ifEmpty { "float32" }
+    if (format !in SUPPORTED_STORAGE_FORMATS) {
+      promise.reject("invalid_arguments", "storageFormat must be one of ${SUPPORTED_STORAGE_FORMATS.joinToString()}")
+      return
+    }
 
     val frameCount = frameCountLong.toInt()
-    val channelMatrix = Array(channelCount) { FloatArray(frameCount) }
+    val byteCount = channelCount.toLong() * frameCount * java.lang.Float.BYTES
+    if (byteCount > Int.MAX_VALUE) {
+      promise.reject("invalid_arguments", "clip exceeds platform limits")
+      return
+    }
+    // Decode straight into the direct buffer the engine adopts, so the samples are not copied again.
+    val samples = ByteBuffer.allocateDirect(byteCount.toInt()).order(ByteOrder.nativeOrder())
+    val floats = samples.asFloatBuffer()
 
     try {
       for (index in 0 until channelCount) {
-        val samples = extractChannelSamples(channelData, index, frameCount)
-        if (samples.size != frameCount) {
+        val channel = extractChannelSamples(channelData, index, frameCount)
+        if (channel.size != frameCount) {
           throw IllegalArgumentException("channelData[$index] length does not match frames")
         }
-        samples.copyInto(channelMatrix[index])
+        floats.put(channel)
       }
     } catch (error: IllegalArgumentException) {
       promise.reject("invalid_arguments", error)
@@ -208,7 +246,114 @@ override fun getName(): String = NAME
     }
 
     try {
-      nativeRegisterClipBuffer(sanitizedKey, sampleRate, channelCount, frameCount, channelMatrix)
+      nativeRegisterClipBufferDirect(sanitizedKey, sampleRate, channelCount, frameCount, samples, format)
+      promise.resolve(null)
+    } catch (error: Exception) {
+      promise.reject("register_clip_failed", error)
+    }
+  }
+
+  /**
+   * Registers a clip whose planar Float32 PCM (`channels` runs of `frames` samples in native byte
+   * order) sits in a file, mapping it instead of copying it. `dataOffsetBytes` skips any header.
+   */
+  @ReactMethod
+  fun registerClipBufferFile(
+    bufferKey: String,
+    filePath: String,
+    sampleRate: Double,
+    channels: Double,
+    frames: Double,
+    dataOffsetBytes: Double,
+    promise: Promise
+  ) {
+    val sanitizedKey = bufferKey.trim()
+    if (sanitizedKey.isEmpty() || filePath.isBlank()) {
+      promise.reject("invalid_arguments", "bufferKey and filePath are required")
+      return
+    }
+    val channelCount = channels.toInt()
+    val frameCount = frames.roundToLong()
+    val offset = dataOffsetBytes.roundToLong()
+    if (!channels.isFinite() || abs(channels - channelCount.toDouble()) > 1e-6 || channelCount !in 1..64 ||
+      !frames.isFinite() || abs(frames - frameCount.toDouble()) > 1e-6 || frameCount !in 1..Int.MAX_VALUE.toLong() ||
+      !dataOffsetBytes.isFinite() || offset < 0
+    ) {
+      promise.reject("invalid_arguments", "channels, frames and dataOffsetBytes must be valid integers")
+      return
+    }
+    try {
+      ParcelFileDescriptor.open(File(filePath), ParcelFileDescriptor.MODE_READ_ONLY).use { descriptor ->
+        registerClipBufferFromFd(sanitizedKey, sampleRate, channelCount, frameCount.toInt(), descriptor, offset)
+      }
+      promise.resolve(null)
+    } catch (error: Exception) {
+      promise.reject("register_clip_failed", error)
+    }
+  }
+
+  /**
+   * Native-side entry point for decoders that already hold planar Float32 PCM in a direct buffer.
+   * The engine adopts the buffer's memory; callers must not write to it after registering.
+   */
+  fun registerClipBufferDirect(bufferKey: String, sampleRate: Double, channels: Int, frames: Int, samples: ByteBuffer) {
+    require(samples.isDirect) { "samples must be a direct ByteBuffer" }
+    require(samples.order() == ByteOrder.nativeOrder()) { "samples must use native byte order" }
+    nativeRegisterClipBufferDirect(bufferKey.trim(), sampleRate, channels, frames, samples, "float32")
+  }
+
+  /**
+   * Native-side entry point for planar Float32 PCM in a file or shared-memory region (e.g. ashmem).
+   * The descriptor may be closed once this returns.
+   */
+  fun registerClipBufferFromFd(
+    bufferKey: String,
+    sampleRate: Double,
+    channels: Int,
+    frames: Int,
+    descriptor: ParcelFileDescriptor,
+    dataOffsetBytes: Long = 0L
+  ) {
+    nativeRegisterClipBufferFd(bufferKey.trim(), sampleRate, channels, frames, descriptor.fd, dataOffsetBytes)
+  }
+
+  /**
+   * Registers a clip that streams from a decoded PCM cache file instead of being copied into memory.
+   *
+   * The file holds interleaved native-endian Float32 frames after `dataOffsetBytes` of header. Clip
+   * players created for `bufferKey` read it through a background read-ahead ring.
+   */
+  @ReactMethod
+  fun registerClipStream(
+    bufferKey: String,
+    filePath: String,
+    sampleRate: Double,
+    channels: Double,
+    dataOffsetBytes: Double,
+    promise: Promise
+  ) {
+    val sanitizedKey = bufferKey.trim()
+    if (sanitizedKey.isEmpty() || filePath.isBlank()) {
+      promise.reject("invalid_arguments", "bufferKey and filePath are required")
+      return
+    }
+    if (!sampleRate.isFinite() || sampleRate <= 0.0) {
+      promise.reject("invalid_arguments", "sampleRate must be positive and finite")
+      return
+    }
+    val channelCount = channels.toInt()
+    if (!channels.isFinite() || abs(channels - channelCount.toDouble()) > 1e-6 || channelCount !in 1..64) {
+      promise.reject("invalid_arguments", "channels must be an integer between 1 and 64")
+      return
+    }
+    val offset = dataOffsetBytes.roundToLong()
+    if (!dataOffsetBytes.isFinite() || offset < 0 || abs(dataOffsetBytes - offset.toDouble()) > 1e-6) {
+      promise.reject("invalid_arguments", "dataOffsetBytes must be a non-negative integer")
+      return
+    }
+
+    try {
+      nativeRegisterClipStream(sanitizedKey, filePath, sampleRate, channelCount, offset)
       promise.resolve(null)
     } catch (error: Exception) {
       promise.reject("register_clip_failed", error)
@@ -301,6 +446,60 @@ override fun getName(): String = NAME
     }
   }
 
+  /**
+   * Applies a binary graph command buffer (add/remove/connect/disconnect nodes, parameter changes and
+   * automation) in one native call. `commands` is the base64 encoding of the buffer built by
+   * `GraphCommandBuffer` in TypeScript; the format is documented in `platform/common/GraphCommandBuffer.h`.
+   * Rejects with `"invalid_arguments"` for a malformed buffer, which applies nothing, or with
+   * `"graph_commands_failed"` when a command fails, in which case the commands before it stay applied.
+   */
+  @ReactMethod
+  fun applyGraphCommands(commands: String, promise: Promise) {
+    val decoded = try {
+      Base64.decode(commands, Base64.NO_WRAP)
+    } catch (error: IllegalArgumentException) {
+      promise.reject("invalid_arguments", "commands must be base64 encoded", error)
+      return
+    }
+    val buffer = ByteBuffer.allocateDirect(decoded.size).order(ByteOrder.LITTLE_ENDIAN)
+    buffer.put(decoded)
+    try {
+      nativeApplyGraphCommands(buffer, decoded.size)
+      promise.resolve(null)
+    } catch (error: IllegalArgumentException) {
+      promise.reject("invalid_arguments", error)
+    } catch (error: Exception) {
+      promise.reject("graph_commands_failed", error)
+    }
+  }
+
+  /**
+   * Opens a batch of graph edits; the engine keeps rendering the previous graph until the matching
+   * [commitGraphUpdate], which compiles every edit made in between at once. Batches nest.
+   */
+  @ReactMethod
+  fun beginGraphUpdate(promise: Promise) {
+    try {
+      nativeBeginGraphUpdate()
+      promise.resolve(null)
+    } catch (error: Exception) {
+      promise.reject("graph_update_failed", error)
+    }
+  }
+
+  /**
+   * Closes the innermost batch opened by [beginGraphUpdate]; the outermost one publishes the new graph.
+   */
+  @ReactMethod
+  fun commitGraphUpdate(promise: Promise) {
+    try {
+      nativeCommitGraphUpdate()
+      promise.resolve(null)
+    } catch (error: Exception) {
+      promise.reject("graph_update_failed", error)
+    }
+  }
+
   /**
    * Schedule a parameter automation event for a node at a specific frame.
    *
@@ -347,12 +546,152 @@ override fun getName(): String = NAME
     }
   }
 
+  /**
+   * Schedule a per-sample parameter ramp for a node starting at a specific frame.
+   *
+   * The node interpolates from its current value to `value` over `durationFrames`, so one call replaces a stream of
+   * step automation events. Rejects with `"invalid_arguments"` for the same validation failures as
+   * [scheduleParameterAutomation], a negative or non-integer `durationFrames`, or an unknown `curve`; rejects with
+   * `"automation_failed"` if native scheduling fails.
+   *
+   * @param curve Either `"linear"` or `"exponential"`.
+   */
+  @ReactMethod
+  fun scheduleParameterRamp(
+    nodeId: String,
+    parameter: String,
+    frame: Double,
+    value: Double,
+    durationFrames: Double,
+    curve: String,
+    promise: Promise
+  ) {
+    val sanitizedNodeId = nodeId.trim()
+    val sanitizedParameter = parameter.trim()
+    if (sanitizedNodeId.isEmpty() || sanitizedParameter.isEmpty()) {
+      promise.reject("invalid_arguments", "nodeId and parameter are required")
+      return
+    }
+    if (!frame.isFinite() || frame < 0 || !durationFrames.isFinite() || durationFrames < 0) {
+      promise.reject("invalid_arguments", "frame and durationFrames must be non-negative")
+      return
+    }
+    if (!value.isFinite()) {
+      promise.reject("invalid_arguments", "value must be finite")
+      return
+    }
+    val frameTicks = frame.roundToLong()
+    val durationTicks = durationFrames.roundToLong()
+    if (abs(frame - frameTicks.toDouble()) > 1e-6 || abs(durationFrames - durationTicks.toDouble()) > 1e-6) {
+      promise.reject("invalid_arguments", "frame and durationFrames must be integer values")
+      return
+    }
+    val exponential = when (curve.trim().lowercase()) {
+      "linear" -> false
+      "exponential" -> true
+      else -> {
+        promise.reject("invalid_arguments", "curve must be 'linear' or 'exponential'")
+        return
+      }
+    }
+    try {
+      nativeScheduleRamp(sanitizedNodeId, sanitizedParameter, frameTicks, value, durationTicks, exponential)
+      promise.resolve(null)
+    } catch (error: Exception) {
+      promise.reject("automation_failed", error)
+    }
+  }
+
+
+  /**
+   * Starts bouncing the graph to a WAV file at `filePath`, faster than realtime. Poll
+   * `getOfflineRenderStatus` for progress; realtime output is silent until the bounce ends.
+   */
+  @ReactMethod
+  fun startOfflineRender(
+    filePath: String,
+    frameCount: Double,
+    channels: Double,
+    workerCount: Double,
+    sampleFormat: String?,
+    promise: Promise
+  ) {
+    if (filePath.isBlank()) {
+      promise.reject("invalid_arguments", "filePath is required")
+      return
+    }
+    val frames = frameCount.roundToLong()
+    if (!frameCount.isFinite() || frames <= 0 || abs(frameCount - frames.toDouble()) > 1e-6) {
+      promise.reject("invalid_arguments", "frameCount must be a positive integer")
+      return
+    }
+    val channelCount = channels.toInt()
+    if (!channels.isFinite() || abs(channels - channelCount.toDouble()) > 1e-6 || channelCount !in 1..64) {
+      promise.reject("invalid_arguments", "channels must be an integer between 1 and 64")
+      return
+    }
+    val workers = workerCount.toInt()
+    if (!workerCount.isFinite() || abs(workerCount - workers.toDouble()) > 1e-6 || workers !in 0..16) {
+      promise.reject("invalid_arguments", "workerCount must be an integer between 0 and 16")
+      return
+    }
+    val format = sampleFormat?.trim().orEmpty().ifEmpty { "float32" }
+    if (format !in SUPPORTED_OFFLINE_FORMATS) {
+      promise.reject("invalid_arguments", "sampleFormat must be one of ${SUPPORTED_OFFLINE_FORMATS.joinToString()}")
+      return
+    }
+
+    try {
+      nativeStartOfflineRender(filePath, frames, channelCount, workers, format)
+      promise.resolve(null)
+    } catch (error: Exception) {
+      promise.reject("offline_render_failed", error)
+    }
+  }
+
+  @ReactMethod
+  fun cancelOfflineRender(promise: Promise) {
+    try {
+      nativeCancelOfflineRender()
+      promise.resolve(null)
+    } catch (error: Exception) {
+      promise.reject("offline_render_failed", error)
+    }
+  }
+
+  /**
+   * Resolves with the current or last bounce: "state" ("idle", "rendering", "finished", "cancelled" or
+   * "failed"), "renderedFrames", "writtenFrames", "totalFrames" and, after a failure, "error".
+   */
+  @ReactMethod
+  fun getOfflineRenderStatus(promise: Promise) {
+    try {
+      val payload = nativeGetOfflineRenderStatus()
+      val state = OFFLINE_RENDER_STATES.getOrElse(payload[0].toInt()) { "idle" }
+      val status = Arguments.createMap().apply {
+        putString("state", state)
+        putDouble("renderedFrames", payload[1])
+        putDouble("writtenFrames", payload[2])
+        putDouble("totalFrames", payload[3])
+        if (state == "failed") {
+          putString("error", nativeGetOfflineRenderError())
+        }
+      }
+      promise.resolve(status)
+    } catch (error: Exception) {
+      promise.reject("offline_render_failed", error)
+    }
+  }
+
   /**
    * Fetches runtime render diagnostics from the native audio engine and delivers them to JavaScript.
    *
    * Resolves the provided promise with a map containing:
    * - "xruns": number of XRuns as a double.
    * - "lastRenderDurationMicros": last render duration in microseconds as a double.
+   * - "clipBufferBytes": bytes retained by registered clip buffers.
+   * - "scratchBufferCount" / "scratchBufferBytes": size of the pooled node scratch buffers.
+   * - "streamUnderruns": streamed-clip reads that found their frames not yet read ahead.
    *
    * @param promise A Promise that is resolved with the diagnostics map on success or rejected with error code "diagnostics_failed" on failure.
    */
@@ -366,6 +705,13 @@ override fun getName(): String = NAME
         if (payload.size >= 3) {
           putDouble("clipBufferBytes", payload[2])
         }
+        if (payload.size >= 5) {
+          putDouble("scratchBufferCount", payload[3])
+          putDouble("scratchBufferBytes", payload[4])
+        }
+        if (payload.size >= 6) {
+          putDouble("streamUnderruns", payload[5])
+        }
       }
       promise.resolve(diagnostics)
     } catch (error: Exception) {
@@ -373,6 +719,64 @@ override fun getName(): String = NAME
     }
   }
 
+  /**
+   * Turns the native render profiler on or off. Enabling starts from empty histograms and the setting
+   * lasts until the engine is re-initialized.
+   */
+  @ReactMethod
+  fun setProfilingEnabled(enabled: Boolean, promise: Promise) {
+    try {
+      nativeSetProfilingEnabled(enabled)
+      promise.resolve(null)
+    } catch (error: Exception) {
+      promise.reject("profiling_failed", error)
+    }
+  }
+
+  /**
+   * Resolves the render profile: block counts, render time, DSP load and callback jitter summaries, and
+   * per-node render time sorted slowest first. Each summary is a map of count, mean, p50, p95, p99 and max.
+   */
+  @ReactMethod
+  fun getRenderProfile(promise: Promise) {
+    try {
+      val profile = nativeGetRenderProfile()
+      val values = profile[0] as DoubleArray
+      val ids = profile[1] as Array<*>
+      fun summary(offset: Int) = Arguments.createMap().apply {
+        putDouble("count", values[offset])
+        putDouble("mean", values[offset + 1])
+        putDouble("p50", values[offset + 2])
+        putDouble("p95", values[offset + 3])
+        putDouble("p99", values[offset + 4])
+        putDouble("max", values[offset + 5])
+      }
+      val nodes = Arguments.createArray()
+      ids.forEachIndexed { index, id ->
+        nodes.pushMap(
+          Arguments.createMap().apply {
+            putString("nodeId", id as String)
+            putMap("renderMicros", summary(PROFILE_HEADER_SIZE + (3 + index) * PROFILE_SUMMARY_SIZE))
+          }
+        )
+      }
+      val result = Arguments.createMap().apply {
+        putBoolean("enabled", values[0] != 0.0)
+        putDouble("blocks", values[1])
+        putDouble("overloads", values[2])
+        putDouble("renderErrors", values[3])
+        putDouble("droppedRecords", values[4])
+        putMap("renderMicros", summary(PROFILE_HEADER_SIZE))
+        putMap("dspLoad", summary(PROFILE_HEADER_SIZE + PROFILE_SUMMARY_SIZE))
+        putMap("callbackJitterMicros", summary(PROFILE_HEADER_SIZE + 2 * PROFILE_SUMMARY_SIZE))
+        putArray("nodes", nodes)
+      }
+      promise.resolve(result)
+    } catch (error: Exception) {
+      promise.reject("profiling_failed", error)
+    }
+  }
+
   /**
  * Initialize the native audio engine with the specified audio configuration.
  *
@@ -381,8 +785,15 @@ override fun getName(): String = NAME
  *
  * @param sampleRate Sample rate in Hz (e.g., 48000.0).
  * @param framesPerBuffer Number of audio frames per buffer (must be a positive integer). 
+ * @param maxChannels Output channels the graph renders, or 0 for the default of four.
+ * @param maxFramesPerBuffer Longest block the graph renders at once, or 0 for the default.
  */
-private external fun nativeInitialize(sampleRate: Double, framesPerBuffer: Int)
+private external fun nativeInitialize(
+    sampleRate: Double,
+    framesPerBuffer: Int,
+    maxChannels: Int,
+    maxFramesPerBuffer: Int
+  )
   /**
  * Shuts down the native audio engine and releases its resources.
  *
@@ -418,6 +829,18 @@ private external fun nativeConnectNodes(source: String, destination: String)
  */
 private external fun nativeDisconnectNodes(source: String, destination: String)
   /**
+ * Applies `length` bytes of an encoded graph command buffer held in a direct ByteBuffer.
+ */
+private external fun nativeApplyGraphCommands(commands: ByteBuffer, length: Int)
+  /**
+ * Opens a batch of graph edits in the native engine.
+ */
+private external fun nativeBeginGraphUpdate()
+  /**
+ * Closes the innermost batch of graph edits, compiling the graph when it was the outermost.
+ */
+private external fun nativeCommitGraphUpdate()
+  /**
  * Schedules an automation event for a node's parameter at a specific frame index with the given value.
  *
  * @param nodeId The node identifier to target (trimmed, non-empty).
@@ -426,38 +849,89 @@ private external fun nativeDisconnectNodes(source: String, destination: String)
  * @param value The value to apply to the parameter at the specified frame.
  */
 private external fun nativeScheduleAutomation(nodeId: String, parameter: String, frame: Long, value: Double)
+  /**
+   * Schedules a per-sample ramp towards `value` lasting `durationFrames`, linear or exponential.
+   */
+  private external fun nativeScheduleRamp(
+    nodeId: String,
+    parameter: String,
+    frame: Long,
+    value: Double,
+    durationFrames: Long,
+    exponential: Boolean
+  )
   /**
    * Registers a multi-channel Float32 clip buffer with the native audio engine.
    *
    * @param bufferKey Identifier for the buffer that native clip nodes will reference.
    * @param sampleRate Sample rate of the buffer in Hz.
    * @param channels Number of channels.
-   * @param frames Frame count stored in each channel array.
-   * @param channelData Planar Float32 PCM: channelData[c][f] with size [channels][frames].
+   * @param frames Frame count stored in each channel.
+   * @param samples Direct buffer of planar native-order Float32 PCM, [channels][frames]; adopted, not copied.
+   * @param storageFormat "float32" adopts `samples`; "int16" or "float16" re-encodes them at half the size.
    */
-  private external fun nativeRegisterClipBuffer(
+  private external fun nativeRegisterClipBufferDirect(
     bufferKey: String,
     sampleRate: Double,
     channels: Int,
     frames: Int,
-    channelData: Array<FloatArray>
+    samples: ByteBuffer,
+    storageFormat: String
+  )
+  private external fun nativeRegisterClipBufferFd(
+    bufferKey: String,
+    sampleRate: Double,
+    channels: Int,
+    frames: Int,
+    fd: Int,
+    dataOffsetBytes: Long
+  )
+  private external fun nativeRegisterClipStream(
+    bufferKey: String,
+    filePath: String,
+    sampleRate: Double,
+    channels: Int,
+    dataOffsetBytes: Long
   )
   private external fun nativeUnregisterClipBuffer(bufferKey: String)
   /**
  * Fetches render diagnostics from the native audio engine.
  *
- * @return A DoubleArray with three elements:
+ * @return A DoubleArray with six elements:
  *         - index 0 — the number of xruns (underruns),
  *         - index 1 — the last render duration in microseconds,
- *         - index 2 — total clip buffer bytes currently registered.
+ *         - index 2 — total clip buffer bytes currently registered,
+ *         - index 3 — pooled scratch buffer count,
+ *         - index 4 — pooled scratch buffer bytes,
+ *         - index 5 — streamed-clip underruns.
  */
 private external fun nativeGetDiagnostics(): DoubleArray
+  private external fun nativeSetProfilingEnabled(enabled: Boolean)
+  /** @return A DoubleArray of the profile's values and an Array<String> of node ids; see the JNI side. */
+  private external fun nativeGetRenderProfile(): Array<Any>
+  private external fun nativeStartOfflineRender(
+    filePath: String,
+    frameCount: Long,
+    channels: Int,
+    workerCount: Int,
+    sampleFormat: String
+  )
+  private external fun nativeCancelOfflineRender()
+  /** @return state code, rendered, written and total frames of the current or last bounce. */
+  private external fun nativeGetOfflineRenderStatus(): DoubleArray
+  private external fun nativeGetOfflineRenderError(): String
   /**
  * Query the native audio engine for the maximum supported frames per buffer.
  *
  * @return The maximum number of frames allowed per audio buffer by the native engine (an integer greater than 0).
  */
 private external fun nativeMaxFramesPerBuffer(): Int
+  /**
+ * Query the native audio engine for the most output channels a graph may render.
+ *
+ * @return The channel limit accepted by `nativeInitialize`.
+ */
+private external fun nativeMaxChannels(): Int
 
   /**
    * Convert and normalize option entries into numeric values keyed by normalized names.
@@ -501,6 +975,20 @@ private external fun nativeMaxFramesPerBuffer(): Int
     return sanitized
   }
 
+  /**
+   * Validate an optional engine limit passed from JavaScript.
+   *
+   * @return The limit as an `Int` (0 meaning the engine default), or `null` when it is not a whole
+   * number between 0 and `ceiling`.
+   */
+  private fun parseLimit(value: Double, ceiling: Int): Int? {
+    if (!value.isFinite() || value < 0.0 || value > ceiling.toDouble()) {
+      return null
+    }
+    val asInt = value.toInt()
+    return if (abs(value - asInt.toDouble()) > 1e-6) null else asInt
+  }
+
   private fun extractChannelSamples(channelData: ReadableArray, index: Int, frameCount: Int): FloatArray {
     return when (channelData.getType(index)) {
       ReadableType.Array -> convertReadableArrayToFloatChannel(channelData.getArray(index), frameCount)
@@ -613,6 +1101,14 @@ private external fun nativeMaxFramesPerBuffer(): Int
   companion object {
     const val NAME = "AudioEngineModule"
 
+    private val SUPPORTED_STORAGE_FORMATS = setOf("float32", "int16", "float16")
+    private val SUPPORTED_OFFLINE_FORMATS = setOf("float32", "int16")
+    // Indexed by the native OfflineRenderer::State value.
+    private val OFFLINE_RENDER_STATES = listOf("idle", "rendering", "finished", "cancelled", "failed")
+    // Layout of nativeGetRenderProfile's values: five counters, then six doubles per summary.
+    private const val PROFILE_HEADER_SIZE = 5
+    private const val PROFILE_SUMMARY_SIZE = 6
+
     private val libraryLoaded = AtomicBoolean(false)
 
     /**
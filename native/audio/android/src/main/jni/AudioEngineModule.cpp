@@ -4,17 +4,24 @@
 #include <cctype>
 #include <cmath>
 #include <cstdint>
+#include <limits>
 #include <memory>
+#include <span>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "audio-engine/platform/android/AudioEngineBridge.h"
+#include "audio-engine/platform/common/ApplyGraphCommands.h"
 #include "audio-engine/platform/common/NodeFactory.h"
 #include "audio_engine/SceneGraph.h"
 
+using daft::audio::bridge::ApplyGraphCommands;
 using daft::audio::bridge::AudioEngineBridge;
 using daft::audio::bridge::CreateNode;
 using daft::audio::bridge::NodeOptions;
+using daft::audio::ParseSampleFormat;
+using daft::audio::SampleFormat;
 
 namespace {
 
@@ -91,6 +98,63 @@ void ThrowJavaException(JNIEnv* env, const char* className, const std::string& m
   env->DeleteLocalRef(exceptionClass);
 }
 
+/**
+ * @brief Global references to the JDK classes and methods `ConvertOptions` uses, resolved on first use.
+ *
+ * `FindClass` and `GetMethodID` are comparatively slow lookups, so they run once per process instead of
+ * once per converted map. Only bootstrap classes are cached, which resolve from any attached thread.
+ */
+struct JavaOptionTypes {
+  jclass number = nullptr;
+  jclass boolean = nullptr;
+  jclass string = nullptr;
+  jmethodID entrySet = nullptr;
+  jmethodID iterator = nullptr;
+  jmethodID hasNext = nullptr;
+  jmethodID next = nullptr;
+  jmethodID getKey = nullptr;
+  jmethodID getValue = nullptr;
+  jmethodID doubleValue = nullptr;
+  jmethodID booleanValue = nullptr;
+};
+
+jclass GlobalClass(JNIEnv* env, const char* name) {
+  jclass local = env->FindClass(name);
+  if (local == nullptr) {
+    return nullptr;
+  }
+  auto* global = static_cast<jclass>(env->NewGlobalRef(local));
+  env->DeleteLocalRef(local);
+  return global;
+}
+
+const JavaOptionTypes& OptionTypes(JNIEnv* env) {
+  static const JavaOptionTypes types = [env] {
+    JavaOptionTypes resolved;
+    jclass mapClass = env->FindClass("java/util/Map");
+    jclass setClass = env->FindClass("java/util/Set");
+    jclass iteratorClass = env->FindClass("java/util/Iterator");
+    jclass entryClass = env->FindClass("java/util/Map$Entry");
+    resolved.number = GlobalClass(env, "java/lang/Number");
+    resolved.boolean = GlobalClass(env, "java/lang/Boolean");
+    resolved.string = GlobalClass(env, "java/lang/String");
+    resolved.entrySet = env->GetMethodID(mapClass, "entrySet", "()Ljava/util/Set;");
+    resolved.iterator = env->GetMethodID(setClass, "iterator", "()Ljava/util/Iterator;");
+    resolved.hasNext = env->GetMethodID(iteratorClass, "hasNext", "()Z");
+    resolved.next = env->GetMethodID(iteratorClass, "next", "()Ljava/lang/Object;");
+    resolved.getKey = env->GetMethodID(entryClass, "getKey", "()Ljava/lang/Object;");
+    resolved.getValue = env->GetMethodID(entryClass, "getValue", "()Ljava/lang/Object;");
+    resolved.doubleValue = env->GetMethodID(resolved.number, "doubleValue", "()D");
+    resolved.booleanValue = env->GetMethodID(resolved.boolean, "booleanValue", "()Z");
+    env->DeleteLocalRef(mapClass);
+    env->DeleteLocalRef(setClass);
+    env->DeleteLocalRef(iteratorClass);
+    env->DeleteLocalRef(entryClass);
+    return resolved;
+  }();
+  return types;
+}
+
 /**
  * @brief Converts a Java Map<String, Object> into a NodeOptions structure.
  *
@@ -111,46 +175,26 @@ NodeOptions ConvertOptions(JNIEnv* env, jobject map) {
     return options;
   }
 
-  jclass mapClass = env->GetObjectClass(map);
-  jmethodID entrySetMethod = env->GetMethodID(mapClass, "entrySet", "()Ljava/util/Set;");
-  jobject entrySet = env->CallObjectMethod(map, entrySetMethod);
-  env->DeleteLocalRef(mapClass);
-
-  jclass setClass = env->GetObjectClass(entrySet);
-  jmethodID iteratorMethod = env->GetMethodID(setClass, "iterator", "()Ljava/util/Iterator;");
-  jobject iterator = env->CallObjectMethod(entrySet, iteratorMethod);
-  env->DeleteLocalRef(setClass);
+  const auto& types = OptionTypes(env);
+  jobject entrySet = env->CallObjectMethod(map, types.entrySet);
+  jobject iterator = env->CallObjectMethod(entrySet, types.iterator);
   env->DeleteLocalRef(entrySet);
 
-  jclass iteratorClass = env->GetObjectClass(iterator);
-  jmethodID hasNextMethod = env->GetMethodID(iteratorClass, "hasNext", "()Z");
-  jmethodID nextMethod = env->GetMethodID(iteratorClass, "next", "()Ljava/lang/Object;");
-
-  jclass entryClass = env->FindClass("java/util/Map$Entry");
-  jmethodID getKeyMethod = env->GetMethodID(entryClass, "getKey", "()Ljava/lang/Object;");
-  jmethodID getValueMethod = env->GetMethodID(entryClass, "getValue", "()Ljava/lang/Object;");
-
-  jclass numberClass = env->FindClass("java/lang/Number");
-  jmethodID doubleValueMethod = env->GetMethodID(numberClass, "doubleValue", "()D");
-  jclass booleanClass = env->FindClass("java/lang/Boolean");
-  jmethodID booleanValueMethod = env->GetMethodID(booleanClass, "booleanValue", "()Z");
-  jclass stringClass = env->FindClass("java/lang/String");
-
-  while (env->CallBooleanMethod(iterator, hasNextMethod) == JNI_TRUE) {
-    jobject entry = env->CallObjectMethod(iterator, nextMethod);
-    jstring keyObject = static_cast<jstring>(env->CallObjectMethod(entry, getKeyMethod));
-    jobject valueObject = env->CallObjectMethod(entry, getValueMethod);
+  while (env->CallBooleanMethod(iterator, types.hasNext) == JNI_TRUE) {
+    jobject entry = env->CallObjectMethod(iterator, types.next);
+    jstring keyObject = static_cast<jstring>(env->CallObjectMethod(entry, types.getKey));
+    jobject valueObject = env->CallObjectMethod(entry, types.getValue);
 
     std::string key = NormalizeKey(ToStdString(env, keyObject));
 
     if (valueObject != nullptr) {
-      if (env->IsInstanceOf(valueObject, numberClass) == JNI_TRUE) {
-        const double numeric = env->CallDoubleMethod(valueObject, doubleValueMethod);
+      if (env->IsInstanceOf(valueObject, types.number) == JNI_TRUE) {
+        const double numeric = env->CallDoubleMethod(valueObject, types.doubleValue);
         options.setNumeric(key, numeric);
-      } else if (env->IsInstanceOf(valueObject, booleanClass) == JNI_TRUE) {
-        const jboolean flag = env->CallBooleanMethod(valueObject, booleanValueMethod);
+      } else if (env->IsInstanceOf(valueObject, types.boolean) == JNI_TRUE) {
+        const jboolean flag = env->CallBooleanMethod(valueObject, types.booleanValue);
         options.setNumeric(key, flag ? 1.0 : 0.0);
-      } else if (env->IsInstanceOf(valueObject, stringClass) == JNI_TRUE) {
+      } else if (env->IsInstanceOf(valueObject, types.string) == JNI_TRUE) {
         std::string raw = ToStdString(env, static_cast<jstring>(valueObject));
         std::string trimmed = TrimCopy(std::move(raw));
         if (trimmed.empty()) {
@@ -179,16 +223,42 @@ NodeOptions ConvertOptions(JNIEnv* env, jobject map) {
     env->DeleteLocalRef(entry);
   }
 
-  env->DeleteLocalRef(iteratorClass);
   env->DeleteLocalRef(iterator);
-  env->DeleteLocalRef(entryClass);
-  env->DeleteLocalRef(numberClass);
-  env->DeleteLocalRef(booleanClass);
-  env->DeleteLocalRef(stringClass);
 
   return options;
 }
 
+/**
+ * @brief Pins a direct ByteBuffer for as long as native code references its memory.
+ *
+ * Returns an owner aliasing `address` that holds a global reference to `buffer` and drops it, attaching
+ * the releasing thread to the VM if necessary, once the last clip player lets go of the samples.
+ */
+std::shared_ptr<const void> RetainDirectBuffer(JNIEnv* env, jobject buffer, const void* address) {
+  JavaVM* vm = nullptr;
+  if (env->GetJavaVM(&vm) != JNI_OK || vm == nullptr) {
+    return nullptr;
+  }
+  jobject global = env->NewGlobalRef(buffer);
+  if (global == nullptr) {
+    return nullptr;
+  }
+  return std::shared_ptr<const void>(address, [vm, global](const void*) {
+    JNIEnv* releaseEnv = nullptr;
+    bool attached = false;
+    if (vm->GetEnv(reinterpret_cast<void**>(&releaseEnv), JNI_VERSION_1_6) == JNI_EDETACHED) {
+      if (vm->AttachCurrentThread(&releaseEnv, nullptr) != JNI_OK) {
+        return;
+      }
+      attached = true;
+    }
+    releaseEnv->DeleteGlobalRef(global);
+    if (attached) {
+      vm->DetachCurrentThread();
+    }
+  });
+}
+
 }  // namespace
 
 extern "C" {
@@ -198,14 +268,20 @@ extern "C" {
  *
  * @param sampleRate Audio sample rate in Hz.
  * @param framesPerBuffer Number of frames per audio buffer.
+ * @param maxChannels Output channels the graph renders; 0 keeps the bridge default of four.
+ * @param maxFramesPerBuffer Longest block the graph renders at once; 0 keeps the graph's default.
  *
  * @throws java.lang.RuntimeException if engine initialization fails.
  */
 JNIEXPORT void JNICALL
 Java_com_daftcitadel_audio_AudioEngineModule_nativeInitialize(JNIEnv* env, jobject /*thiz*/, jdouble sampleRate,
-                                                             jint framesPerBuffer) {
+                                                             jint framesPerBuffer, jint maxChannels,
+                                                             jint maxFramesPerBuffer) {
   try {
-    AudioEngineBridge::initialize(env, sampleRate, static_cast<std::uint32_t>(framesPerBuffer));
+    AudioEngineBridge::initialize(env, sampleRate, static_cast<std::uint32_t>(framesPerBuffer),
+                                  maxChannels > 0 ? static_cast<std::size_t>(maxChannels)
+                                                  : AudioEngineBridge::kDefaultMaxChannels,
+                                  static_cast<std::size_t>(std::max<jint>(maxFramesPerBuffer, 0)));
   } catch (const std::exception& ex) {
     ThrowJavaException(env, "java/lang/RuntimeException", ex.what());
   }
@@ -265,10 +341,18 @@ Java_com_daftcitadel_audio_AudioEngineModule_nativeAddNode(JNIEnv* env, jobject
   }
 }
 
+/**
+ * @brief Registers planar Float32 samples held in a direct ByteBuffer.
+ *
+ * `samples` holds `channels` consecutive runs of `frames` native-order floats. With the default
+ * "float32" storage the buffer is pinned with a global reference until the clip is unregistered and no
+ * clip player uses it any more; "int16" and "float16" re-encode it into engine-owned memory instead.
+ */
 JNIEXPORT void JNICALL
-Java_com_daftcitadel_audio_AudioEngineModule_nativeRegisterClipBuffer(JNIEnv* env, jobject /*thiz*/, jstring bufferKey,
-                                                                      jdouble sampleRate, jint channels, jint frames,
-                                                                      jobjectArray channelData) {
+Java_com_daftcitadel_audio_AudioEngineModule_nativeRegisterClipBufferDirect(JNIEnv* env, jobject /*thiz*/,
+                                                                            jstring bufferKey, jdouble sampleRate,
+                                                                            jint channels, jint frames,
+                                                                            jobject samples, jstring storageFormat) {
   const std::string key = ToStdString(env, bufferKey);
   if (key.empty()) {
     ThrowJavaException(env, "java/lang/IllegalArgumentException", "bufferKey is required");
@@ -282,45 +366,105 @@ Java_com_daftcitadel_audio_AudioEngineModule_nativeRegisterClipBuffer(JNIEnv* en
     ThrowJavaException(env, "java/lang/IllegalArgumentException", "channels and frames must be positive integers");
     return;
   }
-  if (channelData == nullptr) {
-    ThrowJavaException(env, "java/lang/IllegalArgumentException", "channelData is required");
+  if (samples == nullptr) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException", "samples is required");
+    return;
+  }
+  const auto format = ParseSampleFormat(ToStdString(env, storageFormat));
+  if (!format) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException", "storageFormat must be float32, int16 or float16");
     return;
   }
-  const jsize providedChannels = env->GetArrayLength(channelData);
-  if (providedChannels != channels) {
-    ThrowJavaException(env, "java/lang/IllegalArgumentException", "channelData length must equal channels");
+  auto* address = static_cast<const float*>(env->GetDirectBufferAddress(samples));
+  const jlong capacity = env->GetDirectBufferCapacity(samples);
+  if (address == nullptr || capacity < 0) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException", "samples must be a direct ByteBuffer");
     return;
   }
 
   const std::size_t channelCount = static_cast<std::size_t>(channels);
   const std::size_t frameCount = static_cast<std::size_t>(frames);
-
-  std::vector<std::vector<float>> nativeChannels;
-  nativeChannels.reserve(channelCount);
-
-  for (jsize index = 0; index < channels; ++index) {
-    jfloatArray channelArray = static_cast<jfloatArray>(env->GetObjectArrayElement(channelData, index));
-    if (channelArray == nullptr) {
-      ThrowJavaException(env, "java/lang/IllegalArgumentException", "channelData contains null entries");
-      return;
+  if (static_cast<std::size_t>(capacity) < channelCount * frameCount * sizeof(float)) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException", "samples is smaller than channels * frames floats");
+    return;
+  }
+  if (*format != SampleFormat::kFloat32) {
+    std::vector<const float*> channelPointers(channelCount);
+    for (std::size_t channel = 0; channel < channelCount; ++channel) {
+      channelPointers[channel] = address + channel * frameCount;
     }
-    const jsize length = env->GetArrayLength(channelArray);
-    if (length < frames) {
-      env->DeleteLocalRef(channelArray);
-      ThrowJavaException(env, "java/lang/IllegalArgumentException", "channelData entry is shorter than frames");
-      return;
+    if (!AudioEngineBridge::encodeClipBuffer(key, sampleRate, frameCount, channelPointers, *format)) {
+      ThrowJavaException(env, "java/lang/IllegalStateException", "Failed to register clip buffer '" + key + "'");
     }
-    std::vector<float> channel(frameCount);
-    env->GetFloatArrayRegion(channelArray, 0, frames, channel.data());
-    nativeChannels.push_back(std::move(channel));
-    env->DeleteLocalRef(channelArray);
+    return;
   }
-
-  if (!AudioEngineBridge::registerClipBuffer(key, sampleRate, channelCount, frameCount, std::move(nativeChannels))) {
+  auto storage = RetainDirectBuffer(env, samples, address);
+  if (!storage) {
+    ThrowJavaException(env, "java/lang/IllegalStateException", "Failed to pin clip buffer '" + key + "'");
+    return;
+  }
+  std::vector<const void*> channelPointers(channelCount);
+  for (std::size_t channel = 0; channel < channelCount; ++channel) {
+    channelPointers[channel] = address + channel * frameCount;
+  }
+  if (!AudioEngineBridge::adoptClipBuffer(key, sampleRate, frameCount, std::move(channelPointers),
+                                          std::move(storage))) {
     ThrowJavaException(env, "java/lang/IllegalStateException", "Failed to register clip buffer '" + key + "'");
   }
 }
 
+/**
+ * @brief Maps planar Float32 samples from a file or shared-memory descriptor (e.g. ashmem) without copying.
+ *
+ * The caller keeps ownership of `fd`; the mapping outlives it.
+ */
+JNIEXPORT void JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeRegisterClipBufferFd(JNIEnv* env, jobject /*thiz*/, jstring bufferKey,
+                                                                        jdouble sampleRate, jint channels, jint frames,
+                                                                        jint fd, jlong dataOffsetBytes) {
+  const std::string key = ToStdString(env, bufferKey);
+  if (key.empty()) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException", "bufferKey is required");
+    return;
+  }
+  if (!std::isfinite(sampleRate) || sampleRate <= 0.0 || channels <= 0 || frames <= 0 || fd < 0 ||
+      dataOffsetBytes < 0) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException",
+                       "sampleRate, channels and frames must be positive with a valid descriptor and offset");
+    return;
+  }
+  std::string error;
+  if (!AudioEngineBridge::registerClipBufferFromFd(key, sampleRate, static_cast<std::size_t>(channels),
+                                                   static_cast<std::size_t>(frames), fd,
+                                                   static_cast<std::size_t>(dataOffsetBytes), error)) {
+    ThrowJavaException(env, "java/lang/IllegalStateException",
+                       "Failed to map clip buffer '" + key + "': " + error);
+  }
+}
+
+JNIEXPORT void JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeRegisterClipStream(JNIEnv* env, jobject /*thiz*/, jstring bufferKey,
+                                                                      jstring filePath, jdouble sampleRate,
+                                                                      jint channels, jlong dataOffsetBytes) {
+  const std::string key = ToStdString(env, bufferKey);
+  const std::string path = ToStdString(env, filePath);
+  if (key.empty() || path.empty()) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException", "bufferKey and filePath are required");
+    return;
+  }
+  if (!std::isfinite(sampleRate) || sampleRate <= 0.0 || channels <= 0 || dataOffsetBytes < 0) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException",
+                       "sampleRate and channels must be positive and dataOffsetBytes non-negative");
+    return;
+  }
+  std::string error;
+  if (!AudioEngineBridge::registerClipStream(key, path, sampleRate, static_cast<std::size_t>(channels),
+                                             static_cast<std::size_t>(dataOffsetBytes), error)) {
+    ThrowJavaException(env, "java/lang/IllegalStateException",
+                       "Failed to register clip stream '" + key + "': " + error);
+  }
+}
+
 JNIEXPORT void JNICALL
 Java_com_daftcitadel_audio_AudioEngineModule_nativeUnregisterClipBuffer(JNIEnv* env, jobject /*thiz*/, jstring bufferKey) {
   if (bufferKey == nullptr) {
@@ -391,6 +535,62 @@ Java_com_daftcitadel_audio_AudioEngineModule_nativeDisconnectNodes(JNIEnv* env,
   }
 }
 
+/**
+ * @brief Applies an encoded graph command buffer (see GraphCommandBuffer.h) in one call.
+ *
+ * `commands` is a direct ByteBuffer of at least `length` bytes; it is read in place and not retained.
+ *
+ * @throws java/lang/IllegalArgumentException if the buffer is missing, not direct, or malformed.
+ * @throws java/lang/IllegalStateException if a command fails; the commands before it stay applied.
+ */
+JNIEXPORT void JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeApplyGraphCommands(JNIEnv* env, jobject /*thiz*/, jobject commands,
+                                                                      jint length) {
+  const auto* address = commands != nullptr ? static_cast<const std::uint8_t*>(env->GetDirectBufferAddress(commands))
+                                            : nullptr;
+  const jlong capacity = commands != nullptr ? env->GetDirectBufferCapacity(commands) : -1;
+  if (address == nullptr || length < 0 || capacity < length) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException",
+                       "commands must be a direct ByteBuffer holding length bytes");
+    return;
+  }
+  const std::span<const std::uint8_t> buffer(address, static_cast<std::size_t>(length));
+  std::string error;
+  try {
+    if (!daft::audio::bridge::GraphCommandReader(buffer).validate(error)) {
+      ThrowJavaException(env, "java/lang/IllegalArgumentException", error);
+      return;
+    }
+    if (!ApplyGraphCommands(buffer, error)) {
+      ThrowJavaException(env, "java/lang/IllegalStateException", error);
+    }
+  } catch (const std::exception& ex) {
+    ThrowJavaException(env, "java/lang/RuntimeException", ex.what());
+  }
+}
+
+/**
+ * @brief Opens a batch of graph edits; the graph is compiled once when the outermost batch commits.
+ */
+JNIEXPORT void JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeBeginGraphUpdate(JNIEnv* /*env*/, jobject /*thiz*/) {
+  AudioEngineBridge::beginGraphUpdate();
+}
+
+/**
+ * @brief Closes the innermost batch of graph edits, compiling and publishing the graph for the outermost.
+ *
+ * @throws java/lang/RuntimeException if compiling the graph fails.
+ */
+JNIEXPORT void JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeCommitGraphUpdate(JNIEnv* env, jobject /*thiz*/) {
+  try {
+    AudioEngineBridge::commitGraphUpdate();
+  } catch (const std::exception& ex) {
+    ThrowJavaException(env, "java/lang/RuntimeException", ex.what());
+  }
+}
+
 /**
  * @brief Schedule a parameter automation event for a node at a specific frame.
  *
@@ -420,26 +620,192 @@ Java_com_daftcitadel_audio_AudioEngineModule_nativeScheduleAutomation(JNIEnv* en
   }
 }
 
+/**
+ * @brief Schedule a per-sample parameter ramp for a node starting at a specific frame.
+ *
+ * @param nodeId Java string identifier of the target node.
+ * @param parameter Java string name of the parameter to ramp.
+ * @param frame Frame index at which the ramp starts (converted to unsigned 64-bit).
+ * @param value Parameter value reached at the end of the ramp.
+ * @param durationFrames Ramp length in frames; zero applies the value as a step.
+ * @param exponential `true` for an exponential approach, `false` for a linear ramp.
+ *
+ * @throws java/lang/IllegalArgumentException for negative frames/durations or non-finite values.
+ * @throws java/lang/IllegalStateException if scheduling fails due to a native-side error.
+ */
+JNIEXPORT void JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeScheduleRamp(JNIEnv* env, jobject /*thiz*/, jstring nodeId,
+                                                                jstring parameter, jlong frame, jdouble value,
+                                                                jlong durationFrames, jboolean exponential) {
+  if (frame < 0 || durationFrames < 0 || durationFrames > std::numeric_limits<std::uint32_t>::max()) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException", "frame and durationFrames must be non-negative");
+    return;
+  }
+  if (!std::isfinite(value)) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException", "value must be finite");
+    return;
+  }
+  try {
+    AudioEngineBridge::scheduleParameterRamp(ToStdString(env, nodeId), ToStdString(env, parameter),
+                                             static_cast<std::uint64_t>(frame), value,
+                                             static_cast<std::uint32_t>(durationFrames),
+                                             exponential == JNI_TRUE ? daft::audio::RampShape::kExponential
+                                                                     : daft::audio::RampShape::kLinear);
+  } catch (const std::exception& ex) {
+    ThrowJavaException(env, "java/lang/IllegalStateException", ex.what());
+  }
+}
+
+/**
+ * @brief Start bouncing the graph to a WAV file faster than realtime.
+ *
+ * @throws Java IllegalArgumentException for an empty path, non-positive counts or an unknown format, and
+ * IllegalStateException when the bounce cannot start.
+ */
+JNIEXPORT void JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeStartOfflineRender(JNIEnv* env, jobject /*thiz*/, jstring filePath,
+                                                                      jlong frameCount, jint channels,
+                                                                      jint workerCount, jstring sampleFormat) {
+  const std::string path = ToStdString(env, filePath);
+  if (path.empty() || frameCount <= 0 || channels <= 0 || workerCount < 0) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException",
+                       "filePath is required, frameCount and channels must be positive");
+    return;
+  }
+  const auto format = ParseSampleFormat(ToStdString(env, sampleFormat));
+  if (!format || *format == SampleFormat::kFloat16) {
+    ThrowJavaException(env, "java/lang/IllegalArgumentException", "sampleFormat must be float32 or int16");
+    return;
+  }
+  daft::audio::OfflineRenderer::Options options;
+  options.frameCount = static_cast<std::uint64_t>(frameCount);
+  options.channelCount = static_cast<std::size_t>(channels);
+  options.workerCount = static_cast<std::size_t>(workerCount);
+  options.format = *format;
+  std::string error;
+  if (!AudioEngineBridge::startOfflineRender(path, options, error)) {
+    ThrowJavaException(env, "java/lang/IllegalStateException", "Failed to start offline render: " + error);
+  }
+}
+
+JNIEXPORT void JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeCancelOfflineRender(JNIEnv*, jobject /*thiz*/) {
+  AudioEngineBridge::cancelOfflineRender();
+}
+
+/**
+ * @brief Poll the current or last offline render.
+ *
+ * @return jdoubleArray A 4-element double array: the state (0 idle, 1 rendering, 2 finished, 3 cancelled,
+ * 4 failed), frames rendered, frames written and total frames. Returns `nullptr` if allocation fails.
+ */
+JNIEXPORT jdoubleArray JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeGetOfflineRenderStatus(JNIEnv* env, jobject /*thiz*/) {
+  jdoubleArray result = env->NewDoubleArray(4);
+  if (result == nullptr) {
+    return nullptr;
+  }
+  const auto status = AudioEngineBridge::getOfflineRenderStatus();
+  const jdouble payload[4] = {
+      static_cast<jdouble>(status.state),
+      static_cast<jdouble>(status.renderedFrames),
+      static_cast<jdouble>(status.writtenFrames),
+      static_cast<jdouble>(status.totalFrames),
+  };
+  env->SetDoubleArrayRegion(result, 0, 4, payload);
+  return result;
+}
+
+/** @return The reason the last offline render failed, or an empty string. */
+JNIEXPORT jstring JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeGetOfflineRenderError(JNIEnv* env, jobject /*thiz*/) {
+  return env->NewStringUTF(AudioEngineBridge::getOfflineRenderStatus().error.c_str());
+}
+
 /**
  * @brief Retrieve runtime diagnostics from the audio engine.
  *
- * @return jdoubleArray A 3-element double array where element 0 is the number of xruns,
- * element 1 is the last render duration in microseconds, and element 2 is the total
- * number of bytes retained by registered clip buffers. Returns `nullptr` if allocation fails.
+ * @return jdoubleArray A 6-element double array where element 0 is the number of xruns,
+ * element 1 is the last render duration in microseconds, element 2 is the total
+ * number of bytes retained by registered clip buffers, elements 3 and 4 are the
+ * number and byte size of the pooled node scratch buffers, and element 5 is the number
+ * of streamed-clip underruns. Returns `nullptr` if allocation fails.
  */
 JNIEXPORT jdoubleArray JNICALL
 Java_com_daftcitadel_audio_AudioEngineModule_nativeGetDiagnostics(JNIEnv* env, jobject /*thiz*/) {
-  jdoubleArray result = env->NewDoubleArray(3);
+  jdoubleArray result = env->NewDoubleArray(6);
   if (result == nullptr) {
     return nullptr;
   }
   const auto diagnostics = AudioEngineBridge::getDiagnostics();
-  const jdouble payload[3] = {
+  const jdouble payload[6] = {
       static_cast<jdouble>(diagnostics.xruns),
       diagnostics.lastRenderDurationMicros,
       static_cast<jdouble>(diagnostics.clipBufferBytes),
+      static_cast<jdouble>(diagnostics.scratchBufferCount),
+      static_cast<jdouble>(diagnostics.scratchBufferBytes),
+      static_cast<jdouble>(diagnostics.streamUnderruns),
   };
-  env->SetDoubleArrayRegion(result, 0, 3, payload);
+  env->SetDoubleArrayRegion(result, 0, 6, payload);
+  return result;
+}
+
+JNIEXPORT void JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeSetProfilingEnabled(JNIEnv*, jobject /*thiz*/, jboolean enabled) {
+  AudioEngineBridge::setProfilingEnabled(enabled == JNI_TRUE);
+}
+
+/**
+ * @brief Snapshot the render profile of the current graph.
+ *
+ * @return jobjectArray A 2-element array: a double array and a String array of node ids. The doubles are
+ * enabled (0/1), blocks, overloads, render errors and dropped records, then render time, DSP load and
+ * callback jitter as six values each (count, mean, p50, p95, p99, max), then six such values per node
+ * in the order of the ids. Returns `nullptr` if allocation fails.
+ */
+JNIEXPORT jobjectArray JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeGetRenderProfile(JNIEnv* env, jobject /*thiz*/) {
+  const auto report = AudioEngineBridge::getRenderProfile();
+  std::vector<jdouble> payload = {
+      report.enabled ? 1.0 : 0.0,
+      static_cast<jdouble>(report.blocks),
+      static_cast<jdouble>(report.overloads),
+      static_cast<jdouble>(report.renderErrors),
+      static_cast<jdouble>(report.droppedRecords),
+  };
+  const auto append = [&payload](const daft::audio::RenderProfiler::Summary& summary) {
+    payload.insert(payload.end(), {static_cast<jdouble>(summary.count), summary.mean, summary.p50, summary.p95,
+                                   summary.p99, summary.max});
+  };
+  append(report.renderMicros);
+  append(report.dspLoad);
+  append(report.callbackJitterMicros);
+  for (const auto& node : report.nodes) {
+    append(node.renderMicros);
+  }
+
+  const auto& types = OptionTypes(env);
+  jclass objectClass = env->FindClass("java/lang/Object");
+  if (objectClass == nullptr) {
+    return nullptr;
+  }
+  jobjectArray result = env->NewObjectArray(2, objectClass, nullptr);
+  env->DeleteLocalRef(objectClass);
+  jdoubleArray values = env->NewDoubleArray(static_cast<jsize>(payload.size()));
+  jobjectArray ids = env->NewObjectArray(static_cast<jsize>(report.nodes.size()), types.string, nullptr);
+  if (result == nullptr || values == nullptr || ids == nullptr) {
+    return nullptr;
+  }
+  env->SetDoubleArrayRegion(values, 0, static_cast<jsize>(payload.size()), payload.data());
+  for (std::size_t i = 0; i < report.nodes.size(); ++i) {
+    jstring id = env->NewStringUTF(report.nodes[i].id.c_str());
+    env->SetObjectArrayElement(ids, static_cast<jsize>(i), id);
+    env->DeleteLocalRef(id);
+  }
+  env->SetObjectArrayElement(result, 0, values);
+  env->SetObjectArrayElement(result, 1, ids);
+  env->DeleteLocalRef(values);
+  env->DeleteLocalRef(ids);
   return result;
 }
 
@@ -450,7 +816,17 @@ Java_com_daftcitadel_audio_AudioEngineModule_nativeGetDiagnostics(JNIEnv* env, j
  */
 JNIEXPORT jint JNICALL
 Java_com_daftcitadel_audio_AudioEngineModule_nativeMaxFramesPerBuffer(JNIEnv*, jobject /*thiz*/) {
-  return static_cast<jint>(daft::audio::SceneGraph::maxSupportedFramesPerBuffer());
+  return static_cast<jint>(daft::audio::SceneGraph::kFrameLimit);
+}
+
+/**
+ * @brief Reports the most output channels `nativeInitialize` accepts.
+ *
+ * @return The engine's channel limit.
+ */
+JNIEXPORT jint JNICALL
+Java_com_daftcitadel_audio_AudioEngineModule_nativeMaxChannels(JNIEnv*, jobject /*thiz*/) {
+  return static_cast<jint>(daft::audio::SceneGraph::kChannelLimit);
 }
 
 }  // extern "C"
\ No newline at end of file
@@ -4,20 +4,27 @@
 #import <ReactCommon/RCTTurboModule.h>
 #import <os/log.h>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <cmath>
 #include <cctype>
+#include <cstdint>
 #include <exception>
 #include <limits>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
 #include <cstring>
 
+#import "audio-engine/platform/common/ApplyGraphCommands.h"
 #import "audio-engine/platform/common/NodeFactory.h"
 #import "audio-engine/platform/ios/AudioEngineBridge.hpp"
 #import "audio_engine/SceneGraph.h"
 
+using daft::audio::bridge::ApplyGraphCommands;
 using daft::audio::bridge::AudioEngineBridge;
 using daft::audio::bridge::CreateNode;
 using daft::audio::bridge::NodeOptions;
@@ -115,6 +122,8 @@ RCT_EXPORT_MODULE();
 
 RCT_EXPORT_METHOD(initialize:(double)sampleRate
                   framesPerBuffer:(nonnull NSNumber*)framesPerBuffer
+                  maxChannels:(nonnull NSNumber*)maxChannels
+                  maxFramesPerBuffer:(nonnull NSNumber*)maxFramesPerBuffer
                   resolver:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject) {
   if (!std::isfinite(sampleRate) || sampleRate <= 0.0 || framesPerBuffer == nil) {
@@ -132,14 +141,33 @@ RCT_EXPORT_METHOD(initialize:(double)sampleRate
     RejectPromise(reject, @"invalid_arguments", "framesPerBuffer must be an integer value");
     return;
   }
-  const auto maxFrames = daft::audio::SceneGraph::maxSupportedFramesPerBuffer();
+  const auto maxFrames = daft::audio::SceneGraph::kFrameLimit;
   if (framesUnsigned > maxFrames) {
     std::string message = "framesPerBuffer exceeds engine capacity (max " + std::to_string(maxFrames) + ")";
     RejectPromise(reject, @"invalid_arguments", message);
     return;
   }
+  // Zero keeps the bridge defaults: four output channels and the graph's default block limit.
+  const double channelsValue = maxChannels.doubleValue;
+  const auto channelLimit = daft::audio::SceneGraph::kChannelLimit;
+  if (!std::isfinite(channelsValue) || channelsValue < 0.0 || channelsValue > static_cast<double>(channelLimit) ||
+      std::floor(channelsValue) != channelsValue) {
+    std::string message = "maxChannels must be an integer between 0 and " + std::to_string(channelLimit);
+    RejectPromise(reject, @"invalid_arguments", message);
+    return;
+  }
+  const double blockValue = maxFramesPerBuffer.doubleValue;
+  if (!std::isfinite(blockValue) || blockValue < 0.0 || blockValue > static_cast<double>(maxFrames) ||
+      std::floor(blockValue) != blockValue) {
+    std::string message = "maxFramesPerBuffer must be an integer between 0 and " + std::to_string(maxFrames);
+    RejectPromise(reject, @"invalid_arguments", message);
+    return;
+  }
+  const auto channels = static_cast<std::size_t>(channelsValue);
   try {
-    AudioEngineBridge::initialize(sampleRate, framesUnsigned);
+    AudioEngineBridge::initialize(sampleRate, framesUnsigned,
+                                  channels == 0 ? AudioEngineBridge::kDefaultMaxChannels : channels,
+                                  static_cast<std::size_t>(blockValue));
     resolve(nil);
   } catch (const std::exception& ex) {
     os_log_error(ModuleLogger(), "Initialize failed: %{public}s", ex.what());
@@ -190,6 +218,7 @@ RCT_EXPORT_METHOD(registerClipBuffer:(NSString*)bufferKey
                   channels:(nonnull NSNumber*)channels
                   frames:(nonnull NSNumber*)frames
                   channelData:(NSArray*)channelData
+                  storageFormat:(NSString*)storageFormat
                   resolver:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject) {
   const std::string key = Trim(bufferKey.length > 0 ? [bufferKey UTF8String] : "");
@@ -227,6 +256,11 @@ RCT_EXPORT_METHOD(registerClipBuffer:(NSString*)bufferKey
     RejectPromise(reject, @"invalid_arguments", "channelData length must equal channels");
     return;
   }
+  const auto format = daft::audio::ParseSampleFormat(Trim(storageFormat.length > 0 ? [storageFormat UTF8String] : ""));
+  if (!format) {
+    RejectPromise(reject, @"invalid_arguments", "storageFormat must be float32, int16 or float16");
+    return;
+  }
 
   constexpr std::size_t kMaxChannels = 64;
   constexpr unsigned long long kMaxFrames = 10'000'000ULL;
@@ -252,8 +286,11 @@ RCT_EXPORT_METHOD(registerClipBuffer:(NSString*)bufferKey
   }
   const std::size_t requiredBytes = frameCount * sizeof(float);
 
-  std::vector<std::vector<float>> nativeChannels;
-  nativeChannels.reserve(channelCount);
+  // Adopt the bridged ArrayBuffer memory instead of copying it: immutable copies of the NSData objects
+  // (a retain for immutable data) stay alive for as long as the engine references the samples.
+  NSMutableArray<NSData*>* retainedChannels = [NSMutableArray arrayWithCapacity:channelCountUnsigned];
+  std::vector<const float*> channelPointers;
+  channelPointers.reserve(channelCount);
 
   for (NSUInteger index = 0; index < channelCountUnsigned; ++index) {
     id entry = channelData[index];
@@ -261,17 +298,32 @@ RCT_EXPORT_METHOD(registerClipBuffer:(NSString*)bufferKey
       RejectPromise(reject, @"invalid_arguments", "channelData entries must be ArrayBuffer instances");
       return;
     }
-    NSData* data = (NSData*)entry;
+    NSData* data = [(NSData*)entry copy];
     if (data.length < requiredBytes) {
       RejectPromise(reject, @"invalid_arguments", "channelData entry is smaller than the expected frame count");
       return;
     }
-    std::vector<float> channel(frameCount);
-    std::memcpy(channel.data(), data.bytes, requiredBytes);
-    nativeChannels.push_back(std::move(channel));
+    if (reinterpret_cast<std::uintptr_t>(data.bytes) % alignof(float) != 0) {
+      // Unaligned views cannot be read as floats in place; fall back to an aligned copy.
+      NSMutableData* aligned = [NSMutableData dataWithLength:requiredBytes];
+      std::memcpy(aligned.mutableBytes, data.bytes, requiredBytes);
+      data = aligned;
+    }
+    [retainedChannels addObject:data];
+    channelPointers.push_back(static_cast<const float*>(data.bytes));
   }
 
-  const bool ok = AudioEngineBridge::registerClipBuffer(key, sampleRate, channelCount, frameCount, std::move(nativeChannels));
+  bool ok = false;
+  if (*format != daft::audio::SampleFormat::kFloat32) {
+    // Compact formats are re-encoded into engine-owned memory; the bridged data can go right away.
+    ok = AudioEngineBridge::encodeClipBuffer(key, sampleRate, frameCount, channelPointers, *format);
+  } else {
+    const void* retained = CFBridgingRetain([retainedChannels copy]);
+    std::shared_ptr<const void> storage(retained, [](const void* object) { CFRelease(object); });
+    ok = AudioEngineBridge::adoptClipBuffer(key, sampleRate, frameCount,
+                                            std::vector<const void*>(channelPointers.begin(), channelPointers.end()),
+                                            std::move(storage));
+  }
   if (!ok) {
     os_log_error(ModuleLogger(), "Failed to register clip buffer %{public}@", bufferKey);
     RejectPromise(reject, @"register_clip_failed", "Failed to register clip buffer");
@@ -280,6 +332,89 @@ RCT_EXPORT_METHOD(registerClipBuffer:(NSString*)bufferKey
   resolve(nil);
 }
 
+RCT_EXPORT_METHOD(registerClipBufferFile:(NSString*)bufferKey
+                  filePath:(NSString*)filePath
+                  sampleRate:(double)sampleRate
+                  channels:(nonnull NSNumber*)channels
+                  frames:(nonnull NSNumber*)frames
+                  dataOffsetBytes:(nonnull NSNumber*)dataOffsetBytes
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  const std::string key = Trim(bufferKey.length > 0 ? [bufferKey UTF8String] : "");
+  if (key.empty() || filePath.length == 0) {
+    RejectPromise(reject, @"invalid_arguments", "bufferKey and filePath are required");
+    return;
+  }
+  const auto channelCount = channels.unsignedIntegerValue;
+  const auto frameCount = frames.unsignedLongLongValue;
+  const double offsetValue = dataOffsetBytes.doubleValue;
+  if (!std::isfinite(sampleRate) || sampleRate <= 0.0 || channelCount == 0 || channelCount > 64 || frameCount == 0 ||
+      std::fabs(channels.doubleValue - static_cast<double>(channelCount)) > std::numeric_limits<double>::epsilon() ||
+      std::fabs(frames.doubleValue - static_cast<double>(frameCount)) > std::numeric_limits<double>::epsilon() ||
+      !std::isfinite(offsetValue) || offsetValue < 0.0 || std::floor(offsetValue) != offsetValue) {
+    RejectPromise(reject, @"invalid_arguments", "sampleRate, channels, frames and dataOffsetBytes must be valid");
+    return;
+  }
+
+  const int fd = ::open([filePath fileSystemRepresentation], O_RDONLY);
+  if (fd < 0) {
+    RejectPromise(reject, @"register_clip_failed", "Cannot open clip file");
+    return;
+  }
+  std::string error;
+  // The mapping outlives the descriptor, so it can be closed straight away.
+  const bool ok = AudioEngineBridge::registerClipBufferFromFd(key, sampleRate, static_cast<std::size_t>(channelCount),
+                                                              static_cast<std::size_t>(frameCount), fd,
+                                                              static_cast<std::size_t>(offsetValue), error);
+  ::close(fd);
+  if (!ok) {
+    os_log_error(ModuleLogger(), "Failed to map clip buffer %{public}@: %{public}s", bufferKey, error.c_str());
+    RejectPromise(reject, @"register_clip_failed", "Failed to map clip buffer: " + error);
+    return;
+  }
+  resolve(nil);
+}
+
+RCT_EXPORT_METHOD(registerClipStream:(NSString*)bufferKey
+                  filePath:(NSString*)filePath
+                  sampleRate:(double)sampleRate
+                  channels:(nonnull NSNumber*)channels
+                  dataOffsetBytes:(nonnull NSNumber*)dataOffsetBytes
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  const std::string key = Trim(bufferKey.length > 0 ? [bufferKey UTF8String] : "");
+  if (key.empty() || filePath.length == 0) {
+    RejectPromise(reject, @"invalid_arguments", "bufferKey and filePath are required");
+    return;
+  }
+  if (!std::isfinite(sampleRate) || sampleRate <= 0.0) {
+    RejectPromise(reject, @"invalid_arguments", "sampleRate must be positive and finite");
+    return;
+  }
+  const auto channelCount = channels.unsignedIntegerValue;
+  if (channelCount == 0 || channelCount > 64 ||
+      std::fabs(channels.doubleValue - static_cast<double>(channelCount)) > std::numeric_limits<double>::epsilon()) {
+    RejectPromise(reject, @"invalid_arguments", "channels must be an integer between 1 and 64");
+    return;
+  }
+  const double offsetValue = dataOffsetBytes.doubleValue;
+  if (!std::isfinite(offsetValue) || offsetValue < 0.0 || std::floor(offsetValue) != offsetValue) {
+    RejectPromise(reject, @"invalid_arguments", "dataOffsetBytes must be a non-negative integer");
+    return;
+  }
+
+  std::string error;
+  const bool ok = AudioEngineBridge::registerClipStream(key, [filePath fileSystemRepresentation], sampleRate,
+                                                        static_cast<std::size_t>(channelCount),
+                                                        static_cast<std::size_t>(offsetValue), error);
+  if (!ok) {
+    os_log_error(ModuleLogger(), "Failed to register clip stream %{public}@: %{public}s", bufferKey, error.c_str());
+    RejectPromise(reject, @"register_clip_failed", "Failed to register clip stream: " + error);
+    return;
+  }
+  resolve(nil);
+}
+
 RCT_EXPORT_METHOD(unregisterClipBuffer:(NSString*)bufferKey
                   resolver:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject) {
@@ -349,6 +484,50 @@ RCT_EXPORT_METHOD(disconnectNodes:(NSString*)source
   }
 }
 
+RCT_EXPORT_METHOD(applyGraphCommands:(NSString*)commands
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  NSData* data = commands.length > 0 ? [[NSData alloc] initWithBase64EncodedString:commands options:0] : nil;
+  if (data == nil) {
+    RejectPromise(reject, @"invalid_arguments", "commands must be a base64 encoded command buffer");
+    return;
+  }
+  const std::span<const std::uint8_t> buffer(static_cast<const std::uint8_t*>(data.bytes), data.length);
+  std::string error;
+  try {
+    if (!daft::audio::bridge::GraphCommandReader(buffer).validate(error)) {
+      RejectPromise(reject, @"invalid_arguments", error);
+      return;
+    }
+    if (!ApplyGraphCommands(buffer, error)) {
+      os_log_error(ModuleLogger(), "applyGraphCommands failed: %{public}s", error.c_str());
+      RejectPromise(reject, @"graph_commands_failed", error);
+      return;
+    }
+    resolve(nil);
+  } catch (const std::exception& ex) {
+    os_log_error(ModuleLogger(), "applyGraphCommands failed: %{public}s", ex.what());
+    RejectPromise(reject, @"graph_commands_failed", ex.what());
+  }
+}
+
+RCT_EXPORT_METHOD(beginGraphUpdate:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  AudioEngineBridge::beginGraphUpdate();
+  resolve(nil);
+}
+
+RCT_EXPORT_METHOD(commitGraphUpdate:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  try {
+    AudioEngineBridge::commitGraphUpdate();
+    resolve(nil);
+  } catch (const std::exception& ex) {
+    os_log_error(ModuleLogger(), "commitGraphUpdate failed: %{public}s", ex.what());
+    RejectPromise(reject, @"graph_update_failed", ex.what());
+  }
+}
+
 RCT_EXPORT_METHOD(scheduleParameterAutomation:(NSString*)nodeId
                   parameter:(NSString*)parameter
                   frame:(nonnull NSNumber*)frame
@@ -383,6 +562,124 @@ RCT_EXPORT_METHOD(scheduleParameterAutomation:(NSString*)nodeId
   }
 }
 
+RCT_EXPORT_METHOD(scheduleParameterRamp:(NSString*)nodeId
+                  parameter:(NSString*)parameter
+                  frame:(nonnull NSNumber*)frame
+                  value:(double)value
+                  durationFrames:(nonnull NSNumber*)durationFrames
+                  curve:(NSString*)curve
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  if (nodeId.length == 0 || parameter.length == 0 || frame == nil || durationFrames == nil) {
+    RejectPromise(reject, @"invalid_arguments", "nodeId, parameter, frame, and durationFrames are required");
+    return;
+  }
+  const double frameValue = frame.doubleValue;
+  const double durationValue = durationFrames.doubleValue;
+  if (!std::isfinite(frameValue) || frameValue < 0.0 || !std::isfinite(durationValue) || durationValue < 0.0 ||
+      durationValue > static_cast<double>(std::numeric_limits<std::uint32_t>::max())) {
+    RejectPromise(reject, @"invalid_arguments", "frame and durationFrames must be non-negative integers");
+    return;
+  }
+  if (!std::isfinite(value)) {
+    RejectPromise(reject, @"invalid_arguments", "value must be finite");
+    return;
+  }
+  const unsigned long long frameTicks = frame.unsignedLongLongValue;
+  const unsigned long long durationTicks = durationFrames.unsignedLongLongValue;
+  if (std::fabs(frameValue - static_cast<double>(frameTicks)) > 1e-6 ||
+      std::fabs(durationValue - static_cast<double>(durationTicks)) > 1e-6) {
+    RejectPromise(reject, @"invalid_arguments", "frame and durationFrames must be non-negative integers");
+    return;
+  }
+  daft::audio::RampShape shape = daft::audio::RampShape::kLinear;
+  NSString* normalizedCurve = curve.lowercaseString;
+  if ([normalizedCurve isEqualToString:@"exponential"]) {
+    shape = daft::audio::RampShape::kExponential;
+  } else if (![normalizedCurve isEqualToString:@"linear"]) {
+    RejectPromise(reject, @"invalid_arguments", "curve must be 'linear' or 'exponential'");
+    return;
+  }
+  try {
+    AudioEngineBridge::scheduleParameterRamp([nodeId UTF8String], [parameter UTF8String], frameTicks, value,
+                                             static_cast<std::uint32_t>(durationTicks), shape);
+    resolve(nil);
+  } catch (const std::exception& ex) {
+    os_log_error(ModuleLogger(), "scheduleParameterRamp failed: %{public}s", ex.what());
+    RejectPromise(reject, @"automation_failed", ex.what());
+  }
+}
+
+RCT_EXPORT_METHOD(startOfflineRender:(NSString*)filePath
+                  frameCount:(nonnull NSNumber*)frameCount
+                  channels:(nonnull NSNumber*)channels
+                  workerCount:(nonnull NSNumber*)workerCount
+                  sampleFormat:(NSString*)sampleFormat
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  if (filePath.length == 0) {
+    RejectPromise(reject, @"invalid_arguments", "filePath is required");
+    return;
+  }
+  const double frames = frameCount.doubleValue;
+  if (!std::isfinite(frames) || frames <= 0.0 || std::floor(frames) != frames) {
+    RejectPromise(reject, @"invalid_arguments", "frameCount must be a positive integer");
+    return;
+  }
+  const auto channelCount = channels.unsignedIntegerValue;
+  if (channelCount == 0 || channelCount > 64 ||
+      std::fabs(channels.doubleValue - static_cast<double>(channelCount)) > std::numeric_limits<double>::epsilon()) {
+    RejectPromise(reject, @"invalid_arguments", "channels must be an integer between 1 and 64");
+    return;
+  }
+  const auto workers = workerCount.unsignedIntegerValue;
+  if (workers > 16 ||
+      std::fabs(workerCount.doubleValue - static_cast<double>(workers)) > std::numeric_limits<double>::epsilon()) {
+    RejectPromise(reject, @"invalid_arguments", "workerCount must be an integer between 0 and 16");
+    return;
+  }
+  const auto format = daft::audio::ParseSampleFormat(Trim(sampleFormat.length > 0 ? [sampleFormat UTF8String] : ""));
+  if (!format || *format == daft::audio::SampleFormat::kFloat16) {
+    RejectPromise(reject, @"invalid_arguments", "sampleFormat must be float32 or int16");
+    return;
+  }
+
+  daft::audio::OfflineRenderer::Options options;
+  options.frameCount = static_cast<std::uint64_t>(frames);
+  options.channelCount = static_cast<std::size_t>(channelCount);
+  options.workerCount = static_cast<std::size_t>(workers);
+  options.format = *format;
+  std::string error;
+  if (!AudioEngineBridge::startOfflineRender([filePath fileSystemRepresentation], options, error)) {
+    os_log_error(ModuleLogger(), "Failed to start offline render: %{public}s", error.c_str());
+    RejectPromise(reject, @"offline_render_failed", "Failed to start offline render: " + error);
+    return;
+  }
+  resolve(nil);
+}
+
+RCT_EXPORT_METHOD(cancelOfflineRender:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  AudioEngineBridge::cancelOfflineRender();
+  resolve(nil);
+}
+
+RCT_EXPORT_METHOD(getOfflineRenderStatus:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  static NSArray<NSString*>* const states = @[ @"idle", @"rendering", @"finished", @"cancelled", @"failed" ];
+  const auto status = AudioEngineBridge::getOfflineRenderStatus();
+  NSMutableDictionary* result = [@{
+    @"state" : states[static_cast<NSUInteger>(status.state)],
+    @"renderedFrames" : @(static_cast<double>(status.renderedFrames)),
+    @"writtenFrames" : @(static_cast<double>(status.writtenFrames)),
+    @"totalFrames" : @(static_cast<double>(status.totalFrames)),
+  } mutableCopy];
+  if (status.state == daft::audio::OfflineRenderer::State::kFailed) {
+    result[@"error"] = [NSString stringWithUTF8String:status.error.c_str()];
+  }
+  resolve(result);
+}
+
 RCT_EXPORT_METHOD(getRenderDiagnostics:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject) {
   try {
@@ -391,6 +688,9 @@ RCT_EXPORT_METHOD(getRenderDiagnostics:(RCTPromiseResolveBlock)resolve
       @"xruns" : @(static_cast<NSInteger>(diagnostics.xruns)),
       @"lastRenderDurationMicros" : @(diagnostics.lastRenderDurationMicros),
       @"clipBufferBytes" : @(static_cast<NSInteger>(diagnostics.clipBufferBytes)),
+      @"scratchBufferCount" : @(static_cast<NSInteger>(diagnostics.scratchBufferCount)),
+      @"scratchBufferBytes" : @(static_cast<NSInteger>(diagnostics.scratchBufferBytes)),
+      @"streamUnderruns" : @(static_cast<NSInteger>(diagnostics.streamUnderruns)),
     });
   } catch (const std::exception& ex) {
     os_log_error(ModuleLogger(), "getRenderDiagnostics failed: %{public}s", ex.what());
@@ -398,4 +698,54 @@ RCT_EXPORT_METHOD(getRenderDiagnostics:(RCTPromiseResolveBlock)resolve
   }
 }
 
+RCT_EXPORT_METHOD(setProfilingEnabled:(BOOL)enabled
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  try {
+    AudioEngineBridge::setProfilingEnabled(enabled == YES);
+    resolve(nil);
+  } catch (const std::exception& ex) {
+    os_log_error(ModuleLogger(), "setProfilingEnabled failed: %{public}s", ex.what());
+    RejectPromise(reject, @"profiling_failed", ex.what());
+  }
+}
+
+RCT_EXPORT_METHOD(getRenderProfile:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject) {
+  try {
+    const auto report = AudioEngineBridge::getRenderProfile();
+    const auto summary = [](const daft::audio::RenderProfiler::Summary& value) {
+      return @{
+        @"count" : @(static_cast<double>(value.count)),
+        @"mean" : @(value.mean),
+        @"p50" : @(value.p50),
+        @"p95" : @(value.p95),
+        @"p99" : @(value.p99),
+        @"max" : @(value.max),
+      };
+    };
+    NSMutableArray* nodes = [NSMutableArray arrayWithCapacity:report.nodes.size()];
+    for (const auto& node : report.nodes) {
+      [nodes addObject:@{
+        @"nodeId" : [NSString stringWithUTF8String:node.id.c_str()],
+        @"renderMicros" : summary(node.renderMicros),
+      }];
+    }
+    resolve(@{
+      @"enabled" : @(report.enabled),
+      @"blocks" : @(static_cast<double>(report.blocks)),
+      @"overloads" : @(static_cast<double>(report.overloads)),
+      @"renderErrors" : @(static_cast<double>(report.renderErrors)),
+      @"droppedRecords" : @(static_cast<double>(report.droppedRecords)),
+      @"renderMicros" : summary(report.renderMicros),
+      @"dspLoad" : summary(report.dspLoad),
+      @"callbackJitterMicros" : summary(report.callbackJitterMicros),
+      @"nodes" : nodes,
+    });
+  } catch (const std::exception& ex) {
+    os_log_error(ModuleLogger(), "getRenderProfile failed: %{public}s", ex.what());
+    RejectPromise(reject, @"profiling_failed", ex.what());
+  }
+}
+
 @end
@@ -1,5 +1,24 @@
 import { NativeAudioEngine, isNativeModuleAvailable } from './NativeAudioEngine';
+import type {
+  OfflineRenderFormat,
+  OfflineRenderState,
+  RampCurve,
+  RenderProfile,
+  SampleStorageFormat,
+} from './NativeAudioEngine';
 import { AutomationLane, publishAutomationLane, ClockSyncService } from './Automation';
+import { GraphCommandBuffer } from './bridge/GraphCommandBuffer';
+
+const SAMPLE_STORAGE_FORMATS: ReadonlyArray<SampleStorageFormat> = ['float32', 'int16', 'float16'];
+const OFFLINE_RENDER_FORMATS: ReadonlyArray<OfflineRenderFormat> = ['float32', 'int16'];
+const OFFLINE_RENDER_STATES: ReadonlyArray<OfflineRenderState> = [
+  'idle',
+  'rendering',
+  'finished',
+  'cancelled',
+  'failed',
+];
+const DEFAULT_OFFLINE_POLL_INTERVAL_MS = 100;
 
 type ChannelPayload =
   | ArrayBuffer
@@ -107,14 +126,55 @@ export type RenderDiagnostics = {
   xruns: number;
   lastRenderDurationMicros: number;
   clipBufferBytes: number;
+  scratchBufferCount?: number;
+  scratchBufferBytes?: number;
+  streamUnderruns?: number;
 };
 
+export type OfflineRenderProgress = {
+  state: OfflineRenderState;
+  renderedFrames: number;
+  writtenFrames: number;
+  totalFrames: number;
+  error?: string;
+};
+
+export type OfflineRenderOptions = {
+  filePath: string;
+  frameCount: number;
+  channels?: number;
+  /** Render workers used for the bounce; 0 keeps the engine's current setting. */
+  workerCount?: number;
+  sampleFormat?: OfflineRenderFormat;
+  pollIntervalMs?: number;
+  onProgress?: (progress: OfflineRenderProgress) => void;
+  /** Aborting cancels the bounce and deletes the partial file. */
+  signal?: AbortSignal;
+};
+
+const delay = (ms: number) => new Promise<void>((resolve) => setTimeout(resolve, ms));
+
 export class AudioEngine {
   private readonly sampleRate: number;
   private readonly framesPerBuffer: number;
+  private readonly maxChannels: number;
+  private readonly maxFramesPerBuffer: number;
   private readonly clock: ClockSyncService;
-
-  constructor(params: { sampleRate: number; framesPerBuffer: number; bpm: number }) {
+  private pendingCommands: GraphCommandBuffer | null = null;
+  private batchDepth = 0;
+
+  /**
+   * `maxChannels` (e.g. 8 for 7.1 or 16 for third-order ambisonics) and `maxFramesPerBuffer`
+   * (e.g. 4096 for offline bounces) size the native render graph; omitted, the engine keeps four
+   * channels and 1024-frame blocks.
+   */
+  constructor(params: {
+    sampleRate: number;
+    framesPerBuffer: number;
+    bpm: number;
+    maxChannels?: number;
+    maxFramesPerBuffer?: number;
+  }) {
     if (!isNativeModuleAvailable()) {
       throw new Error('AudioEngine native module is unavailable');
     }
@@ -124,8 +184,18 @@ export class AudioEngine {
     if (params.framesPerBuffer <= 0) {
       throw new Error('framesPerBuffer must be positive');
     }
+    const maxChannels = params.maxChannels ?? 0;
+    if (!Number.isInteger(maxChannels) || maxChannels < 0) {
+      throw new Error('maxChannels must be a non-negative integer');
+    }
+    const maxFramesPerBuffer = params.maxFramesPerBuffer ?? 0;
+    if (!Number.isInteger(maxFramesPerBuffer) || maxFramesPerBuffer < 0) {
+      throw new Error('maxFramesPerBuffer must be a non-negative integer');
+    }
     this.sampleRate = params.sampleRate;
     this.framesPerBuffer = params.framesPerBuffer;
+    this.maxChannels = maxChannels;
+    this.maxFramesPerBuffer = maxFramesPerBuffer;
     this.clock = new ClockSyncService(
       params.sampleRate,
       params.framesPerBuffer,
@@ -138,7 +208,12 @@ export class AudioEngine {
   }
 
   public async init(): Promise<void> {
-    await NativeAudioEngine.initialize(this.sampleRate, this.framesPerBuffer);
+    await NativeAudioEngine.initialize(
+      this.sampleRate,
+      this.framesPerBuffer,
+      this.maxChannels,
+      this.maxFramesPerBuffer,
+    );
   }
 
   public async dispose(): Promise<void> {
@@ -149,6 +224,11 @@ export class AudioEngine {
     if (nodes.length === 0) {
       return;
     }
+    const pending = this.pendingCommands;
+    if (pending) {
+      nodes.forEach((node) => pending.addNode(node.id, node.type, node.options ?? {}));
+      return;
+    }
 
     await Promise.all(
       nodes.map((node) =>
@@ -158,17 +238,87 @@ export class AudioEngine {
   }
 
   public async connect(source: string, destination: string): Promise<void> {
+    if (this.pendingCommands) {
+      this.pendingCommands.connect(source, destination);
+      return;
+    }
     await NativeAudioEngine.connectNodes(source, destination);
   }
 
   public async disconnect(source: string, destination: string): Promise<void> {
+    if (this.pendingCommands) {
+      this.pendingCommands.disconnect(source, destination);
+      return;
+    }
     await NativeAudioEngine.disconnectNodes(source, destination);
   }
 
+  /**
+   * Runs `update` as one graph edit. Node, connection and ramp calls made while it runs are
+   * recorded into a `GraphCommandBuffer` instead of crossing the bridge one by one; when the
+   * outermost batch settles, even by throwing, the recorded commands are sent in a single
+   * `applyGraphCommands` call and the engine compiles them into one render plan. Calls nest.
+   * Native failures surface when the batch ends, as the rejection of the outermost call.
+   */
+  public async batchGraphUpdate<T>(update: () => Promise<T>): Promise<T> {
+    if (this.batchDepth === 0) {
+      this.pendingCommands = new GraphCommandBuffer();
+    }
+    this.batchDepth += 1;
+    try {
+      return await update();
+    } finally {
+      this.batchDepth -= 1;
+      if (this.batchDepth === 0) {
+        await this.flushGraphCommands();
+      }
+    }
+  }
+
+  /** Sends an encoded command buffer to the engine in one bridge call, after any batched edits. */
+  public async applyGraphCommands(commands: GraphCommandBuffer): Promise<void> {
+    await this.flushPendingCommands();
+    if (commands.commandCount === 0) {
+      return;
+    }
+    await NativeAudioEngine.applyGraphCommands(commands.toBase64());
+  }
+
   public async publishAutomation(nodeId: string, lane: AutomationLane): Promise<void> {
+    // Lanes are published call by call, so nodes recorded earlier in a batch must exist first.
+    await this.flushPendingCommands();
     await publishAutomationLane(nodeId, lane);
   }
 
+  public async rampParameter(
+    nodeId: string,
+    parameter: string,
+    frame: number,
+    value: number,
+    durationFrames: number,
+    curve: RampCurve = 'linear',
+  ): Promise<void> {
+    if (this.pendingCommands) {
+      this.pendingCommands.scheduleRamp(
+        nodeId,
+        parameter,
+        frame,
+        value,
+        durationFrames,
+        curve,
+      );
+      return;
+    }
+    await NativeAudioEngine.scheduleParameterRamp(
+      nodeId,
+      parameter,
+      frame,
+      value,
+      durationFrames,
+      curve,
+    );
+  }
+
   public async startTransport(): Promise<void> {
     await NativeAudioEngine.startTransport();
   }
@@ -221,13 +371,136 @@ export class AudioEngine {
     return diagnostics;
   }
 
+  /**
+   * Turns the render profiler on or off. While on, the audio thread times every block and node and
+   * `getRenderProfile` summarises the results; enabling again starts from empty histograms. The
+   * setting lasts until the engine is re-initialized.
+   */
+  public async setProfilingEnabled(enabled: boolean): Promise<void> {
+    if (typeof enabled !== 'boolean') {
+      throw new Error('enabled must be a boolean');
+    }
+    await NativeAudioEngine.setProfilingEnabled(enabled);
+  }
+
+  /** Timing histograms collected since profiling was enabled; nodes are sorted slowest first. */
+  public async getRenderProfile(): Promise<RenderProfile> {
+    const profile = await NativeAudioEngine.getRenderProfile();
+    if (
+      typeof profile !== 'object' ||
+      profile === null ||
+      typeof profile.enabled !== 'boolean' ||
+      !Number.isFinite(profile.blocks) ||
+      !Number.isFinite(profile.renderMicros?.p99) ||
+      !Array.isArray(profile.nodes)
+    ) {
+      throw new Error('AudioEngine returned invalid render profile payload');
+    }
+    return profile;
+  }
+
+  /**
+   * Bounces the graph to a WAV file faster than realtime and resolves with the final progress once
+   * every frame is on disk. Realtime output is silent while the bounce runs, and the timeline restarts
+   * from frame 0 afterwards. Rejects if the bounce fails or is cancelled through `signal`.
+   */
+  public async renderOffline(options: OfflineRenderOptions): Promise<OfflineRenderProgress> {
+    const {
+      filePath,
+      frameCount,
+      channels = 2,
+      workerCount = 0,
+      sampleFormat = 'float32',
+      pollIntervalMs = DEFAULT_OFFLINE_POLL_INTERVAL_MS,
+      onProgress,
+      signal,
+    } = options;
+    if (typeof filePath !== 'string' || filePath.length === 0) {
+      throw new Error('filePath must be a non-empty string');
+    }
+    if (!Number.isInteger(frameCount) || frameCount <= 0) {
+      throw new Error('frameCount must be a positive integer');
+    }
+    if (!Number.isInteger(channels) || channels <= 0 || channels > 64) {
+      throw new Error('channels must be a positive integer less than or equal to 64');
+    }
+    if (!Number.isInteger(workerCount) || workerCount < 0 || workerCount > 16) {
+      throw new Error('workerCount must be an integer between 0 and 16');
+    }
+    if (!OFFLINE_RENDER_FORMATS.includes(sampleFormat)) {
+      throw new Error(`sampleFormat must be one of ${OFFLINE_RENDER_FORMATS.join(', ')}`);
+    }
+    if (!Number.isFinite(pollIntervalMs) || pollIntervalMs < 0) {
+      throw new Error('pollIntervalMs must be a non-negative number');
+    }
+    if (signal?.aborted) {
+      throw new Error('Offline render cancelled');
+    }
+
+    await NativeAudioEngine.startOfflineRender(
+      filePath,
+      frameCount,
+      channels,
+      workerCount,
+      sampleFormat,
+    );
+    for (;;) {
+      if (signal?.aborted) {
+        await NativeAudioEngine.cancelOfflineRender();
+      }
+      const progress = await this.getOfflineRenderStatus();
+      onProgress?.(progress);
+      if (progress.state === 'finished') {
+        return progress;
+      }
+      if (progress.state === 'cancelled') {
+        throw new Error('Offline render cancelled');
+      }
+      if (progress.state === 'failed') {
+        throw new Error(`Offline render failed: ${progress.error ?? 'unknown error'}`);
+      }
+      if (progress.state === 'idle') {
+        throw new Error('Offline render is no longer tracked by the engine');
+      }
+      await delay(pollIntervalMs);
+    }
+  }
+
+  public async cancelOfflineRender(): Promise<void> {
+    await NativeAudioEngine.cancelOfflineRender();
+  }
+
+  public async getOfflineRenderStatus(): Promise<OfflineRenderProgress> {
+    const status = await NativeAudioEngine.getOfflineRenderStatus();
+    if (
+      typeof status !== 'object' ||
+      status === null ||
+      !OFFLINE_RENDER_STATES.includes(status.state) ||
+      !Number.isFinite(status.renderedFrames) ||
+      !Number.isFinite(status.writtenFrames) ||
+      !Number.isFinite(status.totalFrames)
+    ) {
+      throw new Error('AudioEngine returned invalid offline render status');
+    }
+    return status;
+  }
+
+  /**
+   * Uploads planar Float32 PCM for clip players. `storageFormat` selects how the engine keeps it
+   * resident: `'int16'` and `'float16'` halve the memory and are decoded while the clip plays.
+   */
   public async uploadClipBuffer(
     bufferKey: string,
     sampleRate: number,
     channels: number,
     frames: number,
     channelData: ReadonlyArray<ChannelPayload>,
+    options: { storageFormat?: SampleStorageFormat } = {},
   ): Promise<void> {
+    const storageFormat = options.storageFormat ?? 'float32';
+    if (!SAMPLE_STORAGE_FORMATS.includes(storageFormat)) {
+      throw new Error(`storageFormat must be one of ${SAMPLE_STORAGE_FORMATS.join(', ')}`);
+    }
     if (!Number.isFinite(sampleRate) || sampleRate <= 0) {
       throw new Error('sampleRate must be a positive number');
     }
@@ -284,6 +557,83 @@ export class AudioEngine {
       channels,
       frames,
       normalizedChannels,
+      storageFormat,
+    );
+  }
+
+  /**
+   * Registers a clip whose planar Float32 PCM (`channels` runs of `frames` native-endian samples
+   * after `dataOffsetBytes` of header) already sits in a file. Native code maps the file instead of
+   * copying samples across the bridge. Release it with `releaseClipBuffer`.
+   */
+  public async registerClipBufferFile(
+    bufferKey: string,
+    filePath: string,
+    sampleRate: number,
+    channels: number,
+    frames: number,
+    dataOffsetBytes = 0,
+  ): Promise<void> {
+    if (typeof bufferKey !== 'string' || bufferKey.length === 0) {
+      throw new Error('bufferKey must be a non-empty string');
+    }
+    if (typeof filePath !== 'string' || filePath.length === 0) {
+      throw new Error('filePath must be a non-empty string');
+    }
+    if (!Number.isFinite(sampleRate) || sampleRate <= 0) {
+      throw new Error('sampleRate must be a positive number');
+    }
+    if (!Number.isInteger(channels) || channels <= 0 || channels > 64) {
+      throw new Error('channels must be a positive integer less than or equal to 64');
+    }
+    if (!Number.isInteger(frames) || frames <= 0) {
+      throw new Error('frames must be a positive integer');
+    }
+    if (!Number.isInteger(dataOffsetBytes) || dataOffsetBytes < 0 || dataOffsetBytes % 4 !== 0) {
+      throw new Error('dataOffsetBytes must be a non-negative multiple of 4');
+    }
+    await NativeAudioEngine.registerClipBufferFile(
+      bufferKey,
+      filePath,
+      sampleRate,
+      channels,
+      frames,
+      dataOffsetBytes,
+    );
+  }
+
+  /**
+   * Registers a clip that streams from a decoded cache file (interleaved Float32 PCM after
+   * `dataOffsetBytes` of header) instead of being uploaded. Release it with `releaseClipBuffer`.
+   */
+  public async registerClipStream(
+    bufferKey: string,
+    filePath: string,
+    sampleRate: number,
+    channels: number,
+    dataOffsetBytes = 0,
+  ): Promise<void> {
+    if (typeof bufferKey !== 'string' || bufferKey.length === 0) {
+      throw new Error('bufferKey must be a non-empty string');
+    }
+    if (typeof filePath !== 'string' || filePath.length === 0) {
+      throw new Error('filePath must be a non-empty string');
+    }
+    if (!Number.isFinite(sampleRate) || sampleRate <= 0) {
+      throw new Error('sampleRate must be a positive number');
+    }
+    if (!Number.isInteger(channels) || channels <= 0 || channels > 64) {
+      throw new Error('channels must be a positive integer less than or equal to 64');
+    }
+    if (!Number.isInteger(dataOffsetBytes) || dataOffsetBytes < 0 || dataOffsetBytes % 4 !== 0) {
+      throw new Error('dataOffsetBytes must be a non-negative multiple of 4');
+    }
+    await NativeAudioEngine.registerClipStream(
+      bufferKey,
+      filePath,
+      sampleRate,
+      channels,
+      dataOffsetBytes,
     );
   }
 
@@ -298,9 +648,33 @@ export class AudioEngine {
     if (nodeIds.length === 0) {
       return;
     }
+    const pending = this.pendingCommands;
+    if (pending) {
+      nodeIds.forEach((nodeId) => pending.removeNode(nodeId));
+      return;
+    }
 
     await Promise.all(nodeIds.map((nodeId) => NativeAudioEngine.removeNode(nodeId)));
   }
+
+  private async flushGraphCommands(): Promise<void> {
+    const pending = this.pendingCommands;
+    this.pendingCommands = null;
+    if (pending && pending.commandCount > 0) {
+      await NativeAudioEngine.applyGraphCommands(pending.toBase64());
+    }
+  }
+
+  /** Sends what a batch has recorded so far, keeping it open for later edits. */
+  private async flushPendingCommands(): Promise<void> {
+    const pending = this.pendingCommands;
+    if (!pending || pending.commandCount === 0) {
+      return;
+    }
+    const encoded = pending.toBase64();
+    pending.clear();
+    await NativeAudioEngine.applyGraphCommands(encoded);
+  }
 }
 
 export { AutomationLane, publishAutomationLane, ClockSyncService };
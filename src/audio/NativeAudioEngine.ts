@@ -3,8 +3,46 @@ import { TurboModuleRegistry, NativeModules } from 'react-native';
 
 type NodeId = string;
 
+export type RampCurve = 'linear' | 'exponential';
+
+export type SampleStorageFormat = 'float32' | 'int16' | 'float16';
+
+export type OfflineRenderFormat = 'float32' | 'int16';
+
+export type OfflineRenderState = 'idle' | 'rendering' | 'finished' | 'cancelled' | 'failed';
+
+export type TimingSummary = {
+  count: number;
+  mean: number;
+  p50: number;
+  p95: number;
+  p99: number;
+  max: number;
+};
+
+export type RenderProfile = {
+  enabled: boolean;
+  blocks: number;
+  overloads: number;
+  renderErrors: number;
+  droppedRecords: number;
+  renderMicros: TimingSummary;
+  dspLoad: TimingSummary;
+  callbackJitterMicros: TimingSummary;
+  nodes: Array<{ nodeId: string; renderMicros: TimingSummary }>;
+};
+
 export interface AudioEngineSpec extends TurboModule {
-  initialize(sampleRate: number, framesPerBuffer: number): Promise<void>;
+  /**
+   * `maxChannels` and `maxFramesPerBuffer` size the render graph; 0 keeps the engine defaults of
+   * four output channels and 1024-frame blocks.
+   */
+  initialize(
+    sampleRate: number,
+    framesPerBuffer: number,
+    maxChannels: number,
+    maxFramesPerBuffer: number,
+  ): Promise<void>;
   shutdown(): Promise<void>;
   addNode(
     nodeId: NodeId,
@@ -17,17 +55,45 @@ export interface AudioEngineSpec extends TurboModule {
     channels: number,
     frames: number,
     channelData: ArrayBuffer[],
+    storageFormat?: SampleStorageFormat,
+  ): Promise<void>;
+  registerClipBufferFile(
+    bufferKey: string,
+    filePath: string,
+    sampleRate: number,
+    channels: number,
+    frames: number,
+    dataOffsetBytes: number,
+  ): Promise<void>;
+  registerClipStream(
+    bufferKey: string,
+    filePath: string,
+    sampleRate: number,
+    channels: number,
+    dataOffsetBytes: number,
   ): Promise<void>;
   unregisterClipBuffer(bufferKey: string): Promise<void>;
   removeNode(nodeId: NodeId): Promise<void>;
   connectNodes(source: NodeId, destination: NodeId): Promise<void>;
   disconnectNodes(source: NodeId, destination: NodeId): Promise<void>;
+  /** `commands` is a base64-encoded `GraphCommandBuffer`; see `bridge/GraphCommandBuffer.ts`. */
+  applyGraphCommands(commands: string): Promise<void>;
+  beginGraphUpdate(): Promise<void>;
+  commitGraphUpdate(): Promise<void>;
   scheduleParameterAutomation(
     nodeId: NodeId,
     parameter: string,
     frame: number,
     value: number,
   ): Promise<void>;
+  scheduleParameterRamp(
+    nodeId: NodeId,
+    parameter: string,
+    frame: number,
+    value: number,
+    durationFrames: number,
+    curve: RampCurve,
+  ): Promise<void>;
   startTransport(): Promise<void>;
   stopTransport(): Promise<void>;
   locateTransport(frame: number): Promise<void>;
@@ -35,11 +101,31 @@ export interface AudioEngineSpec extends TurboModule {
     currentFrame: number;
     isPlaying: boolean;
   }>;
+  startOfflineRender(
+    filePath: string,
+    frameCount: number,
+    channels: number,
+    workerCount: number,
+    sampleFormat: OfflineRenderFormat,
+  ): Promise<void>;
+  cancelOfflineRender(): Promise<void>;
+  getOfflineRenderStatus(): Promise<{
+    state: OfflineRenderState;
+    renderedFrames: number;
+    writtenFrames: number;
+    totalFrames: number;
+    error?: string;
+  }>;
   getRenderDiagnostics(): Promise<{
     xruns: number;
     lastRenderDurationMicros: number;
     clipBufferBytes: number;
+    scratchBufferCount?: number;
+    scratchBufferBytes?: number;
+    streamUnderruns?: number;
   }>;
+  setProfilingEnabled(enabled: boolean): Promise<void>;
+  getRenderProfile(): Promise<RenderProfile>;
 }
 
 const moduleName = 'AudioEngineModule';
@@ -435,7 +435,7 @@ export class SessionAudioBridge {
 
     if (session.metadata.sampleRate !== sampleRate) {
       this.logger.warn(
-        `Session sample rate ${session.metadata.sampleRate} does not match engine sample rate ${sampleRate}; resampling clips`,
+        `Session sample rate ${session.metadata.sampleRate} does not match engine sample rate ${sampleRate}; clips are resampled during playback`,
       );
     }
 
@@ -747,14 +747,16 @@ export class SessionAudioBridge {
     automationKey: string;
     bufferDescriptor: ClipBufferDescriptor;
   }> {
-    const bufferDescriptor = await this.bufferCache.getClipBuffer(
-      clip.audioFile,
-      sampleRate,
-    );
+    const bufferDescriptor = await this.bufferCache.getClipBuffer(clip.audioFile);
 
     const startFrame = this.quantizeFrame(this.msToFrames(clip.start, sampleRate));
     const requestedFrames = Math.max(1, this.msToFrames(clip.duration, sampleRate));
-    const playbackFrames = Math.min(requestedFrames, bufferDescriptor.frames);
+    // Buffers keep their native rate and the clip player resamples, so measure the clip in session frames.
+    const bufferSessionFrames = Math.max(
+      1,
+      Math.floor((bufferDescriptor.frames * sampleRate) / bufferDescriptor.sampleRate),
+    );
+    const playbackFrames = Math.min(requestedFrames, bufferSessionFrames);
     const endFrame = this.quantizeFrame(startFrame + playbackFrames);
     const fadeInFrames = Math.min(
       playbackFrames,
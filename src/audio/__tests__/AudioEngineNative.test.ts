@@ -7,6 +7,8 @@ type AudioEngineMockState = {
   initialized: boolean;
   sampleRate: number;
   framesPerBuffer: number;
+  maxChannels: number;
+  maxFramesPerBuffer: number;
   nodes: Map<
     string,
     {
@@ -37,6 +39,14 @@ type AudioEngineMockState = {
     isPlaying: boolean;
     lastUpdatedMs: number;
   };
+  offlineRender: {
+    state: string;
+    filePath: string;
+    renderedFrames: number;
+    totalFrames: number;
+    error?: string;
+  };
+  graphUpdate: { depth: number; commits: number };
 };
 
 const resolveMockState = (): AudioEngineMockState => {
@@ -49,6 +59,8 @@ describe('NativeAudioEngine TurboModule', () => {
     state.initialized = false;
     state.sampleRate = 0;
     state.framesPerBuffer = 0;
+    state.maxChannels = 0;
+    state.maxFramesPerBuffer = 0;
     state.nodes.clear();
     state.connections.clear();
     state.diagnostics.xruns = 0;
@@ -74,6 +86,8 @@ describe('NativeAudioEngine TurboModule', () => {
       expect(state.initialized).toBe(true);
       expect(state.sampleRate).toBe(48000);
       expect(state.framesPerBuffer).toBe(256);
+      expect(state.maxChannels).toBe(0);
+      expect(state.maxFramesPerBuffer).toBe(0);
 
       await engine.configureNodes([
         {
@@ -166,6 +180,30 @@ describe('NativeAudioEngine TurboModule', () => {
       expect(state.automations.size).toBe(0);
     });
 
+    it('forwards graph channel and block limits to initialize', async () => {
+      const engine = new AudioEngine({
+        sampleRate: 48000,
+        framesPerBuffer: 256,
+        bpm: 120,
+        maxChannels: 16,
+        maxFramesPerBuffer: 4096,
+      });
+
+      await engine.init();
+      const state = resolveMockState();
+      expect(state.maxChannels).toBe(16);
+      expect(state.maxFramesPerBuffer).toBe(4096);
+      await engine.dispose();
+
+      const base = { sampleRate: 48000, framesPerBuffer: 256, bpm: 120 };
+      expect(() => new AudioEngine({ ...base, maxChannels: -1 })).toThrow(
+        'maxChannels must be a non-negative integer',
+      );
+      expect(() => new AudioEngine({ ...base, maxFramesPerBuffer: 1.5 })).toThrow(
+        'maxFramesPerBuffer must be a non-negative integer',
+      );
+    });
+
     it('allows re-initialization after disposal', async () => {
       const engine = new AudioEngine({
         sampleRate: 44100,
@@ -721,6 +759,40 @@ describe('NativeAudioEngine TurboModule', () => {
       expect(diagnostics.lastRenderDurationMicros).toBe(0);
       expect(diagnostics.clipBufferBytes).toBe(0);
     });
+
+    it('toggles the render profiler', async () => {
+      const setSpy = jest.spyOn(NativeAudioEngine, 'setProfilingEnabled');
+      expect((await engine.getRenderProfile()).enabled).toBe(false);
+
+      await engine.setProfilingEnabled(true);
+      expect(setSpy).toHaveBeenCalledWith(true);
+      const profile = await engine.getRenderProfile();
+      expect(profile.enabled).toBe(true);
+      expect(profile.renderMicros).toEqual({ count: 0, mean: 0, p50: 0, p95: 0, p99: 0, max: 0 });
+      expect(profile.nodes).toEqual([]);
+
+      await expect(
+        engine.setProfilingEnabled('yes' as unknown as boolean),
+      ).rejects.toThrow('enabled must be a boolean');
+      setSpy.mockRestore();
+    });
+
+    it('rejects malformed render profiles', async () => {
+      const profileSpy = jest
+        .spyOn(NativeAudioEngine, 'getRenderProfile')
+        .mockResolvedValueOnce({ enabled: true } as never);
+      await expect(engine.getRenderProfile()).rejects.toThrow(
+        'AudioEngine returned invalid render profile payload',
+      );
+      profileSpy.mockRestore();
+    });
+
+    it('turns profiling off when the engine is re-initialized', async () => {
+      await engine.setProfilingEnabled(true);
+      await engine.dispose();
+      await engine.init();
+      expect((await engine.getRenderProfile()).enabled).toBe(false);
+    });
   });
 
   describe('ClockSyncService Integration', () => {
@@ -1079,4 +1151,165 @@ describe('NativeAudioEngine TurboModule', () => {
       });
     });
   });
+
+  describe('Offline rendering', () => {
+    let engine: AudioEngine;
+
+    beforeEach(async () => {
+      engine = new AudioEngine({ sampleRate: 48000, framesPerBuffer: 256, bpm: 120 });
+      await engine.init();
+    });
+
+    afterEach(async () => {
+      jest.restoreAllMocks();
+      await engine.dispose();
+    });
+
+    it('bounces to a file and reports progress until finished', async () => {
+      const progress: number[] = [];
+      const result = await engine.renderOffline({
+        filePath: '/tmp/daft-citadel/bounce.wav',
+        frameCount: 120000,
+        sampleFormat: 'int16',
+        pollIntervalMs: 0,
+        onProgress: (update) => progress.push(update.renderedFrames),
+      });
+      expect(result).toEqual({
+        state: 'finished',
+        renderedFrames: 120000,
+        writtenFrames: 120000,
+        totalFrames: 120000,
+      });
+      expect(progress).toEqual([48000, 96000, 120000]);
+      expect(resolveMockState().offlineRender.filePath).toBe('/tmp/daft-citadel/bounce.wav');
+    });
+
+    it('cancels the bounce when the signal aborts', async () => {
+      const controller = new AbortController();
+      const cancelSpy = jest.spyOn(NativeAudioEngine, 'cancelOfflineRender');
+      const pending = engine.renderOffline({
+        filePath: '/tmp/daft-citadel/bounce.wav',
+        frameCount: 48000 * 60,
+        pollIntervalMs: 0,
+        signal: controller.signal,
+        onProgress: () => controller.abort(),
+      });
+      await expect(pending).rejects.toThrow('Offline render cancelled');
+      expect(cancelSpy).toHaveBeenCalledTimes(1);
+      expect(resolveMockState().offlineRender.state).toBe('cancelled');
+    });
+
+    it('surfaces native failures', async () => {
+      jest.spyOn(NativeAudioEngine, 'getOfflineRenderStatus').mockResolvedValueOnce({
+        state: 'failed',
+        renderedFrames: 1024,
+        writtenFrames: 0,
+        totalFrames: 48000,
+        error: 'cannot write samples',
+      });
+      await expect(
+        engine.renderOffline({ filePath: '/tmp/daft-citadel/bounce.wav', frameCount: 48000 }),
+      ).rejects.toThrow('Offline render failed: cannot write samples');
+    });
+
+    it('validates options before reaching the native module', async () => {
+      const startSpy = jest.spyOn(NativeAudioEngine, 'startOfflineRender');
+      await expect(
+        engine.renderOffline({ filePath: '', frameCount: 48000 }),
+      ).rejects.toThrow('filePath must be a non-empty string');
+      await expect(
+        engine.renderOffline({ filePath: '/tmp/bounce.wav', frameCount: 0.5 }),
+      ).rejects.toThrow('frameCount must be a positive integer');
+      await expect(
+        engine.renderOffline({
+          filePath: '/tmp/bounce.wav',
+          frameCount: 48000,
+          sampleFormat: 'float16' as never,
+        }),
+      ).rejects.toThrow('sampleFormat must be one of float32, int16');
+      expect(startSpy).not.toHaveBeenCalled();
+    });
+  });
+
+  describe('Graph batches', () => {
+    let engine: AudioEngine;
+
+    beforeEach(async () => {
+      engine = new AudioEngine({ sampleRate: 48000, framesPerBuffer: 256, bpm: 120 });
+      await engine.init();
+    });
+
+    afterEach(async () => {
+      jest.restoreAllMocks();
+      await engine.dispose();
+    });
+
+    it('sends nested batches across the bridge in one command buffer', async () => {
+      const applySpy = jest.spyOn(NativeAudioEngine, 'applyGraphCommands');
+      const addSpy = jest.spyOn(NativeAudioEngine, 'addNode');
+      const connectSpy = jest.spyOn(NativeAudioEngine, 'connectNodes');
+      await engine.batchGraphUpdate(async () => {
+        await engine.configureNodes([
+          { id: 'osc', type: 'sine', options: { frequency: 440 } },
+          { id: 'gain', type: 'gain', options: { gain: 0.5 } },
+        ]);
+        await engine.batchGraphUpdate(() => engine.connect('osc', 'gain'));
+        await engine.connect('gain', OUTPUT_BUS);
+        await engine.rampParameter('gain', 'gain', 0, 1, 480, 'exponential');
+        expect(applySpy).not.toHaveBeenCalled();
+      });
+      expect(applySpy).toHaveBeenCalledTimes(1);
+      expect(addSpy).toHaveBeenCalledTimes(2);
+      expect(connectSpy).toHaveBeenCalledTimes(2);
+      const state = resolveMockState();
+      expect(state.graphUpdate).toEqual({ depth: 0, commits: 1 });
+      expect([...state.connections]).toEqual(['osc->gain', `gain->${OUTPUT_BUS}`]);
+      expect(state.automations.get('gain')?.get('gain')).toEqual([
+        { frame: 0, value: 1, durationFrames: 480, curve: 'exponential' },
+      ]);
+    });
+
+    it('flushes recorded nodes before publishing automation', async () => {
+      const lane = new AutomationLane('gain');
+      lane.addPoint({ frame: 128, value: 0.25 });
+      await engine.batchGraphUpdate(async () => {
+        await engine.configureNodes([{ id: 'gain', type: 'gain' }]);
+        await engine.publishAutomation('gain', lane);
+        await engine.connect('gain', OUTPUT_BUS);
+      });
+      const state = resolveMockState();
+      expect(state.automations.get('gain')?.get('gain')).toEqual([{ frame: 128, value: 0.25 }]);
+      expect(state.connections.has(`gain->${OUTPUT_BUS}`)).toBe(true);
+    });
+
+    it('rejects the batch with the failing command and still sends the update', async () => {
+      await expect(
+        engine.batchGraphUpdate(async () => {
+          await engine.configureNodes([{ id: 'osc', type: 'sine' }]);
+          await engine.connect('missing', OUTPUT_BUS);
+        }),
+      ).rejects.toThrow("graph command 1: Source node 'missing' is not registered");
+      const state = resolveMockState();
+      expect(state.nodes.has('osc')).toBe(true);
+      expect(state.graphUpdate).toEqual({ depth: 0, commits: 1 });
+    });
+
+    it('flushes what was recorded when the update throws', async () => {
+      await expect(
+        engine.batchGraphUpdate(async () => {
+          await engine.configureNodes([{ id: 'osc', type: 'sine' }]);
+          throw new Error('reconcile failed');
+        }),
+      ).rejects.toThrow('reconcile failed');
+      expect(resolveMockState().nodes.has('osc')).toBe(true);
+    });
+
+    it('validates arguments while recording', async () => {
+      await expect(
+        engine.batchGraphUpdate(() => engine.rampParameter('gain', 'gain', 1.5, 1, 10)),
+      ).rejects.toThrow('frame must be a non-negative integer');
+      expect(resolveMockState().graphUpdate.commits).toBe(0);
+    });
+  });
+  });
 });
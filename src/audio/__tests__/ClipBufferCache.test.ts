@@ -33,7 +33,7 @@ describe('ClipBufferCache', () => {
     const logger = createLogger();
     const cache = new ClipBufferCache(loader, uploader, logger);
 
-    const descriptor = await cache.getClipBuffer('fixtures/clip.wav', sampleRate);
+    const descriptor = await cache.getClipBuffer('fixtures/clip.wav');
     expect(loader.load).toHaveBeenCalledTimes(1);
     expect(uploader.uploadClipBuffer).toHaveBeenCalledTimes(1);
 
@@ -46,7 +46,7 @@ describe('ClipBufferCache', () => {
     await cache.releaseClipBuffer(descriptor.bufferKey);
     expect(uploader.releaseClipBuffer).toHaveBeenCalledTimes(1);
 
-    const reloaded = await cache.getClipBuffer('fixtures/clip.wav', sampleRate);
+    const reloaded = await cache.getClipBuffer('fixtures/clip.wav');
     expect(loader.load).toHaveBeenCalledTimes(2);
     expect(uploader.uploadClipBuffer).toHaveBeenCalledTimes(2);
     expect(reloaded.bufferKey).toBe(descriptor.bufferKey);
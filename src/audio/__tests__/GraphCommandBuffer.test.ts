@@ -0,0 +1,97 @@
+import { Buffer } from 'buffer';
+
+import { GraphCommandBuffer, decodeGraphCommands } from '../bridge/GraphCommandBuffer';
+
+describe('GraphCommandBuffer', () => {
+  it('round-trips every command', () => {
+    const buffer = new GraphCommandBuffer()
+      .addNode('clip', 'clipPlayer', { bufferKey: 'käse', gain: 0.5, loop: true })
+      .connect('clip', '__output__')
+      .setParameter('clip', 'gain', 0.25)
+      .scheduleAutomation('clip', 'gain', 48000, 0.75)
+      .scheduleRamp('clip', 'gain', 96000, 1, 480, 'exponential')
+      .disconnect('clip', '__output__')
+      .removeNode('clip');
+
+    expect(buffer.commandCount).toBe(7);
+    expect(decodeGraphCommands(buffer.toUint8Array())).toEqual([
+      {
+        op: 'addNode',
+        nodeId: 'clip',
+        nodeType: 'clipPlayer',
+        options: { bufferKey: 'käse', gain: 0.5, loop: true },
+      },
+      { op: 'connect', source: 'clip', destination: '__output__' },
+      { op: 'setParameter', nodeId: 'clip', parameter: 'gain', value: 0.25 },
+      {
+        op: 'scheduleAutomation',
+        nodeId: 'clip',
+        parameter: 'gain',
+        frame: 48000,
+        value: 0.75,
+      },
+      {
+        op: 'scheduleRamp',
+        nodeId: 'clip',
+        parameter: 'gain',
+        frame: 96000,
+        value: 1,
+        durationFrames: 480,
+        curve: 'exponential',
+      },
+      { op: 'disconnect', source: 'clip', destination: '__output__' },
+      { op: 'removeNode', nodeId: 'clip' },
+    ]);
+  });
+
+  it('writes the little-endian layout the engine decodes', () => {
+    const bytes = new GraphCommandBuffer().removeNode('ab').toUint8Array();
+    expect(Array.from(bytes)).toEqual([
+      0x44, 0x47, 0x43, 0x42, // "DGCB"
+      1, 0, // version
+      0, 0, // reserved
+      1, 0, 0, 0, // command count
+      2, // removeNode
+      2, 0, 0x61, 0x62, // "ab"
+    ]);
+  });
+
+  it('grows past its initial capacity', () => {
+    const buffer = new GraphCommandBuffer();
+    const ids = Array.from({ length: 200 }, (_unused, index) => `node-${index}`);
+    ids.forEach((id) => buffer.connect(id, '__output__'));
+    const decoded = decodeGraphCommands(buffer.toUint8Array());
+    expect(decoded).toHaveLength(200);
+    expect(decoded[199]).toEqual({
+      op: 'connect',
+      source: 'node-199',
+      destination: '__output__',
+    });
+  });
+
+  it('leaves the buffer unchanged when a command is rejected', () => {
+    const buffer = new GraphCommandBuffer().removeNode('kept');
+    const before = buffer.byteLength;
+    expect(() => buffer.addNode('osc', 'sine', { frequency: Number.NaN })).toThrow(
+      "option 'frequency' must be a finite number",
+    );
+    expect(() => buffer.connect('', 'gain')).toThrow('source must be a non-empty string');
+    expect(() => buffer.scheduleAutomation('osc', 'gain', -1, 0)).toThrow(
+      'frame must be a non-negative integer',
+    );
+    expect(() => buffer.addNode('osc', 'sine', { label: 'x'.repeat(70000) })).toThrow(
+      "option 'label' exceeds 65535 UTF-8 bytes",
+    );
+    expect(buffer.byteLength).toBe(before);
+    expect(decodeGraphCommands(buffer.toUint8Array())).toEqual([
+      { op: 'removeNode', nodeId: 'kept' },
+    ]);
+  });
+
+  it('encodes to base64 for the bridge', () => {
+    const buffer = new GraphCommandBuffer().connect('a', 'b');
+    expect(Buffer.from(buffer.toBase64(), 'base64')).toEqual(
+      Buffer.from(buffer.toUint8Array()),
+    );
+  });
+});
@@ -4,6 +4,7 @@ import {
   AudioFileData,
 } from '../SessionAudioBridge';
 import { AudioEngine } from '../AudioEngine';
+import type { NodeConfiguration } from '../AudioEngine';
 import { AutomationLane, ClockSyncService } from '../Automation';
 import {
   AutomationCurve,
@@ -69,6 +70,7 @@ const createMockEngine = (
   clock: ClockSyncService,
 ): {
   engine: AudioEngine;
+  batchGraphUpdate: jest.Mock;
   configureNodes: jest.Mock;
   connect: jest.Mock;
   disconnect: jest.Mock;
@@ -85,6 +87,7 @@ const createMockEngine = (
   const configureNodes = jest.fn(async () => undefined);
   const connect = jest.fn(async () => undefined);
   const disconnect = jest.fn(async () => undefined);
+  const batchGraphUpdate = jest.fn(<T>(update: () => Promise<T>) => update());
   const publishAutomation = jest.fn(async () => undefined);
   const removeNodes = jest.fn(async () => undefined);
   const uploadClipBuffer = jest.fn(async () => undefined);
@@ -103,6 +106,7 @@ const createMockEngine = (
     configureNodes,
     connect,
     disconnect,
+    batchGraphUpdate,
     publishAutomation,
     removeNodes,
     uploadClipBuffer,
@@ -115,6 +119,7 @@ const createMockEngine = (
   };
   return {
     engine: engine as AudioEngine,
+    batchGraphUpdate,
     configureNodes,
     connect,
     disconnect,
@@ -327,6 +332,7 @@ describe('SessionAudioBridge', () => {
     const clock = new ClockSyncService(sampleRate, framesPerBuffer, 120);
     const {
       engine,
+      batchGraphUpdate,
       configureNodes,
       connect,
       disconnect,
@@ -348,6 +354,7 @@ describe('SessionAudioBridge', () => {
       frames,
       expect.any(Array),
     );
+    expect(batchGraphUpdate).toHaveBeenCalledTimes(1);
     expect(configureNodes).toHaveBeenCalledTimes(1);
     const initialNodes = configureNodes.mock.calls[0][0];
     expect(initialNodes).toEqual(
@@ -638,7 +645,7 @@ describe('SessionAudioBridge', () => {
     expect(payload.points).toEqual([{ frame: 0, value: 0.75 }]);
   });
 
-  it('resamples audio when loader sample rate differs from engine sample rate', async () => {
+  it('uploads clips at their native rate and sizes playback in session frames', async () => {
     const mismatchRate = 44100;
     const loaderFrames = Math.floor((frames * mismatchRate) / sampleRate);
     const { loader, loadMock } = createLoader(sampleRate, frames, {
@@ -646,7 +653,7 @@ describe('SessionAudioBridge', () => {
       frames: loaderFrames,
     });
     const clock = new ClockSyncService(sampleRate, framesPerBuffer, 120);
-    const { engine, uploadClipBuffer } = createMockEngine(clock);
+    const { engine, uploadClipBuffer, configureNodes } = createMockEngine(clock);
     const bridge = new SessionAudioBridge(engine, { fileLoader: loader });
 
     await bridge.applySessionUpdate(createSession({ revision: 9 }));
@@ -654,17 +661,19 @@ describe('SessionAudioBridge', () => {
     expect(loadMock).toHaveBeenCalled();
     expect(uploadClipBuffer).toHaveBeenCalledWith(
       expect.any(String),
-      sampleRate,
+      mismatchRate,
       1,
-      expect.any(Number),
+      loaderFrames,
       expect.any(Array),
     );
-    const [, , , resampledFrames] = uploadClipBuffer.mock.calls[0];
-    const expectedFrames = Math.max(
-      1,
-      Math.round(loaderFrames * (sampleRate / mismatchRate)),
+    const clipNode = configureNodes.mock.calls[0][0].find(
+      (node: NodeConfiguration) => node.type === 'clipPlayer',
+    );
+    expect(clipNode.options.bufferSampleRate).toBe(mismatchRate);
+    const sessionFrames = Math.floor((loaderFrames * sampleRate) / mismatchRate);
+    expect(clipNode.options.endFrame - clipNode.options.startFrame).toBeLessThanOrEqual(
+      sessionFrames,
     );
-    expect(resampledFrames).toBe(expectedFrames);
   });
 
   it('loads plugin instances and releases them as the routing graph mutates', async () => {
@@ -67,37 +67,27 @@ export class ClipBufferCache {
     private readonly logger: Logger,
   ) {}
 
-  async getClipBuffer(
-    filePath: string,
-    targetSampleRate: number,
-  ): Promise<ClipBufferDescriptor> {
-    const key = this.buildCacheKey(filePath, targetSampleRate);
+  /**
+   * Decodes and uploads `filePath` at its native sample rate. The engine's clip players resample in
+   * realtime, so one upload serves every session rate and no converted copy is kept.
+   */
+  async getClipBuffer(filePath: string): Promise<ClipBufferDescriptor> {
+    const key = this.buildCacheKey(filePath);
     const cached = this.cache.get(key);
     if (cached) {
-      this.logger.debug('ClipBufferCache hit', { filePath, targetSampleRate });
+      this.logger.debug('ClipBufferCache hit', { filePath });
       await cached.upload;
       return cached.descriptor;
     }
 
-    const decoded = await this.loader.load(filePath);
-    this.validateDecodedBuffer(filePath, decoded);
-
-    const prepared =
-      decoded.sampleRate === targetSampleRate
-        ? decoded
-        : this.resampleBuffer(decoded, targetSampleRate);
-
-    if (decoded.sampleRate !== targetSampleRate) {
-      this.logger.info(
-        `Resampled ${filePath} from ${decoded.sampleRate}Hz to ${targetSampleRate}Hz`,
-      );
-    }
+    const prepared = await this.loader.load(filePath);
+    this.validateDecodedBuffer(filePath, prepared);
 
     const descriptor: ClipBufferDescriptor = {
       bufferKey: hashString(
-        `${filePath}:${targetSampleRate}:${prepared.frames}:${prepared.channels}`,
+        `${filePath}:${prepared.sampleRate}:${prepared.frames}:${prepared.channels}`,
       ),
-      sampleRate: targetSampleRate,
+      sampleRate: prepared.sampleRate,
       channels: prepared.channels,
       frames: prepared.frames,
     };
@@ -196,41 +186,8 @@ export class ClipBufferCache {
     }
   }
 
-  private resampleBuffer(buffer: AudioFileData, targetSampleRate: number): AudioFileData {
-    const ratio = targetSampleRate / buffer.sampleRate;
-    const nextFrameCount = Math.max(1, Math.round(buffer.frames * ratio));
-    const resampledChannels = buffer.data.map((channel) =>
-      this.resampleChannel(channel, ratio, nextFrameCount),
-    );
-    return {
-      sampleRate: targetSampleRate,
-      channels: buffer.channels,
-      frames: nextFrameCount,
-      data: resampledChannels,
-    };
-  }
-
-  private resampleChannel(
-    channel: Float32Array,
-    ratio: number,
-    nextFrameCount: number,
-  ): Float32Array {
-    const result = new Float32Array(nextFrameCount);
-    const maxIndex = channel.length - 1;
-    for (let i = 0; i < nextFrameCount; i += 1) {
-      const sourceIndex = i / ratio;
-      const indexFloor = Math.floor(sourceIndex);
-      const indexCeil = Math.min(indexFloor + 1, maxIndex);
-      const t = sourceIndex - indexFloor;
-      const start = channel[indexFloor] ?? 0;
-      const end = channel[indexCeil] ?? start;
-      result[i] = start + (end - start) * t;
-    }
-    return result;
-  }
-
-  private buildCacheKey(filePath: string, targetSampleRate: number): CacheKey {
-    return `${filePath}@${targetSampleRate}`;
+  private buildCacheKey(filePath: string): CacheKey {
+    return filePath;
   }
 }
 
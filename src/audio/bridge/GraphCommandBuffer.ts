@@ -0,0 +1,386 @@
+import { Buffer } from 'buffer';
+
+import type { RampCurve } from '../NativeAudioEngine';
+
+type NodeOptionValue = number | string | boolean;
+
+export type GraphCommand =
+  | {
+      op: 'addNode';
+      nodeId: string;
+      nodeType: string;
+      options: Record<string, NodeOptionValue>;
+    }
+  | { op: 'removeNode'; nodeId: string }
+  | { op: 'connect'; source: string; destination: string }
+  | { op: 'disconnect'; source: string; destination: string }
+  | { op: 'setParameter'; nodeId: string; parameter: string; value: number }
+  | {
+      op: 'scheduleAutomation';
+      nodeId: string;
+      parameter: string;
+      frame: number;
+      value: number;
+    }
+  | {
+      op: 'scheduleRamp';
+      nodeId: string;
+      parameter: string;
+      frame: number;
+      value: number;
+      durationFrames: number;
+      curve: RampCurve;
+    };
+
+// Layout shared with audio-engine/platform/common/GraphCommandBuffer.h; keep the two in step.
+const MAGIC = 0x42434744; // "DGCB" as a little-endian u32
+const VERSION = 1;
+const HEADER_BYTES = 12;
+const MAX_STRING_BYTES = 0xffff;
+const MAX_OPTIONS = 0xffff;
+
+const OPCODES = {
+  addNode: 1,
+  removeNode: 2,
+  connect: 3,
+  disconnect: 4,
+  setParameter: 5,
+  scheduleAutomation: 6,
+  scheduleRamp: 7,
+} as const;
+
+const OPTION_NUMBER = 0;
+const OPTION_STRING = 1;
+const OPTION_BOOLEAN = 2;
+
+/**
+ * Records graph edits into the binary layout the native engine decodes, so a whole batch crosses
+ * the bridge in one call. Arguments are validated while recording; a rejected call leaves the
+ * buffer as it was.
+ */
+export class GraphCommandBuffer {
+  private bytes = new Uint8Array(256);
+
+  private view = new DataView(this.bytes.buffer);
+
+  private length = HEADER_BYTES;
+
+  private count = 0;
+
+  get commandCount(): number {
+    return this.count;
+  }
+
+  get byteLength(): number {
+    return this.length;
+  }
+
+  addNode(
+    nodeId: string,
+    nodeType: string,
+    options: Record<string, NodeOptionValue> = {},
+  ): this {
+    const entries = Object.entries(options);
+    if (entries.length > MAX_OPTIONS) {
+      throw new Error(`node '${nodeId}' has more than ${MAX_OPTIONS} options`);
+    }
+    return this.record(() => {
+      this.writeU8(OPCODES.addNode);
+      this.writeId(nodeId, 'nodeId');
+      this.writeId(nodeType, 'nodeType');
+      this.writeU16(entries.length);
+      entries.forEach(([key, value]) => {
+        this.writeId(key, 'option key');
+        if (typeof value === 'number') {
+          this.writeU8(OPTION_NUMBER);
+          this.writeNumber(value, `option '${key}'`);
+        } else if (typeof value === 'string') {
+          this.writeU8(OPTION_STRING);
+          this.writeString(value, `option '${key}'`);
+        } else if (typeof value === 'boolean') {
+          this.writeU8(OPTION_BOOLEAN);
+          this.writeU8(value ? 1 : 0);
+        } else {
+          throw new Error(`option '${key}' must be a number, string or boolean`);
+        }
+      });
+    });
+  }
+
+  removeNode(nodeId: string): this {
+    return this.record(() => {
+      this.writeU8(OPCODES.removeNode);
+      this.writeId(nodeId, 'nodeId');
+    });
+  }
+
+  connect(source: string, destination: string): this {
+    return this.record(() => {
+      this.writeU8(OPCODES.connect);
+      this.writeId(source, 'source');
+      this.writeId(destination, 'destination');
+    });
+  }
+
+  disconnect(source: string, destination: string): this {
+    return this.record(() => {
+      this.writeU8(OPCODES.disconnect);
+      this.writeId(source, 'source');
+      this.writeId(destination, 'destination');
+    });
+  }
+
+  /** Sets a parameter at the start of the next render block. */
+  setParameter(nodeId: string, parameter: string, value: number): this {
+    return this.record(() => {
+      this.writeU8(OPCODES.setParameter);
+      this.writeId(nodeId, 'nodeId');
+      this.writeId(parameter, 'parameter');
+      this.writeNumber(value, 'value');
+    });
+  }
+
+  scheduleAutomation(
+    nodeId: string,
+    parameter: string,
+    frame: number,
+    value: number,
+  ): this {
+    return this.record(() => {
+      this.writeU8(OPCODES.scheduleAutomation);
+      this.writeId(nodeId, 'nodeId');
+      this.writeId(parameter, 'parameter');
+      this.writeFrame(frame);
+      this.writeNumber(value, 'value');
+    });
+  }
+
+  scheduleRamp(
+    nodeId: string,
+    parameter: string,
+    frame: number,
+    value: number,
+    durationFrames: number,
+    curve: RampCurve = 'linear',
+  ): this {
+    if (
+      !Number.isInteger(durationFrames) ||
+      durationFrames < 0 ||
+      durationFrames > 0xffffffff
+    ) {
+      throw new Error('durationFrames must be a non-negative 32-bit integer');
+    }
+    if (curve !== 'linear' && curve !== 'exponential') {
+      throw new Error("curve must be 'linear' or 'exponential'");
+    }
+    return this.record(() => {
+      this.writeU8(OPCODES.scheduleRamp);
+      this.writeId(nodeId, 'nodeId');
+      this.writeId(parameter, 'parameter');
+      this.writeFrame(frame);
+      this.writeNumber(value, 'value');
+      this.writeU32(durationFrames);
+      this.writeU8(curve === 'exponential' ? 1 : 0);
+    });
+  }
+
+  /** Copies out the encoded commands, header included. */
+  toUint8Array(): Uint8Array {
+    this.view.setUint32(0, MAGIC, true);
+    this.view.setUint16(4, VERSION, true);
+    this.view.setUint16(6, 0, true);
+    this.view.setUint32(8, this.count, true);
+    return this.bytes.slice(0, this.length);
+  }
+
+  /** The encoded buffer as base64, which is how it crosses the bridge. */
+  toBase64(): string {
+    return Buffer.from(this.toUint8Array()).toString('base64');
+  }
+
+  clear(): void {
+    this.length = HEADER_BYTES;
+    this.count = 0;
+  }
+
+  private record(write: () => void): this {
+    const start = this.length;
+    try {
+      write();
+    } catch (error) {
+      this.length = start;
+      throw error;
+    }
+    this.count += 1;
+    return this;
+  }
+
+  // Call before reading `bytes` or `view`: growing replaces both.
+  private reserve(bytes: number): number {
+    const offset = this.length;
+    const required = offset + bytes;
+    if (required > this.bytes.byteLength) {
+      let capacity = this.bytes.byteLength * 2;
+      while (capacity < required) {
+        capacity *= 2;
+      }
+      const grown = new Uint8Array(capacity);
+      grown.set(this.bytes.subarray(0, offset));
+      this.bytes = grown;
+      this.view = new DataView(grown.buffer);
+    }
+    this.length = required;
+    return offset;
+  }
+
+  private writeU8(value: number): void {
+    const offset = this.reserve(1);
+    this.view.setUint8(offset, value);
+  }
+
+  private writeU16(value: number): void {
+    const offset = this.reserve(2);
+    this.view.setUint16(offset, value, true);
+  }
+
+  private writeU32(value: number): void {
+    const offset = this.reserve(4);
+    this.view.setUint32(offset, value, true);
+  }
+
+  private writeNumber(value: number, name: string): void {
+    if (typeof value !== 'number' || !Number.isFinite(value)) {
+      throw new Error(`${name} must be a finite number`);
+    }
+    const offset = this.reserve(8);
+    this.view.setFloat64(offset, value, true);
+  }
+
+  private writeFrame(frame: number): void {
+    if (!Number.isSafeInteger(frame) || frame < 0) {
+      throw new Error('frame must be a non-negative integer');
+    }
+    const offset = this.reserve(8);
+    this.view.setFloat64(offset, frame, true);
+  }
+
+  private writeId(value: string, name: string): void {
+    if (typeof value !== 'string' || value.length === 0) {
+      throw new Error(`${name} must be a non-empty string`);
+    }
+    this.writeString(value, name);
+  }
+
+  private writeString(value: string, name: string): void {
+    const encoded = Buffer.from(value, 'utf8');
+    if (encoded.byteLength > MAX_STRING_BYTES) {
+      throw new Error(`${name} exceeds ${MAX_STRING_BYTES} UTF-8 bytes`);
+    }
+    this.writeU16(encoded.byteLength);
+    const offset = this.reserve(encoded.byteLength);
+    this.bytes.set(encoded, offset);
+  }
+}
+
+/**
+ * Decodes a buffer produced by `GraphCommandBuffer`. The engine does this natively; this copy
+ * backs the Jest mock and round-trip tests.
+ */
+export const decodeGraphCommands = (encoded: Uint8Array): GraphCommand[] => {
+  const view = new DataView(encoded.buffer, encoded.byteOffset, encoded.byteLength);
+  let offset = 0;
+  const need = (bytes: number) => {
+    if (offset + bytes > encoded.byteLength) {
+      throw new Error('graph command buffer is truncated');
+    }
+    const start = offset;
+    offset += bytes;
+    return start;
+  };
+  const u8 = () => view.getUint8(need(1));
+  const u16 = () => view.getUint16(need(2), true);
+  const u32 = () => view.getUint32(need(4), true);
+  const f64 = () => view.getFloat64(need(8), true);
+  const str = () => {
+    const bytes = u16();
+    const start = need(bytes);
+    return Buffer.from(encoded.subarray(start, start + bytes)).toString('utf8');
+  };
+
+  if (u32() !== MAGIC || u16() !== VERSION || u16() !== 0) {
+    throw new Error('graph command buffer has an unsupported header');
+  }
+  const count = u32();
+  const commands: GraphCommand[] = [];
+  for (let index = 0; index < count; index += 1) {
+    const op = u8();
+    switch (op) {
+      case OPCODES.addNode: {
+        const nodeId = str();
+        const nodeType = str();
+        const options: Record<string, NodeOptionValue> = {};
+        const optionCount = u16();
+        for (let option = 0; option < optionCount; option += 1) {
+          const key = str();
+          const kind = u8();
+          if (kind === OPTION_NUMBER) {
+            options[key] = f64();
+          } else if (kind === OPTION_STRING) {
+            options[key] = str();
+          } else if (kind === OPTION_BOOLEAN) {
+            options[key] = u8() === 1;
+          } else {
+            throw new Error(`graph command ${index} has unknown option kind ${kind}`);
+          }
+        }
+        commands.push({ op: 'addNode', nodeId, nodeType, options });
+        break;
+      }
+      case OPCODES.removeNode:
+        commands.push({ op: 'removeNode', nodeId: str() });
+        break;
+      case OPCODES.connect:
+      case OPCODES.disconnect:
+        commands.push({
+          op: op === OPCODES.connect ? 'connect' : 'disconnect',
+          source: str(),
+          destination: str(),
+        });
+        break;
+      case OPCODES.setParameter:
+        commands.push({
+          op: 'setParameter',
+          nodeId: str(),
+          parameter: str(),
+          value: f64(),
+        });
+        break;
+      case OPCODES.scheduleAutomation:
+        commands.push({
+          op: 'scheduleAutomation',
+          nodeId: str(),
+          parameter: str(),
+          frame: f64(),
+          value: f64(),
+        });
+        break;
+      case OPCODES.scheduleRamp:
+        commands.push({
+          op: 'scheduleRamp',
+          nodeId: str(),
+          parameter: str(),
+          frame: f64(),
+          value: f64(),
+          durationFrames: u32(),
+          curve: u8() === 1 ? 'exponential' : 'linear',
+        });
+        break;
+      default:
+        throw new Error(`graph command ${index} has unknown opcode ${op}`);
+    }
+  }
+  if (offset !== encoded.byteLength) {
+    throw new Error('graph command buffer has trailing bytes');
+  }
+  return commands;
+};
@@ -27,8 +27,11 @@ export class GraphReconciler {
     nodes: Map<NodeId, NodeConfiguration>,
     connections: Set<ConnectionKey>,
   ): Promise<void> {
-    await this.reconcileNodes(nodes);
-    await this.reconcileConnections(connections, nodes);
+    // One compile for the whole reconciliation rather than one per node and connection edit.
+    await this.audioEngine.batchGraphUpdate(async () => {
+      await this.reconcileNodes(nodes);
+      await this.reconcileConnections(connections, nodes);
+    });
   }
 
   async forceConfigureNode(node: NodeConfiguration): Promise<void> {
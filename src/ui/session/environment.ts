@@ -190,6 +190,8 @@ interface ProductionEnvironmentOptions {
   storageDirectory?: string;
   sampleRate?: number;
   framesPerBuffer?: number;
+  maxChannels?: number;
+  maxFramesPerBuffer?: number;
   bpm?: number;
   fileLoader?: AudioFileLoader;
 }
@@ -251,7 +253,13 @@ export const createProductionSessionEnvironment = async (
   const bpm = options.bpm ?? DEFAULT_BPM;
   const sessionId = options.sessionId ?? DEMO_SESSION_ID;
 
-  const audioEngine = new AudioEngine({ sampleRate, framesPerBuffer, bpm });
+  const audioEngine = new AudioEngine({
+    sampleRate,
+    framesPerBuffer,
+    bpm,
+    maxChannels: options.maxChannels,
+    maxFramesPerBuffer: options.maxFramesPerBuffer,
+  });
   await audioEngine.init();
   const fileLoader = options.fileLoader ?? new NativeAudioFileLoader();
   const pluginHost = instantiatePluginHost();